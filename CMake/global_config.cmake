@@ -61,6 +61,10 @@ macro(global_set_flags)
         add_definitions(-DRS2_USE_CUDA)
     endif()
 
+    if (BUILD_WITH_LIBJPEG_TURBO)
+        add_definitions(-DRS2_USE_LIBJPEG_TURBO)
+    endif()
+
     if (BUILD_SHARED_LIBS)
         add_definitions(-DBUILD_SHARED_LIBS)
     endif()
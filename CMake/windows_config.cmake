@@ -39,7 +39,6 @@ macro(os_set_flags)
         set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} /MP")
 
         set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} /bigobj /wd4819")
-        set(LRS_TRY_USE_AVX true)
         add_definitions(-D_UNICODE)
     endif()
     set(DOTNET_VERSION_LIBRARY "3.5" CACHE STRING ".Net Version, defaulting to '3.5', the Unity wrapper currently supports only .NET 3.5")
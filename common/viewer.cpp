@@ -885,6 +885,10 @@ namespace rs2
         _hidden_options.emplace(RS2_OPTION_STREAM_FORMAT_FILTER);
         _hidden_options.emplace(RS2_OPTION_STREAM_INDEX_FILTER);
         _hidden_options.emplace(RS2_OPTION_FRAMES_QUEUE_SIZE);
+        _hidden_options.emplace(RS2_OPTION_FRAMES_POOL_HITS);
+        _hidden_options.emplace(RS2_OPTION_FRAMES_POOL_MISSES);
+        _hidden_options.emplace(RS2_OPTION_FRAMES_POOL_EVICTIONS);
+        _hidden_options.emplace(RS2_OPTION_FRAMES_POOL_RETENTION);
         _hidden_options.emplace(RS2_OPTION_SENSOR_MODE);
         _hidden_options.emplace(RS2_OPTION_NOISE_ESTIMATION);
     }
@@ -80,6 +80,24 @@ void rs2_context_remove_device(rs2_context* ctx, const char* file, rs2_error** e
  */
 void rs2_context_unload_tracking_module(rs2_context* ctx, rs2_error** error);
 
+/**
+* Sets the threads that the CPU processing blocks (filters, align, pointcloud, colorizer and format conversions)
+* split each frame between. The threads are shared by all the blocks of the library, in every context, so blocks
+* that run at the same time do not oversubscribe the cores
+* \param[in] ctx      Object representing librealsense session
+* \param[in] threads  Threads working on a frame, including the one that processes it: 1 for none, 0 for one per core (the default)
+* \param[in] pinned   Non-zero to bind each worker thread to a core of its own (Linux and Windows)
+* \param[out] error   If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_context_set_processing_threads(rs2_context* ctx, int threads, int pinned, rs2_error** error);
+
+/**
+* \param[in] ctx      Object representing librealsense session
+* \param[out] error   If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return             The threads that the CPU processing blocks split each frame between
+*/
+int rs2_context_get_processing_threads(const rs2_context* ctx, rs2_error** error);
+
 /**
 * create a static snapshot of all connected devices at the time of the call
 * \param context     Object representing librealsense session
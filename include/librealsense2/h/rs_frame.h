@@ -96,6 +96,17 @@ rs2_metadata_type rs2_get_frame_metadata(const rs2_frame* frame, rs2_frame_metad
 */
 int rs2_supports_frame_metadata(const rs2_frame* frame, rs2_frame_metadata_value frame_metadata, rs2_error** error);
 
+/**
+* retrieve all the metadata of a frame at once, which costs less than querying the attributes one at a time
+* \param[in] frame         handle returned from a callback
+* \param[out] values       receives the first count metadata values, by rs2_frame_metadata_value; 0 for those the frame does not support
+* \param[out] supported    receives (count + 7) / 8 bytes, with bit (i % 8) of byte (i / 8) set when the frame supports metadata value i
+* \param[in] count         number of metadata values to retrieve, usually RS2_FRAME_METADATA_COUNT
+* \param[out] error        if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                  the number of metadata values the frame supports
+*/
+int rs2_get_all_frame_metadata(const rs2_frame* frame, rs2_metadata_type* values, unsigned char* supported, int count, rs2_error** error);
+
 /**
 * retrieve timestamp domain from frame handle. timestamps can only be comparable if they are in common domain
 * (for example, depth timestamp might come from system time while color timestamp might come from the device)
@@ -357,6 +368,29 @@ void rs2_pose_frame_get_pose_data(const rs2_frame* frame, rs2_pose* pose, rs2_er
 */
 void rs2_extract_target_dimensions(const rs2_frame* frame, rs2_calib_target_type calib_type, float * target_dims, unsigned int target_dims_size, rs2_error** error);
 
+/**
+* Provide the memory for frame buffers allocated by the library from now on, e.g. from a huge-page arena, a NUMA-local pool or shared memory
+* Buffers allocated earlier keep being released through the allocator that provided them
+* \param[in] on_allocate    Function returning a buffer of at least the requested size in bytes. Must not return null
+* \param[in] on_deallocate  Function releasing a buffer previously returned by on_allocate, along with its size
+* \param[in] user           User argument passed to both functions
+* \param[out] error         If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_frame_allocator(rs2_frame_allocate_ptr on_allocate, rs2_frame_deallocate_ptr on_deallocate, void* user, rs2_error** error);
+
+/**
+* Provide the memory for frame buffers allocated by the library from now on
+* \param[in] allocator      Allocator object created from C++ application. Ownership over the object is moved into the library, which calls its release() once it is no longer in use
+* \param[out] error         If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_frame_allocator_cpp(rs2_frame_allocator* allocator, rs2_error** error);
+
+/**
+* Restore the default heap allocation of frame buffers
+* \param[out] error         If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_reset_frame_allocator(rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
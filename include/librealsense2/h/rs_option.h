@@ -111,6 +111,10 @@ extern "C" {
         RS2_OPTION_AUTO_GAIN_LIMIT, /**< Set and get auto gain limits ranging from 16 to 248. Default is 0 which means full gain. If the requested gain limit is less than 16, it will be set to 16. If the requested gain limit is greater than 248, it will be set to 248. Setting will not take effect until next streaming session. */
         RS2_OPTION_AUTO_RX_SENSITIVITY, /**< Enable receiver sensitivity according to ambient light, bounded by the Receiver Gain control. */
         RS2_OPTION_TRANSMITTER_FREQUENCY, /**<changes the transmitter frequencies increasing effective range over sharpness. */
+        RS2_OPTION_FRAMES_POOL_HITS, /**< Debug: number of frames whose buffer was reused from the frame buffers pool */
+        RS2_OPTION_FRAMES_POOL_MISSES, /**< Debug: number of frames that required a new frame buffer allocation */
+        RS2_OPTION_FRAMES_POOL_EVICTIONS, /**< Debug: number of frame buffers dropped from the pool, either expired or overflowing */
+        RS2_OPTION_FRAMES_POOL_RETENTION, /**< Time in milliseconds an unused frame buffer is kept in the frame buffers pool for reuse */
         RS2_OPTION_COUNT /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
     } rs2_option;
 
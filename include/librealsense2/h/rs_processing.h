@@ -27,6 +27,13 @@ extern "C" {
 */
 rs2_processing_block* rs2_create_colorizer(rs2_error** error);
 
+/**
+* Creates Depth-Colorizer processing block with a choice of output format
+* \param[in] format  RS2_FORMAT_RGB8, RS2_FORMAT_BGR8, RS2_FORMAT_RGBA8 or RS2_FORMAT_BGRA8; the 4th byte of RGBA8/BGRA8 is opaque
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_colorizer_with_format(rs2_format format, rs2_error** error);
+
 /**
 * Creates Sync processing block. This block accepts arbitrary frames and output composite frames of best matches
 * Some frames may be released within the syncer if they are waiting for match for too long
@@ -35,6 +42,15 @@ rs2_processing_block* rs2_create_colorizer(rs2_error** error);
 */
 rs2_processing_block* rs2_create_sync_processing_block(rs2_error** error);
 
+/**
+* Creates Cross-Device Sync processing block. This block accepts the frames of several hardware-synchronized devices
+* and outputs one composite frame per capture instant, referencing the input frames.
+* Frames are matched by global-time timestamp, and by frame counter once the counter offsets between the streams are known
+* \param[in] tolerance_ms  Max timestamp difference between frames of the same capture; 0 for half the frame interval
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_cross_device_sync_processing_block(float tolerance_ms, rs2_error** error);
+
 /**
 * Creates Point-Cloud processing block. This block accepts depth frames and outputs Points frames
 * In addition, given non-depth frame, the block will align texture coordinate to the non-depth stream
@@ -149,6 +165,16 @@ void rs2_delete_processing_block(rs2_processing_block* block);
 */
 rs2_frame_queue* rs2_create_frame_queue(int capacity, rs2_error** error);
 
+/**
+* create a frame queue backed by a lock-free ring buffer. Frames are handed over without locking, which avoids
+* the wakeup latency of the regular queue when the consumer is already waiting. Dropping behavior is the same.
+* \param[in] capacity max number of frames to allow to be stored in the queue before older frames will start to get dropped
+* \param[in] spin_count number of times a waiting consumer polls the queue before going to sleep; 0 sleeps immediately
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return handle to the frame queue, must be released using rs2_delete_frame_queue
+*/
+rs2_frame_queue* rs2_create_lock_free_frame_queue(int capacity, int spin_count, rs2_error** error);
+
 /**
 * deletes frame queue and releases all frames inside it
 * \param[in] queue queue to delete
@@ -229,6 +255,23 @@ rs2_processing_block* rs2_create_disparity_transform_block(unsigned char transfo
 */
 rs2_processing_block* rs2_create_hole_filling_filter_block(rs2_error** error);
 
+/**
+* Creates a Depth post-processing block that runs the recommended chain of filters in a single block:
+* decimation, depth to disparity, spatial, temporal, disparity to depth and hole filling.
+* The output is the same as that of the individual blocks, with a single frame allocation
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_post_processing_block(rs2_error** error);
+
+/**
+* Retrieve a stage of a Depth post-processing block, to query and set its options as on the individual block
+* \param[in]  block    The Depth post-processing block
+* \param[in]  stage    RS2_EXTENSION_DECIMATION_FILTER, RS2_EXTENSION_SPATIAL_FILTER, RS2_EXTENSION_TEMPORAL_FILTER or RS2_EXTENSION_HOLE_FILLING_FILTER
+* \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return              The stage processing block, to be released with rs2_delete_processing_block
+*/
+rs2_processing_block* rs2_get_depth_post_processing_stage(rs2_processing_block* block, rs2_extension stage, rs2_error** error);
+
 /**
 * Creates a rates printer block. The printer prints the actual FPS of the invoked frame stream.
 * The block ignores reapiting frames and calculats the FPS only if the frame number of the relevant frame was changed.
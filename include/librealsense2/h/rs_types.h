@@ -9,6 +9,8 @@
 #ifndef LIBREALSENSE_RS2_TYPES_H
 #define LIBREALSENSE_RS2_TYPES_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -131,6 +133,14 @@ typedef struct rs2_vector
     float x, y, z;
 }rs2_vector;
 
+/** \brief Sample of a motion frame of RS2_FORMAT_MOTION_BATCH, which holds an array of them */
+typedef struct rs2_motion_sample
+{
+    double      timestamp; /**< Of the sample, in the timestamp domain of the frame, in milliseconds */
+    rs2_vector  data;      /**< As in a motion frame of RS2_FORMAT_MOTION_XYZ32F */
+    float       reserved;
+} rs2_motion_sample;
+
 /** \brief Quaternion used to represent rotation  */
 typedef struct rs2_quaternion
 {
@@ -289,6 +299,7 @@ typedef struct rs2_firmware_log_message rs2_firmware_log_message;
 typedef struct rs2_firmware_log_parsed_message rs2_firmware_log_parsed_message;
 typedef struct rs2_firmware_log_parser rs2_firmware_log_parser;
 typedef struct rs2_terminal_parser rs2_terminal_parser;
+typedef struct rs2_frame_allocator rs2_frame_allocator;
 typedef void (*rs2_log_callback_ptr)(rs2_log_severity, rs2_log_message const *, void * arg);
 typedef void (*rs2_notification_callback_ptr)(rs2_notification*, void*);
 typedef void(*rs2_software_device_destruction_callback_ptr)(void*);
@@ -296,6 +307,8 @@ typedef void (*rs2_devices_changed_callback_ptr)(rs2_device_list*, rs2_device_li
 typedef void (*rs2_frame_callback_ptr)(rs2_frame*, void*);
 typedef void (*rs2_frame_processor_callback_ptr)(rs2_frame*, rs2_source*, void*);
 typedef void(*rs2_update_progress_callback_ptr)(const float, void*);
+typedef void* (*rs2_frame_allocate_ptr)(size_t, void*);
+typedef void (*rs2_frame_deallocate_ptr)(void*, size_t, void*);
 
 typedef double      rs2_time_t;     /**< Timestamp format. units are milliseconds */
 typedef long long   rs2_metadata_type; /**< Metadata attribute type is defined as 64 bit signed integer*/
@@ -206,6 +206,26 @@ namespace rs2
             rs2::error::handle(e);
         }
 
+        /**
+        * Sets the threads that the CPU processing blocks split each frame between, for the whole library
+        * \param[in] threads  Including the thread that processes the frame: 1 for none, 0 for one per core (the default)
+        * \param[in] pinned   Whether each worker thread is bound to a core of its own
+        */
+        void set_processing_threads(int threads, bool pinned = false)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_processing_threads(_context.get(), threads, pinned ? 1 : 0, &e);
+            rs2::error::handle(e);
+        }
+
+        int get_processing_threads() const
+        {
+            rs2_error* e = nullptr;
+            auto threads = rs2_context_get_processing_threads(_context.get(), &e);
+            rs2::error::handle(e);
+            return threads;
+        }
+
         context(std::shared_ptr<rs2_context> ctx)
             : _context(ctx)
         {}
@@ -5,6 +5,8 @@
 #define LIBREALSENSE_RS2_FRAME_HPP
 
 #include "rs_types.hpp"
+#include <array>
+#include <bitset>
 
 namespace rs2
 {
@@ -514,6 +516,23 @@ namespace rs2
             return r != 0;
         }
 
+        /** retrieve all the frame_metadata at once, which costs less than querying it one at a time
+        * \param[out] values  the value of each frame_metadata, by rs2_frame_metadata_value; 0 for those not supported
+        * \return             the frame_metadata that can be queried
+        */
+        std::bitset<RS2_FRAME_METADATA_COUNT> get_all_frame_metadata(std::array<rs2_metadata_type, RS2_FRAME_METADATA_COUNT>& values) const
+        {
+            rs2_error* e = nullptr;
+            unsigned char mask[(RS2_FRAME_METADATA_COUNT + 7) / 8];
+            rs2_get_all_frame_metadata(frame_ref, values.data(), mask, RS2_FRAME_METADATA_COUNT, &e);
+            error::handle(e);
+
+            std::bitset<RS2_FRAME_METADATA_COUNT> supported;
+            for (int i = 0; i < RS2_FRAME_METADATA_COUNT; ++i)
+                supported[i] = (mask[i / 8] >> (i % 8) & 1) != 0;
+            return supported;
+        }
+
         /**
         * retrieve frame number (from frame handle)
         * \return               the frame number of the frame, in milliseconds since the device was started
@@ -900,13 +919,33 @@ namespace rs2
         }
         /**
         * Retrieve the motion data from IMU sensor
-        * \return rs2_vector - 3D vector in Euclidean coordinate space.
+        * \return rs2_vector - 3D vector in Euclidean coordinate space; the last sample of a frame of RS2_FORMAT_MOTION_BATCH.
         */
         rs2_vector get_motion_data() const
         {
+            if (auto count = get_sample_count())
+                return get_samples()[count - 1].data;
             auto data = reinterpret_cast<const float*>(get_data());
             return rs2_vector{ data[0], data[1], data[2] };
         }
+        /**
+        * Retrieve the number of samples in a frame of RS2_FORMAT_MOTION_BATCH
+        * \return the number of samples, or 0 for the frames of other formats
+        */
+        size_t get_sample_count() const
+        {
+            if (get_profile().format() != RS2_FORMAT_MOTION_BATCH)
+                return 0;
+            return get_data_size() / sizeof(rs2_motion_sample);
+        }
+        /**
+        * Retrieve the samples of a frame of RS2_FORMAT_MOTION_BATCH, from the oldest
+        * \return pointer to get_sample_count() samples
+        */
+        const rs2_motion_sample* get_samples() const
+        {
+            return reinterpret_cast<const rs2_motion_sample*>(get_data());
+        }
     };
 
     class pose_frame : public frame
@@ -151,6 +151,21 @@ namespace rs2
 
         frame_queue() : frame_queue(1) {}
 
+        /**
+        * create frame queue backed by a lock-free ring buffer, for consumers sensitive to wakeup latency
+        * param[in] capacity size of the frame queue
+        * param[in] keep_frames  if set to true, the queue automatically calls keep() on every frame enqueued into it.
+        * param[in] spin_count  number of times a waiting consumer polls the queue before going to sleep
+        */
+        frame_queue(unsigned int capacity, bool keep_frames, unsigned int spin_count) : _capacity(capacity), _keep(keep_frames)
+        {
+            rs2_error* e = nullptr;
+            _queue = std::shared_ptr<rs2_frame_queue>(
+                rs2_create_lock_free_frame_queue(capacity, spin_count, &e),
+                rs2_delete_frame_queue);
+            error::handle(e);
+        }
+
         /**
         * enqueue new frame into the queue
         * \param[in] f - frame handle to enqueue (this operation passed ownership to the queue)
@@ -658,6 +673,86 @@ namespace rs2
         frame_queue _results;
     };
 
+    /**
+    * Matches the frames of several devices into one frameset per capture instant. Frames of all the devices
+    * are passed to the same instance; the devices should be hardware-synchronized and have global time enabled.
+    */
+    class cross_device_syncer
+    {
+    public:
+        /**
+        * \param[in] tolerance_ms  Max timestamp difference of frames of the same capture; 0 for half a frame interval
+        * \param[in] queue_size    Number of framesets kept until they are waited for
+        */
+        explicit cross_device_syncer(float tolerance_ms = 0.f, int queue_size = 1)
+            : _sync(init(tolerance_ms)), _results(queue_size)
+        {
+            _sync.start(_results);
+        }
+
+        /**
+        * Wait until a frameset becomes available
+        * \param[in] timeout_ms   Max time in milliseconds to wait until an exception will be thrown
+        * \return Frames of all the devices taken at the same instant
+        */
+        frameset wait_for_frames(unsigned int timeout_ms = 5000) const
+        {
+            return frameset(_results.wait_for_frame(timeout_ms));
+        }
+
+        /**
+        * Check if a frameset is available
+        * \param[out] fs      New frameset
+        * \return true if new frameset was stored to result
+        */
+        bool poll_for_frames(frameset* fs) const
+        {
+            frame result;
+            if (_results.poll_for_frame(&result))
+            {
+                *fs = frameset(result);
+                return true;
+            }
+            return false;
+        }
+
+        /**
+        * Wait until a frameset becomes available
+        * \param[in] timeout_ms     Max time in milliseconds to wait until an available frame
+        * \param[out] fs            New frameset
+        * \return true if new frameset was stored to result
+        */
+        bool try_wait_for_frames(frameset* fs, unsigned int timeout_ms = 5000) const
+        {
+            frame result;
+            if (_results.try_wait_for_frame(&result, timeout_ms))
+            {
+                *fs = frameset(result);
+                return true;
+            }
+            return false;
+        }
+
+        void operator()(frame f) const
+        {
+            _sync.invoke(std::move(f));
+        }
+    private:
+        static std::shared_ptr<rs2_processing_block> init(float tolerance_ms)
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_cross_device_sync_processing_block(tolerance_ms, &e),
+                rs2_delete_processing_block);
+
+            error::handle(e);
+            return block;
+        }
+
+        processing_block _sync;
+        frame_queue _results;
+    };
+
     /**
     Auxiliary processing block that performs image alignment using depth data and camera calibration
     */
@@ -733,6 +828,11 @@ namespace rs2
             set_option(RS2_OPTION_COLOR_SCHEME, float(color_scheme));
         }
         /**
+        * Create colorizer processing block with a choice of output format
+        * \param[in] output_format - RS2_FORMAT_RGB8, RS2_FORMAT_BGR8, RS2_FORMAT_RGBA8 or RS2_FORMAT_BGRA8
+        */
+        colorizer(rs2_format output_format) : filter(init(output_format), 1) { }
+        /**
         * Start to generate color image base on depth frame
         * \param[in] depth - depth frame to be processed to generate the color image
         * \return video_frame - generated color image
@@ -759,6 +859,17 @@ namespace rs2
 
             return block;
         }
+
+        std::shared_ptr<rs2_processing_block> init(rs2_format output_format)
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_colorizer_with_format(output_format, &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
     };
 
     class decimation_filter : public filter
@@ -1077,6 +1188,50 @@ namespace rs2
         }
     };
 
+    class depth_post_processing : public filter
+    {
+    public:
+        /**
+        * Create a Depth post-processing block
+        * The block runs decimation, spatial, temporal and hole filling (in the disparity domain, where supported)
+        * with the same output as the chain of the individual filters, and a single frame allocation.
+        * The options of each stage are set through the stage accessors.
+        */
+        depth_post_processing() : filter(init(), 1) {}
+
+        depth_post_processing(filter f) : filter(f) {}
+
+        decimation_filter decimation() const { return get_stage(RS2_EXTENSION_DECIMATION_FILTER); }
+        spatial_filter spatial() const { return get_stage(RS2_EXTENSION_SPATIAL_FILTER); }
+        temporal_filter temporal() const { return get_stage(RS2_EXTENSION_TEMPORAL_FILTER); }
+        hole_filling_filter hole_filling() const { return get_stage(RS2_EXTENSION_HOLE_FILLING_FILTER); }
+
+    private:
+        friend class context;
+
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_post_processing_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+
+        filter get_stage(rs2_extension stage) const
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_get_depth_post_processing_stage(_block.get(), stage, &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return filter(block);
+        }
+    };
+
     class rates_printer : public filter
     {
     public:
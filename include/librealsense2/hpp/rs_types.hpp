@@ -59,6 +59,14 @@ struct rs2_log_callback
     virtual                                 ~rs2_log_callback() {}
 };
 
+struct rs2_frame_allocator
+{
+    virtual void*                           allocate(size_t size) = 0;
+    virtual void                            deallocate(void* buffer, size_t size) = 0;
+    virtual void                            release() = 0;
+    virtual                                 ~rs2_frame_allocator() {}
+};
+
 struct rs2_calibration_change_callback
 {
     virtual void                            on_calibration_change( rs2_calibration_status ) noexcept = 0;
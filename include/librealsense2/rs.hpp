@@ -152,6 +152,47 @@ namespace rs2
         rs2_log(severity, message, &e);
         error::handle(e);
     }
+
+    /*
+        Wrapper around the functions given to set_frame_allocator.
+    */
+    template<class A, class D>
+    class frame_allocator : public rs2_frame_allocator
+    {
+        A on_allocate_function;
+        D on_deallocate_function;
+    public:
+        frame_allocator(A on_allocate, D on_deallocate)
+            : on_allocate_function(on_allocate), on_deallocate_function(on_deallocate) {}
+
+        void* allocate(size_t size) override { return on_allocate_function(size); }
+        void deallocate(void* buffer, size_t size) override { on_deallocate_function(buffer, size); }
+        void release() override { delete this; }
+    };
+
+    /*
+        Provide the memory for frame buffers allocated from now on, e.g. from a huge-page arena or shared memory:
+            rs2::set_frame_allocator(
+                []( size_t size ) { return arena.allocate( size ); },
+                []( void * buffer, size_t size ) { arena.free( buffer, size ); } );
+        The allocation function must not return null. Buffers allocated earlier keep being released
+        through the functions that provided them, so these must remain valid until all frames are released.
+    */
+    template<class A, class D>
+    inline void set_frame_allocator(A on_allocate, D on_deallocate)
+    {
+        rs2_error* e = nullptr;
+        rs2_set_frame_allocator_cpp(new frame_allocator<A, D>(std::move(on_allocate), std::move(on_deallocate)), &e);
+        error::handle(e);
+    }
+
+    // Restore the default heap allocation of frame buffers
+    inline void reset_frame_allocator()
+    {
+        rs2_error* e = nullptr;
+        rs2_reset_frame_allocator(&e);
+        error::handle(e);
+    }
 }
 
 inline std::ostream & operator << (std::ostream & o, rs2_stream stream) { return o << rs2_stream_to_string(stream); }
@@ -158,30 +158,31 @@ namespace librealsense
     std::shared_ptr<archive_interface> make_archive(rs2_extension type,
         std::atomic<uint32_t>* in_max_frame_queue_size,
         std::shared_ptr<platform::time_service> ts,
-        std::shared_ptr<metadata_parser_map> parsers)
+        std::shared_ptr<metadata_parser_map> parsers,
+        std::shared_ptr<const metadata_parser_table> table)
     {
         switch (type)
         {
         case RS2_EXTENSION_VIDEO_FRAME:
-            return std::make_shared<frame_archive<video_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<video_frame>>(in_max_frame_queue_size, ts, parsers, table);
 
         case RS2_EXTENSION_COMPOSITE_FRAME:
-            return std::make_shared<frame_archive<composite_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<composite_frame>>(in_max_frame_queue_size, ts, parsers, table);
 
         case RS2_EXTENSION_MOTION_FRAME:
-            return std::make_shared<frame_archive<motion_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<motion_frame>>(in_max_frame_queue_size, ts, parsers, table);
 
         case RS2_EXTENSION_POINTS:
-            return std::make_shared<frame_archive<points>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<points>>(in_max_frame_queue_size, ts, parsers, table);
 
         case RS2_EXTENSION_DEPTH_FRAME:
-            return std::make_shared<frame_archive<depth_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<depth_frame>>(in_max_frame_queue_size, ts, parsers, table);
 
         case RS2_EXTENSION_POSE_FRAME:
-            return std::make_shared<frame_archive<pose_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<pose_frame>>(in_max_frame_queue_size, ts, parsers, table);
 
         case RS2_EXTENSION_DISPARITY_FRAME:
-            return std::make_shared<frame_archive<disparity_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<disparity_frame>>(in_max_frame_queue_size, ts, parsers, table);
 
         default:
             throw std::runtime_error("Requested frame type is not supported!");
@@ -219,6 +220,18 @@ namespace librealsense
             throw invalid_value_exception(to_string() << "metadata not available for "
                 << get_string(get_stream()->get_stream_type()) << " stream");
 
+        if (frame_metadata >= 0 && frame_metadata < ::RS2_FRAME_METADATA_COUNT)
+        {
+            bool supported = false;
+            rs2_metadata_type value = 0;
+            if (read_decoded_metadata([&](const frame_metadata_values& metadata) {
+                    supported = metadata.supported[frame_metadata];
+                    value = metadata.values[frame_metadata];
+                }) && supported)
+                return value;
+        }
+
+        // Not supported, or not decoded yet; the parsers tell why
         auto parsers = metadata_parsers->equal_range(frame_metadata);
         if (parsers.first == metadata_parsers->end())          // Possible user error - md attribute is not supported by this frame type
             throw invalid_value_exception(to_string() << get_string(frame_metadata)
@@ -253,6 +266,15 @@ namespace librealsense
         if (!metadata_parsers)
             return false;                         // No parsers are available or no metadata was attached
 
+        if (frame_metadata >= 0 && frame_metadata < ::RS2_FRAME_METADATA_COUNT)
+        {
+            bool supported = false;
+            if (read_decoded_metadata([&](const frame_metadata_values& metadata) {
+                    supported = metadata.supported[frame_metadata];
+                }))
+                return supported;
+        }
+
         bool ret = false;
         auto found = metadata_parsers->equal_range(frame_metadata);
         if (found.first == metadata_parsers->end())
@@ -268,8 +290,80 @@ namespace librealsense
         return ret;
     }
 
+    void frame::get_all_frame_metadata(frame_metadata_values& metadata) const
+    {
+        if (!read_decoded_metadata([&](const frame_metadata_values& decoded) { metadata = decoded; }))
+            decode_metadata(metadata);
+    }
+
+    bool frame::acquire_decoded_metadata() const
+    {
+        unsigned state = _metadata_state;
+        for (;;)
+        {
+            auto phase = state & metadata_phase_mask;
+            if (phase == metadata_decoded)
+            {
+                if (_metadata_state.compare_exchange_weak(state, state + metadata_reader, std::memory_order_acquire))
+                    return true;
+            }
+            // Frames no archive owns are not cached, and values still read are not overwritten
+            else if (phase == metadata_not_decoded && !(state & metadata_readers_mask) && owner)
+            {
+                if (_metadata_state.compare_exchange_weak(state, state | metadata_decoding, std::memory_order_acquire))
+                    break;
+            }
+            else
+                return false;
+        }
+
+        decode_metadata(_metadata);
+
+        // The decoder is the first reader
+        unsigned current = state | metadata_decoding;
+        if (_metadata_state.compare_exchange_strong(current, (state | metadata_decoded) + metadata_reader, std::memory_order_release))
+            return true;
+
+        // Invalidated while decoded: not decoded, at the generation it has reached
+        while (!_metadata_state.compare_exchange_weak(current, (current & ~metadata_phase_mask) | metadata_not_decoded))
+            ;
+        return false;
+    }
+
+    void frame::decode_metadata(frame_metadata_values& metadata) const
+    {
+        metadata.values.fill(0);
+        metadata.supported.reset();
+        if (!metadata_parsers)
+            return;
+
+        if (metadata_table)
+        {
+            metadata_table->decode(*this, metadata);
+            return;
+        }
+
+        for (auto&& parser : *metadata_parsers)
+        {
+            auto i = parser.first;
+            // The internal attributes are past RS2_FRAME_METADATA_COUNT
+            if (i < 0 || i >= ::RS2_FRAME_METADATA_COUNT || metadata.supported[i] || !parser.second->supports(*this))
+                continue;
+            try
+            {
+                metadata.values[i] = parser.second->get(*this);
+                metadata.supported.set(i);
+            }
+            catch (invalid_value_exception&) {}
+        }
+    }
+
     int frame::get_frame_data_size() const
     {
+        // Frames that wrap a backend buffer (zero-copy) own no data of their own
+        if (data.empty() && on_release.get_data())
+            return (int)additional_data.raw_size;
+
         return (int)data.size();
     }
 
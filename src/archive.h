@@ -13,6 +13,7 @@ namespace librealsense
 {
     class archive_interface;
     class md_attribute_parser_base;
+    class metadata_parser_table;
     class frame;
 
     // multimap is necessary here in order to permit registration to some metadata value in multiple places in metadata
@@ -71,6 +72,248 @@ namespace librealsense
         }
     };
 
+    // STL allocator forwarding frame buffer allocations to the user provided allocator,
+    // or to the default heap when none was set
+    template<class T>
+    class frame_buffer_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        frame_buffer_allocator() {}
+        explicit frame_buffer_allocator(frame_allocator_ptr allocator) : _allocator(std::move(allocator)) {}
+        template<class U>
+        frame_buffer_allocator(const frame_buffer_allocator<U>& other) : _allocator(other.get_allocator()) {}
+
+        T* allocate(size_t n)
+        {
+            if (!_allocator)
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+
+            auto buffer = _allocator->allocate(n * sizeof(T));
+            if (!buffer)
+                throw std::bad_alloc();
+            return static_cast<T*>(buffer);
+        }
+
+        void deallocate(T* buffer, size_t n)
+        {
+            if (!_allocator)
+                ::operator delete(buffer);
+            else
+                _allocator->deallocate(buffer, n * sizeof(T));
+        }
+
+        const frame_allocator_ptr& get_allocator() const { return _allocator; }
+
+    private:
+        frame_allocator_ptr _allocator;
+    };
+
+    template<class T, class U>
+    bool operator==(const frame_buffer_allocator<T>& a, const frame_buffer_allocator<U>& b) { return a.get_allocator() == b.get_allocator(); }
+    template<class T, class U>
+    bool operator!=(const frame_buffer_allocator<T>& a, const frame_buffer_allocator<U>& b) { return !(a == b); }
+
+    typedef std::vector<byte, frame_buffer_allocator<byte>> frame_buffer;
+
+    // Lock-free pool of frame buffers, bucketed by buffer size
+    // Every bucket serves a single buffer size and holds a fixed number of slots.
+    // Slots are claimed with a compare-and-swap on their state, so concurrent
+    // producers and consumers never block each other. Buffers that were not reused
+    // within the retention period are evicted.
+    class frame_buffer_pool
+    {
+    public:
+        static const int BUCKETS = 8;
+        static const int SLOTS = 16;
+
+        struct statistics
+        {
+            unsigned long long hits;
+            unsigned long long misses;
+            unsigned long long evictions;
+        };
+
+        explicit frame_buffer_pool(rs2_time_t retention = 1000.)
+            : _retention(retention), _hits(0), _misses(0), _evictions(0)
+        {
+            for (auto&& b : _buckets)
+            {
+                b.size = 0;
+                for (auto&& s : b.slots)
+                    s.state = slot_empty;
+            }
+        }
+
+        // Take a buffer of the requested size out of the pool. Returns false on a miss
+        bool acquire(size_t size, rs2_time_t now, frame_buffer& buffer)
+        {
+            if (auto b = find_bucket(size, false))
+            {
+                for (auto&& s : b->slots)
+                {
+                    if (!try_lock(s, slot_full))
+                        continue;
+
+                    auto stale = now > s.released_at + _retention;
+                    if (!stale && s.buffer.size() == size)
+                    {
+                        buffer = std::move(s.buffer);
+                        s.buffer = frame_buffer();
+                        s.state = slot_empty;
+                        ++_hits;
+                        return true;
+                    }
+
+                    s.buffer = frame_buffer();
+                    s.state = slot_empty;
+                    ++_evictions;
+                }
+            }
+
+            ++_misses;
+            evict_stale(now);
+            return false;
+        }
+
+        // Hand a buffer back for reuse. The buffer is dropped when its bucket is full
+        void release(frame_buffer&& buffer, rs2_time_t now)
+        {
+            auto size = buffer.size();
+            if (!size)
+                return;
+
+            if (auto b = find_bucket(size, true))
+            {
+                for (auto&& s : b->slots)
+                {
+                    if (!try_lock(s, slot_empty))
+                        continue;
+
+                    s.buffer = std::move(buffer);
+                    s.released_at = now;
+                    s.state = slot_full;
+                    return;
+                }
+            }
+
+            ++_evictions;
+        }
+
+        // Allocate buffers ahead of time, so the first frames of a stream hit the pool
+        void prewarm(size_t size, int count, rs2_time_t now, const frame_buffer_allocator<byte>& allocator)
+        {
+            for (auto i = 0; i < count; i++)
+                release(frame_buffer(size, 0, allocator), now);
+        }
+
+        void clear()
+        {
+            for (auto&& b : _buckets)
+            {
+                for (auto&& s : b.slots)
+                {
+                    if (!try_lock(s, slot_full))
+                        continue;
+
+                    s.buffer = frame_buffer();
+                    s.state = slot_empty;
+                }
+            }
+        }
+
+        void set_retention(rs2_time_t retention) { _retention = retention; }
+
+        statistics get_statistics() const
+        {
+            return { _hits.load(), _misses.load(), _evictions.load() };
+        }
+
+    private:
+        enum slot_state { slot_empty, slot_locked, slot_full };
+
+        struct slot
+        {
+            std::atomic<int> state;
+            frame_buffer buffer;
+            rs2_time_t released_at = 0;
+        };
+
+        struct bucket
+        {
+            std::atomic<size_t> size;
+            std::array<slot, SLOTS> slots;
+        };
+
+        static bool try_lock(slot& s, slot_state expected)
+        {
+            int state = expected;
+            return s.state.compare_exchange_strong(state, slot_locked);
+        }
+
+        bucket* find_bucket(size_t size, bool claim)
+        {
+            for (auto&& b : _buckets)
+                if (b.size == size)
+                    return &b;
+
+            if (claim)
+            {
+                for (auto&& b : _buckets)
+                {
+                    size_t unused = 0;
+                    if (b.size.compare_exchange_strong(unused, size) || unused == size)
+                        return &b;
+                }
+            }
+            return nullptr;
+        }
+
+        // Drop expired buffers from every bucket, and release the buckets left empty
+        // so that they can serve a different buffer size
+        void evict_stale(rs2_time_t now)
+        {
+            for (auto&& b : _buckets)
+            {
+                bool empty = true;
+                for (auto&& s : b.slots)
+                {
+                    if (!try_lock(s, slot_full))
+                    {
+                        empty = empty && s.state == slot_empty;
+                        continue;
+                    }
+
+                    if (now > s.released_at + _retention)
+                    {
+                        s.buffer = frame_buffer();
+                        s.state = slot_empty;
+                        ++_evictions;
+                    }
+                    else
+                    {
+                        s.state = slot_full;
+                        empty = false;
+                    }
+                }
+
+                // A buffer released concurrently into a recycled bucket is caught by the size check in acquire()
+                if (empty)
+                    b.size = 0;
+            }
+        }
+
+        std::array<bucket, BUCKETS> _buckets;
+        std::atomic<rs2_time_t> _retention;
+        std::atomic<unsigned long long> _hits;
+        std::atomic<unsigned long long> _misses;
+        std::atomic<unsigned long long> _evictions;
+    };
+
     class archive_interface : public sensor_part
     {
     public:
@@ -78,7 +321,12 @@ namespace librealsense
 
         virtual frame_interface* alloc_and_track(const size_t size, const frame_additional_data& additional_data, bool requires_memory) = 0;
 
+        virtual void prewarm(const size_t size, int count) = 0;
+        virtual void set_buffers_retention(rs2_time_t retention) = 0;
+        virtual frame_buffer_pool::statistics get_buffers_statistics() const = 0;
+
         virtual std::shared_ptr<metadata_parser_map> get_md_parsers() const = 0;
+        virtual std::shared_ptr<const metadata_parser_table> get_md_table() const = 0;
 
         virtual void flush() = 0;
 
@@ -91,23 +339,28 @@ namespace librealsense
     std::shared_ptr<archive_interface> make_archive(rs2_extension type,
         std::atomic<uint32_t>* in_max_frame_queue_size,
         std::shared_ptr<platform::time_service> ts,
-        std::shared_ptr<metadata_parser_map> parsers);
+        std::shared_ptr<metadata_parser_map> parsers,
+        std::shared_ptr<const metadata_parser_table> table);
 
     // Define a movable but explicitly noncopyable buffer type to hold our frame data
     class LRS_EXTENSION_API frame : public frame_interface
     {
     public:
-        std::vector<byte> data;
+        frame_buffer data;
         frame_additional_data additional_data;
         std::shared_ptr<metadata_parser_map> metadata_parsers = nullptr;
-        explicit frame() : ref_count(0), owner(nullptr), on_release(),_kept(false) {}
+        std::shared_ptr<const metadata_parser_table> metadata_table = nullptr; // Of metadata_parsers
+        explicit frame() : ref_count(0), owner(nullptr), on_release(),_kept(false), _metadata_state(metadata_not_decoded) {}
         frame(const frame& r) = delete;
         frame(frame&& r)
-            : ref_count(r.ref_count.exchange(0)), owner(r.owner), on_release(), _kept(r._kept.exchange(false))
+            : ref_count(r.ref_count.exchange(0)), owner(r.owner), on_release(), _kept(r._kept.exchange(false)),
+            _metadata_state(metadata_not_decoded)
         {
             *this = std::move(r);
             if (owner) metadata_parsers = owner->get_md_parsers();
+            if (owner) metadata_table = owner->get_md_table();
             if (r.metadata_parsers) metadata_parsers = std::move(r.metadata_parsers);
+            if (r.metadata_table) metadata_table = std::move(r.metadata_table);
         }
 
         frame& operator=(const frame& r) = delete;
@@ -119,24 +372,42 @@ namespace librealsense
             _kept = r._kept.exchange(false);
             on_release = std::move(r.on_release);
             additional_data = std::move(r.additional_data);
+            invalidate_metadata();
             r.owner.reset();
             if (owner) metadata_parsers = owner->get_md_parsers();
+            if (owner) metadata_table = owner->get_md_table();
             if (r.metadata_parsers) metadata_parsers = std::move(r.metadata_parsers);
+            if (r.metadata_table) metadata_table = std::move(r.metadata_table);
             return *this;
         }
 
         virtual ~frame() { on_release.reset(); }
         rs2_metadata_type get_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const override;
         bool supports_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const override;
+        void get_all_frame_metadata(frame_metadata_values& metadata) const override;
+        // The metadata is decoded once, on first use; changes to additional_data after that must
+        // be followed by a call to this. Safe while other threads read or decode the metadata
+        void invalidate_metadata()
+        {
+            // A decoder still running stays the only one, and drops what it decoded once it sees
+            // the generation move; readers still at it finish with the values they hold
+            unsigned state = _metadata_state;
+            unsigned next;
+            do
+                next = (state & ~metadata_phase_mask) + metadata_generation
+                     + ((state & metadata_phase_mask) == metadata_decoding ? metadata_decoding : metadata_not_decoded);
+            while (!_metadata_state.compare_exchange_weak(state, next));
+        }
         int get_frame_data_size() const override;
         const byte* get_frame_data() const override;
         rs2_time_t get_frame_timestamp() const override;
         rs2_timestamp_domain get_frame_timestamp_domain() const override;
-        void set_timestamp(double new_ts) override { additional_data.timestamp = new_ts; }
+        void set_timestamp(double new_ts) override { additional_data.timestamp = new_ts; invalidate_metadata(); }
         unsigned long long get_frame_number() const override;
         void set_timestamp_domain(rs2_timestamp_domain timestamp_domain) override
         {
             additional_data.timestamp_domain = timestamp_domain;
+            invalidate_metadata();
         }
 
         rs2_time_t get_frame_system_time() const override;
@@ -180,6 +451,36 @@ namespace librealsense
         bool _fixed = false;
         std::atomic_bool _kept;
         std::shared_ptr<stream_profile_interface> stream;
+
+        // _metadata_state holds the phase of _metadata in its low bits, then the number of threads
+        // reading it, then a generation that invalidate_metadata() advances. Whoever moves the phase
+        // from not_decoded to decoding, which takes no readers, fills _metadata, and marks it decoded
+        // only if the generation has not moved meanwhile. Readers join only while it is decoded, so
+        // _metadata is never written while read; the threads that find it in any other phase (and
+        // the parsers that query other attributes) go to the parsers. Frames are published, and so
+        // decoded, from the moment an archive allocates them
+        enum
+        {
+            metadata_not_decoded, metadata_decoding, metadata_decoded, metadata_phase_mask = 3,
+            metadata_reader = 4, metadata_readers_mask = 0xffff * metadata_reader,
+            metadata_generation = 0x10000 * metadata_reader
+        };
+        mutable std::atomic<unsigned> _metadata_state;
+        mutable frame_metadata_values _metadata;
+
+        // Calls read(_metadata), decoding it first if no other thread has; false, without calling
+        // read, if it is being decoded or changed, and is to be decoded apart
+        template<class F>
+        bool read_decoded_metadata(F read) const
+        {
+            if (!acquire_decoded_metadata())
+                return false;
+            read(static_cast<const frame_metadata_values&>(_metadata));
+            _metadata_state.fetch_sub(metadata_reader, std::memory_order_release);
+            return true;
+        }
+        bool acquire_decoded_metadata() const;
+        void decode_metadata(frame_metadata_values& metadata) const;
     };
 
     class points : public frame
@@ -234,6 +535,10 @@ namespace librealsense
         {
             return first()->supports_frame_metadata(frame_metadata);
         }
+        void get_all_frame_metadata(frame_metadata_values& metadata) const override
+        {
+            first()->get_all_frame_metadata(metadata);
+        }
         int get_frame_data_size() const override
         {
             return first()->get_frame_data_size();
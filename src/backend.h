@@ -293,6 +293,7 @@ namespace librealsense
         {
             hid_sensor sensor;
             frame_object fo;
+            bool batch_continues; // More samples read along with this one follow, from the same thread
         };
 
         struct hid_profile
@@ -6,7 +6,7 @@
 #include "Lz4Compression.h"
 #include "RvlCompression.h"
 
-std::shared_ptr<ICompression> CompressionFactory::getObject(int t_width, int t_height, rs2_format t_format, rs2_stream t_streamType, int t_bpp)
+std::shared_ptr<ICompression> CompressionFactory::getObject(int t_width, int t_height, rs2_format t_format, rs2_stream t_streamType, int t_bpp, ZipMethod t_depthMethod)
 {
     ZipMethod zipMeth;
     if(t_streamType == RS2_STREAM_COLOR || t_streamType == RS2_STREAM_INFRARED)
@@ -15,7 +15,7 @@ std::shared_ptr<ICompression> CompressionFactory::getObject(int t_width, int t_h
     }
     else if(t_streamType == RS2_STREAM_DEPTH)
     {
-        zipMeth = ZipMethod::lz;
+        zipMeth = t_depthMethod;
     }
     if(!isCompressionSupported(t_format, t_streamType))
     {
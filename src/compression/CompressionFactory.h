@@ -17,7 +17,9 @@ typedef enum ZipMethod
 class CompressionFactory
 {
 public:
-    static std::shared_ptr<ICompression> getObject(int t_width, int t_height, rs2_format t_format, rs2_stream t_streamType, int t_bpp);
+    // Depth is compressed with t_depthMethod: lz by default, rvl is only decoded by clients that
+    // read the depth_compression SDP field
+    static std::shared_ptr<ICompression> getObject(int t_width, int t_height, rs2_format t_format, rs2_stream t_streamType, int t_bpp, ZipMethod t_depthMethod = ZipMethod::lz);
     static bool isCompressionSupported(rs2_format t_format, rs2_stream t_streamType);
     static bool& getIsEnabled();
 };
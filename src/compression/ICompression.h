@@ -12,6 +12,8 @@ class ICompression
 public:
     ICompression(int t_width, int t_height, rs2_format t_format, int t_bpp): 
         m_width(t_width),m_height(t_height), m_format(t_format), m_bpp(t_bpp) {};
+    // t_compressedBuf holds t_size bytes, and nothing is written past them: frames that do not
+    // compress to that fail, with -1
     virtual int compressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_compressedBuf) = 0;
     virtual int decompressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_uncompressedBuf) = 0;
 
@@ -13,19 +13,16 @@ Lz4Compression::Lz4Compression(int t_width, int t_height, rs2_format t_format, i
 
 int Lz4Compression::compressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_compressedBuf)
 {
-    const int maxDstSize = LZ4_compressBound(t_size);
-    const int compressedSize = LZ4_compress_default((const char*)t_buffer, (char*)t_compressedBuf + sizeof(int), t_size, maxDstSize);
+    // The destination holds t_size bytes, and LZ4 stops rather than write past them: frames that do
+    // not compress fail here
+    const int maxDstSize = t_size - int(sizeof(int));
+    const int compressedSize = maxDstSize > 0 ? LZ4_compress_default((const char*)t_buffer, (char*)t_compressedBuf + sizeof(int), t_size, maxDstSize) : 0;
     if(compressedSize <= 0)
-    {
-        ERR << "Failure trying to compress the data.";
-        return -1;
-    }
-    int compressWithHeaderSize = compressedSize + sizeof(compressedSize);
-    if(compressWithHeaderSize > t_size)
     {
         ERR << "Compression overflow, destination buffer is smaller than the compressed size.";
         return -1;
     }
+    int compressWithHeaderSize = compressedSize + sizeof(compressedSize);
     if(m_compFrameCounter++ % 50 == 0)
     {
         INF << "frame " << m_compFrameCounter << "\tdepth\tcompression\tlz4\t" << t_size << "\t/\t" << compressedSize;
@@ -2,128 +2,356 @@
 // Copyright(c) 2020 Intel Corporation. All Rights Reserved.
 
 #include "RvlCompression.h"
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <iostream>
+#include <thread>
 #include <ipDeviceCommon/Statistic.h>
+#include <thread-pool.h>
 
-RvlCompression::RvlCompression(int t_width, int t_height, rs2_format t_format, int t_bpp)
-    :ICompression(t_width, t_height, t_format, t_bpp)
-{
-}
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
-int RvlCompression::encodeVLE(int t_value)
+namespace
 {
-    do
-    {
-        int nibble = t_value & 0x7; // lower 3 bits
-        if(t_value >>= 3)
-            nibble |= 0x8; // more to come
-        m_word <<= 4;
-        m_word |= nibble;
-        if(++m_nibblesWritten == 8) // output word
+    class VleWriter
+    {
+    public:
+        VleWriter(int* t_buffer)
+            : m_pBuffer(t_buffer), m_word(0), m_nibblesWritten(0)
         {
-            *m_pBuffer++ = m_word;
+        }
+
+        void encode(int t_value)
+        {
+            do
+            {
+                int nibble = t_value & 0x7; // lower 3 bits
+                if(t_value >>= 3)
+                    nibble |= 0x8; // more to come
+                m_word <<= 4;
+                m_word |= nibble;
+                if(++m_nibblesWritten == 8) // output word
+                {
+                    *m_pBuffer++ = m_word;
+                    m_nibblesWritten = 0;
+                    m_word = 0;
+                }
+            } while(t_value);
+        }
+
+        // Writes the last few values, and returns the end of the words
+        int* flush()
+        {
+            if(m_nibblesWritten)
+                *m_pBuffer++ = m_word << 4 * (8 - m_nibblesWritten);
             m_nibblesWritten = 0;
             m_word = 0;
+            return m_pBuffer;
         }
-    } while(t_value);
 
-    return 0;
-}
+    private:
+        int* m_pBuffer;
+        int m_word, m_nibblesWritten;
+    };
 
-int RvlCompression::decodeVLE()
-{
-    unsigned int nibble;
-    int value = 0, bits = 29;
-    do
+    class VleReader
     {
-        if(!m_nibblesWritten)
+    public:
+        VleReader(const int* t_buffer, const int* t_end)
+            : m_pBuffer(t_buffer), m_pEnd(t_end), m_word(0), m_nibblesLeft(0), m_overrun(false)
+        {
+        }
+
+        int decode()
         {
-            m_word = *m_pBuffer++; // load word
-            m_nibblesWritten = 8;
+            unsigned int nibble;
+            int value = 0, bits = 29;
+            do
+            {
+                if(bits < 0 || (!m_nibblesLeft && m_pBuffer == m_pEnd))
+                {
+                    m_overrun = true;
+                    return 0;
+                }
+                if(!m_nibblesLeft)
+                {
+                    m_word = *m_pBuffer++; // load word
+                    m_nibblesLeft = 8;
+                }
+                nibble = m_word & 0xf0000000;
+                value |= (nibble << 1) >> bits;
+                m_word <<= 4;
+                m_nibblesLeft--;
+                bits -= 3;
+            } while(nibble & 0x80000000);
+            return value;
         }
-        nibble = m_word & 0xf0000000;
-        value |= (nibble << 1) >> bits;
-        m_word <<= 4;
-        m_nibblesWritten--;
-        bits -= 3;
-    } while(nibble & 0x80000000);
-    return value;
+
+        bool overrun() const { return m_overrun; }
+
+    private:
+        const int *m_pBuffer, *m_pEnd;
+        unsigned int m_word;
+        int m_nibblesLeft;
+        bool m_overrun;
+    };
+
+#if defined(__SSSE3__) || defined(__ARM_NEON)
+    inline int countTrailingZeros(uint64_t t_mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, t_mask);
+        return int(index);
+#else
+        return __builtin_ctzll(t_mask);
+#endif
+    }
+#endif
+
+    // The length of the run of zero (or of nonzero) pixels that starts at t_pixels, 8 pixels at a time
+    int countRun(const short* t_pixels, const short* t_end, bool t_zeros)
+    {
+        const short* p = t_pixels;
+#ifdef __SSSE3__
+        const __m128i zero = _mm_setzero_si128();
+        const int inRun = t_zeros ? 0xffff : 0;
+        for(; t_end - p >= 8; p += 8)
+        {
+            // 2 bits per pixel, set for zeros
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)p), zero)) ^ inRun;
+            if(mask)
+                return int(p - t_pixels) + countTrailingZeros(uint64_t(mask)) / 2;
+        }
+#elif defined(__ARM_NEON)
+        const uint64_t inRun = t_zeros ? ~uint64_t(0) : 0;
+        for(; t_end - p >= 8; p += 8)
+        {
+            // 8 bits per pixel, set for zeros
+            uint8x8_t zeros = vmovn_u16(vceqq_s16(vld1q_s16(p), vdupq_n_s16(0)));
+            uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(zeros), 0) ^ inRun;
+            if(mask)
+                return int(p - t_pixels) + countTrailingZeros(mask) / 8;
+        }
+#endif
+        for(; p != t_end && (*p == 0) == t_zeros; p++)
+            ;
+        return int(p - t_pixels);
+    }
+
+    // Returns the number of words written
+    int encodeRvl(const short* t_pixels, int t_count, int* t_words)
+    {
+        VleWriter writer(t_words);
+        const short* end = t_pixels + t_count;
+        short previous = 0;
+        while(t_pixels != end)
+        {
+            int zeros = countRun(t_pixels, end, true);
+            t_pixels += zeros;
+            writer.encode(zeros);
+            int nonzeros = countRun(t_pixels, end, false);
+            writer.encode(nonzeros);
+            for(int i = 0; i < nonzeros; i++)
+            {
+                short current = *t_pixels++;
+                int delta = current - previous;
+                int positive = int(unsigned(delta) << 1) ^ (delta >> 31);
+                writer.encode(positive);
+                previous = current;
+            }
+        }
+        return int(writer.flush() - t_words);
+    }
+
+    // Returns false if the words end before the pixels, or hold more pixels than t_count
+    bool decodeRvl(const int* t_words, int t_wordCount, short* t_pixels, int t_count)
+    {
+        VleReader reader(t_words, t_words + t_wordCount);
+        short current, previous = 0;
+        while(t_count)
+        {
+            int zeros = reader.decode();
+            if(reader.overrun() || zeros > t_count)
+                return false;
+            t_count -= zeros;
+            t_pixels = std::fill_n(t_pixels, zeros, short(0));
+            int nonzeros = reader.decode();
+            if(reader.overrun() || nonzeros > t_count || (!zeros && !nonzeros && t_count))
+                return false;
+            t_count -= nonzeros;
+            for(; nonzeros; nonzeros--)
+            {
+                int positive = reader.decode();
+                int delta = (positive >> 1) ^ -(positive & 1);
+                current = previous + delta;
+                *t_pixels++ = current;
+                previous = current;
+            }
+            if(reader.overrun())
+                return false;
+        }
+        return true;
+    }
+
+    // Runs slice(0) ... slice(t_slices - 1) on the thread pool of the library, shared with the
+    // processing blocks, so no thread is started per frame
+    void forEachSlice(int t_slices, const std::function<void(int)>& t_slice)
+    {
+        librealsense::parallel_for(t_slices, t_slice);
+    }
+
+    // Each slice has the same rows on both sides
+    int sliceFirstRow(int t_slice, int t_slices, int t_height)
+    {
+        return int((long long)t_slice * t_height / t_slices);
+    }
+} // namespace
+
+RvlCompression::RvlCompression(int t_width, int t_height, rs2_format t_format, int t_bpp, int t_slices)
+    :ICompression(t_width, t_height, t_format, t_bpp)
+    , m_slices(t_slices)
+{
+    if(m_slices <= 0)
+        m_slices = std::min(16, std::max(1, int(std::thread::hardware_concurrency())));
+    m_slices = std::max(1, std::min(m_slices, m_height));
 }
 
-int RvlCompression::compressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_compressedBuf)
+int RvlCompression::compressSlices(const short* t_pixels, int t_size, unsigned char* t_compressedBuf)
 {
-    short* buffer2 = (short*)t_buffer;
-    int* pHead = m_pBuffer = (int*)t_compressedBuf + 1;
-    m_nibblesWritten = 0;
-    short* end = buffer2 + t_size / m_bpp;
-    short previous = 0;
-    while(buffer2 != end)
-    {
-        int zeros = 0, nonzeros = 0;
-        for(; (buffer2 != end) && !*buffer2; buffer2++, zeros++)
-            ;
-        encodeVLE(zeros);
-        for(short* p = buffer2; (p != end) && *p++; nonzeros++)
-            ;
-        encodeVLE(nonzeros);
-        for(int i = 0; i < nonzeros; i++)
+    if(int(m_sliceBuffers.size()) != m_slices)
+    {
+        // 8 nibbles, or one word, per pixel at most: the delta takes 6 and the run lengths 2
+        m_sliceBuffers.resize(m_slices);
+        for(int s = 0; s < m_slices; s++)
         {
-            short current = *buffer2++;
-            int delta = current - previous;
-            int positive = (delta << 1) ^ (delta >> 31);
-            encodeVLE(positive);
-            previous = current;
+            int rows = sliceFirstRow(s + 1, m_slices, m_height) - sliceFirstRow(s, m_slices, m_height);
+            m_sliceBuffers[s].resize(rows * m_width + 4);
         }
     }
-    if(m_nibblesWritten) // last few values
-        *m_pBuffer++ = m_word << 4 * (8 - m_nibblesWritten);
-    int compressedSize = int((char*)m_pBuffer - (char*)pHead);
-    int compressWithHeaderSize = compressedSize + sizeof(compressedSize);
+
+    std::vector<int> sliceSizes(m_slices);
+    forEachSlice(m_slices, [&](int s) {
+        int firstRow = sliceFirstRow(s, m_slices, m_height);
+        int rows = sliceFirstRow(s + 1, m_slices, m_height) - firstRow;
+        sliceSizes[s] = encodeRvl(t_pixels + firstRow * m_width, rows * m_width, m_sliceBuffers[s].data()) * sizeof(int);
+    });
+
+    bool sliced = m_slices > 1;
+    int headerSize = sliced ? int(sizeof(int)) * (2 + m_slices) : int(sizeof(int));
+    int compressedSize = 0;
+    for(int size : sliceSizes)
+        compressedSize += size;
+    int compressWithHeaderSize = compressedSize + headerSize;
     if(compressWithHeaderSize > t_size)
     {
         ERR << "Compression overflow, destination buffer is smaller than the compressed size";
         return -1;
     }
-    memcpy(t_compressedBuf, &compressedSize, sizeof(compressedSize));
-    if(m_compFrameCounter++ % 50 == 0)
+
+    int* header = (int*)t_compressedBuf;
+    if(sliced)
     {
-        INF << "frame " << m_compFrameCounter << "\tdepth\tcompression\tlz4\t" << t_size << "\t/\t" << compressedSize;
+        *header++ = int(RVL_SLICED_TAG | RVL_SLICED_VERSION);
+        *header++ = m_slices;
+        for(int size : sliceSizes)
+            *header++ = size;
+    }
+    else
+    {
+        *header++ = compressedSize;
+    }
+
+    unsigned char* data = (unsigned char*)header;
+    for(int s = 0; s < m_slices; s++)
+    {
+        memcpy(data, m_sliceBuffers[s].data(), sliceSizes[s]);
+        data += sliceSizes[s];
     }
-    memcpy(t_compressedBuf, &compressedSize, sizeof(compressedSize));
     return compressWithHeaderSize;
 }
 
-int RvlCompression::decompressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_uncompressedBuf)
+int RvlCompression::compressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_compressedBuf)
+{
+    if(t_size < m_width * m_height * int(sizeof(short)))
+    {
+        ERR << "Compression failed, the frame is smaller than " << m_width << "x" << m_height;
+        return -1;
+    }
+    int compressWithHeaderSize = compressSlices((const short*)t_buffer, t_size, t_compressedBuf);
+    if(compressWithHeaderSize != -1 && m_compFrameCounter++ % 50 == 0)
+    {
+        INF << "frame " << m_compFrameCounter << "\tdepth\tcompression\trvl\t" << t_size << "\t/\t" << compressWithHeaderSize << "\t" << m_slices << " slices";
+    }
+    return compressWithHeaderSize;
+}
+
+int RvlCompression::decompressSlices(unsigned char* t_buffer, int t_size, short* t_pixels)
 {
-    short* currentPtr = (short*)t_uncompressedBuf;
-    m_pBuffer = (int*)t_buffer + 1;
-    m_nibblesWritten = 0;
-    short current, previous = 0;
-    unsigned int compressedSize;
-    int numPixelsToDecode = t_size / 2;
-    while(numPixelsToDecode)
-    {
-        int zeros = decodeVLE();
-        numPixelsToDecode -= zeros;
-        for(; zeros; zeros--)
-            *currentPtr++ = 0;
-        int nonzeros = decodeVLE();
-        numPixelsToDecode -= nonzeros;
-        for(; nonzeros; nonzeros--)
+    const int* header = (const int*)t_buffer;
+    if(t_size < int(sizeof(int)))
+        return -1;
+
+    // Legacy frames are a single slice, with the size of its words
+    int slices = 1;
+    std::vector<int> sliceSizes(1, header[0]);
+    const int* words = header + 1;
+    if((header[0] & ~0xff) == int(RVL_SLICED_TAG))
+    {
+        int version = header[0] & 0xff;
+        if(version > RVL_SLICED_VERSION)
         {
-            int positive = decodeVLE();
-            int delta = (positive >> 1) ^ -(positive & 1);
-            current = previous + delta;
-            *currentPtr++ = current;
-            previous = current;
+            ERR << "RVL frame of version " << version << " is not supported, up to " << RVL_SLICED_VERSION << " is";
+            return -1;
         }
+        if(t_size < int(sizeof(int)) * 2)
+            return -1;
+        slices = header[1];
+        if(slices < 1 || slices > m_height || t_size < int(sizeof(int)) * (2 + slices))
+            return -1;
+        sliceSizes.assign(header + 2, header + 2 + slices);
+        words = header + 2 + slices;
+    }
+
+    std::vector<const int*> sliceWords(slices);
+    long long available = t_size - ((const unsigned char*)words - t_buffer);
+    for(int s = 0; s < slices; s++)
+    {
+        if(sliceSizes[s] < 0 || sliceSizes[s] % sizeof(int) || sliceSizes[s] > available)
+            return -1;
+        sliceWords[s] = words;
+        words += sliceSizes[s] / sizeof(int);
+        available -= sliceSizes[s];
+    }
+
+    std::vector<char> decoded(slices);
+    forEachSlice(slices, [&](int s) {
+        int firstRow = sliceFirstRow(s, slices, m_height);
+        int rows = sliceFirstRow(s + 1, slices, m_height) - firstRow;
+        decoded[s] = decodeRvl(sliceWords[s], sliceSizes[s] / sizeof(int), t_pixels + firstRow * m_width, rows * m_width);
+    });
+    if(std::find(decoded.begin(), decoded.end(), false) != decoded.end())
+        return -1;
+    return m_width * m_height * int(sizeof(short));
+}
+
+int RvlCompression::decompressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_uncompressedBuf)
+{
+    int uncompressedSize = decompressSlices(t_buffer, t_size, (short*)t_uncompressedBuf);
+    if(uncompressedSize == -1)
+    {
+        ERR << "Failure trying to decompress the frame.";
+        return -1;
     }
-    int uncompressedSize = int((char*)currentPtr - (char*)t_uncompressedBuf);
     if(m_decompFrameCounter++ % 50 == 0)
     {
-        INF << "frame " << m_decompFrameCounter << "\tdepth\tcompression\tlz4\t" << compressedSize << "\t/\t" << uncompressedSize;
+        INF << "frame " << m_decompFrameCounter << "\tdepth\tdecompression\trvl\t" << t_size << "\t/\t" << uncompressedSize;
     }
     return uncompressedSize;
 }
@@ -4,16 +4,29 @@
 #pragma once
 
 #include "ICompression.h"
+#include <vector>
+
+// Compressed frames start with one int:
+//   legacy:  the size of the RVL words that follow, which is never negative
+//   sliced:  RVL_SLICED_TAG | version, followed by the number of slices, the size of each slice,
+//            and the slices themselves. Each slice is a band of rows coded on its own (the delta
+//            of its first pixel is taken from 0), so slices are coded and decoded in parallel.
+// Frames of both kinds are decoded, so clients keep working with servers that send legacy frames.
+#define RVL_SLICED_TAG 0xA5C56C00
+#define RVL_SLICED_VERSION 1
 
 class RvlCompression : public ICompression
 {
 public:
-    RvlCompression(int t_width, int t_height, rs2_format t_format, int t_bpp);
+    // t_slices: 1 for legacy frames, 0 for a slice per core
+    RvlCompression(int t_width, int t_height, rs2_format t_format, int t_bpp, int t_slices = 0);
     int compressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_compressedBuf);
     int decompressBuffer(unsigned char* t_buffer, int t_size, unsigned char* t_uncompressedBuf);
 
 private:
-    int encodeVLE(int value);
-    int decodeVLE();
-    int *m_pBuffer, m_word, m_nibblesWritten;
+    int compressSlices(const short* t_pixels, int t_size, unsigned char* t_compressedBuf);
+    int decompressSlices(unsigned char* t_buffer, int t_size, short* t_pixels);
+
+    int m_slices;
+    std::vector<std::vector<int>> m_sliceBuffers; // Worst case sized, one per slice
 };
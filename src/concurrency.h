@@ -9,9 +9,134 @@
 #include <atomic>
 #include <functional>
 #include <cassert>
+#include <memory>
+#include <type_traits>
+#include <algorithm>
 
 const int QUEUE_MAX_SIZE = 10;
+
+// How a queue passes items from its producers to its consumer
+enum class queue_type
+{
+    locked,     // std::deque guarded by a mutex; waiting is done on condition variables
+    lock_free   // bounded ring buffer; waiting busy-polls for a while before parking
+};
+
+// Bounded lock-free ring buffer (D. Vyukov's sequenced-cell scheme): every cell carries a sequence
+// number telling whether it is ready to be written or read at a given position, so any number of
+// threads can push and pop concurrently without locks.
+// Storage for all the cells is allocated up front, and T need not be default-constructible.
+template<class T>
+class ring_buffer
+{
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage;
+
+        T * item() { return reinterpret_cast<T *>(&storage); }
+    };
+
+    size_t const _size;
+    std::unique_ptr<cell[]> _cells;
+    // Keep the producer and consumer positions on separate cache lines
+    char _pad0[64];
+    std::atomic<size_t> _enqueue_pos;
+    char _pad1[64];
+    std::atomic<size_t> _dequeue_pos;
+    char _pad2[64];
+
+public:
+    explicit ring_buffer(size_t size)
+        : _size(size ? size : 1), _cells(new cell[_size]), _enqueue_pos(0), _dequeue_pos(0)
+    {
+        for (size_t i = 0; i < _size; ++i)
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~ring_buffer()
+    {
+        while (try_pop([](T&&) {}));
+    }
+
+    // Moves the item in and returns true, or leaves it untouched and returns false if full
+    bool try_push(T& item)
+    {
+        auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+        cell * c;
+        for (;;)
+        {
+            c = &_cells[pos % _size];
+            auto seq = c->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0)
+            {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+        new (c->item()) T(std::move(item));
+        c->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Hands the oldest item to consume(T&&) and returns true, or returns false if empty
+    template<class F>
+    bool try_pop(F consume)
+    {
+        auto pos = _dequeue_pos.load(std::memory_order_relaxed);
+        cell * c;
+        for (;;)
+        {
+            c = &_cells[pos % _size];
+            auto seq = c->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0)
+            {
+                if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+        }
+        {
+            T item(std::move(*c->item()));
+            c->item()->~T();
+            c->sequence.store(pos + _size, std::memory_order_release);
+            consume(std::move(item));
+        }
+        return true;
+    }
+
+    // True if the next pop would find a fully written item
+    bool readable() const
+    {
+        auto pos = _dequeue_pos.load(std::memory_order_acquire);
+        return _cells[pos % _size].sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    // Approximate while pushes or pops are in progress
+    size_t size() const
+    {
+        auto deq = _dequeue_pos.load(std::memory_order_acquire);
+        auto enq = _enqueue_pos.load(std::memory_order_acquire);
+        return enq > deq ? std::min(enq - deq, _size) : 0;
+    }
+};
+
 // Simplest implementation of a blocking concurrent queue for thread messaging
+//
+// The queue_type selects how items are handed over. With queue_type::lock_free, enqueue and dequeue
+// never take a lock as long as neither side has to wait; a consumer waiting for an item (or a
+// producer waiting for room) first re-checks the ring spin_count times, and only then parks on a
+// condition variable. Producers take the mutex only when somebody is parked. peek() is not available
+// in this mode, since producers may drop the oldest item at any time.
 template<class T>
 class single_consumer_queue
 {
@@ -21,16 +146,28 @@ class single_consumer_queue
     std::condition_variable _enq_cv; // not full signal
 
     unsigned int const _cap;
-    bool _accepting;
+    std::atomic<bool> _accepting;
 
     std::function<void(T const &)> const _on_drop_callback;
 
+    // Only used with queue_type::lock_free
+    std::unique_ptr<ring_buffer<T>> _ring;
+    unsigned int const _spin_count;
+    std::atomic<int> _deq_waiters;
+    std::atomic<int> _enq_waiters;
+
 public:
     explicit single_consumer_queue< T >( unsigned int cap = QUEUE_MAX_SIZE,
-                                         std::function< void( T const & ) > on_drop_callback = nullptr )
+                                         std::function< void( T const & ) > on_drop_callback = nullptr,
+                                         queue_type type = queue_type::locked,
+                                         unsigned int spin_count = 0 )
         : _cap( cap )
         , _accepting( true )
         , _on_drop_callback( on_drop_callback )
+        , _ring( type == queue_type::lock_free ? new ring_buffer< T >( cap ) : nullptr )
+        , _spin_count( spin_count )
+        , _deq_waiters( 0 )
+        , _enq_waiters( 0 )
     {
     }
 
@@ -38,6 +175,12 @@ public:
     // If the queue grows beyond capacity, the front will be removed, losing whatever was there!
     void enqueue(T&& item)
     {
+        if( _ring )
+        {
+            _ring_enqueue( item );
+            return;
+        }
+
         std::unique_lock<std::mutex> lock(_mutex);
         if( ! _accepting )
         {
@@ -66,6 +209,9 @@ public:
     // Returns true if the enqueue succeeded
     bool blocking_enqueue(T&& item)
     {
+        if( _ring )
+            return _ring_blocking_enqueue( item );
+
         std::unique_lock<std::mutex> lock(_mutex);
         _enq_cv.wait( lock, [this]() {
             return _queue.size() < _cap; } );
@@ -91,6 +237,9 @@ public:
     // Return true if an item was removed -- otherwise, false
     bool dequeue( T * item, unsigned int timeout_ms )
     {
+        if( _ring )
+            return _ring_dequeue( item, timeout_ms );
+
         std::unique_lock<std::mutex> lock(_mutex);
         if( ! _deq_cv.wait_for( lock,
                                 std::chrono::milliseconds( timeout_ms ),
@@ -113,6 +262,9 @@ public:
     // Return true if an item was removed -- otherwise, false
     bool try_dequeue(T* item)
     {
+        if( _ring )
+            return _ring_try_dequeue( item );
+
         std::lock_guard< std::mutex > lock( _mutex );
         if( _queue.empty() )
             return false;
@@ -128,6 +280,10 @@ public:
 
     bool peek(T** item)
     {
+        assert( ! _ring );
+        if( _ring )
+            return false;
+
         std::lock_guard< std::mutex > lock( _mutex );
 
         if (_queue.empty())
@@ -157,6 +313,8 @@ protected:
     void _clear()
     {
         _queue.clear();
+        if( _ring )
+            while( _ring->try_pop( []( T && ) {} ) );
 
         // Wake up anyone who is waiting for room to enqueue, or waiting for something to dequeue -- there's nothing now
         _enq_cv.notify_all();
@@ -175,11 +333,126 @@ public:
 
     size_t size() const
     {
+        if( _ring )
+            return _ring->size();
+
         std::lock_guard< std::mutex > lock( _mutex );
         return _queue.size();
     }
 
     bool empty() const { return ! size(); }
+
+private:
+    void _drop( T && item )
+    {
+        if( _on_drop_callback )
+            _on_drop_callback( item );
+    }
+
+    // Wake whoever is parked on cv, if anyone
+    void _wake( std::atomic< int > & waiters, std::condition_variable & cv )
+    {
+        // Pairs with the fence in _park(): either we see the waiter, or it sees our update
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if( waiters.load( std::memory_order_relaxed ) )
+        {
+            // Taking the lock guarantees the waiter is either before its check or inside wait
+            { std::lock_guard< std::mutex > lock( _mutex ); }
+            cv.notify_all();
+        }
+    }
+
+    // Busy-poll for ready() up to _spin_count times, then sleep on cv until it holds or the timeout
+    // expires. Returns the last value of ready().
+    template< class Duration, class Pred >
+    bool _park( std::atomic< int > & waiters, std::condition_variable & cv, Duration timeout, Pred ready )
+    {
+        for( unsigned int i = 0; i < _spin_count; ++i )
+            if( ready() )
+                return true;
+
+        std::unique_lock< std::mutex > lock( _mutex );
+        waiters.fetch_add( 1 );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        auto result = cv.wait_for( lock, timeout, ready );
+        waiters.fetch_sub( 1 );
+        return result;
+    }
+
+    void _ring_enqueue( T & item )
+    {
+        if( ! _accepting )
+        {
+            _drop( std::move( item ) );
+            return;
+        }
+
+        // Make room by dropping the oldest item, exactly like the locked queue does
+        while( ! _ring->try_push( item ) )
+            _ring->try_pop( [this]( T && oldest ) { _drop( std::move( oldest ) ); } );
+
+        // A stop() that raced with us would have missed this item
+        if( ! _accepting )
+            _ring_stop_race();
+
+        _wake( _deq_waiters, _deq_cv );
+    }
+
+    bool _ring_blocking_enqueue( T & item )
+    {
+        while( _accepting )
+        {
+            if( _ring->try_push( item ) )
+            {
+                if( ! _accepting )
+                    _ring_stop_race();
+                _wake( _deq_waiters, _deq_cv );
+                return true;
+            }
+            _park( _enq_waiters, _enq_cv, std::chrono::milliseconds( 100 ), [this]() {
+                return ! _accepting || _ring->size() < _cap;
+            } );
+        }
+
+        // We shouldn't be adding anything to the queue when we're stopping
+        _drop( std::move( item ) );
+        return false;
+    }
+
+    bool _ring_dequeue( T * item, unsigned int timeout_ms )
+    {
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( timeout_ms );
+        for( ;; )
+        {
+            if( _ring_try_dequeue( item ) )
+                return true;
+
+            auto const now = std::chrono::steady_clock::now();
+            if( ! _accepting || now >= deadline )
+                return false;
+
+            _park( _deq_waiters, _deq_cv, deadline - now, [this]() {
+                return ! _accepting || _ring->readable();
+            } );
+        }
+    }
+
+    bool _ring_try_dequeue( T * item )
+    {
+        if( ! _ring->try_pop( [item]( T && next ) { *item = std::move( next ); } ) )
+            return false;
+
+        // We've made room -- let whoever is waiting for room know about it
+        _wake( _enq_waiters, _enq_cv );
+        return true;
+    }
+
+    void _ring_stop_race()
+    {
+        std::lock_guard< std::mutex > lock( _mutex );
+        if( ! _accepting )
+            _clear();
+    }
 };
 
 template<class T>
@@ -188,7 +461,10 @@ class single_consumer_frame_queue
     single_consumer_queue<T> _queue;
 
 public:
-    single_consumer_frame_queue<T>(unsigned int cap = QUEUE_MAX_SIZE) : _queue(cap) {}
+    single_consumer_frame_queue<T>(unsigned int cap = QUEUE_MAX_SIZE,
+                                   queue_type type = queue_type::locked,
+                                   unsigned int spin_count = 0)
+        : _queue(cap, nullptr, type, spin_count) {}
 
     void enqueue(T&& item)
     {
@@ -290,8 +566,12 @@ public:
     // and we're non-blocking. The on_drop_callback allows caputring of these instances, if we
     // want...
     //
+    // See single_consumer_queue for the queue type and spin count.
+    //
     dispatcher( unsigned int queue_capacity,
-                std::function< void( action ) > on_drop_callback = nullptr );
+                std::function< void( action ) > on_drop_callback = nullptr,
+                queue_type type = queue_type::locked,
+                unsigned int spin_count = 0 );
 
     ~dispatcher();
 
@@ -272,8 +272,7 @@ namespace librealsense
             register_info(RS2_CAMERA_INFO_PRODUCT_ID, pid_str);
 
             color_ep->register_processing_block(processing_block_factory::create_pbf_vector<yuy2_converter>(RS2_FORMAT_YUYV, map_supported_color_formats(RS2_FORMAT_YUYV), RS2_STREAM_COLOR));
-            color_ep->register_processing_block({ {RS2_FORMAT_MJPEG} }, { {RS2_FORMAT_RGB8, RS2_STREAM_COLOR} }, []() { return std::make_shared<mjpeg_converter>(RS2_FORMAT_RGB8); });
-            color_ep->register_processing_block(processing_block_factory::create_id_pbf(RS2_FORMAT_MJPEG, RS2_STREAM_COLOR));
+            color_ep->register_processing_block(processing_block_factory::create_pbf_vector<mjpeg_converter>(RS2_FORMAT_MJPEG, map_supported_color_formats(RS2_FORMAT_MJPEG), RS2_STREAM_COLOR));
 
             // Timestamps are given in units set by device which may vary among the OEM vendors.
             // For consistent (msec) measurements use "time of arrival" metadata attribute
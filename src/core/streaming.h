@@ -6,6 +6,8 @@
 #include "../types.h"
 #include "info.h"
 #include <functional>
+#include <array>
+#include <bitset>
 
 namespace librealsense
 {
@@ -79,11 +81,19 @@ namespace librealsense
         virtual void set_c_wrapper(rs2_stream_profile* wrapper) = 0;
     };
 
+    // All the metadata of a frame, by rs2_frame_metadata_value; the values not supported are 0
+    struct frame_metadata_values
+    {
+        std::array<rs2_metadata_type, ::RS2_FRAME_METADATA_COUNT> values;
+        std::bitset<::RS2_FRAME_METADATA_COUNT> supported;
+    };
+
     class frame_interface : public sensor_part
     {
     public:
         virtual rs2_metadata_type get_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const = 0;
         virtual bool supports_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const = 0;
+        virtual void get_all_frame_metadata(frame_metadata_values& metadata) const = 0;
         virtual int get_frame_data_size() const = 0;
         virtual const byte* get_frame_data() const = 0;
         virtual rs2_time_t get_frame_timestamp() const = 0;
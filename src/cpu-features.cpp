@@ -0,0 +1,79 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "cpu-features.h"
+
+#include <atomic>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace librealsense
+{
+    static bool detect_avx2()
+    {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        // Checks the OS support (XGETBV) as well
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        __cpuid(info, 1);
+        bool const osxsave = (info[2] & (1 << 27)) != 0;
+        bool const avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)   // XMM and YMM state
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    bool cpu_has_avx2()
+    {
+        static const bool avx2 = detect_avx2();
+        return avx2;
+    }
+
+    static simd_level detect_simd_level()
+    {
+#if defined(__SSSE3__)
+#ifndef ANDROID
+        // The AVX2 unpackers of image-avx.cpp are not built for Android
+        if (cpu_has_avx2())
+            return simd_level::avx2;
+#endif
+        return simd_level::ssse3;
+#elif defined(__ARM_NEON)
+        return simd_level::neon;
+#else
+        return simd_level::scalar;
+#endif
+    }
+
+    static std::atomic<int> simd_limit(static_cast<int>(simd_level::avx2));
+
+    simd_level cpu_simd_level()
+    {
+        static const simd_level detected = detect_simd_level();
+        auto limit = static_cast<simd_level>(simd_limit.load(std::memory_order_relaxed));
+        if (limit == simd_level::scalar)
+            return simd_level::scalar;
+        if (limit == simd_level::ssse3 && detected == simd_level::avx2)
+            return simd_level::ssse3;
+        return detected;
+    }
+
+    simd_level set_simd_limit(simd_level limit)
+    {
+        return static_cast<simd_level>(simd_limit.exchange(static_cast<int>(limit)));
+    }
+}
@@ -0,0 +1,27 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+namespace librealsense
+{
+    // Whether the CPU the library runs on (rather than the one it was built for) supports AVX2,
+    // and the OS saves the AVX registers. Always false on other architectures.
+    bool cpu_has_avx2();
+
+    // The instruction sets of the vectorized code paths
+    enum class simd_level
+    {
+        scalar,
+        ssse3,  // The baseline of the x86 builds
+        avx2,   // Detected at runtime, see cpu_has_avx2()
+        neon    // The baseline of the ARM builds
+    };
+
+    // The best code path this build can run on this CPU, capped by set_simd_limit()
+    simd_level cpu_simd_level();
+
+    // Caps cpu_simd_level() at limit (scalar, ssse3, or avx2 / neon for no cap), so that tests
+    // and benchmarks can run the slower paths. Returns the previous cap.
+    simd_level set_simd_limit(simd_level limit);
+}
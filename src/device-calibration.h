@@ -14,6 +14,7 @@ namespace librealsense
     {
     public:
         virtual void register_calibration_change_callback(calibration_change_callback_ptr) = 0;
+        virtual void unregister_calibration_change_callback(calibration_change_callback_ptr) = 0;
     };
     MAP_EXTENSION(RS2_EXTENSION_CALIBRATION_CHANGE_DEVICE, calibration_change_device);
 
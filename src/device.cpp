@@ -120,7 +120,7 @@ std::shared_ptr<matcher> matcher_factory::create_frame_number_composite_matcher(
 }
 std::shared_ptr<matcher> matcher_factory::create_timestamp_composite_matcher(std::vector<std::shared_ptr<matcher>> matchers)
 {
-    return std::make_shared<timestamp_composite_matcher>(matchers);
+    return std::make_shared<timestamp_indexed_matcher>(matchers);
 }
 
 device::device(std::shared_ptr<context> ctx,
@@ -274,6 +274,15 @@ std::vector<rs2_format> device::map_supported_color_formats(rs2_format source_fo
     case RS2_FORMAT_UYVY:
         target_formats.push_back(RS2_FORMAT_UYVY);
         break;
+    case RS2_FORMAT_MJPEG:
+#ifdef RS2_USE_LIBJPEG_TURBO
+        target_formats.push_back(RS2_FORMAT_Y8);
+#else
+        // stb_image decodes to RGB only
+        target_formats = { RS2_FORMAT_RGB8 };
+#endif
+        target_formats.push_back(RS2_FORMAT_MJPEG);
+        break;
     default:
         LOG_ERROR("Format is not supported for mapping");
     }
@@ -6,8 +6,11 @@
 #include "../common/utilities/time/waiting-on.h"
 
 
-dispatcher::dispatcher( unsigned int cap, std::function< void( action ) > on_drop_callback )
-    : _queue( cap, on_drop_callback )
+dispatcher::dispatcher( unsigned int cap,
+                        std::function< void( action ) > on_drop_callback,
+                        queue_type type,
+                        unsigned int spin_count )
+    : _queue( cap, on_drop_callback, type, spin_count )
     , _was_stopped( true )
     , _is_alive( true )
 {
@@ -236,6 +236,19 @@ namespace librealsense
             [&, mm_correct_opt]() { return std::make_shared<gyroscope_transform>(_mm_calib, mm_correct_opt);
         });
 
+        // The samples of each read in one frame, when the app asks for them
+        hid_ep->register_processing_block(
+            { {RS2_FORMAT_MOTION_BATCH, RS2_STREAM_ACCEL} },
+            { {RS2_FORMAT_MOTION_BATCH, RS2_STREAM_ACCEL} },
+            [&, mm_correct_opt]() { return std::make_shared<acceleration_transform>(_mm_calib, mm_correct_opt, RS2_FORMAT_MOTION_BATCH);
+        });
+
+        hid_ep->register_processing_block(
+            { {RS2_FORMAT_MOTION_BATCH, RS2_STREAM_GYRO} },
+            { {RS2_FORMAT_MOTION_BATCH, RS2_STREAM_GYRO} },
+            [&, mm_correct_opt]() { return std::make_shared<gyroscope_transform>(_mm_calib, mm_correct_opt, RS2_FORMAT_MOTION_BATCH);
+        });
+
         if ((camera_fw_version >= firmware_version(custom_sensor_fw_ver)) &&
                 (!val_in_range(_pid, { ds::RS400_IMU_PID, ds::RS435I_PID, ds::RS430I_PID, ds::RS465_PID, ds::RS405_PID, ds::RS455_PID })))
         {
@@ -507,6 +520,12 @@ namespace librealsense
        return _hw_monitor->send(cmd);
     }
 
+    mm_calib_handler::mm_calib_handler(std::shared_ptr<mm_calib_parser> calib_parser) :
+        _pid(0)
+    {
+        _calib_parser = [calib_parser]() { return calib_parser; };
+    }
+
     ds::imu_intrinsic mm_calib_handler::get_intrinsic(rs2_stream stream)
     {
         return (*_calib_parser)->get_intrinsic(stream);
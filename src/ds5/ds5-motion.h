@@ -379,6 +379,8 @@ namespace librealsense
     {
     public:
         mm_calib_handler(std::shared_ptr<hw_monitor> hw_monitor, uint16_t pid);
+        // With a calibration that does not come from a device, e.g. in tests
+        explicit mm_calib_handler(std::shared_ptr<mm_calib_parser> calib_parser);
         ~mm_calib_handler() {}
 
         ds::imu_intrinsic get_intrinsic(rs2_stream);
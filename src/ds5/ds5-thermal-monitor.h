@@ -51,20 +51,31 @@ namespace librealsense
             if (auto mon = _monitor.lock())
                 mon->add_observer([&](float)
                 {
-                    for (auto && cb : _user_callbacks)
+                    std::set<calibration_change_callback_ptr> callbacks;
+                    {
+                        std::lock_guard<std::mutex> lock(_callbacks_mutex);
+                        callbacks = _user_callbacks;
+                    }
+                    for (auto && cb : callbacks)
                         cb->on_calibration_change(rs2_calibration_status::RS2_CALIBRATION_SUCCESSFUL);
                 });
         }
 
         void register_calibration_change_callback(calibration_change_callback_ptr callback) override
         {
-            {
-                _user_callbacks.insert(callback);
-            }
+            std::lock_guard<std::mutex> lock(_callbacks_mutex);
+            _user_callbacks.insert(callback);
+        }
+
+        void unregister_calibration_change_callback(calibration_change_callback_ptr callback) override
+        {
+            std::lock_guard<std::mutex> lock(_callbacks_mutex);
+            _user_callbacks.erase(callback);
         }
 
     private:
         std::weak_ptr<ds5_thermal_monitor>  _monitor;
+        std::mutex _callbacks_mutex;
         std::set<calibration_change_callback_ptr> _user_callbacks;
     };
 
@@ -3,6 +3,8 @@
 
 #include "environment.h"
 
+#include <algorithm>
+
 namespace librealsense
 {
     extrinsics_graph::extrinsics_graph()
@@ -252,4 +254,40 @@ namespace librealsense
     {
         return _ts;
     }
+
+    void environment::set_frame_allocator(frame_allocator_ptr allocator)
+    {
+        std::atomic_store(&_frame_allocator, allocator);
+    }
+
+    frame_allocator_ptr environment::get_frame_allocator() const
+    {
+        return std::atomic_load(&_frame_allocator);
+    }
+
+    void environment::set_processing_threads(int threads, bool pinned)
+    {
+        if (threads <= 0)
+            threads = std::max(1, int(std::thread::hardware_concurrency()));
+
+        // Calls in progress keep the pool they started on
+        std::lock_guard<std::mutex> lock(_thread_pool_mutex);
+        std::atomic_store(&_thread_pool, std::make_shared<thread_pool>(threads, pinned));
+    }
+
+    std::shared_ptr<thread_pool> environment::get_thread_pool()
+    {
+        auto pool = std::atomic_load(&_thread_pool);
+        if (pool)
+            return pool;
+
+        std::lock_guard<std::mutex> lock(_thread_pool_mutex);
+        pool = std::atomic_load(&_thread_pool);
+        if (!pool)
+        {
+            pool = std::make_shared<thread_pool>(std::max(1, int(std::thread::hardware_concurrency())), false);
+            std::atomic_store(&_thread_pool, pool);
+        }
+        return pool;
+    }
 }
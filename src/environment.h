@@ -4,6 +4,7 @@
 #pragma once
 #include "core/streaming.h"
 #include "types.h"
+#include "thread-pool.h"
 #include <memory>
 #include <mutex>
 
@@ -101,6 +102,14 @@ namespace librealsense
         void set_time_service(std::shared_ptr<platform::time_service> ts);
         std::shared_ptr<platform::time_service> get_time_service();
 
+        // User provided memory for frame buffers, null for the default heap
+        void set_frame_allocator(frame_allocator_ptr allocator);
+        frame_allocator_ptr get_frame_allocator() const;
+
+        // The threads of the CPU processing blocks; 0 threads for one per core
+        void set_processing_threads(int threads, bool pinned);
+        std::shared_ptr<thread_pool> get_thread_pool();
+
         environment(const environment&) = delete;
         environment(const environment&&) = delete;
         environment operator=(const environment&) = delete;
@@ -110,6 +119,9 @@ namespace librealsense
         extrinsics_graph _extrinsics;
         std::atomic<int> _stream_id;
         std::shared_ptr<platform::time_service> _ts;
+        frame_allocator_ptr _frame_allocator;
+        std::shared_ptr<thread_pool> _thread_pool;
+        std::mutex _thread_pool_mutex;
 
         environment(){_stream_id = 0;}
 
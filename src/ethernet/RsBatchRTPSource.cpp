@@ -0,0 +1,181 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2020 Intel Corporation. All Rights Reserved.
+
+#include "RsBatchRTPSource.hh"
+#include "GroupsockHelper.hh"
+
+#include <cstring>
+
+RsBatchRTPSource* RsBatchRTPSource::createNew(UsageEnvironment& t_env, Groupsock* t_RTPgs, unsigned char t_rtpPayloadFormat, unsigned t_rtpTimestampFrequency)
+{
+    return new RsBatchRTPSource(t_env, t_RTPgs, t_rtpPayloadFormat, t_rtpTimestampFrequency);
+}
+
+RsBatchRTPSource::RsBatchRTPSource(UsageEnvironment& t_env, Groupsock* t_RTPgs, unsigned char t_rtpPayloadFormat, unsigned t_rtpTimestampFrequency)
+    : RTPSource(t_env, t_RTPgs, t_rtpPayloadFormat, t_rtpTimestampFrequency)
+    , m_packetsRead(0)
+    , m_nextPacket(0)
+    , m_nextSeqNum(0)
+    , m_lastWasMarker(false)
+    , m_isReading(false)
+{
+    resetFrame();
+}
+
+RsBatchRTPSource::~RsBatchRTPSource()
+{
+    doStopGettingFrames();
+}
+
+void RsBatchRTPSource::resetFrame()
+{
+    m_frameSize = 0;
+    m_frameTimestamp = 0;
+    m_frameStarted = false;
+    m_frameCorrupt = false;
+}
+
+void RsBatchRTPSource::doGetNextFrame()
+{
+    fFrameSize = 0;
+    fNumTruncatedBytes = 0;
+
+    // The packets left from the last read may hold a whole frame
+    if(assembleFrame())
+    {
+        nextTask() = envir().taskScheduler().scheduleDelayedTask(0, (TaskFunc*)FramedSource::afterGetting, this);
+        return;
+    }
+    if(!m_isReading)
+    {
+        fRTPInterface.startNetworkReading((TaskScheduler::BackgroundHandlerProc*)&networkReadHandler);
+        m_isReading = true;
+    }
+}
+
+void RsBatchRTPSource::doStopGettingFrames()
+{
+    if(m_isReading)
+    {
+        fRTPInterface.stopNetworkReading();
+        m_isReading = false;
+    }
+    envir().taskScheduler().unscheduleDelayedTask(nextTask());
+    resetFrame();
+    m_lastWasMarker = false;
+}
+
+void RsBatchRTPSource::networkReadHandler(RsBatchRTPSource* t_source, int /*t_mask*/)
+{
+    t_source->networkReadHandler1();
+}
+
+void RsBatchRTPSource::networkReadHandler1()
+{
+    while(m_nextPacket < m_packetsRead || readPackets())
+    {
+        if(assembleFrame())
+        {
+            // Reading resumes with the next frame requested
+            fRTPInterface.stopNetworkReading();
+            m_isReading = false;
+            FramedSource::afterGetting(this);
+            return;
+        }
+    }
+}
+
+bool RsBatchRTPSource::readPackets()
+{
+    m_packetsRead = m_nextPacket = 0;
+#ifdef __linux__
+    m_packetsRead = m_receiver.receive(fRTPInterface.gs()->socketNum());
+    return m_packetsRead > 0;
+#else
+    return false;
+#endif
+}
+
+bool RsBatchRTPSource::assembleFrame()
+{
+#ifdef __linux__
+    while(m_nextPacket < m_packetsRead)
+    {
+        unsigned char* packet = m_receiver.packet(m_nextPacket);
+        unsigned size = m_receiver.size(m_nextPacket);
+        bool truncated = m_receiver.truncated(m_nextPacket);
+        m_nextPacket++;
+
+        // RTP version 2, with our payload format
+        if(size < 12 || truncated || (packet[0] >> 6) != 2 || (packet[1] & 0x7f) != rtpPayloadFormat())
+        {
+            continue;
+        }
+        unsigned headerSize = 12 + 4 * (packet[0] & 0x0f);
+        if(packet[0] & 0x10) // Header extension
+        {
+            if(size < headerSize + 4)
+                continue;
+            headerSize += 4 + 4 * ((packet[headerSize + 2] << 8) | packet[headerSize + 3]);
+        }
+        unsigned padding = (packet[0] & 0x20) ? packet[size - 1] : 0;
+        if(size < headerSize + padding)
+        {
+            continue;
+        }
+
+        bool marker = (packet[1] & 0x80) != 0;
+        u_int16_t seqNum = u_int16_t((packet[2] << 8) | packet[3]);
+        u_int32_t timestamp = (u_int32_t(packet[4]) << 24) | (packet[5] << 16) | (packet[6] << 8) | packet[7];
+        u_int32_t ssrc = (u_int32_t(packet[8]) << 24) | (packet[9] << 16) | (packet[10] << 8) | packet[11];
+        unsigned payloadSize = size - headerSize - padding;
+
+        fLastReceivedSSRC = ssrc;
+        fCurPacketRTPSeqNum = seqNum;
+        fCurPacketRTPTimestamp = timestamp;
+        fCurPacketMarkerBit = marker;
+        receptionStatsDB().noteIncomingPacket(ssrc, seqNum, timestamp, timestampFrequency(), True, fPresentationTime, fCurPacketHasBeenSynchronizedUsingRTCP, payloadSize);
+
+        if(!m_frameStarted || timestamp != m_frameTimestamp)
+        {
+            // A frame starts right after the marker of the one before it
+            m_frameCorrupt = !m_lastWasMarker || seqNum != m_nextSeqNum;
+            m_frameStarted = true;
+            m_frameTimestamp = timestamp;
+            m_frameSize = 0;
+            fNumTruncatedBytes = 0;
+        }
+        else if(seqNum != m_nextSeqNum)
+        {
+            m_frameCorrupt = true;
+        }
+        m_nextSeqNum = u_int16_t(seqNum + 1);
+        m_lastWasMarker = marker;
+
+        if(!m_frameCorrupt)
+        {
+            unsigned toCopy = payloadSize;
+            if(m_frameSize + toCopy > fMaxSize)
+            {
+                toCopy = m_frameSize < fMaxSize ? fMaxSize - m_frameSize : 0;
+                fNumTruncatedBytes += payloadSize - toCopy;
+            }
+            memcpy(fTo + m_frameSize, packet + headerSize, toCopy);
+            m_frameSize += toCopy;
+        }
+
+        if(marker)
+        {
+            bool complete = !m_frameCorrupt;
+            fFrameSize = m_frameSize;
+            fDurationInMicroseconds = 0;
+            resetFrame();
+            if(complete)
+            {
+                return true;
+            }
+        }
+    }
+#endif
+    return false;
+}
@@ -0,0 +1,47 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2020 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "liveMedia.hh"
+
+#include "RsBatchSocket.h"
+
+// Receives the frames of rs-server, which are split into RTP packets and end with the marker bit,
+// reading the packets that are waiting on the socket together (see RsBatchReceiver). Frames that lose a packet, or get one out of order, are dropped, as no reordering
+// is done. Linux only, SimpleRTPSource is used elsewhere.
+class RsBatchRTPSource : public RTPSource
+{
+public:
+    static RsBatchRTPSource* createNew(UsageEnvironment& t_env, Groupsock* t_RTPgs, unsigned char t_rtpPayloadFormat, unsigned t_rtpTimestampFrequency);
+
+    virtual void setPacketReorderingThresholdTime(unsigned /*t_uSeconds*/) {}
+
+protected:
+    RsBatchRTPSource(UsageEnvironment& t_env, Groupsock* t_RTPgs, unsigned char t_rtpPayloadFormat, unsigned t_rtpTimestampFrequency);
+    virtual ~RsBatchRTPSource();
+
+private:
+    virtual void doGetNextFrame();
+    virtual void doStopGettingFrames();
+
+    static void networkReadHandler(RsBatchRTPSource* t_source, int t_mask);
+    void networkReadHandler1();
+
+    // Reads the packets waiting on the socket, returns false if there are none
+    bool readPackets();
+    // Adds the packets read to the frame, returns true once the frame is complete
+    bool assembleFrame();
+    void resetFrame();
+
+#ifdef __linux__
+    RsBatchReceiver m_receiver;
+#endif
+    int m_packetsRead, m_nextPacket;
+
+    unsigned m_frameSize;
+    u_int32_t m_frameTimestamp;
+    u_int16_t m_nextSeqNum;
+    bool m_frameStarted, m_frameCorrupt, m_lastWasMarker;
+    bool m_isReading;
+};
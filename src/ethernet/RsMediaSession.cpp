@@ -5,6 +5,7 @@
 #include "Locale.hh"
 #include "liveMedia.hh"
 
+#include "RsBatchRTPSource.hh"
 #include "RsCommon.h"
 #include "RsMediaSession.hh"
 
@@ -68,6 +69,7 @@ void RsMediaSubsessionIterator::reset()
 
 RsMediaSubsession::RsMediaSubsession(RsMediaSession& parent)
     : MediaSubsession(parent)
+    , m_depthMethod(ZipMethod::lz)
 {}
 
 RsMediaSubsession::~RsMediaSubsession()
@@ -83,8 +85,19 @@ Boolean RsMediaSubsession::createSourceObjects(int useSpecialRTPoffset)
     if(strcmp(fCodecName, RS_PAYLOAD_FORMAT.c_str()) == 0)
     {
         // This subsession uses our custom RTP payload format:
+#ifdef __linux__
+        // Reads all the packets waiting on the socket at once
+        fReadSource = fRTPSource = RsBatchRTPSource::createNew(env(), fRTPSocket, fRTPPayloadFormat, fRTPTimestampFrequency);
+        if(rtpSource() != NULL)
+        {
+            // Room for the packets of a few frames, while the frames before them are handled
+            int socketNum = rtpSource()->RTPgs()->socketNum();
+            setReceiveBufferTo(env(), socketNum, 1024 * 1024 * 8);
+        }
+#else
         std::string mimeTypeString = RS_MEDIA_TYPE + "/" + RS_PAYLOAD_FORMAT;
         fReadSource = fRTPSource = SimpleRTPSource::createNew(env(), fRTPSocket, fRTPPayloadFormat, fRTPTimestampFrequency, mimeTypeString.c_str());
+#endif
 
 #if defined(_WIN32)
         if(rtpSource() != NULL)
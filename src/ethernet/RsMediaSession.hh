@@ -5,6 +5,8 @@
 
 #include "MediaSession.hh"
 
+#include <compression/CompressionFactory.h>
+
 class RsMediaSubsession; // forward
 
 class RsMediaSession : public MediaSession
@@ -38,6 +40,17 @@ private:
 
 class RsMediaSubsession : public MediaSubsession
 {
+public:
+    // How the server compresses this stream if it is depth, from the depth_compression SDP field
+    ZipMethod getDepthMethod() const
+    {
+        return m_depthMethod;
+    }
+    void setDepthMethod(ZipMethod t_depthMethod)
+    {
+        m_depthMethod = t_depthMethod;
+    }
+
 protected:
     friend class RsMediaSession;
     friend class RsMediaSubsessionIterator;
@@ -45,4 +58,7 @@ protected:
     virtual ~RsMediaSubsession();
     virtual Boolean createSourceObjects(int useSpecialRTPoffset);
     // create "fRTPSource" and "fReadSource" member objects, after we've been initialized via SDP
+
+private:
+    ZipMethod m_depthMethod;
 };
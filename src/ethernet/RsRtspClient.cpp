@@ -8,6 +8,8 @@
 #include <ipDeviceCommon/RsCommon.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 #include <iostream>
 #include <math.h>
 #include <string>
@@ -21,6 +23,25 @@
 // key is generated by rs2_stream+index: depth=1,color=2,irl=3,irr=4
 std::map<std::pair<int, int>, rs2_extrinsics> minimal_extrinsics_map;
 
+// The depth_compression SDP field. Servers that don't send it compress depth with lz4, and so do
+// clients that get a method they don't decode
+static ZipMethod parseDepthMethod(UsageEnvironment& t_env, const char* t_value)
+{
+    if (*t_value == '\0')
+    {
+        return ZipMethod::lz;
+    }
+    char* end;
+    errno = 0;
+    long method = strtol(t_value, &end, 10);
+    if (end != t_value && *end == '\0' && errno == 0 && (method == ZipMethod::lz || method == ZipMethod::jpeg || method == ZipMethod::rvl))
+    {
+        return static_cast<ZipMethod>(method);
+    }
+    t_env << "Unknown depth compression " << t_value << ", using lz4\n";
+    return ZipMethod::lz;
+}
+
 std::string format_error_msg(std::string function, RsRtspReturnValue retVal)
 {
     return std::string("[" + function + "] error: " + retVal.msg + " - " + std::to_string(retVal.exit_code));
@@ -132,7 +153,7 @@ int RsRTSPClient::addStream(rs2_video_stream t_stream, rtp_callback *t_callbackO
         throw std::runtime_error(format_error_msg(__FUNCTION__, m_lastReturnValue));
     }
 
-    subsession->sink = RsSink::createNew(this->envir(), *subsession, t_stream, m_memPool, this->url());
+    subsession->sink = RsSink::createNew(this->envir(), *subsession, t_stream, m_memPool, this->url(), subsession->getDepthMethod());
     // perhaps use your own custom "MediaSink" subclass instead
     if (subsession->sink == NULL)
     {
@@ -459,6 +480,7 @@ void RsRTSPClient::continueAfterDESCRIBE(RTSPClient *rtspClient, int resultCode,
             videoStream.intrinsics.fx = subsession->attrVal_int("fx");
             videoStream.intrinsics.fy = subsession->attrVal_int("fy");
             CompressionFactory::getIsEnabled() = subsession->attrVal_bool("compression");
+            subsession->setDepthMethod(parseDepthMethod(rsRtspClient->envir(), subsession->attrVal_str("depth_compression")));
             videoStream.intrinsics.model = (rs2_distortion)subsession->attrVal_int("model");
 
             for (size_t i = 0; i < 5; i++)
@@ -11,12 +11,12 @@
 
 #define WRITE_FRAMES_TO_FILE 0
 
-RsSink* RsSink::createNew(UsageEnvironment& t_env, MediaSubsession& t_subsession, rs2_video_stream t_stream, MemoryPool* t_memPool, char const* t_streamId)
+RsSink* RsSink::createNew(UsageEnvironment& t_env, MediaSubsession& t_subsession, rs2_video_stream t_stream, MemoryPool* t_memPool, char const* t_streamId, ZipMethod t_depthMethod)
 {
-    return new RsSink(t_env, t_subsession, t_stream, t_memPool, t_streamId);
+    return new RsSink(t_env, t_subsession, t_stream, t_memPool, t_streamId, t_depthMethod);
 }
 
-RsSink::RsSink(UsageEnvironment& t_env, MediaSubsession& t_subsession, rs2_video_stream t_stream, MemoryPool* t_memPool, char const* t_streamId)
+RsSink::RsSink(UsageEnvironment& t_env, MediaSubsession& t_subsession, rs2_video_stream t_stream, MemoryPool* t_memPool, char const* t_streamId, ZipMethod t_depthMethod)
     : MediaSink(t_env)
     , m_memPool(t_memPool)
     , m_subsession(t_subsession)
@@ -49,7 +49,7 @@ RsSink::RsSink(UsageEnvironment& t_env, MediaSubsession& t_subsession, rs2_video
     */
     if(CompressionFactory::isCompressionSupported(m_stream.fmt, m_stream.type))
     {
-        m_iCompress = CompressionFactory::getObject(m_stream.width, m_stream.height, m_stream.fmt, m_stream.type, m_stream.bpp);
+        m_iCompress = CompressionFactory::getObject(m_stream.width, m_stream.height, m_stream.fmt, m_stream.type, m_stream.bpp, t_depthMethod);
     }
     else
     {
@@ -107,7 +107,7 @@ void RsSink::afterGettingFrame(unsigned t_frameSize, unsigned t_numTruncatedByte
         {
             if(CompressionFactory::isCompressionSupported(m_stream.fmt, m_stream.type) && m_iCompress != nullptr)
             {
-                m_to = m_memPool->getNextMem();
+                m_to = m_memPool->getNextMem(m_bufferSize);
                 if(m_to == nullptr)
                 {
                     return;
@@ -150,7 +150,7 @@ Boolean RsSink::continuePlaying()
         return False; // sanity check (should not happen)
 
     // Request the next frame of data from our input source.  "afterGettingFrame()" will get called later, when it arrives:
-    m_receiveBuffer = m_memPool->getNextMem();
+    m_receiveBuffer = m_memPool->getNextMem(m_bufferSize);
     if(m_receiveBuffer == nullptr)
     {
         return false;
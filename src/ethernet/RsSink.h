@@ -20,12 +20,13 @@ public:
                              MediaSubsession& t_subsession,
                              rs2_video_stream t_stream, // identifies the kind of data that's being received
                              MemoryPool* t_mempool,
-                             char const* t_streamId = NULL); // identifies the stream itself (optional)
+                             char const* t_streamId = NULL, // identifies the stream itself (optional)
+                             ZipMethod t_depthMethod = ZipMethod::lz);
 
     void setCallback(rtp_callback* t_callback);
 
 private:
-    RsSink(UsageEnvironment& t_env, MediaSubsession& t_subsession, rs2_video_stream t_stream, MemoryPool* t_mempool, char const* t_streamId);
+    RsSink(UsageEnvironment& t_env, MediaSubsession& t_subsession, rs2_video_stream t_stream, MemoryPool* t_mempool, char const* t_streamId, ZipMethod t_depthMethod);
     // called only by "createNew()"
     virtual ~RsSink();
 
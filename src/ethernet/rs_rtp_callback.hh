@@ -4,6 +4,7 @@
 #pragma once
 
 #include "rs_rtp_stream.hh"
+#include "rtp_callback.hh"
 
 #include <memory>
 #include <mutex>
@@ -3,29 +3,34 @@
 
 #pragma once
 
-#include "RsRtspClient.h"
-#include "RsSink.h"
-
-#include "software-device.h"
+#include <ipDeviceCommon/MemoryPool.h>
+#include <ipDeviceCommon/RsCommon.h>
+#include <librealsense2/hpp/rs_internal.hpp>
 #include <librealsense2/rs.hpp>
 
 #include <NetdevLog.h>
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <queue>
+
 const int RTP_QUEUE_MAX_SIZE = 30;
 
+// A frame received over RTP. The buffer belongs to the memory pool of the streams, and is handed
+// over to the software frame, which returns it to the pool once it is released.
 struct Raw_Frame
 {
+    Raw_Frame()
+        : m_metadata(nullptr)
+        , m_buffer(nullptr)
+        , m_size(0)
+        , m_timestamp(){};
     Raw_Frame(char* buffer, int size, struct timeval timestamp)
         : m_metadata((RsMetadataHeader*)buffer)
         , m_buffer(buffer + sizeof(RsMetadataHeader))
         , m_size(size)
         , m_timestamp(timestamp){};
-    Raw_Frame(const Raw_Frame&);
-    Raw_Frame& operator=(const Raw_Frame&);
-    ~Raw_Frame()
-    {
-        delete[] m_buffer;
-    };
 
     RsMetadataHeader* m_metadata;
     char* m_buffer;
@@ -37,14 +42,14 @@ class rs_rtp_stream
 {
 public:
     rs_rtp_stream(rs2_video_stream rs_stream, rs2::stream_profile rs_profile)
+        : is_enabled(false)
     {
         frame_data_buff.bpp = rs_stream.bpp;
 
         frame_data_buff.profile = rs_profile;
         m_stream_profile = rs_profile;
         frame_data_buff.stride = rs_stream.bpp * rs_stream.width;
-        pixels_buff.resize(frame_data_buff.stride * rs_stream.height, 0);
-        frame_data_buff.pixels = pixels_buff.data();
+        frame_data_buff.pixels = nullptr;
         frame_data_buff.deleter = this->frame_deleter;
 
         m_rs_stream = rs_stream;
@@ -60,37 +65,65 @@ public:
         return m_rs_stream.type;
     }
 
-    void insert_frame(Raw_Frame* new_raw_frame)
+    // Frames are queued from here on, until stop()
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(this->stream_lock);
+        is_enabled = true;
+    }
+
+    // Wakes up extract_frame()
+    void stop()
     {
-        if(queue_size() > RTP_QUEUE_MAX_SIZE)
         {
-            ERR << "Queue is full. Dropping frame for: " << this->m_rs_stream.uid;
+            std::lock_guard<std::mutex> lock(this->stream_lock);
+            is_enabled = false;
         }
-        else
+        frames_cv.notify_all();
+    }
+
+    void insert_frame(const Raw_Frame& new_raw_frame)
+    {
+        bool enabled;
         {
             std::lock_guard<std::mutex> lock(this->stream_lock);
-            frames_queue.push(new_raw_frame);
+            enabled = is_enabled;
+            if(enabled && frames_queue.size() <= RTP_QUEUE_MAX_SIZE)
+            {
+                frames_queue.push(new_raw_frame);
+                frames_cv.notify_one();
+                return;
+            }
         }
+        if(enabled)
+        {
+            ERR << "Queue is full. Dropping frame for: " << this->m_rs_stream.uid;
+        }
+        frame_deleter(new_raw_frame.m_buffer);
     }
 
     // extrinsics between this stream to all other streams
     // the key is generated by RsRTSPClient::getStreamProfileUniqueKey function
     std::map<long long int, rs2_extrinsics> extrinsics_map;
 
-    Raw_Frame* extract_frame()
+    // Waits for the next frame, and returns false once the stream is stopped
+    bool extract_frame(Raw_Frame& frame)
     {
-        std::lock_guard<std::mutex> lock(this->stream_lock);
-        Raw_Frame* frame = frames_queue.front();
+        std::unique_lock<std::mutex> lock(this->stream_lock);
+        frames_cv.wait(lock, [this]() { return !is_enabled || !frames_queue.empty(); });
+        if(!is_enabled)
+            return false;
+        frame = frames_queue.front();
         frames_queue.pop();
-        return frame;
+        return true;
     }
 
     void reset_queue()
     {
+        std::lock_guard<std::mutex> lock(this->stream_lock);
         while(!frames_queue.empty())
         {
-            Raw_Frame* frame = frames_queue.front();
-            get_memory_pool().returnMem((unsigned char*)frame->m_buffer - sizeof(RsFrameHeader));
+            frame_deleter(frames_queue.front().m_buffer);
             frames_queue.pop();
         }
         INF << "Frames queue cleaned for " << m_rs_stream.uid;
@@ -104,12 +137,11 @@ public:
 
     static MemoryPool& get_memory_pool()
     {
-        static MemoryPool memory_pool_instance = MemoryPool();
-        return memory_pool_instance;
+        // Never destroyed, frames may be released after the static objects are
+        static MemoryPool* memory_pool_instance = new MemoryPool();
+        return *memory_pool_instance;
     }
 
-    bool is_enabled;
-
     rs2_video_stream m_rs_stream;
 
     rs2_software_video_frame frame_data_buff;
@@ -124,7 +156,9 @@ private:
 
     std::mutex stream_lock;
 
-    std::queue<Raw_Frame*> frames_queue;
+    std::condition_variable frames_cv;
+
+    bool is_enabled;
 
-    std::vector<uint8_t> pixels_buff;
+    std::queue<Raw_Frame> frames_queue;
 };
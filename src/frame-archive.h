@@ -3,6 +3,7 @@
 #pragma once
 
 #include "archive.h"
+#include "environment.h"
 
 namespace librealsense
 {
@@ -14,12 +15,12 @@ namespace librealsense
         std::atomic<uint32_t> published_frames_count;
         small_heap<T, RS2_USER_QUEUE_SIZE> published_frames;
         std::shared_ptr<metadata_parser_map> _metadata_parsers = nullptr;
+        std::shared_ptr<const metadata_parser_table> _metadata_table = nullptr;
         callbacks_heap callback_inflight;
 
-        std::vector<T> freelist; // return frames here
+        frame_buffer_pool buffers; // return frame buffers here
         std::atomic<bool> recycle_frames;
         int pending_frames = 0;
-        std::recursive_mutex mutex;
         std::shared_ptr<platform::time_service> _time_service;
 
         std::weak_ptr<sensor_interface> _sensor;
@@ -29,35 +30,11 @@ namespace librealsense
         T alloc_frame(const size_t size, const frame_additional_data& additional_data, bool requires_memory)
         {
             T backbuffer;
-            //const size_t size = modes[stream].get_image_size(stream);
-            {
-                std::lock_guard<std::recursive_mutex> guard(mutex);
-
-                if (requires_memory)
-                {
-                    // Attempt to obtain a buffer of the appropriate size from the freelist
-                    for (auto it = begin(freelist); it != end(freelist); ++it)
-                    {
-                        if (it->data.size() == size)
-                        {
-                            backbuffer = std::move(*it);
-                            freelist.erase(it);
-                            break;
-                        }
-                    }
-                }
-
-                // Discard buffers that have been in the freelist for longer than 1s
-                for (auto it = begin(freelist); it != end(freelist);)
-                {
-                    if (additional_data.timestamp > it->additional_data.timestamp + 1000) it = freelist.erase(it);
-                    else ++it;
-                }
-            }
-
             if (requires_memory)
             {
-                backbuffer.data.resize(size, 0); // TODO: Allow users to provide a custom allocator for frame buffers
+                // Attempt to obtain a buffer of the appropriate size from the pool
+                if (!buffers.acquire(size, get_time(), backbuffer.data))
+                    backbuffer.data = frame_buffer(size, 0, frame_buffer_allocator<byte>(environment::get_instance().get_frame_allocator()));
             }
             backbuffer.additional_data = additional_data;
             return backbuffer;
@@ -65,8 +42,6 @@ namespace librealsense
 
         frame_interface* track_frame(T& f)
         {
-            std::unique_lock<std::recursive_mutex> lock(mutex);
-
             auto published_frame = f.publish(this->shared_from_this());
             if (published_frame)
             {
@@ -84,15 +59,13 @@ namespace librealsense
             {
                 auto f = (T*)frame;
                 log_frame_callback_end(f);
-                std::unique_lock<std::recursive_mutex> lock(mutex);
 
                 frame->keep();
 
                 if (recycle_frames)
                 {
-                    freelist.push_back(std::move(*f));
+                    buffers.release(std::move(f->data), get_time());
                 }
-                lock.unlock();
 
                 if (f->is_fixed())
                     published_frames.deallocate(f);
@@ -157,17 +130,21 @@ namespace librealsense
             }
         }
 
+        rs2_time_t get_time() const { return _time_service ? _time_service->get_time() : 0; }
+
         std::shared_ptr<metadata_parser_map> get_md_parsers() const override { return _metadata_parsers; };
+        std::shared_ptr<const metadata_parser_table> get_md_table() const override { return _metadata_table; };
 
         friend class frame;
 
     public:
         explicit frame_archive(std::atomic<uint32_t>* in_max_frame_queue_size,
             std::shared_ptr<platform::time_service> ts,
-            std::shared_ptr<metadata_parser_map> parsers)
+            std::shared_ptr<metadata_parser_map> parsers,
+            std::shared_ptr<const metadata_parser_table> table)
             : max_frame_queue_size(in_max_frame_queue_size),
-            recycle_frames(true), mutex(), _time_service(ts),
-            _metadata_parsers(parsers)
+            recycle_frames(true), _time_service(ts),
+            _metadata_parsers(parsers), _metadata_table(table)
         {
             published_frames_count = 0;
         }
@@ -188,6 +165,21 @@ namespace librealsense
             return track_frame(frame);
         }
 
+        void prewarm(const size_t size, int count) override
+        {
+            buffers.prewarm(size, count, get_time(), frame_buffer_allocator<byte>(environment::get_instance().get_frame_allocator()));
+        }
+
+        void set_buffers_retention(rs2_time_t retention) override
+        {
+            buffers.set_retention(retention);
+        }
+
+        frame_buffer_pool::statistics get_buffers_statistics() const override
+        {
+            return buffers.get_statistics();
+        }
+
         void flush() override
         {
             published_frames.stop_allocation();
@@ -202,10 +194,7 @@ namespace librealsense
             // wait until user is done with all the stuff he chose to borrow
             callback_inflight.wait_until_empty();
 
-            {
-                std::lock_guard<std::recursive_mutex> guard(mutex);
-                freelist.clear();
-            }
+            buffers.clear();
 
             pending_frames = published_frames.get_size();
             if (pending_frames > 0)
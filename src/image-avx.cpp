@@ -4,26 +4,35 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include "image-avx.h"
+#include "thread-pool.h"
+
+#include <algorithm>
 
 //#include "../include/librealsense2/rsutil.h" // For projection/deprojection logic
 
 #ifndef ANDROID
-    #if defined(__SSSE3__) && defined(__AVX2__)
+    #if defined(__SSSE3__)
     #include <tmmintrin.h> // For SSE3 intrinsic used in unpack_yuy2_sse
     #include <immintrin.h>
 
+    // The rest of the library is built without AVX: only the functions marked so may use it, and
+    // they are only called when the CPU supports it (see cpu_simd_level())
+    #if defined(__GNUC__)
+    #define AVX2_TARGET __attribute__((target("avx2")))
+    #else
+    #define AVX2_TARGET
+    #endif
+
     #pragma pack(push, 1) // All structs in this file are assumed to be byte-packed
     namespace librealsense
     {
-        template<rs2_format FORMAT> void unpack_yuy2(byte * const d[], const byte * s, int n)
-        {
-            assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
+        // Blocks of 32 pixels per band of the thread pool
+        static const int unpack_strip_blocks = 512;
 
-            auto src = reinterpret_cast<const __m256i *>(s);
-            auto dst = reinterpret_cast<__m256i *>(d[0]);
-
-            #pragma omp parallel for
-            for (int i = 0; i < n / 32; i++)
+        // The blocks of 32 pixels [first, last)
+        template<rs2_format FORMAT> AVX2_TARGET void unpack_yuy2_blocks(const __m256i * src, __m256i * dst, int first, int last)
+        {
+            for (int i = first; i < last; i++)
             {
                 const __m256i zero = _mm256_set1_epi8(0);
                 const __m256i n100 = _mm256_set1_epi16(100 << 4);
@@ -41,12 +50,12 @@
 
                 if (FORMAT == RS2_FORMAT_Y8)
                 {
-                    // Align all Y components and output 32 pixels (32 bytes) at once
-                    __m256i y0 = _mm256_shuffle_epi8(s0, _mm256_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14,
-                        1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14));
-                    __m256i y1 = _mm256_shuffle_epi8(s1, _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
-                        0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15));
-                    _mm256_storeu_si256(&dst[i], _mm256_alignr_epi8(y0, y1, 8));
+                    // Gather the Y components of each lane to its low half, then put the halves of the two registers in order
+                    const __m256i evens_odds_y = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                        0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+                    __m256i y0 = _mm256_shuffle_epi8(s0, evens_odds_y);
+                    __m256i y1 = _mm256_shuffle_epi8(s1, evens_odds_y);
+                    _mm256_storeu_si256(&dst[i], _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(y0, y1), _MM_SHUFFLE(3, 1, 2, 0)));
                     continue;
                 }
 
@@ -218,11 +227,11 @@
                         // Shuffle rgb triples to the start and end of each register
                         __m128i bgr0 = _mm_shuffle_epi8(rgba0, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
                         __m128i bgr1 = _mm_shuffle_epi8(rgba1, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                        __m128i bgr2 = _mm_shuffle_epi8(rgba2, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 1));
+                        __m128i bgr2 = _mm_shuffle_epi8(rgba2, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
                         __m128i bgr3 = _mm_shuffle_epi8(rgba3, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
                         __m128i bgr4 = _mm_shuffle_epi8(rgba4, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
                         __m128i bgr5 = _mm_shuffle_epi8(rgba5, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                        __m128i bgr6 = _mm_shuffle_epi8(rgba6, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 1));
+                        __m128i bgr6 = _mm_shuffle_epi8(rgba6, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
                         __m128i bgr7 = _mm_shuffle_epi8(rgba7, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
 
                         __m128i a1 = _mm_alignr_epi8(bgr1, bgr0, 4);
@@ -250,29 +259,108 @@
             }
         }
 
-        void unpack_yuy2_avx_y8(byte * const d[], const byte * s, int n)
+        template<rs2_format FORMAT> int unpack_yuy2(byte * const d[], const byte * s, int n)
+        {
+            auto src = reinterpret_cast<const __m256i *>(s);
+            auto dst = reinterpret_cast<__m256i *>(d[0]);
+
+            const int blocks = n / 32;
+            parallel_for((blocks + unpack_strip_blocks - 1) / unpack_strip_blocks, [&](int strip)
+            {
+                unpack_yuy2_blocks<FORMAT>(src, dst, strip * unpack_strip_blocks, std::min(blocks, (strip + 1) * unpack_strip_blocks));
+            });
+            return blocks * 32;
+        }
+
+        int unpack_yuy2_avx_y8(byte * const d[], const byte * s, int n)
+        {
+            return unpack_yuy2<RS2_FORMAT_Y8>(d, s, n);
+        }
+        int unpack_yuy2_avx_y16(byte * const d[], const byte * s, int n)
+        {
+            return unpack_yuy2<RS2_FORMAT_Y16>(d, s, n);
+        }
+        int unpack_yuy2_avx_rgb8(byte * const d[], const byte * s, int n)
+        {
+            return unpack_yuy2<RS2_FORMAT_RGB8>(d, s, n);
+        }
+        int unpack_yuy2_avx_rgba8(byte * const d[], const byte * s, int n)
         {
-            unpack_yuy2<RS2_FORMAT_Y8>(d, s, n);
+            return unpack_yuy2<RS2_FORMAT_RGBA8>(d, s, n);
         }
-        void unpack_yuy2_avx_y16(byte * const d[], const byte * s, int n)
+        int unpack_yuy2_avx_bgr8(byte * const d[], const byte * s, int n)
         {
-            unpack_yuy2<RS2_FORMAT_Y16>(d, s, n);
+            return unpack_yuy2<RS2_FORMAT_BGR8>(d, s, n);
         }
-        void unpack_yuy2_avx_rgb8(byte * const d[], const byte * s, int n)
+        int unpack_yuy2_avx_bgra8(byte * const d[], const byte * s, int n)
         {
-            unpack_yuy2<RS2_FORMAT_RGB8>(d, s, n);
+            return unpack_yuy2<RS2_FORMAT_BGRA8>(d, s, n);
+        }
+
+        // The 64-bit quarters of a register in the order 0, 2, 1, 3, undoing the in-lane unpack and
+        // pack instructions
+        #define AVX2_QWORDS_IN_ORDER _MM_SHUFFLE(3, 1, 2, 0)
+
+        AVX2_TARGET int unpack_y8_y8_from_y8i_avx(byte * const d[], const byte * s, int count)
+        {
+            const __m256i split = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+            int i = 0;
+            for (; i + 32 <= count; i += 32)
+            {
+                // Each lane to 8 left pixels and then 8 right ones
+                __m256i a = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i * 2)), split);
+                __m256i b = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i * 2 + 32)), split);
+                __m256i l = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), AVX2_QWORDS_IN_ORDER);
+                __m256i r = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a, b), AVX2_QWORDS_IN_ORDER);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(d[0] + i), l);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(d[1] + i), r);
+            }
+            return i;
         }
-        void unpack_yuy2_avx_rgba8(byte * const d[], const byte * s, int n)
+
+        AVX2_TARGET int unpack_y16_from_y16_10_avx(uint16_t * d, const uint16_t * s, int count)
         {
-            unpack_yuy2<RS2_FORMAT_RGBA8>(d, s, n);
+            int i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + i), _mm256_slli_epi16(p, 6));
+            }
+            return i;
         }
-        void unpack_yuy2_avx_bgr8(byte * const d[], const byte * s, int n)
+
+        AVX2_TARGET int unpack_y8_from_y16_10_avx(uint8_t * d, const uint16_t * s, int count)
         {
-            unpack_yuy2<RS2_FORMAT_BGR8>(d, s, n);
+            // Truncated, rather than saturated, to 8 bits
+            const __m256i low_byte = _mm256_set1_epi16(0xff);
+            int i = 0;
+            for (; i + 32 <= count; i += 32)
+            {
+                __m256i a = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i)), 2), low_byte);
+                __m256i b = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i + 16)), 2), low_byte);
+                __m256i y8 = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), AVX2_QWORDS_IN_ORDER);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + i), y8);
+            }
+            return i;
         }
-        void unpack_yuy2_avx_bgra8(byte * const d[], const byte * s, int n)
+
+        AVX2_TARGET int unpack_rgb_from_bgr_avx(byte * d, const byte * s, int count)
         {
-            unpack_yuy2<RS2_FORMAT_BGRA8>(d, s, n);
+            // 5 pixels per lane; the 16th byte is copied as is, and rewritten by the next store
+            const __m256i swap = _mm256_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15,
+                2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+            int i = 0;
+            for (; i * 3 + 31 <= count * 3; i += 10)
+            {
+                auto p = i * 3;
+                __m256i bgr = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + p))),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + p + 15)), 1);
+                __m256i rgb = _mm256_shuffle_epi8(bgr, swap);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(d + p), _mm256_castsi256_si128(rgb));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(d + p + 15), _mm256_extracti128_si256(rgb, 1));
+            }
+            return i;
         }
     }
 
@@ -10,13 +10,20 @@
 namespace librealsense
 {
 #ifndef ANDROID
-    #if defined(__SSSE3__) && defined(__AVX2__)
-    void unpack_yuy2_avx_y8(byte * const d[], const byte * s, int n);
-    void unpack_yuy2_avx_y16(byte * const d[], const byte * s, int n);
-    void unpack_yuy2_avx_rgb8(byte * const d[], const byte * s, int n);
-    void unpack_yuy2_avx_rgba8(byte * const d[], const byte * s, int n);
-    void unpack_yuy2_avx_bgr8(byte * const d[], const byte * s, int n);
-    void unpack_yuy2_avx_bgra8(byte * const d[], const byte * s, int n);
+    #if defined(__SSSE3__)
+    // Built for AVX2 whatever the flags of the library, and only to be called when
+    // cpu_simd_level() is simd_level::avx2. They return the number of pixels unpacked, from the
+    // start; the rest are left to the caller
+    int unpack_yuy2_avx_y8(byte * const d[], const byte * s, int n);
+    int unpack_yuy2_avx_y16(byte * const d[], const byte * s, int n);
+    int unpack_yuy2_avx_rgb8(byte * const d[], const byte * s, int n);
+    int unpack_yuy2_avx_rgba8(byte * const d[], const byte * s, int n);
+    int unpack_yuy2_avx_bgr8(byte * const d[], const byte * s, int n);
+    int unpack_yuy2_avx_bgra8(byte * const d[], const byte * s, int n);
+    int unpack_y8_y8_from_y8i_avx(byte * const d[], const byte * s, int count);
+    int unpack_y16_from_y16_10_avx(uint16_t * d, const uint16_t * s, int count);
+    int unpack_y8_from_y16_10_avx(uint8_t * d, const uint16_t * s, int count);
+    int unpack_rgb_from_bgr_avx(byte * d, const byte * s, int count);
     #endif
 #endif
 }
@@ -50,6 +50,7 @@ namespace librealsense
         case RS2_FORMAT_W10: return 32;
         case RS2_FORMAT_Z16H: return 16;
         case RS2_FORMAT_FG: return 16;
+        case RS2_FORMAT_MOTION_BATCH: return 1;
         default: assert(false); return 0;
         }
     }
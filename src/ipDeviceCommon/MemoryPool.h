@@ -5,94 +5,163 @@
 
 #include <ipDeviceCommon/RsCommon.h>
 
+#include <atomic>
+#include <cstddef>
 #include <iostream>
-#include <mutex>
-#include <queue>
 
 #include "NetdevLog.h"
 
-#define POOL_SIZE 100
+#define POOL_SIZE 32    // Free buffers kept for each size
+#define POOL_BUCKETS 8  // Sizes kept, any other size is allocated and freed each time
 
+struct MemoryPoolStatistics
+{
+    long long allocated;   // Buffers allocated since the pool was created
+    long long reused;      // Buffers served from the pool instead of being allocated
+    int inUse;             // Buffers given out, and not returned yet
+    int highWaterMark;     // Most buffers in use at once
+};
+
+// Frame buffers, reused instead of being allocated for every frame. Each buffer remembers its
+// size, and returns to the free buffers of that size. Free buffers are kept in slots that are
+// claimed and released by atomic exchanges, so frames can be taken and returned from any
+// thread without a lock.
 class MemoryPool
 {
 
 public:
     MemoryPool()
+        : m_allocated(0), m_reused(0), m_inUse(0), m_highWaterMark(0)
     {
-        // //alloc memory
-        // std::unique_lock<std::mutex> lk(m_mutex);
-        // for(int i = 0; i < POOL_SIZE; i++)
-        // {
-        //     unsigned char *mem = new unsigned char[sizeof(RsFrameHeader) + MAX_FRAME_SIZE]; //TODO:to use OutPacketBuffer::maxSize;
-        //     m_pool.push(mem);
-        // }
-        // lk.unlock();
+        for(auto& bucket : m_buckets)
+        {
+            bucket.size = 0;
+            for(auto& slot : bucket.slots)
+                slot = nullptr;
+        }
     }
 
-    MemoryPool(const MemoryPool& obj)
-    {
-        m_pool = obj.m_pool;
-    }
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
 
-    MemoryPool& operator=(const MemoryPool&& obj)
+    // A buffer of t_size bytes at least
+    unsigned char* getNextMem(size_t t_size = MAX_MESSAGE_SIZE)
     {
-        m_pool = obj.m_pool;
-        return *this;
+        size_t size = roundSize(t_size);
+        unsigned char* mem = nullptr;
+        Bucket* bucket = findBucket(size, true);
+        if(bucket)
+        {
+            for(auto& slot : bucket->slots)
+            {
+                if(slot.load(std::memory_order_relaxed) && (mem = slot.exchange(nullptr, std::memory_order_acquire)))
+                    break;
+            }
+        }
+
+        if(mem)
+        {
+            m_reused++;
+        }
+        else
+        {
+            mem = new unsigned char[HEADER_SIZE + size];
+            *(size_t*)mem = size;
+            mem += HEADER_SIZE;
+            m_allocated++;
+        }
+
+        int inUse = ++m_inUse;
+        int highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+        while(inUse > highWaterMark && !m_highWaterMark.compare_exchange_weak(highWaterMark, inUse))
+            ;
+        return mem;
     }
 
-    unsigned char* getNextMem()
+    void returnMem(unsigned char* t_mem)
     {
-        // unsigned char* mem = nullptr;
-        // std::unique_lock<std::mutex> lk(m_mutex);
-        // if(!m_pool.empty())
-        // {
-        //     mem = m_pool.front();
-        //     m_pool.pop();
-        // }
-        // else
-        // {
-        //     ERR << "getNextMem: pool is empty";
-        // }
-        // lk.unlock();
-        // return mem;
-        return new unsigned char[sizeof(RsFrameHeader) + MAX_FRAME_SIZE]; 
+        if(t_mem == nullptr)
+        {
+            ERR << "returnMem: invalid address";
+            return;
+        }
+        m_inUse--;
+
+        size_t size = *(size_t*)(t_mem - HEADER_SIZE);
+        Bucket* bucket = findBucket(size, false);
+        if(bucket)
+        {
+            for(auto& slot : bucket->slots)
+            {
+                unsigned char* empty = nullptr;
+                if(!slot.load(std::memory_order_relaxed) && slot.compare_exchange_strong(empty, t_mem, std::memory_order_release))
+                    return;
+            }
+        }
+        // The pool of this size is full
+        delete[](t_mem - HEADER_SIZE);
     }
 
-    void returnMem(unsigned char* t_mem)
+    MemoryPoolStatistics getStatistics() const
     {
-        // if(t_mem != nullptr)
-        // {
-        //     std::unique_lock<std::mutex> lk(m_mutex);
-        //     m_pool.push(t_mem);
-        //     lk.unlock();
-        // }
-        // else
-        // {
-        //     ERR << "returnMem: invalid address";
-        // }
-        delete[] t_mem;
+        return {m_allocated.load(), m_reused.load(), m_inUse.load(), m_highWaterMark.load()};
     }
 
     ~MemoryPool()
     {
-        // std::unique_lock<std::mutex> lk(m_mutex);
-        // while(!m_pool.empty())
-        // {
-        //     unsigned char* mem = m_pool.front();
-        //     m_pool.pop();
-        //     if(mem != nullptr)
-        //     {
-        //         delete mem;
-        //     }
-        //     else
-        //     {
-        //         ERR << "~memory_pool: invalid address";
-        //     }
-        // }
-        // lk.unlock();
+        if(m_inUse)
+        {
+            ERR << "~MemoryPool: " << m_inUse << " buffers are still in use";
+        }
+        DBG << "~MemoryPool: " << m_allocated << " buffers allocated, " << m_reused << " reused, at most " << m_highWaterMark << " in use";
+        for(auto& bucket : m_buckets)
+        {
+            for(auto& slot : bucket.slots)
+            {
+                unsigned char* mem = slot.exchange(nullptr);
+                if(mem)
+                    delete[](mem - HEADER_SIZE);
+            }
+        }
     }
 
 private:
-    std::queue<unsigned char*> m_pool;
-    std::mutex m_mutex;
+    // Holds the size of the buffer, and keeps its data as aligned as the allocation
+    static const size_t HEADER_SIZE = 64;
+
+    struct Bucket
+    {
+        std::atomic<size_t> size; // 0 until the bucket is taken
+        std::atomic<unsigned char*> slots[POOL_SIZE];
+    };
+
+    // Sizes that differ by a little share their buffers
+    static size_t roundSize(size_t t_size)
+    {
+        const size_t page = 4096;
+        return (t_size + page - 1) / page * page;
+    }
+
+    // The bucket of the size, which is taken if there is none and t_add is set
+    Bucket* findBucket(size_t t_size, bool t_add)
+    {
+        for(auto& bucket : m_buckets)
+        {
+            size_t size = bucket.size.load(std::memory_order_acquire);
+            if(size == t_size)
+                return &bucket;
+            if(size == 0)
+            {
+                if(!t_add)
+                    return nullptr;
+                if(bucket.size.compare_exchange_strong(size, t_size) || size == t_size)
+                    return &bucket;
+            }
+        }
+        return nullptr;
+    }
+
+    Bucket m_buckets[POOL_BUCKETS];
+    std::atomic<long long> m_allocated, m_reused;
+    std::atomic<int> m_inUse, m_highWaterMark;
 };
@@ -0,0 +1,156 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2020 Intel Corporation. All Rights Reserved.
+
+#ifdef __linux__
+
+#include "RsBatchSocket.h"
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdint.h>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103 // Linux 4.18
+#endif
+
+RsBatchSender::RsBatchSender()
+    : m_useGso(true)
+{}
+
+RsBatchSender::~RsBatchSender() {}
+
+bool RsBatchSender::send(int t_socket, struct sockaddr_storage const& t_dest, socklen_t t_destSize, unsigned char const* t_packets, size_t const* t_offsets, size_t t_count)
+{
+    size_t first = 0;
+    while(first < t_count)
+    {
+        if(!m_useGso)
+        {
+            // Without GSO, everything that is left goes out in sendmmsg() calls
+            return sendPackets(t_socket, t_dest, t_destSize, t_packets, t_offsets + first, t_count - first);
+        }
+
+        // A run of equal packets, the last of which may be shorter, is sent as one buffer
+        size_t size = t_offsets[first + 1] - t_offsets[first];
+        size_t last = first + 1;
+        size_t maxSegments = std::min<size_t>(RS_BATCH_MAX_SEGMENTS, 65000 / std::max<size_t>(size, 1));
+        while(last < t_count && last - first < maxSegments && t_offsets[last + 1] - t_offsets[last] <= size)
+        {
+            last++;
+            if(t_offsets[last] - t_offsets[last - 1] < size)
+                break;
+        }
+
+        bool success = last - first > 1 ? sendSegments(t_socket, t_dest, t_destSize, t_packets, t_offsets + first, last - first)
+                                        : sendPackets(t_socket, t_dest, t_destSize, t_packets, t_offsets + first, 1);
+        if(!success)
+        {
+            return false;
+        }
+        first = last;
+    }
+    return true;
+}
+
+bool RsBatchSender::sendSegments(int t_socket, struct sockaddr_storage const& t_dest, socklen_t t_destSize, unsigned char const* t_packets, size_t const* t_offsets, size_t t_count)
+{
+    struct iovec iov;
+    iov.iov_base = (void*)(t_packets + t_offsets[0]);
+    iov.iov_len = t_offsets[t_count] - t_offsets[0];
+
+    char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+    struct msghdr msg = {};
+    msg.msg_name = (void*)&t_dest;
+    msg.msg_namelen = t_destSize;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = IPPROTO_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    uint16_t segmentSize = uint16_t(t_offsets[1] - t_offsets[0]);
+    memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+
+    if(sendSegmented(t_socket, &msg) >= 0)
+    {
+        return true;
+    }
+    if(errno == EIO || errno == EINVAL || errno == ENOPROTOOPT || errno == EOPNOTSUPP)
+    {
+        // The kernel or the interface can't segment UDP
+        m_useGso = false;
+        return sendPackets(t_socket, t_dest, t_destSize, t_packets, t_offsets, t_count);
+    }
+    return false;
+}
+
+bool RsBatchSender::sendPackets(int t_socket, struct sockaddr_storage const& t_dest, socklen_t t_destSize, unsigned char const* t_packets, size_t const* t_offsets, size_t t_count)
+{
+    m_iovecs.resize(t_count);
+    m_messages.resize(t_count);
+    for(size_t i = 0; i < t_count; i++)
+    {
+        m_iovecs[i].iov_base = (void*)(t_packets + t_offsets[i]);
+        m_iovecs[i].iov_len = t_offsets[i + 1] - t_offsets[i];
+        memset(&m_messages[i], 0, sizeof(m_messages[i]));
+        m_messages[i].msg_hdr.msg_name = (void*)&t_dest;
+        m_messages[i].msg_hdr.msg_namelen = t_destSize;
+        m_messages[i].msg_hdr.msg_iov = &m_iovecs[i];
+        m_messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // sendmmsg() may stop short of the count, when the socket buffer fills or a signal comes
+    size_t sent = 0;
+    while(sent < t_count)
+    {
+        int result = sendMessages(t_socket, &m_messages[sent], unsigned(t_count - sent));
+        if(result <= 0)
+        {
+            if(result == 0)
+                errno = EAGAIN;
+            return false;
+        }
+        sent += result;
+    }
+    return true;
+}
+
+ssize_t RsBatchSender::sendSegmented(int t_socket, struct msghdr const* t_message)
+{
+    return sendmsg(t_socket, t_message, 0);
+}
+
+int RsBatchSender::sendMessages(int t_socket, struct mmsghdr* t_messages, unsigned t_count)
+{
+    return sendmmsg(t_socket, t_messages, t_count, 0);
+}
+
+RsBatchReceiver::RsBatchReceiver()
+    : m_packets(RS_BATCH_RECEIVE_PACKETS * RS_BATCH_RECEIVE_PACKET_SIZE)
+    , m_messages(RS_BATCH_RECEIVE_PACKETS)
+    , m_iovecs(RS_BATCH_RECEIVE_PACKETS)
+{
+    for(int i = 0; i < RS_BATCH_RECEIVE_PACKETS; i++)
+    {
+        m_iovecs[i].iov_base = &m_packets[i * RS_BATCH_RECEIVE_PACKET_SIZE];
+        m_iovecs[i].iov_len = RS_BATCH_RECEIVE_PACKET_SIZE;
+        memset(&m_messages[i], 0, sizeof(m_messages[i]));
+        m_messages[i].msg_hdr.msg_iov = &m_iovecs[i];
+        m_messages[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+int RsBatchReceiver::receive(int t_socket)
+{
+    int received = recvmmsg(t_socket, m_messages.data(), RS_BATCH_RECEIVE_PACKETS, MSG_DONTWAIT, NULL);
+    return received > 0 ? received : 0;
+}
+
+#endif
@@ -0,0 +1,75 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2020 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#ifdef __linux__
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <cstddef>
+#include <vector>
+
+#define RS_BATCH_MAX_SEGMENTS 64          // Packets in one UDP GSO send
+#define RS_BATCH_RECEIVE_PACKETS 64       // Packets read by one recvmmsg()
+#define RS_BATCH_RECEIVE_PACKET_SIZE 2048
+
+// Sends UDP packets that lie back to back in one buffer with a few system calls, instead of one
+// for each packet. Runs of equal sized packets go out as UDP GSO sends (UDP_SEGMENT), where the
+// kernel splits a single buffer into packets, and the rest with sendmmsg().
+//
+// Whether GSO works is only known at run time: it needs Linux 4.18, and an interface that can
+// segment UDP. So GSO is tried first, and the first GSO send that fails with EIO, EINVAL,
+// ENOPROTOOPT or EOPNOTSUPP turns it off for the life of the sender; those packets, and all the
+// packets after them, are sent with sendmmsg().
+class RsBatchSender
+{
+public:
+    RsBatchSender();
+    virtual ~RsBatchSender();
+
+    // Sends t_count packets to t_dest, packet i being bytes [t_offsets[i], t_offsets[i + 1]) of
+    // t_packets. Returns false, with errno set, if a system call fails.
+    bool send(int t_socket, struct sockaddr_storage const& t_dest, socklen_t t_destSize, unsigned char const* t_packets, size_t const* t_offsets, size_t t_count);
+
+    // False once GSO was found not to work
+    bool usesGso() const { return m_useGso; }
+
+protected:
+    // The system calls, which tests replace to make them fail or send fewer packets than asked
+    virtual ssize_t sendSegmented(int t_socket, struct msghdr const* t_message);
+    virtual int sendMessages(int t_socket, struct mmsghdr* t_messages, unsigned t_count);
+
+private:
+    bool sendSegments(int t_socket, struct sockaddr_storage const& t_dest, socklen_t t_destSize, unsigned char const* t_packets, size_t const* t_offsets, size_t t_count);
+    bool sendPackets(int t_socket, struct sockaddr_storage const& t_dest, socklen_t t_destSize, unsigned char const* t_packets, size_t const* t_offsets, size_t t_count);
+
+    std::vector<struct iovec> m_iovecs;
+    std::vector<struct mmsghdr> m_messages;
+    bool m_useGso;
+};
+
+// Reads the UDP packets waiting on a socket with a single recvmmsg(), instead of a read for each
+class RsBatchReceiver
+{
+public:
+    RsBatchReceiver();
+
+    // Reads up to RS_BATCH_RECEIVE_PACKETS packets, without waiting for them. Returns how many,
+    // 0 if none are waiting.
+    int receive(int t_socket);
+
+    // Of the packets the last receive() read
+    unsigned char* packet(int t_index) { return &m_packets[t_index * RS_BATCH_RECEIVE_PACKET_SIZE]; }
+    unsigned size(int t_index) const { return m_messages[t_index].msg_len; }
+    // Longer than RS_BATCH_RECEIVE_PACKET_SIZE, and cut to it
+    bool truncated(int t_index) const { return (m_messages[t_index].msg_hdr.msg_flags & MSG_TRUNC) != 0; }
+
+private:
+    std::vector<unsigned char> m_packets;
+    std::vector<struct mmsghdr> m_messages;
+    std::vector<struct iovec> m_iovecs;
+};
+
+#endif
@@ -143,6 +143,19 @@ namespace librealsense
             { {RS2_FORMAT_MOTION_XYZ32F, RS2_STREAM_GYRO} },
             [&, mm_correct_opt]() { return std::make_shared<gyroscope_transform>(_mm_calib, mm_correct_opt); }
         );
+
+        // The samples of each read in one frame, when the app asks for them
+        hid_ep->register_processing_block(
+            { {RS2_FORMAT_MOTION_BATCH, RS2_STREAM_ACCEL} },
+            { {RS2_FORMAT_MOTION_BATCH, RS2_STREAM_ACCEL} },
+            [&, mm_correct_opt]() { return std::make_shared<acceleration_transform>(_mm_calib, mm_correct_opt, RS2_FORMAT_MOTION_BATCH); }
+        );
+
+        hid_ep->register_processing_block(
+            { {RS2_FORMAT_MOTION_BATCH, RS2_STREAM_GYRO} },
+            { {RS2_FORMAT_MOTION_BATCH, RS2_STREAM_GYRO} },
+            [&, mm_correct_opt]() { return std::make_shared<gyroscope_transform>(_mm_calib, mm_correct_opt, RS2_FORMAT_MOTION_BATCH); }
+        );
         return hid_ep;
     }
 
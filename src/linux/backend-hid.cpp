@@ -607,6 +607,7 @@ namespace librealsense
 
                             sens_data.fo = {hid_data_size, metadata? meta_data.header.length: uint8_t(0),
                                             p_raw_data,  metadata? &meta_data : nullptr, now_ts};
+                            sens_data.batch_continues = i + 1 < sz;
                             //Linux HID provides timestamps in nanosec. Convert to usec (FW default)
                             if (metadata)
                             {
@@ -62,6 +62,12 @@ stream_profiles record_sensor::get_stream_profiles(int tag) const
 
 void librealsense::record_sensor::open(const stream_profiles& requests)
 {
+    // A bag holds a motion frame as one Imu message, which has no room for a batch of samples
+    for (auto&& request : requests)
+    {
+        if (request->get_format() == RS2_FORMAT_MOTION_BATCH)
+            throw invalid_value_exception("Recording RS2_FORMAT_MOTION_BATCH streams is not supported, record RS2_FORMAT_MOTION_XYZ32F instead");
+    }
     m_sensor.open(requests);
 }
 
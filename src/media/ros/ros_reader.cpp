@@ -444,7 +444,9 @@ namespace librealsense
         frame->get_stream()->set_format(stream_format);
         frame->get_stream()->set_stream_index(int(stream_id.stream_index));
         frame->get_stream()->set_stream_type(stream_id.stream_type);
-        video_frame->data = std::move(msg->data);
+        // Not moved: the message's std::vector cannot become a frame_buffer, whose memory comes from the
+        // frame allocator and goes back to the frame pool. The buffer is already sized, so this is one memcpy
+        std::copy(msg->data.begin(), msg->data.end(), video_frame->data.begin());
         librealsense::frame_holder fh{ video_frame };
         LOG_DEBUG("Created image frame: " << stream_id << " " << video_frame->get_width() << "x" << video_frame->get_height() << " " << stream_format);
 
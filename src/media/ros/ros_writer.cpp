@@ -102,15 +102,16 @@ namespace librealsense
         timestamp_domain.value = librealsense::get_string(frame->get_frame_timestamp_domain());
         write_message(metadata_topic, timestamp, timestamp_domain);
 
+        frame_metadata_values metadata;
+        frame->get_all_frame_metadata(metadata);
         for (int i = 0; i < static_cast<rs2_frame_metadata_value>(rs2_frame_metadata_value::RS2_FRAME_METADATA_COUNT); i++)
         {
             rs2_frame_metadata_value type = static_cast<rs2_frame_metadata_value>(i);
-            if (frame->supports_frame_metadata(type))
+            if (metadata.supported[i])
             {
-                auto md = frame->get_frame_metadata(type);
                 diagnostic_msgs::KeyValue md_msg;
                 md_msg.key = librealsense::get_string(type);
-                md_msg.value = std::to_string(md);
+                md_msg.value = std::to_string(metadata.values[i]);
                 write_message(metadata_topic, timestamp, md_msg);
             }
         }
@@ -202,6 +203,10 @@ namespace librealsense
         {
             throw io_exception("Null frame passed to write_motion_frame");
         }
+        if (frame.frame->get_stream()->get_format() == RS2_FORMAT_MOTION_BATCH)
+        {
+            throw io_exception("Motion frames of RS2_FORMAT_MOTION_BATCH cannot be written");
+        }
 
         imu_msg.header.seq = static_cast<uint32_t>(frame.frame->get_frame_number());
         std::chrono::duration<double, std::milli> timestamp_ms(frame.frame->get_frame_timestamp());
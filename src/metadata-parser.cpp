@@ -0,0 +1,106 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "metadata-parser.h"
+
+namespace librealsense
+{
+    template<class T> static T read_md(const uint8_t* p)
+    {
+        T value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint64_t read_md_unsigned(const uint8_t* p, uint32_t width)
+    {
+        switch (width)
+        {
+        case 1: return read_md<uint8_t>(p);
+        case 2: return read_md<uint16_t>(p);
+        case 4: return read_md<uint32_t>(p);
+        default: return read_md<uint64_t>(p);
+        }
+    }
+
+    static int64_t read_md_signed(const uint8_t* p, uint32_t width)
+    {
+        switch (width)
+        {
+        case 1: return read_md<int8_t>(p);
+        case 2: return read_md<int16_t>(p);
+        case 4: return read_md<int32_t>(p);
+        default: return read_md<int64_t>(p);
+        }
+    }
+
+    bool read_md_field(const md_field& field, const frame_additional_data& data, rs2_metadata_type& value)
+    {
+        auto blob = data.metadata_blob.data();
+
+        // The same checks as the parsers', all of them whichever fails
+        bool valid = data.metadata_size >= field.min_size;
+        if (field.struct_size)
+            valid &= (read_md<uint32_t>(blob + field.header_offset) == field.type_id)
+                & (read_md<uint32_t>(blob + field.header_offset + sizeof(uint32_t)) >= field.struct_size);
+        if (field.flags_width)
+            valid &= (read_md_unsigned(blob + field.flags_offset, field.flags_width) & field.flag_mask) != 0;
+        if (!valid)
+            return false;
+
+        value = field.value_signed ? static_cast<rs2_metadata_type>(read_md_signed(blob + field.value_offset, field.value_width))
+                                   : static_cast<rs2_metadata_type>(read_md_unsigned(blob + field.value_offset, field.value_width));
+        value &= field.value_mask;
+        if (field.modifier)
+            value = field.modifier(value);
+        return true;
+    }
+
+    metadata_parser_table::metadata_parser_table(const metadata_parser_map& parsers)
+    {
+        _entries.reserve(parsers.size());
+        for (auto&& parser : parsers)
+        {
+            // The internal attributes are past RS2_FRAME_METADATA_COUNT, and only queried one at a time
+            if (parser.first < 0 || parser.first >= ::RS2_FRAME_METADATA_COUNT)
+                continue;
+
+            entry e{ parser.first, false, {}, nullptr };
+            e.is_field = parser.second->get_field(e.field);
+            if (!e.is_field)
+                e.parser = parser.second;
+            _entries.push_back(std::move(e));
+        }
+    }
+
+    void metadata_parser_table::decode(const frame& frm, frame_metadata_values& metadata) const
+    {
+        for (auto&& e : _entries)
+        {
+            if (metadata.supported[e.attribute])
+                continue;
+
+            rs2_metadata_type value = 0;
+            if (e.is_field)
+            {
+                if (!read_md_field(e.field, frm.additional_data, value))
+                    continue;
+            }
+            else
+            {
+                if (!e.parser->supports(frm))
+                    continue;
+                try
+                {
+                    value = e.parser->get(frm);
+                }
+                catch (invalid_value_exception&)
+                {
+                    continue;
+                }
+            }
+            metadata.values[e.attribute] = value;
+            metadata.supported.set(e.attribute);
+        }
+    }
+}
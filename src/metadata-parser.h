@@ -23,12 +23,36 @@ namespace librealsense
         RS2_FRAME_METADATA_COUNT
     };
 
+    /**\brief Post-processing adjustment of the metadata attribute
+     *  e.g change auto_exposure enum to boolean, change units from nano->ms,etc'*/
+    typedef std::function<rs2_metadata_type(const rs2_metadata_type& param)> attrib_modifyer;
+
+    /**\brief Where an attribute is in the metadata blob and how to tell it is valid, for the parsers
+     *  that read it from the blob only. Offsets are from the start of the blob*/
+    struct md_field
+    {
+        uint32_t        min_size = 0;       // Of the metadata
+        uint32_t        struct_size = 0;    // Of the md_header'ed struct holding the attribute; 0 for no md_header
+        uint32_t        header_offset = 0;
+        uint32_t        type_id = 0;        // Expected in the md_header
+        uint32_t        flags_width = 0;    // In bytes; 0 when no flag tells whether the attribute is valid
+        uint32_t        flags_offset = 0;
+        uint32_t        flag_mask = 0;
+        uint32_t        value_width = 0;    // In bytes
+        uint32_t        value_offset = 0;
+        bool            value_signed = false;
+        uint64_t        value_mask = ~0ull;
+        attrib_modifyer modifier;
+    };
+
     /**\brief Base class that establishes the interface for retrieving metadata attributes*/
     class md_attribute_parser_base
     {
     public:
         virtual rs2_metadata_type get(const frame& frm) const = 0;
         virtual bool supports(const frame& frm) const = 0;
+        // For the parsers that only read the metadata blob: fills in where they read from
+        virtual bool get_field(md_field& field) const { return false; }
 
         virtual ~md_attribute_parser_base() = default;
     };
@@ -85,10 +109,6 @@ namespace librealsense
     };
 
 
-    /**\brief Post-processing adjustment of the metadata attribute
-     *  e.g change auto_exposure enum to boolean, change units from nano->ms,etc'*/
-    typedef std::function<rs2_metadata_type(const rs2_metadata_type& param)> attrib_modifyer;
-
     class md_time_of_arrival_parser : public md_attribute_parser_base
     {
     public:
@@ -103,6 +123,29 @@ namespace librealsense
         }
     };
 
+    template<class T, bool = std::is_enum<T>::value> struct md_integer { typedef T type; };
+    template<class T> struct md_integer<T, true> { typedef typename std::underlying_type<T>::type type; };
+
+    // Sets the value of the field to the member of a struct at offset in the blob; false for members
+    // that are no integers, or out of the blob
+    template<class S, class Attribute>
+    bool set_md_field_value(md_field& field, Attribute S::* attribute, unsigned long long offset)
+    {
+        typedef typename md_integer<Attribute>::type integer;
+        if (!std::is_integral<integer>::value || sizeof(integer) > sizeof(uint64_t))
+            return false;
+
+        S s{};
+        auto member = reinterpret_cast<const uint8_t*>(&(s.*attribute)) - reinterpret_cast<const uint8_t*>(&s);
+        if (offset + member + sizeof(integer) > MAX_META_DATA_SIZE)
+            return false;
+
+        field.value_offset = static_cast<uint32_t>(offset + member);
+        field.value_width = sizeof(integer);
+        field.value_signed = std::is_signed<integer>::value;
+        return true;
+    }
+
     /**\brief The metadata parser class directly access the metadata attribute in the blob received from HW.
     *   Given the metadata-nested construct, and the c++ lack of pointers
     *   to the inner struct, we pre-calculate and store the attribute offset internally
@@ -134,6 +177,25 @@ namespace librealsense
             return is_attribute_valid(s);
         }
 
+        bool get_field(md_field& field) const override
+        {
+            S s{};
+            auto base = reinterpret_cast<const uint8_t*>(&s);
+            auto header = reinterpret_cast<const uint8_t*>(&s.header) - base;
+            auto flags = reinterpret_cast<const uint8_t*>(&s.flags) - base;
+            if (_offset + sizeof(S) > MAX_META_DATA_SIZE || !set_md_field_value(field, _md_attribute, _offset))
+                return false;
+
+            field.struct_size = sizeof(S);
+            field.header_offset = static_cast<uint32_t>(_offset + header);
+            field.type_id = static_cast<uint32_t>(md_type_trait<S>::type);
+            field.flags_width = sizeof(s.flags);
+            field.flags_offset = static_cast<uint32_t>(_offset + flags);
+            field.flag_mask = static_cast<uint32_t>(_md_flag);
+            field.modifier = _modifyer;
+            return true;
+        }
+
     protected:
 
             bool is_attribute_valid(const S* s) const
@@ -201,6 +263,15 @@ namespace librealsense
         bool supports(const librealsense::frame & frm) const override
         { return (frm.additional_data.metadata_size >= platform::uvc_header_size); }
 
+        bool get_field(md_field& field) const override
+        {
+            if (!set_md_field_value(field, _md_attribute, 0))
+                return false;
+            field.min_size = platform::uvc_header_size;
+            field.modifier = _modifyer;
+            return true;
+        }
+
     private:
         md_uvc_header_parser() = delete;
         md_uvc_header_parser(const md_uvc_header_parser&) = delete;
@@ -241,6 +312,16 @@ namespace librealsense
             return (frm.additional_data.metadata_size >= platform::hid_header_size);
         }
 
+        bool get_field(md_field& field) const override
+        {
+            if (!set_md_field_value(field, _md_attribute, 0))
+                return false;
+            field.min_size = platform::hid_header_size;
+            field.value_mask = 0x00000000ffffffff;
+            field.modifier = _modifyer;
+            return true;
+        }
+
     private:
         md_hid_header_parser() = delete;
         md_hid_header_parser(const md_hid_header_parser&) = delete;
@@ -437,6 +518,15 @@ namespace librealsense
             return (frm.additional_data.metadata_size >= (sizeof(S) + platform::uvc_header_size));
         }
 
+        bool get_field(md_field& field) const override
+        {
+            if (!set_md_field_value(field, _md_attribute, _offset))
+                return false;
+            field.min_size = sizeof(S) + platform::uvc_header_size;
+            field.modifier = _modifyer;
+            return true;
+        }
+
     private:
         md_sr300_attribute_parser() = delete;
         md_sr300_attribute_parser(const md_sr300_attribute_parser&) = delete;
@@ -454,4 +544,29 @@ namespace librealsense
         std::shared_ptr<md_sr300_attribute_parser<S, Attribute>> parser(new md_sr300_attribute_parser<S, Attribute>(attribute, offset, mod));
         return parser;
     }
+
+    /**\brief The parsers of a metadata_parser_map, in its order, compiled when streaming starts. Those that
+     *  only read the metadata blob become md_fields, read by one function instead of their virtual calls*/
+    class metadata_parser_table
+    {
+    public:
+        explicit metadata_parser_table(const metadata_parser_map& parsers);
+
+        // The attributes of the frame, as the first of their parsers that supports it gives them, into
+        // metadata that is cleared
+        void decode(const frame& frm, frame_metadata_values& metadata) const;
+
+    private:
+        struct entry
+        {
+            rs2_frame_metadata_value                    attribute;
+            bool                                        is_field;
+            md_field                                    field;
+            std::shared_ptr<md_attribute_parser_base>   parser;     // When not a field
+        };
+        std::vector<entry> _entries;
+    };
+
+    // The attribute in the metadata, if it's valid there
+    bool read_md_field(const md_field& field, const frame_additional_data& data, rs2_metadata_type& value);
 }
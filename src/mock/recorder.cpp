@@ -1485,6 +1485,7 @@ namespace librealsense
                     sd.fo.metadata_size = static_cast<uint8_t>(metadata.size());
 
                     sd.sensor.name = sensor_name;
+                    sd.batch_continues = false;
 
                     _callback(sd);
                 }
@@ -83,6 +83,9 @@ namespace librealsense
                     return false;
                 if (a->get_format() != RS2_FORMAT_ANY && b.format != RS2_FORMAT_ANY && (a->get_format() != b.format))
                     return false;
+                // Batches of motion samples change what a frame holds, so only come when asked for by name
+                if (a->get_format() == RS2_FORMAT_MOTION_BATCH && b.format != RS2_FORMAT_MOTION_BATCH)
+                    return false;
                 if (a->get_framerate() != 0 && b.fps != 0 && (a->get_framerate() != b.fps))
                     return false;
 
@@ -185,6 +188,8 @@ namespace librealsense
 
                 for (auto profile : profiles)
                 {
+                    if (profile->get_format() == RS2_FORMAT_MOTION_BATCH)
+                        continue;
                     profiles_map[std::make_tuple(profile->get_unique_id(), profile->get_stream_index())].push_back(profile);
                 }
 
@@ -3,67 +3,173 @@
 
 #include "../include/librealsense2/hpp/rs_sensor.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "../include/librealsense2/hpp/rs_device.hpp"
 #include "../include/librealsense2/rsutil.h"
 
 #include "core/video.h"
 #include "proc/synthetic-stream.h"
 #include "environment.h"
+#include "thread-pool.h"
+#include "device-calibration.h"
 #include "align.h"
 #include "stream.h"
 
+#include <cstring>
+
 namespace librealsense
 {
     template<int N> struct bytes { byte b[N]; };
 
-    template<class GET_DEPTH, class TRANSFER_PIXEL>
-    void align_images(const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other,
-        const rs2_intrinsics& other_intrin, GET_DEPTH get_depth, TRANSFER_PIXEL transfer_pixel)
+    // Depth rows per band of the depth to other transfer
+    static const int align_band_rows = 32;
+
+    void align::prepare_corners(const rs2_intrinsics& depth_intrin)
+    {
+        update_rays(depth_intrin);
+        _pixel_top_left.resize(depth_intrin.width * depth_intrin.height);
+        _pixel_bottom_right.resize(depth_intrin.width * depth_intrin.height);
+        _row_span.resize(depth_intrin.height);
+    }
+
+    void align::map_row(int depth_y, const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other,
+        const rs2_intrinsics& other_intrin, const uint16_t* z_pixels, float z_scale)
     {
-        // Iterate over the pixels of the depth image
-#pragma omp parallel for schedule(dynamic)
-        for (int depth_y = 0; depth_y < depth_intrin.height; ++depth_y)
+        const int width = depth_intrin.width;
+        const int depth_pixel_index = depth_y * width;
+        auto top_left = _pixel_top_left.data() + depth_pixel_index;
+        auto bottom_right = _pixel_bottom_right.data() + depth_pixel_index;
+
+        // Map the corners of the depth pixels onto the other image
+        corner_row row = { z_pixels + depth_pixel_index, width,
+            _rays_x.data() + depth_y * (width + 1), _rays_y.data() + depth_y * (width + 1),
+            _rays_x.data() + (depth_y + 1) * (width + 1), _rays_y.data() + (depth_y + 1) * (width + 1) };
+        map_corners(row, z_scale, other_intrin, depth_to_other, top_left, bottom_right);
+
+        int2 span = { other_intrin.height, -1 };
+        for (int depth_x = 0; depth_x < width; ++depth_x)
         {
-            int depth_pixel_index = depth_y * depth_intrin.width;
-            for (int depth_x = 0; depth_x < depth_intrin.width; ++depth_x, ++depth_pixel_index)
+            // Depth pixels with the value of zero map nowhere: we have no depth data so we will not write anything into our aligned images
+            if (top_left[depth_x].x < 0 || top_left[depth_x].y < 0 ||
+                bottom_right[depth_x].x >= other_intrin.width || bottom_right[depth_x].y >= other_intrin.height)
             {
-                // Skip over depth pixels with the value of zero, we have no depth data so we will not write anything into our aligned images
-                if (float depth = get_depth(depth_pixel_index))
-                {
-                    // Map the top-left corner of the depth pixel onto the other image
-                    float depth_pixel[2] = { depth_x - 0.5f, depth_y - 0.5f }, depth_point[3], other_point[3], other_pixel[2];
-                    rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
-                    rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
-                    rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
-                    const int other_x0 = static_cast<int>(other_pixel[0] + 0.5f);
-                    const int other_y0 = static_cast<int>(other_pixel[1] + 0.5f);
-
-                    // Map the bottom-right corner of the depth pixel onto the other image
-                    depth_pixel[0] = depth_x + 0.5f; depth_pixel[1] = depth_y + 0.5f;
-                    rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
-                    rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
-                    rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
-                    const int other_x1 = static_cast<int>(other_pixel[0] + 0.5f);
-                    const int other_y1 = static_cast<int>(other_pixel[1] + 0.5f);
-
-                    if (other_x0 < 0 || other_y0 < 0 || other_x1 >= other_intrin.width || other_y1 >= other_intrin.height)
-                        continue;
-
-                    // Transfer between the depth pixels and the pixels inside the rectangle on the other image
-                    for (int y = other_y0; y <= other_y1; ++y)
-                    {
-                        for (int x = other_x0; x <= other_x1; ++x)
-                        {
-                            transfer_pixel(depth_pixel_index, y * other_intrin.width + x);
-                        }
-                    }
-                }
+                top_left[depth_x].x = -1;
+                continue;
+            }
+            span.x = std::min(span.x, top_left[depth_x].y);
+            span.y = std::max(span.y, bottom_right[depth_x].y);
+        }
+        _row_span[depth_y] = span;
+    }
+
+    void align::map_corners(const corner_row& row, float z_scale,
+        const rs2_intrinsics& other_intrin, const rs2_extrinsics& depth_to_other,
+        int2* top_left, int2* bottom_right)
+    {
+        for (int depth_x = 0; depth_x < row.width; ++depth_x)
+        {
+            if (float depth = z_scale * row.depth[depth_x])
+            {
+                // Map the top-left corner of the depth pixel onto the other image
+                float depth_point[3] = { depth * row.top_x[depth_x], depth * row.top_y[depth_x], depth }, other_point[3], other_pixel[2];
+                rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
+                rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
+                top_left[depth_x] = { static_cast<int>(other_pixel[0] + 0.5f), static_cast<int>(other_pixel[1] + 0.5f) };
+
+                // Map the bottom-right corner of the depth pixel onto the other image
+                depth_point[0] = depth * row.bottom_x[depth_x + 1];
+                depth_point[1] = depth * row.bottom_y[depth_x + 1];
+                rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
+                rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
+                bottom_right[depth_x] = { static_cast<int>(other_pixel[0] + 0.5f), static_cast<int>(other_pixel[1] + 0.5f) };
+            }
+            else
+            {
+                top_left[depth_x] = bottom_right[depth_x] = { -1, -1 };
             }
         }
     }
 
+    void align::update_rays(const rs2_intrinsics& depth_intrin)
+    {
+        // A calibration change may update the intrinsics of the same profile
+        if (_calibration_changed->exchange(false))
+            _rays_valid = false;
+        if (_rays_valid && !std::memcmp(&_rays_intrinsics, &depth_intrin, sizeof(rs2_intrinsics)))
+            return;
+
+        const int width = depth_intrin.width + 1;
+        _rays_x.resize(width * (depth_intrin.height + 1));
+        _rays_y.resize(width * (depth_intrin.height + 1));
+
+        // The deprojection, whatever the model, is linear in depth
+        parallel_for(depth_intrin.height + 1, [&](int y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const float pixel[] = { x - 0.5f, y - 0.5f };
+                float point[3];
+                rs2_deproject_pixel_to_point(point, &depth_intrin, pixel, 1.f);
+                _rays_x[y * width + x] = point[0];
+                _rays_y[y * width + x] = point[1];
+            }
+        });
+
+        _rays_intrinsics = depth_intrin;
+        _rays_valid = true;
+    }
+
+    void align::reset_cache(rs2_stream from, rs2_stream to)
+    {
+        _rays_valid = false;
+    }
+
+    void align::register_calibration_change(const rs2::frame& depth)
+    {
+        if (_calibration_callback_registered)
+            return;
+        _calibration_callback_registered = true;
+
+        auto sensor = ((frame_interface*)depth.get())->get_sensor();
+        if (!sensor)
+            return;
+        auto d2r = dynamic_cast<calibration_change_device*>(&sensor->get_device());
+        if (!d2r)
+            return;
+
+        try
+        {
+            _calibration_device = sensor->get_device().shared_from_this();
+        }
+        catch (const std::bad_weak_ptr&)
+        {
+            LOG_WARNING("Device destroyed");
+            return;
+        }
+
+        // The callback may outlive the block
+        std::weak_ptr<std::atomic<bool>> changed = _calibration_changed;
+        auto fn = [changed](rs2_calibration_status status) {
+            auto flag = changed.lock();
+            if (flag && status == RS2_CALIBRATION_SUCCESSFUL)
+                *flag = true;
+        };
+        _calibration_callback = {
+            new rs2::calibration_change_callback<decltype(fn)>(std::move(fn)),
+            [](rs2_calibration_change_callback* p) { p->release(); } };
+        d2r->register_calibration_change_callback(_calibration_callback);
+    }
+
     align::align(rs2_stream to_stream) : align(to_stream, "Align")
     {}
 
+    align::~align()
+    {
+        // The device would otherwise keep the callback of every align block it ever fed
+        if (auto device = _calibration_device.lock())
+            if (auto d2r = dynamic_cast<calibration_change_device*>(device.get()))
+                d2r->unregister_calibration_change_callback(_calibration_callback);
+    }
+
     void align::align_z_to_other(rs2::video_frame& aligned, 
         const rs2::video_frame& depth, const rs2::video_stream_profile& other_profile, float z_scale)
     {
@@ -80,48 +186,86 @@ namespace librealsense
         auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
         auto out_z = (uint16_t *)(aligned_data);
 
-        align_images(z_intrin, z_to_other, other_intrin,
-            [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; },
-            [out_z, z_pixels](int z_pixel_index, int other_pixel_index)
+        prepare_corners(z_intrin);
+        parallel_for(z_intrin.height, [&](int z_y)
         {
-            out_z[other_pixel_index] = out_z[other_pixel_index] ?
-                std::min((int)out_z[other_pixel_index], (int)z_pixels[z_pixel_index]) :
-                z_pixels[z_pixel_index];
+            map_row(z_y, z_intrin, z_to_other, other_intrin, z_pixels, z_scale);
         });
+
+        // The rows of the other image that each band of depth rows maps to
+        const int bands = (z_intrin.height + align_band_rows - 1) / align_band_rows;
+        std::vector<int2> band_spans(bands, { other_intrin.height, -1 });
+        for (int z_y = 0; z_y < z_intrin.height; ++z_y)
+        {
+            auto& span = band_spans[z_y / align_band_rows];
+            span.x = std::min(span.x, _row_span[z_y].x);
+            span.y = std::max(span.y, _row_span[z_y].y);
+        }
+
+        // Several depth pixels may map to the same pixel, where the nearest depth wins. The bands are
+        // transferred every other one at a time, so that the threads do not write to the same rows;
+        // where they would, because of the parallax of near objects, they take turns.
+        bool separate = true;
+        for (int b = 0; b < bands; ++b)
+            for (int other = b + 2; other < bands; other += 2)
+                if (band_spans[b].x <= band_spans[other].y && band_spans[other].x <= band_spans[b].y)
+                    separate = false;
+
+        auto transfer_band = [&](int b)
+        {
+            const int band_end = std::min(z_intrin.height, (b + 1) * align_band_rows);
+            for (int z_pixel_index = b * align_band_rows * z_intrin.width; z_pixel_index < band_end * z_intrin.width; ++z_pixel_index)
+            {
+                auto& top_left = _pixel_top_left[z_pixel_index];
+                auto& bottom_right = _pixel_bottom_right[z_pixel_index];
+                if (top_left.x < 0)
+                    continue;
+
+                // The nearest depth wins, where 0 is none
+                const uint16_t z = z_pixels[z_pixel_index];
+                for (int y = top_left.y; y <= bottom_right.y; ++y)
+                {
+                    auto out = out_z + y * other_intrin.width;
+                    for (int x = top_left.x; x <= bottom_right.x; ++x)
+                        out[x] = uint16_t(out[x] - 1) < z ? out[x] : z;
+                }
+            }
+        };
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const int pass_bands = (bands - pass + 1) / 2;
+            if (separate)
+                parallel_for(pass_bands, [&](int i) { transfer_band(pass + 2 * i); });
+            else
+                for (int i = 0; i < pass_bands; ++i)
+                    transfer_band(pass + 2 * i);
+        }
     }
 
-    template<int N, class GET_DEPTH>
-    void align_other_to_depth_bytes(byte* other_aligned_to_depth, GET_DEPTH get_depth, const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin, const byte* other_pixels)
+    template<int N>
+    void align::align_other_to_depth_bytes(byte* other_aligned_to_depth, const rs2_intrinsics& depth_intrin,
+        const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin,
+        const uint16_t* z_pixels, float z_scale, const byte* other_pixels)
     {
         auto in_other = (const bytes<N> *)(other_pixels);
         auto out_other = (bytes<N> *)(other_aligned_to_depth);
-        align_images(depth_intrin, depth_to_other, other_intrin, get_depth,
-            [out_other, in_other](int depth_pixel_index, int other_pixel_index) { out_other[depth_pixel_index] = in_other[other_pixel_index]; });
-    }
-
-    template<class GET_DEPTH>
-    void align_other_to_depth(byte* other_aligned_to_depth, GET_DEPTH get_depth, const rs2_intrinsics& depth_intrin, const rs2_extrinsics & depth_to_other, const rs2_intrinsics& other_intrin, const byte* other_pixels, rs2_format other_format)
-    {
-        switch (other_format)
+        prepare_corners(depth_intrin);
+        parallel_for(depth_intrin.height, [&](int depth_y)
         {
-        case RS2_FORMAT_Y8:
-            align_other_to_depth_bytes<1>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
-            break;
-        case RS2_FORMAT_Y16:
-        case RS2_FORMAT_Z16:
-            align_other_to_depth_bytes<2>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
-            break;
-        case RS2_FORMAT_RGB8:
-        case RS2_FORMAT_BGR8:
-            align_other_to_depth_bytes<3>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
-            break;
-        case RS2_FORMAT_RGBA8:
-        case RS2_FORMAT_BGRA8:
-            align_other_to_depth_bytes<4>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
-            break;
-        default:
-            assert(false); // NOTE: rs2_align_other_to_depth_bytes<2>(...) is not appropriate for RS2_FORMAT_YUYV/RS2_FORMAT_RAW10 images, no logic prevents U/V channels from being written to one another
-        }
+            map_row(depth_y, depth_intrin, depth_to_other, other_intrin, z_pixels, z_scale);
+
+            // Every pixel of the rectangle on the other image would be copied in turn to the depth
+            // pixel: the last one stays
+            const int depth_pixel_index = depth_y * depth_intrin.width;
+            auto top_left = _pixel_top_left.data() + depth_pixel_index;
+            auto bottom_right = _pixel_bottom_right.data() + depth_pixel_index;
+            for (int depth_x = 0; depth_x < depth_intrin.width; ++depth_x)
+            {
+                if (top_left[depth_x].x >= 0 && top_left[depth_x].x <= bottom_right[depth_x].x && top_left[depth_x].y <= bottom_right[depth_x].y)
+                    out_other[depth_pixel_index + depth_x] = in_other[bottom_right[depth_x].y * other_intrin.width + bottom_right[depth_x].x];
+            }
+        });
     }
 
     void align::align_other_to_z(rs2::video_frame& aligned, const rs2::video_frame& depth, const rs2::video_frame& other, float z_scale)
@@ -140,8 +284,26 @@ namespace librealsense
         auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
         auto other_pixels = reinterpret_cast<const byte*>(other.get_data());
 
-        align_other_to_depth(aligned_data, [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; },
-            z_intrin, z_to_other, other_intrin, other_pixels, other_profile.format());
+        switch (other_profile.format())
+        {
+        case RS2_FORMAT_Y8:
+            align_other_to_depth_bytes<1>(aligned_data, z_intrin, z_to_other, other_intrin, z_pixels, z_scale, other_pixels);
+            break;
+        case RS2_FORMAT_Y16:
+        case RS2_FORMAT_Z16:
+            align_other_to_depth_bytes<2>(aligned_data, z_intrin, z_to_other, other_intrin, z_pixels, z_scale, other_pixels);
+            break;
+        case RS2_FORMAT_RGB8:
+        case RS2_FORMAT_BGR8:
+            align_other_to_depth_bytes<3>(aligned_data, z_intrin, z_to_other, other_intrin, z_pixels, z_scale, other_pixels);
+            break;
+        case RS2_FORMAT_RGBA8:
+        case RS2_FORMAT_BGRA8:
+            align_other_to_depth_bytes<4>(aligned_data, z_intrin, z_to_other, other_intrin, z_pixels, z_scale, other_pixels);
+            break;
+        default:
+            assert(false); // NOTE: rs2_align_other_to_depth_bytes<2>(...) is not appropriate for RS2_FORMAT_YUYV/RS2_FORMAT_RAW10 images, no logic prevents U/V channels from being written to one another
+        }
     }
 
     std::shared_ptr<rs2::video_stream_profile> align::create_aligned_profile(
@@ -257,6 +419,7 @@ namespace librealsense
         auto depth = frames.first_or_default(RS2_STREAM_DEPTH, RS2_FORMAT_Z16).as<rs2::depth_frame>();
 
         _depth_scale = ((librealsense::depth_frame*)depth.get())->get_units();
+        register_calibration_change(depth);
 
         if (_to_stream_type == RS2_STREAM_DEPTH)
             frames.foreach_rs([&other_frames](const rs2::frame& f) {if ((f.get_profile().stream_type() != RS2_STREAM_DEPTH) && f.is<rs2::video_frame>()) other_frames.push_back(f); });
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <utility>
 #include "core/processing.h"
@@ -16,17 +17,34 @@ namespace librealsense
     {
     public:
         align(rs2_stream to_stream);
+        ~align() override;
+
+        // A row of depth pixels, with the rays of the corners of its pixels deprojected at a depth of 1:
+        // the top-left corner of pixel x is at top_x[x], top_y[x], and its bottom-right one at
+        // bottom_x[x + 1], bottom_y[x + 1]
+        struct corner_row
+        {
+            const uint16_t* depth;
+            int width;
+            const float* top_x;
+            const float* top_y;
+            const float* bottom_x;
+            const float* bottom_y;
+        };
 
     protected:
         align(rs2_stream to_stream, const char* name)
             : generic_processing_block(name), 
-              _to_stream_type(to_stream), _depth_scale(0)
+              _to_stream_type(to_stream), _depth_scale(0),
+              _rays_valid(false),
+              _calibration_changed(std::make_shared<std::atomic<bool>>(false)),
+              _calibration_callback_registered(false)
         {}
 
         bool should_process(const rs2::frame& frame) override;
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
-        virtual void reset_cache(rs2_stream from, rs2_stream to) {}
+        virtual void reset_cache(rs2_stream from, rs2_stream to);
 
         virtual void align_z_to_other(rs2::video_frame& aligned, 
                                       const rs2::video_frame& depth, 
@@ -40,6 +58,13 @@ namespace librealsense
 
         virtual rs2_extension select_extension(const rs2::frame& input);
 
+        // The pixels of the other image that the top-left and bottom-right corners of the depth pixels
+        // of a row map to, rounded as rs2_project_point_to_pixel + 0.5f, or -1 where there is no depth
+        virtual void map_corners(const corner_row& row, float z_scale,
+                                 const rs2_intrinsics& other_intrin,
+                                 const rs2_extrinsics& depth_to_other,
+                                 int2* top_left, int2* bottom_right);
+
         std::shared_ptr<rs2::video_stream_profile> create_aligned_profile(
             rs2::video_stream_profile& original_profile,
             rs2::video_stream_profile& to_profile);
@@ -52,5 +77,34 @@ namespace librealsense
     private:
         rs2::video_frame allocate_aligned_frame(const rs2::frame_source& source, const rs2::video_frame& from, const rs2::video_frame& to);
         void align_frames(rs2::video_frame& aligned, const rs2::video_frame& from, const rs2::video_frame& to);
+
+        void prepare_corners(const rs2_intrinsics& depth_intrin);
+        void map_row(int depth_y, const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other,
+                     const rs2_intrinsics& other_intrin, const uint16_t* z_pixels, float z_scale);
+        template<int N>
+        void align_other_to_depth_bytes(byte* other_aligned_to_depth, const rs2_intrinsics& depth_intrin,
+                                        const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin,
+                                        const uint16_t* z_pixels, float z_scale, const byte* other_pixels);
+
+        void update_rays(const rs2_intrinsics& depth_intrin);
+        void register_calibration_change(const rs2::frame& depth);
+
+        // The deprojection of the corners of all the depth pixels at a depth of 1, a grid of
+        // (width + 1) x (height + 1) rays: kept across frames for as long as the depth intrinsics
+        // stay the same, and the calibration of the device does not change
+        rs2_intrinsics _rays_intrinsics;
+        bool _rays_valid;
+        std::vector<float> _rays_x;
+        std::vector<float> _rays_y;
+        std::shared_ptr<std::atomic<bool>> _calibration_changed;
+        bool _calibration_callback_registered;
+        std::weak_ptr<device_interface> _calibration_device;
+        calibration_change_callback_ptr _calibration_callback;
+
+        // The rectangles of the other image that the depth pixels map to, or -1 where they map
+        // nowhere, and the first and last rows of the other image that each depth row maps to
+        std::vector<int2> _pixel_top_left;
+        std::vector<int2> _pixel_bottom_right;
+        std::vector<int2> _row_span;
     };
 }
@@ -0,0 +1,148 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rsutil.h>
+
+#include "avx-align.h"
+
+#ifdef __SSSE3__
+
+#include <immintrin.h>
+
+// The rest of the library is built without AVX: only these functions may use it. FMA is not
+// enabled, so that the results are the same as those of the scalar code.
+#if defined(__GNUC__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+
+namespace librealsense
+{
+    // rs2_transform_point_to_point and rs2_project_point_to_pixel of 8 points at a time, where the
+    // modified and inverse Brown-Conrady models are the same projection
+    template<rs2_distortion MODEL>
+    struct corner_projection
+    {
+        __m256 r[9], t[3];
+        __m256 c0, c1, c2, c3, c4, c2x2, c3x2;
+        __m256 fx, fy, ppx, ppy;
+        __m256 one, two, half;
+
+        AVX2_TARGET corner_projection(const rs2_intrinsics& intrin, const rs2_extrinsics& extr)
+        {
+            for (int i = 0; i < 9; ++i)
+                r[i] = _mm256_set1_ps(extr.rotation[i]);
+            for (int i = 0; i < 3; ++i)
+                t[i] = _mm256_set1_ps(extr.translation[i]);
+
+            c0 = _mm256_set1_ps(intrin.coeffs[0]);
+            c1 = _mm256_set1_ps(intrin.coeffs[1]);
+            c2 = _mm256_set1_ps(intrin.coeffs[2]);
+            c3 = _mm256_set1_ps(intrin.coeffs[3]);
+            c4 = _mm256_set1_ps(intrin.coeffs[4]);
+            c2x2 = _mm256_set1_ps(2 * intrin.coeffs[2]);
+            c3x2 = _mm256_set1_ps(2 * intrin.coeffs[3]);
+            fx = _mm256_set1_ps(intrin.fx);
+            fy = _mm256_set1_ps(intrin.fy);
+            ppx = _mm256_set1_ps(intrin.ppx);
+            ppy = _mm256_set1_ps(intrin.ppy);
+            one = _mm256_set1_ps(1.f);
+            two = _mm256_set1_ps(2.f);
+            half = _mm256_set1_ps(0.5f);
+        }
+
+        // The pixels of the points at depth z on 8 rays, or -1 where the mask is set
+        AVX2_TARGET void map(int2* pixels, __m256 z, __m256i invalid, const float* ray_x, const float* ray_y) const
+        {
+            auto px = _mm256_mul_ps(z, _mm256_loadu_ps(ray_x));
+            auto py = _mm256_mul_ps(z, _mm256_loadu_ps(ray_y));
+
+            auto tx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[0], px), _mm256_mul_ps(r[3], py)), _mm256_mul_ps(r[6], z)), t[0]);
+            auto ty = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[1], px), _mm256_mul_ps(r[4], py)), _mm256_mul_ps(r[7], z)), t[1]);
+            auto tz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[2], px), _mm256_mul_ps(r[5], py)), _mm256_mul_ps(r[8], z)), t[2]);
+
+            auto x = _mm256_div_ps(tx, tz);
+            auto y = _mm256_div_ps(ty, tz);
+
+            if (MODEL != RS2_DISTORTION_NONE)
+            {
+                auto r2 = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+                auto f = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(one, _mm256_mul_ps(c0, r2)),
+                    _mm256_mul_ps(_mm256_mul_ps(c1, r2), r2)), _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(c4, r2), r2), r2));
+                auto xf = _mm256_mul_ps(x, f);
+                auto yf = _mm256_mul_ps(y, f);
+
+                // Brown-Conrady adds the tangential distortion of the undistorted point
+                auto xt = (MODEL == RS2_DISTORTION_BROWN_CONRADY) ? x : xf;
+                auto yt = (MODEL == RS2_DISTORTION_BROWN_CONRADY) ? y : yf;
+                x = _mm256_add_ps(_mm256_add_ps(xf, _mm256_mul_ps(_mm256_mul_ps(c2x2, xt), yt)),
+                    _mm256_mul_ps(c3, _mm256_add_ps(r2, _mm256_mul_ps(_mm256_mul_ps(two, xt), xt))));
+                y = _mm256_add_ps(_mm256_add_ps(yf, _mm256_mul_ps(_mm256_mul_ps(c3x2, xt), yt)),
+                    _mm256_mul_ps(c2, _mm256_add_ps(r2, _mm256_mul_ps(_mm256_mul_ps(two, yt), yt))));
+            }
+
+            // Truncated as static_cast<int> does
+            auto u = _mm256_add_ps(_mm256_mul_ps(x, fx), ppx);
+            auto v = _mm256_add_ps(_mm256_mul_ps(y, fy), ppy);
+            auto iu = _mm256_or_si256(invalid, _mm256_cvttps_epi32(_mm256_add_ps(u, half)));
+            auto iv = _mm256_or_si256(invalid, _mm256_cvttps_epi32(_mm256_add_ps(v, half)));
+
+            auto lo = _mm256_unpacklo_epi32(iu, iv);
+            auto hi = _mm256_unpackhi_epi32(iu, iv);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels), _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + 4), _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+    };
+
+    template<rs2_distortion MODEL>
+    static AVX2_TARGET int map_corners_avx2(const align::corner_row& row, float z_scale,
+        const rs2_intrinsics& other_intrin, const rs2_extrinsics& depth_to_other,
+        int2* top_left, int2* bottom_right)
+    {
+        corner_projection<MODEL> projection(other_intrin, depth_to_other);
+        auto scale = _mm256_set1_ps(z_scale);
+        auto zero = _mm256_setzero_ps();
+
+        int x = 0;
+        for (; x + 8 <= row.width; x += 8)
+        {
+            auto d = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row.depth + x)));
+            auto z = _mm256_mul_ps(scale, _mm256_cvtepi32_ps(d));
+            auto invalid = _mm256_castps_si256(_mm256_cmp_ps(z, zero, _CMP_EQ_OQ));
+
+            projection.map(top_left + x, z, invalid, row.top_x + x, row.top_y + x);
+            projection.map(bottom_right + x, z, invalid, row.bottom_x + x + 1, row.bottom_y + x + 1);
+        }
+        return x;
+    }
+
+    void align_avx2::map_corners(const corner_row& row, float z_scale,
+        const rs2_intrinsics& other_intrin, const rs2_extrinsics& depth_to_other,
+        int2* top_left, int2* bottom_right)
+    {
+        int done;
+        switch (other_intrin.model)
+        {
+        case RS2_DISTORTION_NONE:
+            done = map_corners_avx2<RS2_DISTORTION_NONE>(row, z_scale, other_intrin, depth_to_other, top_left, bottom_right);
+            break;
+        case RS2_DISTORTION_BROWN_CONRADY:
+            done = map_corners_avx2<RS2_DISTORTION_BROWN_CONRADY>(row, z_scale, other_intrin, depth_to_other, top_left, bottom_right);
+            break;
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+        case RS2_DISTORTION_INVERSE_BROWN_CONRADY:
+            done = map_corners_avx2<RS2_DISTORTION_INVERSE_BROWN_CONRADY>(row, z_scale, other_intrin, depth_to_other, top_left, bottom_right);
+            break;
+        default:
+            done = 0;
+        }
+
+        // The rest of the row
+        corner_row rest = { row.depth + done, row.width - done,
+            row.top_x + done, row.top_y + done, row.bottom_x + done, row.bottom_y + done };
+        align::map_corners(rest, z_scale, other_intrin, depth_to_other, top_left + done, bottom_right + done);
+    }
+}
+
+#endif
@@ -0,0 +1,26 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "../align.h"
+
+namespace librealsense
+{
+    // The generic align, with the corners of 8 depth pixels at a time mapped onto the other image
+    // with AVX2. Only the kernel is compiled for AVX2, and this block is only created when the CPU
+    // supports it (see cpu_has_avx2()).
+    //
+    // The output is that of the generic block, bit for bit, for no, Brown-Conrady and (modified or
+    // inverse) Brown-Conrady distortion of the other stream; other models are mapped by the generic block.
+    class align_avx2 : public align
+    {
+    public:
+        align_avx2(rs2_stream to_stream) : align(to_stream, "Align (AVX2)") {}
+
+    protected:
+        void map_corners(const corner_row& row, float z_scale,
+                         const rs2_intrinsics& other_intrin,
+                         const rs2_extrinsics& depth_to_other,
+                         int2* top_left, int2* bottom_right) override;
+    };
+}
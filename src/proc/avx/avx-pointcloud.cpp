@@ -0,0 +1,289 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/rsutil.h>
+
+#include "../synthetic-stream.h"
+#include "../../thread-pool.h"
+#include "avx-pointcloud.h"
+
+#include <algorithm>
+
+#ifdef __SSSE3__
+
+#include <immintrin.h>
+
+// The rest of the library is built without AVX: only these functions may use it. FMA is not
+// enabled, so that the results are the same as those of the scalar code.
+#if defined(__GNUC__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+
+namespace librealsense
+{
+    // Rows per band of the parallel loops: every band starts on a multiple of 8 pixels, so that its
+    // vector stores are aligned when those of the frame are
+    static const size_t pointcloud_band_rows = 8;
+
+    // x, y and z of 8 points from xyz xyz ...
+    static inline AVX2_TARGET void load_points(const float* p, __m256& x, __m256& y, __m256& z)
+    {
+        auto m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 12), 1);
+        auto m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 16), 1);
+        auto m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 8)), _mm_loadu_ps(p + 20), 1);
+
+        auto xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+        auto yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+        x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+        y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+        z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+    }
+
+    // The outputs are several times the size of the cache: when they are aligned, they are written
+    // around it, as in the SSE block
+    template<bool STREAM>
+    static inline AVX2_TARGET void store(float* p, __m128 v)
+    {
+        if (STREAM)
+            _mm_stream_ps(p, v);
+        else
+            _mm_storeu_ps(p, v);
+    }
+
+    // 8 points to xyz xyz ...
+    template<bool STREAM>
+    static inline AVX2_TARGET void store_points(float* p, __m256 x, __m256 y, __m256 z)
+    {
+        auto xy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+        auto yz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+        auto zx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+        auto m03 = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+        auto m14 = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+        auto m25 = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1));
+
+        store<STREAM>(p, _mm256_castps256_ps128(m03));
+        store<STREAM>(p + 4, _mm256_castps256_ps128(m14));
+        store<STREAM>(p + 8, _mm256_castps256_ps128(m25));
+        store<STREAM>(p + 12, _mm256_extractf128_ps(m03, 1));
+        store<STREAM>(p + 16, _mm256_extractf128_ps(m14, 1));
+        store<STREAM>(p + 20, _mm256_extractf128_ps(m25, 1));
+    }
+
+    // 8 pairs to uv uv ...
+    template<bool STREAM>
+    static inline AVX2_TARGET void store_pairs(float* p, __m256 u, __m256 v)
+    {
+        auto lo = _mm256_unpacklo_ps(u, v);
+        auto hi = _mm256_unpackhi_ps(u, v);
+        store<STREAM>(p, _mm256_castps256_ps128(lo));
+        store<STREAM>(p + 4, _mm256_castps256_ps128(hi));
+        store<STREAM>(p + 8, _mm256_extractf128_ps(lo, 1));
+        store<STREAM>(p + 12, _mm256_extractf128_ps(hi, 1));
+    }
+
+    template<bool STREAM>
+    static AVX2_TARGET void deproject_band(float* points, const uint16_t* depth,
+        const float* map_x, const float* map_y, size_t count, float depth_scale)
+    {
+        auto scale = _mm256_set1_ps(depth_scale);
+
+        size_t x = 0;
+        for (; x + 8 <= count; x += 8)
+        {
+            auto d = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(depth + x)));
+            auto z = _mm256_mul_ps(scale, _mm256_cvtepi32_ps(d));
+            store_points<STREAM>(points + x * 3,
+                _mm256_mul_ps(z, _mm256_loadu_ps(map_x + x)), _mm256_mul_ps(z, _mm256_loadu_ps(map_y + x)), z);
+        }
+        for (; x < count; ++x)
+        {
+            float z = depth_scale * depth[x];
+            points[x * 3] = z * map_x[x];
+            points[x * 3 + 1] = z * map_y[x];
+            points[x * 3 + 2] = z;
+        }
+    }
+
+    // rs2_transform_point_to_point and rs2_project_point_to_pixel of a band of points, where the
+    // modified and inverse Brown-Conrady models are the same projection
+    template<rs2_distortion MODEL, bool STREAM>
+    static AVX2_TARGET void texture_band(float* tex, float* pixels, const float* points, size_t count,
+        const rs2_intrinsics& intrin, const rs2_extrinsics& extr)
+    {
+        __m256 r[9], t[3];
+        for (int i = 0; i < 9; ++i)
+            r[i] = _mm256_set1_ps(extr.rotation[i]);
+        for (int i = 0; i < 3; ++i)
+            t[i] = _mm256_set1_ps(extr.translation[i]);
+
+        auto one = _mm256_set1_ps(1.f);
+        auto two = _mm256_set1_ps(2.f);
+        auto c0 = _mm256_set1_ps(intrin.coeffs[0]);
+        auto c1 = _mm256_set1_ps(intrin.coeffs[1]);
+        auto c2 = _mm256_set1_ps(intrin.coeffs[2]);
+        auto c3 = _mm256_set1_ps(intrin.coeffs[3]);
+        auto c4 = _mm256_set1_ps(intrin.coeffs[4]);
+        auto c2x2 = _mm256_set1_ps(2 * intrin.coeffs[2]);
+        auto c3x2 = _mm256_set1_ps(2 * intrin.coeffs[3]);
+        auto fx = _mm256_set1_ps(intrin.fx);
+        auto fy = _mm256_set1_ps(intrin.fy);
+        auto ppx = _mm256_set1_ps(intrin.ppx);
+        auto ppy = _mm256_set1_ps(intrin.ppy);
+        auto w = _mm256_set1_ps(float(intrin.width));
+        auto h = _mm256_set1_ps(float(intrin.height));
+        auto zero = _mm256_setzero_ps();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 px, py, pz;
+            load_points(points + i * 3, px, py, pz);
+            auto valid = _mm256_cmp_ps(pz, zero, _CMP_NEQ_UQ);
+
+            auto tx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[0], px), _mm256_mul_ps(r[3], py)), _mm256_mul_ps(r[6], pz)), t[0]);
+            auto ty = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[1], px), _mm256_mul_ps(r[4], py)), _mm256_mul_ps(r[7], pz)), t[1]);
+            auto tz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[2], px), _mm256_mul_ps(r[5], py)), _mm256_mul_ps(r[8], pz)), t[2]);
+
+            auto x = _mm256_div_ps(tx, tz);
+            auto y = _mm256_div_ps(ty, tz);
+
+            if (MODEL != RS2_DISTORTION_NONE)
+            {
+                auto r2 = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+                auto f = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(one, _mm256_mul_ps(c0, r2)),
+                    _mm256_mul_ps(_mm256_mul_ps(c1, r2), r2)), _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(c4, r2), r2), r2));
+                auto xf = _mm256_mul_ps(x, f);
+                auto yf = _mm256_mul_ps(y, f);
+
+                // Brown-Conrady adds the tangential distortion of the undistorted point
+                auto xt = (MODEL == RS2_DISTORTION_BROWN_CONRADY) ? x : xf;
+                auto yt = (MODEL == RS2_DISTORTION_BROWN_CONRADY) ? y : yf;
+                x = _mm256_add_ps(_mm256_add_ps(xf, _mm256_mul_ps(_mm256_mul_ps(c2x2, xt), yt)),
+                    _mm256_mul_ps(c3, _mm256_add_ps(r2, _mm256_mul_ps(_mm256_mul_ps(two, xt), xt))));
+                y = _mm256_add_ps(_mm256_add_ps(yf, _mm256_mul_ps(_mm256_mul_ps(c3x2, xt), yt)),
+                    _mm256_mul_ps(c2, _mm256_add_ps(r2, _mm256_mul_ps(_mm256_mul_ps(two, yt), yt))));
+            }
+
+            auto u = _mm256_and_ps(valid, _mm256_add_ps(_mm256_mul_ps(x, fx), ppx));
+            auto v = _mm256_and_ps(valid, _mm256_add_ps(_mm256_mul_ps(y, fy), ppy));
+            store_pairs<STREAM>(pixels + i * 2, u, v);
+            store_pairs<STREAM>(tex + i * 2, _mm256_div_ps(u, w), _mm256_div_ps(v, h));
+        }
+        for (; i < count; ++i)
+        {
+            const float* point = points + i * 3;
+            if (point[2])
+            {
+                float trans[3];
+                rs2_transform_point_to_point(trans, &extr, point);
+                rs2_project_point_to_pixel(pixels + i * 2, &intrin, trans);
+                tex[i * 2] = pixels[i * 2] / intrin.width;
+                tex[i * 2 + 1] = pixels[i * 2 + 1] / intrin.height;
+            }
+            else
+            {
+                pixels[i * 2] = pixels[i * 2 + 1] = 0.f;
+                tex[i * 2] = tex[i * 2 + 1] = 0.f;
+            }
+        }
+    }
+
+    pointcloud_avx2::pointcloud_avx2() : pointcloud("Pointcloud (AVX2)") {}
+
+    void pointcloud_avx2::preprocess()
+    {
+        auto& intrin = *_depth_intrinsics;
+        _pre_compute_map_x.resize(intrin.width * intrin.height);
+        _pre_compute_map_y.resize(intrin.width * intrin.height);
+
+        // The generic deprojection, whatever the model, is linear in depth
+        parallel_for(intrin.height, [&](int h)
+        {
+            for (int w = 0; w < intrin.width; ++w)
+            {
+                const float pixel[] = { (float)w, (float)h };
+                float point[3];
+                rs2_deproject_pixel_to_point(point, &intrin, pixel, 1.f);
+                _pre_compute_map_x[h * intrin.width + w] = point[0];
+                _pre_compute_map_y[h * intrin.width + w] = point[1];
+            }
+        });
+    }
+
+    static bool is_aligned(const void* p)
+    {
+        return (reinterpret_cast<uintptr_t>(p) & 15) == 0;
+    }
+
+    const float3* pointcloud_avx2::depth_to_points(rs2::points output,
+        const rs2_intrinsics &depth_intrinsics,
+        const rs2::depth_frame& depth_frame,
+        float depth_scale)
+    {
+        auto depth_image = (const uint16_t*)depth_frame.get_data();
+        auto points = (float*)output.get_vertices();
+        auto map_x = _pre_compute_map_x.data();
+        auto map_y = _pre_compute_map_y.data();
+        auto deproject = is_aligned(points) ? deproject_band<true> : deproject_band<false>;
+
+        const size_t width = depth_intrinsics.width;
+        const size_t height = depth_intrinsics.height;
+        const int bands = int((height + pointcloud_band_rows - 1) / pointcloud_band_rows);
+
+        parallel_for(bands, [&](int b)
+        {
+            auto begin = b * pointcloud_band_rows * width;
+            auto end = std::min(height, (b + 1) * pointcloud_band_rows) * width;
+            deproject(points + begin * 3, depth_image + begin, map_x + begin, map_y + begin, end - begin, depth_scale);
+        });
+        _mm_sfence();
+        return (float3*)points;
+    }
+
+    void pointcloud_avx2::get_texture_map(rs2::points output,
+        const float3* points,
+        const unsigned int width,
+        const unsigned int height,
+        const rs2_intrinsics &other_intrinsics,
+        const rs2_extrinsics& extr,
+        float2* pixels_ptr)
+    {
+        auto tex_ptr = (float*)output.get_texture_coordinates();
+        auto pixels = (float*)pixels_ptr;
+        auto xyz = (const float*)points;
+        bool const stream = is_aligned(tex_ptr) && is_aligned(pixels);
+
+        void (*map_band)(float*, float*, const float*, size_t, const rs2_intrinsics&, const rs2_extrinsics&);
+        switch (other_intrinsics.model)
+        {
+        case RS2_DISTORTION_NONE:
+            map_band = stream ? texture_band<RS2_DISTORTION_NONE, true> : texture_band<RS2_DISTORTION_NONE, false>;
+            break;
+        case RS2_DISTORTION_BROWN_CONRADY:
+            map_band = stream ? texture_band<RS2_DISTORTION_BROWN_CONRADY, true> : texture_band<RS2_DISTORTION_BROWN_CONRADY, false>;
+            break;
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+        case RS2_DISTORTION_INVERSE_BROWN_CONRADY:
+            map_band = stream ? texture_band<RS2_DISTORTION_INVERSE_BROWN_CONRADY, true> : texture_band<RS2_DISTORTION_INVERSE_BROWN_CONRADY, false>;
+            break;
+        default:
+            pointcloud::get_texture_map(output, points, width, height, other_intrinsics, extr, pixels_ptr);
+            return;
+        }
+
+        const int bands = int((height + pointcloud_band_rows - 1) / pointcloud_band_rows);
+
+        parallel_for(bands, [&](int b)
+        {
+            size_t begin = b * pointcloud_band_rows * size_t(width);
+            size_t end = std::min(size_t(height), (b + 1) * pointcloud_band_rows) * width;
+            map_band(tex_ptr + begin * 2, pixels + begin * 2, xyz + begin * 3, end - begin, other_intrinsics, extr);
+        });
+        _mm_sfence();
+    }
+}
+
+#endif
@@ -4,8 +4,19 @@
 #include "color-formats-converter.h"
 
 #include "option.h"
+#include "context.h"
+#include "core/video.h"
 #include "image-avx.h"
 #include "image.h"
+#include "thread-pool.h"
+#include "cpu-features.h"
+
+#include <algorithm>
+#include <csetjmp>
+
+#ifdef RS2_USE_LIBJPEG_TURBO
+#include <jpeglib.h>
+#endif
 
 #define STB_IMAGE_STATIC
 #define STB_IMAGE_IMPLEMENTATION
@@ -17,35 +28,15 @@
 #ifdef __SSSE3__
 #include <tmmintrin.h> // For SSSE3 intrinsics
 #endif
-
-#if defined (ANDROID) || (defined (__linux__) && !defined (__x86_64__))
-
-bool has_avx() { return false; }
-
-#else
-
-#ifdef _WIN32
-#include <intrin.h>
-#define cpuid(info, x)    __cpuidex(info, x, 0)
-#else
-#include <cpuid.h>
-void cpuid(int info[4], int info_type) {
-    __cpuid_count(info_type, 0, info[0], info[1], info[2], info[3]);
-}
-#endif
-
-bool has_avx()
-{
-    int info[4];
-    cpuid(info, 0);
-    cpuid(info, 0x80000000);
-    return (info[2] & ((int)1 << 28)) != 0;
-}
-
+#ifdef __ARM_NEON
+#include <arm_neon.h>
 #endif
 
 namespace librealsense 
 {
+    // Blocks of 16 pixels per band of the thread pool
+    static const int unpack_strip_blocks = 1024;
+
     /////////////////////////////
     // YUY2 unpacking routines //
     /////////////////////////////
@@ -60,166 +51,173 @@ namespace librealsense
         return;
 #endif
 #if defined __SSSE3__ && ! defined ANDROID
-        static bool do_avx = has_avx();
-#ifdef __AVX2__
-
-        if (do_avx)
-        {
-            if (FORMAT == RS2_FORMAT_Y8) unpack_yuy2_avx_y8(d, s, n);
-            if (FORMAT == RS2_FORMAT_Y16) unpack_yuy2_avx_y16(d, s, n);
-            if (FORMAT == RS2_FORMAT_RGB8) unpack_yuy2_avx_rgb8(d, s, n);
-            if (FORMAT == RS2_FORMAT_RGBA8) unpack_yuy2_avx_rgba8(d, s, n);
-            if (FORMAT == RS2_FORMAT_BGR8) unpack_yuy2_avx_bgr8(d, s, n);
-            if (FORMAT == RS2_FORMAT_BGRA8) unpack_yuy2_avx_bgra8(d, s, n);
-        }
-        else
-#endif
+        const auto simd = cpu_simd_level();
+        if (simd != simd_level::scalar)
         {
+            // AVX2 works on blocks of 32 pixels, leaving up to 16 to the SSSE3 code
+            int done = 0;
+            if (simd == simd_level::avx2)
+            {
+                if (FORMAT == RS2_FORMAT_Y8) done = unpack_yuy2_avx_y8(d, s, n);
+                if (FORMAT == RS2_FORMAT_Y16) done = unpack_yuy2_avx_y16(d, s, n);
+                if (FORMAT == RS2_FORMAT_RGB8) done = unpack_yuy2_avx_rgb8(d, s, n);
+                if (FORMAT == RS2_FORMAT_RGBA8) done = unpack_yuy2_avx_rgba8(d, s, n);
+                if (FORMAT == RS2_FORMAT_BGR8) done = unpack_yuy2_avx_bgr8(d, s, n);
+                if (FORMAT == RS2_FORMAT_BGRA8) done = unpack_yuy2_avx_bgra8(d, s, n);
+            }
+
             auto src = reinterpret_cast<const __m128i *>(s);
             auto dst = reinterpret_cast<__m128i *>(d[0]);
 
-#pragma omp parallel for
-            for (int i = 0; i < n / 16; i++)
+            const int first = done / 16;
+            const int blocks = n / 16;
+            parallel_for((blocks - first + unpack_strip_blocks - 1) / unpack_strip_blocks, [&](int strip)
             {
-                const __m128i zero = _mm_set1_epi8(0);
-                const __m128i n100 = _mm_set1_epi16(100 << 4);
-                const __m128i n208 = _mm_set1_epi16(208 << 4);
-                const __m128i n298 = _mm_set1_epi16(298 << 4);
-                const __m128i n409 = _mm_set1_epi16(409 << 4);
-                const __m128i n516 = _mm_set1_epi16(516 << 4);
-                const __m128i evens_odds = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
-
-                // Load 8 YUY2 pixels each into two 16-byte registers
-                __m128i s0 = _mm_loadu_si128(&src[i * 2]);
-                __m128i s1 = _mm_loadu_si128(&src[i * 2 + 1]);
-
-                if (FORMAT == RS2_FORMAT_Y8)
-                {
-                    // Align all Y components and output 16 pixels (16 bytes) at once
-                    __m128i y0 = _mm_shuffle_epi8(s0, _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14));
-                    __m128i y1 = _mm_shuffle_epi8(s1, _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15));
-                    _mm_storeu_si128(&dst[i], _mm_alignr_epi8(y0, y1, 8));
-                    continue;
-                }
-
-                // Shuffle all Y components to the low order bytes of the register, and all U/V components to the high order bytes
-                const __m128i evens_odd1s_odd3s = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15); // to get yyyyyyyyuuuuvvvv
-                __m128i yyyyyyyyuuuuvvvv0 = _mm_shuffle_epi8(s0, evens_odd1s_odd3s);
-                __m128i yyyyyyyyuuuuvvvv8 = _mm_shuffle_epi8(s1, evens_odd1s_odd3s);
-
-                // Retrieve all 16 Y components as 16-bit values (8 components per register))
-                __m128i y16__0_7 = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv0, zero);         // convert to 16 bit
-                __m128i y16__8_F = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv8, zero);         // convert to 16 bit
-
-                if (FORMAT == RS2_FORMAT_Y16)
+                const int end = std::min(blocks, first + (strip + 1) * unpack_strip_blocks);
+                for (int i = first + strip * unpack_strip_blocks; i < end; i++)
                 {
-                    // Output 16 pixels (32 bytes) at once
-                    _mm_storeu_si128(&dst[i * 2], _mm_slli_epi16(y16__0_7, 8));
-                    _mm_storeu_si128(&dst[i * 2 + 1], _mm_slli_epi16(y16__8_F, 8));
-                    continue;
-                }
-
-                // Retrieve all 16 U and V components as 16-bit values (8 components per register)
-                __m128i uv = _mm_unpackhi_epi32(yyyyyyyyuuuuvvvv0, yyyyyyyyuuuuvvvv8); // uuuuuuuuvvvvvvvv
-                __m128i u = _mm_unpacklo_epi8(uv, uv);                                 //  uu uu uu uu uu uu uu uu  u's duplicated
-                __m128i v = _mm_unpackhi_epi8(uv, uv);                                 //  vv vv vv vv vv vv vv vv
-                __m128i u16__0_7 = _mm_unpacklo_epi8(u, zero);                         // convert to 16 bit
-                __m128i u16__8_F = _mm_unpackhi_epi8(u, zero);                         // convert to 16 bit
-                __m128i v16__0_7 = _mm_unpacklo_epi8(v, zero);                         // convert to 16 bit
-                __m128i v16__8_F = _mm_unpackhi_epi8(v, zero);                         // convert to 16 bit
-
-                                                                                       // Compute R, G, B values for first 8 pixels
-                __m128i c16__0_7 = _mm_slli_epi16(_mm_subs_epi16(y16__0_7, _mm_set1_epi16(16)), 4);
-                __m128i d16__0_7 = _mm_slli_epi16(_mm_subs_epi16(u16__0_7, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
-                __m128i e16__0_7 = _mm_slli_epi16(_mm_subs_epi16(v16__0_7, _mm_set1_epi16(128)), 4);
-                __m128i r16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(e16__0_7, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
-                __m128i g16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n100)), _mm_mulhi_epi16(e16__0_7, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
-                __m128i b16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
-
-                                                                                                                                                                                                                                 // Compute R, G, B values for second 8 pixels
-                __m128i c16__8_F = _mm_slli_epi16(_mm_subs_epi16(y16__8_F, _mm_set1_epi16(16)), 4);
-                __m128i d16__8_F = _mm_slli_epi16(_mm_subs_epi16(u16__8_F, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
-                __m128i e16__8_F = _mm_slli_epi16(_mm_subs_epi16(v16__8_F, _mm_set1_epi16(128)), 4);
-                __m128i r16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(e16__8_F, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
-                __m128i g16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n100)), _mm_mulhi_epi16(e16__8_F, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
-                __m128i b16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
-
-                if (FORMAT == RS2_FORMAT_RGB8 || FORMAT == RS2_FORMAT_RGBA8)
-                {
-                    // Shuffle separate R, G, B values into four registers storing four pixels each in (R, G, B, A) order
-                    __m128i rg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                    __m128i ba8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_set1_epi8(-1));
-                    __m128i rgba_0_3 = _mm_unpacklo_epi16(rg8__0_7, ba8__0_7);
-                    __m128i rgba_4_7 = _mm_unpackhi_epi16(rg8__0_7, ba8__0_7);
-
-                    __m128i rg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                    __m128i ba8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_set1_epi8(-1));
-                    __m128i rgba_8_B = _mm_unpacklo_epi16(rg8__8_F, ba8__8_F);
-                    __m128i rgba_C_F = _mm_unpackhi_epi16(rg8__8_F, ba8__8_F);
-
-                    if (FORMAT == RS2_FORMAT_RGBA8)
+                    const __m128i zero = _mm_set1_epi8(0);
+                    const __m128i n100 = _mm_set1_epi16(100 << 4);
+                    const __m128i n208 = _mm_set1_epi16(208 << 4);
+                    const __m128i n298 = _mm_set1_epi16(298 << 4);
+                    const __m128i n409 = _mm_set1_epi16(409 << 4);
+                    const __m128i n516 = _mm_set1_epi16(516 << 4);
+                    const __m128i evens_odds = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+
+                    // Load 8 YUY2 pixels each into two 16-byte registers
+                    __m128i s0 = _mm_loadu_si128(&src[i * 2]);
+                    __m128i s1 = _mm_loadu_si128(&src[i * 2 + 1]);
+
+                    if (FORMAT == RS2_FORMAT_Y8)
                     {
-                        // Store 16 pixels (64 bytes) at once
-                        _mm_storeu_si128(&dst[i * 4], rgba_0_3);
-                        _mm_storeu_si128(&dst[i * 4 + 1], rgba_4_7);
-                        _mm_storeu_si128(&dst[i * 4 + 2], rgba_8_B);
-                        _mm_storeu_si128(&dst[i * 4 + 3], rgba_C_F);
+                        // Gather the Y components to the low half of each register and output 16 pixels (16 bytes) at once
+                        __m128i y0 = _mm_shuffle_epi8(s0, evens_odds);
+                        __m128i y1 = _mm_shuffle_epi8(s1, evens_odds);
+                        _mm_storeu_si128(&dst[i], _mm_unpacklo_epi64(y0, y1));
+                        continue;
                     }
 
-                    if (FORMAT == RS2_FORMAT_RGB8)
-                    {
-                        // Shuffle rgb triples to the start and end of each register
-                        __m128i rgb0 = _mm_shuffle_epi8(rgba_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
-                        __m128i rgb1 = _mm_shuffle_epi8(rgba_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                        __m128i rgb2 = _mm_shuffle_epi8(rgba_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
-                        __m128i rgb3 = _mm_shuffle_epi8(rgba_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+                    // Shuffle all Y components to the low order bytes of the register, and all U/V components to the high order bytes
+                    const __m128i evens_odd1s_odd3s = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15); // to get yyyyyyyyuuuuvvvv
+                    __m128i yyyyyyyyuuuuvvvv0 = _mm_shuffle_epi8(s0, evens_odd1s_odd3s);
+                    __m128i yyyyyyyyuuuuvvvv8 = _mm_shuffle_epi8(s1, evens_odd1s_odd3s);
 
-                        // Align registers and store 16 pixels (48 bytes) at once
-                        _mm_storeu_si128(&dst[i * 3], _mm_alignr_epi8(rgb1, rgb0, 4));
-                        _mm_storeu_si128(&dst[i * 3 + 1], _mm_alignr_epi8(rgb2, rgb1, 8));
-                        _mm_storeu_si128(&dst[i * 3 + 2], _mm_alignr_epi8(rgb3, rgb2, 12));
-                    }
-                }
+                    // Retrieve all 16 Y components as 16-bit values (8 components per register))
+                    __m128i y16__0_7 = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv0, zero);         // convert to 16 bit
+                    __m128i y16__8_F = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv8, zero);         // convert to 16 bit
 
-                if (FORMAT == RS2_FORMAT_BGR8 || FORMAT == RS2_FORMAT_BGRA8)
-                {
-                    // Shuffle separate R, G, B values into four registers storing four pixels each in (B, G, R, A) order
-                    __m128i bg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                    __m128i ra8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_set1_epi8(-1));
-                    __m128i bgra_0_3 = _mm_unpacklo_epi16(bg8__0_7, ra8__0_7);
-                    __m128i bgra_4_7 = _mm_unpackhi_epi16(bg8__0_7, ra8__0_7);
-
-                    __m128i bg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                    __m128i ra8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_set1_epi8(-1));
-                    __m128i bgra_8_B = _mm_unpacklo_epi16(bg8__8_F, ra8__8_F);
-                    __m128i bgra_C_F = _mm_unpackhi_epi16(bg8__8_F, ra8__8_F);
-
-                    if (FORMAT == RS2_FORMAT_BGRA8)
+                    if (FORMAT == RS2_FORMAT_Y16)
                     {
-                        // Store 16 pixels (64 bytes) at once
-                        _mm_storeu_si128(&dst[i * 4], bgra_0_3);
-                        _mm_storeu_si128(&dst[i * 4 + 1], bgra_4_7);
-                        _mm_storeu_si128(&dst[i * 4 + 2], bgra_8_B);
-                        _mm_storeu_si128(&dst[i * 4 + 3], bgra_C_F);
+                        // Output 16 pixels (32 bytes) at once
+                        _mm_storeu_si128(&dst[i * 2], _mm_slli_epi16(y16__0_7, 8));
+                        _mm_storeu_si128(&dst[i * 2 + 1], _mm_slli_epi16(y16__8_F, 8));
+                        continue;
                     }
 
-                    if (FORMAT == RS2_FORMAT_BGR8)
+                    // Retrieve all 16 U and V components as 16-bit values (8 components per register)
+                    __m128i uv = _mm_unpackhi_epi32(yyyyyyyyuuuuvvvv0, yyyyyyyyuuuuvvvv8); // uuuuuuuuvvvvvvvv
+                    __m128i u = _mm_unpacklo_epi8(uv, uv);                                 //  uu uu uu uu uu uu uu uu  u's duplicated
+                    __m128i v = _mm_unpackhi_epi8(uv, uv);                                 //  vv vv vv vv vv vv vv vv
+                    __m128i u16__0_7 = _mm_unpacklo_epi8(u, zero);                         // convert to 16 bit
+                    __m128i u16__8_F = _mm_unpackhi_epi8(u, zero);                         // convert to 16 bit
+                    __m128i v16__0_7 = _mm_unpacklo_epi8(v, zero);                         // convert to 16 bit
+                    __m128i v16__8_F = _mm_unpackhi_epi8(v, zero);                         // convert to 16 bit
+
+                                                                                           // Compute R, G, B values for first 8 pixels
+                    __m128i c16__0_7 = _mm_slli_epi16(_mm_subs_epi16(y16__0_7, _mm_set1_epi16(16)), 4);
+                    __m128i d16__0_7 = _mm_slli_epi16(_mm_subs_epi16(u16__0_7, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
+                    __m128i e16__0_7 = _mm_slli_epi16(_mm_subs_epi16(v16__0_7, _mm_set1_epi16(128)), 4);
+                    __m128i r16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(e16__0_7, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
+                    __m128i g16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n100)), _mm_mulhi_epi16(e16__0_7, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
+                    __m128i b16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
+
+                                                                                                                                                                                                                                     // Compute R, G, B values for second 8 pixels
+                    __m128i c16__8_F = _mm_slli_epi16(_mm_subs_epi16(y16__8_F, _mm_set1_epi16(16)), 4);
+                    __m128i d16__8_F = _mm_slli_epi16(_mm_subs_epi16(u16__8_F, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
+                    __m128i e16__8_F = _mm_slli_epi16(_mm_subs_epi16(v16__8_F, _mm_set1_epi16(128)), 4);
+                    __m128i r16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(e16__8_F, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
+                    __m128i g16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n100)), _mm_mulhi_epi16(e16__8_F, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
+                    __m128i b16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
+
+                    if (FORMAT == RS2_FORMAT_RGB8 || FORMAT == RS2_FORMAT_RGBA8)
                     {
-                        // Shuffle rgb triples to the start and end of each register
-                        __m128i bgr0 = _mm_shuffle_epi8(bgra_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
-                        __m128i bgr1 = _mm_shuffle_epi8(bgra_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                        __m128i bgr2 = _mm_shuffle_epi8(bgra_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
-                        __m128i bgr3 = _mm_shuffle_epi8(bgra_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+                        // Shuffle separate R, G, B values into four registers storing four pixels each in (R, G, B, A) order
+                        __m128i rg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                        __m128i ba8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_set1_epi8(-1));
+                        __m128i rgba_0_3 = _mm_unpacklo_epi16(rg8__0_7, ba8__0_7);
+                        __m128i rgba_4_7 = _mm_unpackhi_epi16(rg8__0_7, ba8__0_7);
+
+                        __m128i rg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                        __m128i ba8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_set1_epi8(-1));
+                        __m128i rgba_8_B = _mm_unpacklo_epi16(rg8__8_F, ba8__8_F);
+                        __m128i rgba_C_F = _mm_unpackhi_epi16(rg8__8_F, ba8__8_F);
+
+                        if (FORMAT == RS2_FORMAT_RGBA8)
+                        {
+                            // Store 16 pixels (64 bytes) at once
+                            _mm_storeu_si128(&dst[i * 4], rgba_0_3);
+                            _mm_storeu_si128(&dst[i * 4 + 1], rgba_4_7);
+                            _mm_storeu_si128(&dst[i * 4 + 2], rgba_8_B);
+                            _mm_storeu_si128(&dst[i * 4 + 3], rgba_C_F);
+                        }
+
+                        if (FORMAT == RS2_FORMAT_RGB8)
+                        {
+                            // Shuffle rgb triples to the start and end of each register
+                            __m128i rgb0 = _mm_shuffle_epi8(rgba_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
+                            __m128i rgb1 = _mm_shuffle_epi8(rgba_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
+                            __m128i rgb2 = _mm_shuffle_epi8(rgba_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
+                            __m128i rgb3 = _mm_shuffle_epi8(rgba_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+
+                            // Align registers and store 16 pixels (48 bytes) at once
+                            _mm_storeu_si128(&dst[i * 3], _mm_alignr_epi8(rgb1, rgb0, 4));
+                            _mm_storeu_si128(&dst[i * 3 + 1], _mm_alignr_epi8(rgb2, rgb1, 8));
+                            _mm_storeu_si128(&dst[i * 3 + 2], _mm_alignr_epi8(rgb3, rgb2, 12));
+                        }
+                    }
 
-                        // Align registers and store 16 pixels (48 bytes) at once
-                        _mm_storeu_si128(&dst[i * 3], _mm_alignr_epi8(bgr1, bgr0, 4));
-                        _mm_storeu_si128(&dst[i * 3 + 1], _mm_alignr_epi8(bgr2, bgr1, 8));
-                        _mm_storeu_si128(&dst[i * 3 + 2], _mm_alignr_epi8(bgr3, bgr2, 12));
+                    if (FORMAT == RS2_FORMAT_BGR8 || FORMAT == RS2_FORMAT_BGRA8)
+                    {
+                        // Shuffle separate R, G, B values into four registers storing four pixels each in (B, G, R, A) order
+                        __m128i bg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                        __m128i ra8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_set1_epi8(-1));
+                        __m128i bgra_0_3 = _mm_unpacklo_epi16(bg8__0_7, ra8__0_7);
+                        __m128i bgra_4_7 = _mm_unpackhi_epi16(bg8__0_7, ra8__0_7);
+
+                        __m128i bg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                        __m128i ra8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_set1_epi8(-1));
+                        __m128i bgra_8_B = _mm_unpacklo_epi16(bg8__8_F, ra8__8_F);
+                        __m128i bgra_C_F = _mm_unpackhi_epi16(bg8__8_F, ra8__8_F);
+
+                        if (FORMAT == RS2_FORMAT_BGRA8)
+                        {
+                            // Store 16 pixels (64 bytes) at once
+                            _mm_storeu_si128(&dst[i * 4], bgra_0_3);
+                            _mm_storeu_si128(&dst[i * 4 + 1], bgra_4_7);
+                            _mm_storeu_si128(&dst[i * 4 + 2], bgra_8_B);
+                            _mm_storeu_si128(&dst[i * 4 + 3], bgra_C_F);
+                        }
+
+                        if (FORMAT == RS2_FORMAT_BGR8)
+                        {
+                            // Shuffle rgb triples to the start and end of each register
+                            __m128i bgr0 = _mm_shuffle_epi8(bgra_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
+                            __m128i bgr1 = _mm_shuffle_epi8(bgra_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
+                            __m128i bgr2 = _mm_shuffle_epi8(bgra_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
+                            __m128i bgr3 = _mm_shuffle_epi8(bgra_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+
+                            // Align registers and store 16 pixels (48 bytes) at once
+                            _mm_storeu_si128(&dst[i * 3], _mm_alignr_epi8(bgr1, bgr0, 4));
+                            _mm_storeu_si128(&dst[i * 3 + 1], _mm_alignr_epi8(bgr2, bgr1, 8));
+                            _mm_storeu_si128(&dst[i * 3 + 2], _mm_alignr_epi8(bgr3, bgr2, 12));
+                        }
                     }
                 }
-            }
+            });
+            return;
         }
-#else  // Generic code for when SSSE3 is not available.
+#endif
+        // Generic code, for when SSSE3 is not available or not selected
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
         for (; n; n -= 16, src += 32)
@@ -351,7 +349,6 @@ namespace librealsense
                 continue;
             }
         }
-#endif
     }
 
     void unpack_yuy2(rs2_format dst_format, rs2_stream dst_stream, byte * const d[], const byte * s, int w, int h, int actual_size)
@@ -393,133 +390,138 @@ namespace librealsense
         auto n = width * height;
         assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
 #ifdef __SSSE3__
-        auto src = reinterpret_cast<const __m128i *>(s);
-        auto dst = reinterpret_cast<__m128i *>(d[0]);
-        for (; n; n -= 16)
+        if (cpu_simd_level() != simd_level::scalar)
         {
-            const __m128i zero = _mm_set1_epi8(0);
-            const __m128i n100 = _mm_set1_epi16(100 << 4);
-            const __m128i n208 = _mm_set1_epi16(208 << 4);
-            const __m128i n298 = _mm_set1_epi16(298 << 4);
-            const __m128i n409 = _mm_set1_epi16(409 << 4);
-            const __m128i n516 = _mm_set1_epi16(516 << 4);
-            const __m128i evens_odds = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
-
-            // Load 8 UYVY pixels each into two 16-byte registers
-            __m128i s0 = _mm_loadu_si128(src++);
-            __m128i s1 = _mm_loadu_si128(src++);
-
-
-            // Shuffle all Y components to the low order bytes of the register, and all U/V components to the high order bytes
-            const __m128i evens_odd1s_odd3s = _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 4, 8, 12, 2, 6, 10, 14); // to get yyyyyyyyuuuuvvvv
-            __m128i yyyyyyyyuuuuvvvv0 = _mm_shuffle_epi8(s0, evens_odd1s_odd3s);
-            __m128i yyyyyyyyuuuuvvvv8 = _mm_shuffle_epi8(s1, evens_odd1s_odd3s);
-
-            // Retrieve all 16 Y components as 16-bit values (8 components per register))
-            __m128i y16__0_7 = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv0, zero);         // convert to 16 bit
-            __m128i y16__8_F = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv8, zero);         // convert to 16 bit
-
-
-            // Retrieve all 16 U and V components as 16-bit values (8 components per register)
-            __m128i uv = _mm_unpackhi_epi32(yyyyyyyyuuuuvvvv0, yyyyyyyyuuuuvvvv8); // uuuuuuuuvvvvvvvv
-            __m128i u = _mm_unpacklo_epi8(uv, uv);                                 //  uu uu uu uu uu uu uu uu  u's duplicated
-            __m128i v = _mm_unpackhi_epi8(uv, uv);                                 //  vv vv vv vv vv vv vv vv
-            __m128i u16__0_7 = _mm_unpacklo_epi8(u, zero);                         // convert to 16 bit
-            __m128i u16__8_F = _mm_unpackhi_epi8(u, zero);                         // convert to 16 bit
-            __m128i v16__0_7 = _mm_unpacklo_epi8(v, zero);                         // convert to 16 bit
-            __m128i v16__8_F = _mm_unpackhi_epi8(v, zero);                         // convert to 16 bit
-
-                                                                                   // Compute R, G, B values for first 8 pixels
-            __m128i c16__0_7 = _mm_slli_epi16(_mm_subs_epi16(y16__0_7, _mm_set1_epi16(16)), 4);
-            __m128i d16__0_7 = _mm_slli_epi16(_mm_subs_epi16(u16__0_7, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
-            __m128i e16__0_7 = _mm_slli_epi16(_mm_subs_epi16(v16__0_7, _mm_set1_epi16(128)), 4);
-            __m128i r16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(e16__0_7, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
-            __m128i g16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n100)), _mm_mulhi_epi16(e16__0_7, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
-            __m128i b16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
-
-                                                                                                                                                                                                                             // Compute R, G, B values for second 8 pixels
-            __m128i c16__8_F = _mm_slli_epi16(_mm_subs_epi16(y16__8_F, _mm_set1_epi16(16)), 4);
-            __m128i d16__8_F = _mm_slli_epi16(_mm_subs_epi16(u16__8_F, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
-            __m128i e16__8_F = _mm_slli_epi16(_mm_subs_epi16(v16__8_F, _mm_set1_epi16(128)), 4);
-            __m128i r16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(e16__8_F, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
-            __m128i g16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n100)), _mm_mulhi_epi16(e16__8_F, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
-            __m128i b16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
-
-            if (FORMAT == RS2_FORMAT_RGB8 || FORMAT == RS2_FORMAT_RGBA8)
+            auto src = reinterpret_cast<const __m128i *>(s);
+            auto dst = reinterpret_cast<__m128i *>(d[0]);
+            for (; n; n -= 16)
             {
-                // Shuffle separate R, G, B values into four registers storing four pixels each in (R, G, B, A) order
-                __m128i rg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ba8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_set1_epi8(-1));
-                __m128i rgba_0_3 = _mm_unpacklo_epi16(rg8__0_7, ba8__0_7);
-                __m128i rgba_4_7 = _mm_unpackhi_epi16(rg8__0_7, ba8__0_7);
-
-                __m128i rg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ba8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_set1_epi8(-1));
-                __m128i rgba_8_B = _mm_unpacklo_epi16(rg8__8_F, ba8__8_F);
-                __m128i rgba_C_F = _mm_unpackhi_epi16(rg8__8_F, ba8__8_F);
-
-                if (FORMAT == RS2_FORMAT_RGBA8)
-                {
-                    // Store 16 pixels (64 bytes) at once
-                    _mm_storeu_si128(dst++, rgba_0_3);
-                    _mm_storeu_si128(dst++, rgba_4_7);
-                    _mm_storeu_si128(dst++, rgba_8_B);
-                    _mm_storeu_si128(dst++, rgba_C_F);
-                }
+                const __m128i zero = _mm_set1_epi8(0);
+                const __m128i n100 = _mm_set1_epi16(100 << 4);
+                const __m128i n208 = _mm_set1_epi16(208 << 4);
+                const __m128i n298 = _mm_set1_epi16(298 << 4);
+                const __m128i n409 = _mm_set1_epi16(409 << 4);
+                const __m128i n516 = _mm_set1_epi16(516 << 4);
+                const __m128i evens_odds = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
 
-                if (FORMAT == RS2_FORMAT_RGB8)
-                {
-                    // Shuffle rgb triples to the start and end of each register
-                    __m128i rgb0 = _mm_shuffle_epi8(rgba_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i rgb1 = _mm_shuffle_epi8(rgba_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i rgb2 = _mm_shuffle_epi8(rgba_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
-                    __m128i rgb3 = _mm_shuffle_epi8(rgba_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
-
-                    // Align registers and store 16 pixels (48 bytes) at once
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb1, rgb0, 4));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb2, rgb1, 8));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb3, rgb2, 12));
-                }
-            }
+                // Load 8 UYVY pixels each into two 16-byte registers
+                __m128i s0 = _mm_loadu_si128(src++);
+                __m128i s1 = _mm_loadu_si128(src++);
 
-            if (FORMAT == RS2_FORMAT_BGR8 || FORMAT == RS2_FORMAT_BGRA8)
-            {
-                // Shuffle separate R, G, B values into four registers storing four pixels each in (B, G, R, A) order
-                __m128i bg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ra8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_set1_epi8(-1));
-                __m128i bgra_0_3 = _mm_unpacklo_epi16(bg8__0_7, ra8__0_7);
-                __m128i bgra_4_7 = _mm_unpackhi_epi16(bg8__0_7, ra8__0_7);
-
-                __m128i bg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ra8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_set1_epi8(-1));
-                __m128i bgra_8_B = _mm_unpacklo_epi16(bg8__8_F, ra8__8_F);
-                __m128i bgra_C_F = _mm_unpackhi_epi16(bg8__8_F, ra8__8_F);
-
-                if (FORMAT == RS2_FORMAT_BGRA8)
+
+                // Shuffle all Y components to the low order bytes of the register, and all U/V components to the high order bytes
+                const __m128i evens_odd1s_odd3s = _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 4, 8, 12, 2, 6, 10, 14); // to get yyyyyyyyuuuuvvvv
+                __m128i yyyyyyyyuuuuvvvv0 = _mm_shuffle_epi8(s0, evens_odd1s_odd3s);
+                __m128i yyyyyyyyuuuuvvvv8 = _mm_shuffle_epi8(s1, evens_odd1s_odd3s);
+
+                // Retrieve all 16 Y components as 16-bit values (8 components per register))
+                __m128i y16__0_7 = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv0, zero);         // convert to 16 bit
+                __m128i y16__8_F = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv8, zero);         // convert to 16 bit
+
+
+                // Retrieve all 16 U and V components as 16-bit values (8 components per register)
+                __m128i uv = _mm_unpackhi_epi32(yyyyyyyyuuuuvvvv0, yyyyyyyyuuuuvvvv8); // uuuuuuuuvvvvvvvv
+                __m128i u = _mm_unpacklo_epi8(uv, uv);                                 //  uu uu uu uu uu uu uu uu  u's duplicated
+                __m128i v = _mm_unpackhi_epi8(uv, uv);                                 //  vv vv vv vv vv vv vv vv
+                __m128i u16__0_7 = _mm_unpacklo_epi8(u, zero);                         // convert to 16 bit
+                __m128i u16__8_F = _mm_unpackhi_epi8(u, zero);                         // convert to 16 bit
+                __m128i v16__0_7 = _mm_unpacklo_epi8(v, zero);                         // convert to 16 bit
+                __m128i v16__8_F = _mm_unpackhi_epi8(v, zero);                         // convert to 16 bit
+
+                                                                                       // Compute R, G, B values for first 8 pixels
+                __m128i c16__0_7 = _mm_slli_epi16(_mm_subs_epi16(y16__0_7, _mm_set1_epi16(16)), 4);
+                __m128i d16__0_7 = _mm_slli_epi16(_mm_subs_epi16(u16__0_7, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
+                __m128i e16__0_7 = _mm_slli_epi16(_mm_subs_epi16(v16__0_7, _mm_set1_epi16(128)), 4);
+                __m128i r16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(e16__0_7, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
+                __m128i g16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n100)), _mm_mulhi_epi16(e16__0_7, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
+                __m128i b16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
+
+                                                                                                                                                                                                                                 // Compute R, G, B values for second 8 pixels
+                __m128i c16__8_F = _mm_slli_epi16(_mm_subs_epi16(y16__8_F, _mm_set1_epi16(16)), 4);
+                __m128i d16__8_F = _mm_slli_epi16(_mm_subs_epi16(u16__8_F, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
+                __m128i e16__8_F = _mm_slli_epi16(_mm_subs_epi16(v16__8_F, _mm_set1_epi16(128)), 4);
+                __m128i r16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(e16__8_F, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
+                __m128i g16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n100)), _mm_mulhi_epi16(e16__8_F, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
+                __m128i b16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
+
+                if (FORMAT == RS2_FORMAT_RGB8 || FORMAT == RS2_FORMAT_RGBA8)
                 {
-                    // Store 16 pixels (64 bytes) at once
-                    _mm_storeu_si128(dst++, bgra_0_3);
-                    _mm_storeu_si128(dst++, bgra_4_7);
-                    _mm_storeu_si128(dst++, bgra_8_B);
-                    _mm_storeu_si128(dst++, bgra_C_F);
+                    // Shuffle separate R, G, B values into four registers storing four pixels each in (R, G, B, A) order
+                    __m128i rg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                    __m128i ba8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_set1_epi8(-1));
+                    __m128i rgba_0_3 = _mm_unpacklo_epi16(rg8__0_7, ba8__0_7);
+                    __m128i rgba_4_7 = _mm_unpackhi_epi16(rg8__0_7, ba8__0_7);
+
+                    __m128i rg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                    __m128i ba8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_set1_epi8(-1));
+                    __m128i rgba_8_B = _mm_unpacklo_epi16(rg8__8_F, ba8__8_F);
+                    __m128i rgba_C_F = _mm_unpackhi_epi16(rg8__8_F, ba8__8_F);
+
+                    if (FORMAT == RS2_FORMAT_RGBA8)
+                    {
+                        // Store 16 pixels (64 bytes) at once
+                        _mm_storeu_si128(dst++, rgba_0_3);
+                        _mm_storeu_si128(dst++, rgba_4_7);
+                        _mm_storeu_si128(dst++, rgba_8_B);
+                        _mm_storeu_si128(dst++, rgba_C_F);
+                    }
+
+                    if (FORMAT == RS2_FORMAT_RGB8)
+                    {
+                        // Shuffle rgb triples to the start and end of each register
+                        __m128i rgb0 = _mm_shuffle_epi8(rgba_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
+                        __m128i rgb1 = _mm_shuffle_epi8(rgba_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
+                        __m128i rgb2 = _mm_shuffle_epi8(rgba_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
+                        __m128i rgb3 = _mm_shuffle_epi8(rgba_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+
+                        // Align registers and store 16 pixels (48 bytes) at once
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb1, rgb0, 4));
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb2, rgb1, 8));
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb3, rgb2, 12));
+                    }
                 }
 
-                if (FORMAT == RS2_FORMAT_BGR8)
+                if (FORMAT == RS2_FORMAT_BGR8 || FORMAT == RS2_FORMAT_BGRA8)
                 {
-                    // Shuffle rgb triples to the start and end of each register
-                    __m128i bgr0 = _mm_shuffle_epi8(bgra_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i bgr1 = _mm_shuffle_epi8(bgra_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i bgr2 = _mm_shuffle_epi8(bgra_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
-                    __m128i bgr3 = _mm_shuffle_epi8(bgra_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
-
-                    // Align registers and store 16 pixels (48 bytes) at once
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr1, bgr0, 4));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr2, bgr1, 8));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr3, bgr2, 12));
+                    // Shuffle separate R, G, B values into four registers storing four pixels each in (B, G, R, A) order
+                    __m128i bg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                    __m128i ra8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_set1_epi8(-1));
+                    __m128i bgra_0_3 = _mm_unpacklo_epi16(bg8__0_7, ra8__0_7);
+                    __m128i bgra_4_7 = _mm_unpackhi_epi16(bg8__0_7, ra8__0_7);
+
+                    __m128i bg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                    __m128i ra8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_set1_epi8(-1));
+                    __m128i bgra_8_B = _mm_unpacklo_epi16(bg8__8_F, ra8__8_F);
+                    __m128i bgra_C_F = _mm_unpackhi_epi16(bg8__8_F, ra8__8_F);
+
+                    if (FORMAT == RS2_FORMAT_BGRA8)
+                    {
+                        // Store 16 pixels (64 bytes) at once
+                        _mm_storeu_si128(dst++, bgra_0_3);
+                        _mm_storeu_si128(dst++, bgra_4_7);
+                        _mm_storeu_si128(dst++, bgra_8_B);
+                        _mm_storeu_si128(dst++, bgra_C_F);
+                    }
+
+                    if (FORMAT == RS2_FORMAT_BGR8)
+                    {
+                        // Shuffle rgb triples to the start and end of each register
+                        __m128i bgr0 = _mm_shuffle_epi8(bgra_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
+                        __m128i bgr1 = _mm_shuffle_epi8(bgra_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
+                        __m128i bgr2 = _mm_shuffle_epi8(bgra_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
+                        __m128i bgr3 = _mm_shuffle_epi8(bgra_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+
+                        // Align registers and store 16 pixels (48 bytes) at once
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr1, bgr0, 4));
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr2, bgr1, 8));
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr3, bgr2, 12));
+                    }
                 }
             }
+            return;
         }
-#else  // Generic code for when SSSE3 is not available.
+#endif
+        // Generic code, for when SSSE3 is not available or not selected
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
         for (; n; n -= 16, src += 32)
@@ -624,7 +626,6 @@ namespace librealsense
                 continue;
             }
         }
-#endif
     }
 
     void unpack_uyvyc(rs2_format dst_format, rs2_stream dst_stream, byte * const d[], const byte * s, int w, int h, int actual_size)
@@ -652,7 +653,109 @@ namespace librealsense
     /////////////////////////////
     // MJPEG unpacking routines //
     /////////////////////////////
-    void unpack_mjpeg(byte * const dest[], const byte * source, int width, int height, int actual_size, int input_size)
+#ifdef RS2_USE_LIBJPEG_TURBO
+    // A libjpeg-turbo decompressor, kept for the frames of one converter
+    class jpeg_decoder
+    {
+    public:
+        jpeg_decoder()
+        {
+            _info.err = jpeg_std_error(&_error.mgr);
+            _error.mgr.error_exit = on_error;
+            _error.mgr.output_message = on_message;
+            jpeg_create_decompress(&_info);
+        }
+
+        ~jpeg_decoder()
+        {
+            jpeg_destroy_decompress(&_info);
+        }
+
+        // Decodes into width x height pixels of the format, scaling the image down to fit if it's larger
+        bool decode(const byte * source, int size, rs2_format format, byte * dest, int width, int height)
+        {
+            J_COLOR_SPACE color_space;
+            switch (format)
+            {
+            case RS2_FORMAT_RGB8: color_space = JCS_EXT_RGB; break;
+            case RS2_FORMAT_BGR8: color_space = JCS_EXT_BGR; break;
+            case RS2_FORMAT_RGBA8: color_space = JCS_EXT_RGBA; break;
+            case RS2_FORMAT_BGRA8: color_space = JCS_EXT_BGRA; break;
+            case RS2_FORMAT_Y8: color_space = JCS_GRAYSCALE; break;
+            default:
+                LOG_ERROR("Unsupported format for MJPEG conversion.");
+                return false;
+            }
+
+            if (setjmp(_error.jump))
+            {
+                LOG_ERROR("jpeg decode failed: " << _error.message);
+                jpeg_abort_decompress(&_info);
+                return false;
+            }
+
+            jpeg_mem_src(&_info, const_cast<byte *>(source), static_cast<unsigned long>(size));
+            jpeg_read_header(&_info, TRUE);
+            _info.out_color_space = color_space;
+            _info.scale_num = 1;
+            _info.scale_denom = 1;
+            while (_info.scale_denom < 8 && (int)((_info.image_width + _info.scale_denom - 1) / _info.scale_denom) > width)
+                _info.scale_denom *= 2;
+
+            jpeg_start_decompress(&_info);
+            if ((int)_info.output_width != width || (int)_info.output_height != height)
+            {
+                LOG_ERROR("jpeg decode failed: " << _info.output_width << "x" << _info.output_height
+                    << " image for a " << width << "x" << height << " frame");
+                jpeg_abort_decompress(&_info);
+                return false;
+            }
+
+            const auto stride = width * _info.output_components;
+            JSAMPROW rows[16];
+            while (_info.output_scanline < _info.output_height)
+            {
+                auto count = std::min<JDIMENSION>(16, _info.output_height - _info.output_scanline);
+                for (JDIMENSION i = 0; i < count; ++i)
+                    rows[i] = dest + (_info.output_scanline + i) * stride;
+                jpeg_read_scanlines(&_info, rows, count);
+            }
+            jpeg_finish_decompress(&_info);
+            return true;
+        }
+
+    private:
+        struct error_manager
+        {
+            jpeg_error_mgr mgr; // First, as libjpeg passes a pointer to it
+            std::jmp_buf jump;
+            char message[JMSG_LENGTH_MAX];
+        };
+
+        // libjpeg exits the process on errors, unless the handler leaves instead
+        static void on_error(j_common_ptr info)
+        {
+            auto error = reinterpret_cast<error_manager *>(info->err);
+            (*info->err->format_message)(info, error->message);
+            std::longjmp(error->jump, 1);
+        }
+
+        // Warnings of corrupt data, which still decodes
+        static void on_message(j_common_ptr info)
+        {
+            char message[JMSG_LENGTH_MAX];
+            (*info->err->format_message)(info, message);
+            LOG_DEBUG("jpeg decode: " << message);
+        }
+
+        jpeg_decompress_struct _info;
+        error_manager _error;
+    };
+#else
+    class jpeg_decoder {};
+#endif
+
+    bool unpack_mjpeg(byte * const dest[], const byte * source, int width, int height, int actual_size, int input_size)
     {
         int w, h, bpp;
         auto uncompressed_rgb = stbi_load_from_memory(source, actual_size, &w, &h, &bpp, false);
@@ -661,24 +764,70 @@ namespace librealsense
             auto uncompressed_size = w * h * bpp;
             librealsense::copy(dest[0], uncompressed_rgb, uncompressed_size);
             stbi_image_free(uncompressed_rgb);
+            return true;
         }
-        else
-            LOG_ERROR("jpeg decode failed");
+        LOG_ERROR("jpeg decode failed");
+        return false;
     }
 
     /////////////////////////////
     // BGR unpacking routines //
     /////////////////////////////
+#ifdef __SSSE3__
+    static int unpack_rgb_from_bgr_ssse3(byte * d, const byte * s, int count)
+    {
+        // 5 pixels per register; the 16th byte is copied as is, and rewritten by the next store
+        const __m128i swap = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+        int i = 0;
+        for (; i * 3 + 16 <= count * 3; i += 5)
+        {
+            __m128i bgr = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i * 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(d + i * 3), _mm_shuffle_epi8(bgr, swap));
+        }
+        return i;
+    }
+#endif
+
+#ifdef __ARM_NEON
+    static int unpack_rgb_from_bgr_neon(byte * d, const byte * s, int count)
+    {
+        int i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x3_t bgr = vld3q_u8(s + i * 3);
+            uint8x16x3_t rgb = { { bgr.val[2], bgr.val[1], bgr.val[0] } };
+            vst3q_u8(d + i * 3, rgb);
+        }
+        return i;
+    }
+#endif
+
     void unpack_rgb_from_bgr(byte * const dest[], const byte * source, int width, int height, int actual_size)
     {
         auto count = width * height;
         auto in = reinterpret_cast<const uint8_t *>(source);
         auto out = reinterpret_cast<uint8_t *>(dest[0]);
 
-        librealsense::copy(out, in, count * 3);
-        for (auto i = 0; i < count; i++)
+        int done = 0;
+        switch (cpu_simd_level())
+        {
+#if defined __SSSE3__ && ! defined ANDROID
+        case simd_level::avx2: done = unpack_rgb_from_bgr_avx(out, in, count); break;
+#endif
+#ifdef __SSSE3__
+        case simd_level::ssse3: done = unpack_rgb_from_bgr_ssse3(out, in, count); break;
+#endif
+#ifdef __ARM_NEON
+        case simd_level::neon: done = unpack_rgb_from_bgr_neon(out, in, count); break;
+#endif
+        default: break;
+        }
+
+        for (auto i = done; i < count; i++)
         {
-            std::swap(out[i * 3], out[i * 3 + 2]);
+            out[i * 3] = in[i * 3 + 2];
+            out[i * 3 + 1] = in[i * 3 + 1];
+            out[i * 3 + 2] = in[i * 3];
         }
     }
 
@@ -692,9 +841,102 @@ namespace librealsense
         unpack_uyvyc(_target_format, _target_stream, dest, source, width, height, actual_size);
     }
 
+#ifdef RS2_USE_LIBJPEG_TURBO
+    // Set from the application while frames are decoded, so the scale is atomic
+    class mjpeg_decode_scale : public option_base
+    {
+    public:
+        mjpeg_decode_scale(std::atomic<int>& scale)
+            : option_base({ 1, 4, 1, 1 }),
+              _scale(scale)
+        {}
+
+        void set(float value) override
+        {
+            if (!is_valid(value) || value == 3)
+                throw invalid_value_exception(to_string() << "Unsupported MJPEG decode scale " << value);
+
+            _scale = static_cast<int>(value);
+            _recording_function(*this);
+        }
+
+        float query() const override { return static_cast<float>(_scale.load()); }
+
+        bool is_enabled() const override { return true; }
+
+        const char* get_description() const override { return "Decode at 1/2 or 1/4 of the resolution"; }
+
+        const char* get_value_description(float value) const override
+        {
+            if (value == 1) return "Full";
+            if (value == 2) return "Half";
+            if (value == 4) return "Quarter";
+            return nullptr;
+        }
+    private:
+        std::atomic<int>& _scale;
+    };
+#endif
+
+    mjpeg_converter::mjpeg_converter(const char* name, rs2_format target_format) :
+        color_converter(name, target_format)
+    {
+#ifdef RS2_USE_LIBJPEG_TURBO
+        _decoder.reset(new jpeg_decoder());
+
+        register_option(RS2_OPTION_FILTER_MAGNITUDE, std::make_shared<mjpeg_decode_scale>(_scale));
+#endif
+    }
+
+    mjpeg_converter::~mjpeg_converter() = default;
+
+    rs2::frame mjpeg_converter::prepare_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        _source_size = static_cast<int>(f.get_data_size());
+
+        const int scale = _scale;
+        auto vf = f.as<rs2::video_frame>();
+        if (scale == 1 || !vf)
+            return functional_processing_block::prepare_frame(source, f);
+
+        init_profiles_info(&f);
+        if (_scaled_source_profile.get() != _source_stream_profile.get() || _scaled_profile_scale != scale)
+        {
+            // As the decimation filter does, with the size rounded up as libjpeg does
+            auto profile = _source_stream_profile.clone(_source_stream_profile.stream_type(), _source_stream_profile.stream_index(), _target_format);
+            auto src_vspi = dynamic_cast<video_stream_profile_interface*>(_source_stream_profile.get()->profile);
+            auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(profile.get()->profile);
+            rs2_intrinsics intrin = src_vspi->get_intrinsics();
+            intrin.width = (src_vspi->get_width() + scale - 1) / scale;
+            intrin.height = (src_vspi->get_height() + scale - 1) / scale;
+            intrin.fx /= scale;
+            intrin.fy /= scale;
+            intrin.ppx /= scale;
+            intrin.ppy /= scale;
+            tgt_vspi->set_intrinsics([intrin]() { return intrin; });
+            tgt_vspi->set_dims(intrin.width, intrin.height);
+
+            _scaled_source_profile = _source_stream_profile;
+            _scaled_profile = profile;
+            _scaled_profile_scale = scale;
+        }
+
+        int width = (vf.get_width() + scale - 1) / scale;
+        int height = (vf.get_height() + scale - 1) / scale;
+        return source.allocate_video_frame(_scaled_profile, f, _target_bpp,
+            width, height, width * _target_bpp, _extension_type);
+    }
+
     void mjpeg_converter::process_function(byte * const dest[], const byte * source, int width, int height, int actual_size, int input_size)
     {
-        unpack_mjpeg(dest, source, width, height, actual_size, input_size);
+#ifdef RS2_USE_LIBJPEG_TURBO
+        bool decoded = _decoder->decode(source, _source_size, _target_format, dest[0], width, height);
+#else
+        bool decoded = unpack_mjpeg(dest, source, width, height, actual_size, input_size);
+#endif
+        // A black frame rather than whatever the buffer held before, or the rows decoded before the error
+        if (!decoded)
+            std::memset(dest[0], 0, width * height * _target_bpp);
     }
 
     void bgr_to_rgb::process_function(byte * const dest[], const byte * source, int width, int height, int actual_size, int input_size)
@@ -5,6 +5,8 @@
 
 #include "synthetic-stream.h"
 
+#include <atomic>
+
 namespace librealsense
 {
     class LRS_EXTENSION_API color_converter : public functional_processing_block
@@ -38,16 +40,32 @@ namespace librealsense
         void process_function(byte * const dest[], const byte * source, int width, int height, int actual_size, int input_size) override;
     };
 
+    class jpeg_decoder;
+
+    // Decodes MJPEG into RGB8. Built with libjpeg-turbo (BUILD_WITH_LIBJPEG_TURBO), it also decodes
+    // into RGBA8/BGR8/BGRA8/Y8, straight into the target frame, and can scale the image down by 2 or
+    // 4 while decoding (RS2_OPTION_FILTER_MAGNITUDE)
     class LRS_EXTENSION_API mjpeg_converter : public color_converter
     {
     public:
         mjpeg_converter(rs2_format target_format) :
             mjpeg_converter("MJPEG Converter", target_format) {};
+        ~mjpeg_converter();
 
     protected:
-        mjpeg_converter(const char* name, rs2_format target_format) :
-            color_converter(name, target_format) {};
+        mjpeg_converter(const char* name, rs2_format target_format);
+        rs2::frame prepare_frame(const rs2::frame_source& source, const rs2::frame& f) override;
         void process_function(byte * const dest[], const byte * source, int width, int height, int actual_size, int input_size) override;
+
+    private:
+        std::unique_ptr<jpeg_decoder> _decoder;
+        std::atomic<int> _scale{ 1 };
+        int _source_size = 0; // Of the compressed frame being decoded
+
+        // The target profile at the scale it was built for
+        rs2::stream_profile _scaled_source_profile;
+        rs2::stream_profile _scaled_profile;
+        int _scaled_profile_scale = 0;
     };
 
     class LRS_EXTENSION_API bgr_to_rgb : public color_converter
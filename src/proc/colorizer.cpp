@@ -7,12 +7,27 @@
 #include "proc/synthetic-stream.h"
 #include "context.h"
 #include "environment.h"
+#include "thread-pool.h"
 #include "option.h"
 #include "colorizer.h"
 #include "disparity-transform.h"
 
+#include <cstring>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace librealsense
 {
+    // Histogram bands, each counted separately (in parallel on the thread pool)
+    const int colorizer_histogram_bands = 4;
+
+    // Pixels per strip when applying the lookup table
+    const int colorizer_strip_size = 0x4000;
+
     static color_map hue{ {
         { 255, 0, 0 },
         { 255, 255, 0 },
@@ -138,11 +153,27 @@ namespace librealsense
         : colorizer("Depth Visualization")
     {}
 
-    colorizer::colorizer(const char* name)
+    colorizer::colorizer(rs2_format output_format)
+        : colorizer("Depth Visualization", output_format)
+    {}
+
+    colorizer::colorizer(const char* name, rs2_format output_format)
         : stream_filter_processing_block(name),
          _min(0.f), _max(6.f), _equalize(true), 
-         _target_stream_profile(), _histogram()
+         _target_stream_profile(), _histogram(),
+         _output_format(output_format)
     {
+        switch (output_format)
+        {
+        case RS2_FORMAT_RGB8: _bpp = 3; _red_offset = 0; break;
+        case RS2_FORMAT_BGR8: _bpp = 3; _red_offset = 2; break;
+        case RS2_FORMAT_RGBA8: _bpp = 4; _red_offset = 0; break;
+        case RS2_FORMAT_BGRA8: _bpp = 4; _red_offset = 2; break;
+        default:
+            throw invalid_value_exception(to_string()
+                << "Unsupported colorizer output format " << rs2_format_to_string(output_format));
+        }
+
         _histogram = std::vector<int>(MAX_DEPTH, 0);
         _hist_data = _histogram.data();
         _stream_filter.stream = RS2_STREAM_DEPTH;
@@ -238,7 +269,7 @@ namespace librealsense
         if (f.get_profile().get() != _source_stream_profile.get())
         {
             _source_stream_profile = f.get_profile();
-            _target_stream_profile = f.get_profile().clone(RS2_STREAM_DEPTH, f.get_profile().stream_index(), RS2_FORMAT_RGB8);
+            _target_stream_profile = f.get_profile().clone(RS2_STREAM_DEPTH, f.get_profile().stream_index(), _output_format);
 
             auto snr = ( (frame_interface *)f.get() )->get_sensor().get();
             auto depth_sensor = As< librealsense::depth_sensor >( snr );
@@ -284,8 +315,8 @@ namespace librealsense
             else if (depth_format == RS2_FORMAT_Z16)
             {
                 auto depth_data = reinterpret_cast<const uint16_t*>(depth.get_data());
-                update_histogram(_hist_data, depth_data, w, h);
-                make_rgb_data<uint16_t>(depth_data, rgb_data, w, h, coloring_function);
+                make_equalized_lut(depth_data, w, h);
+                apply_lut(depth_data, rgb_data, w, h);
             }
         };
 
@@ -312,20 +343,15 @@ namespace librealsense
             else if (depth_format == RS2_FORMAT_Z16)
             {
                 auto depth_data = reinterpret_cast<const uint16_t*>(depth.get_data());
-                auto min = _min;
-                auto max = _max;
-                auto coloring_function = [&, this](float data) {
-                    if (min >= max) return 0.f;
-                    return (data * _depth_units - min) / (max - min);
-                };
-                make_rgb_data<uint16_t>(depth_data, rgb_data, w, h, coloring_function);
+                make_value_cropped_lut();
+                apply_lut(depth_data, rgb_data, w, h);
             }
         };
 
         rs2::frame ret;
 
         auto vf = f.as<rs2::video_frame>();
-        ret = source.allocate_video_frame(_target_stream_profile, f, 3, vf.get_width(), vf.get_height(), vf.get_width() * 3, RS2_EXTENSION_VIDEO_FRAME);
+        ret = source.allocate_video_frame(_target_stream_profile, f, _bpp, vf.get_width(), vf.get_height(), vf.get_width() * _bpp, RS2_EXTENSION_VIDEO_FRAME);
 
         if (_equalize)
             make_equalized_histogram(f, ret);
@@ -334,4 +360,143 @@ namespace librealsense
 
         return ret;
     }
+
+    // The output pixel of a color map value, in the output order; without a map, black for holes
+    uint32_t colorizer::lut_entry(const color_map* cm, float value) const
+    {
+        uint8_t pixel[4] = { 0, 0, 0, 0xff };
+        if (cm)
+        {
+            auto c = cm->get(value);
+            pixel[_red_offset] = (uint8_t)c.x;
+            pixel[1] = (uint8_t)c.y;
+            pixel[2 - _red_offset] = (uint8_t)c.z;
+        }
+
+        uint32_t entry;
+        memcpy(&entry, pixel, sizeof(entry));
+        return entry;
+    }
+
+    void colorizer::make_equalized_lut(const uint16_t* depth_data, int width, int height)
+    {
+        // Count each band of the frame into its own histogram, then merge them into the
+        // cumulative histogram for the indices in [1,0xFFFF]
+        const int pixels = width * height;
+        _band_histograms.resize(colorizer_histogram_bands * MAX_DEPTH);
+        auto bands = _band_histograms.data();
+
+        parallel_for(colorizer_histogram_bands, [&](int b)
+        {
+            int* hist = bands + b * MAX_DEPTH;
+            memset(hist, 0, MAX_DEPTH * sizeof(int));
+            const int end = int(int64_t(pixels) * (b + 1) / colorizer_histogram_bands);
+            for (int i = int(int64_t(pixels) * b / colorizer_histogram_bands); i < end; ++i)
+                hist[depth_data[i]] += 1;
+        });
+
+        int cumulative = 0;
+        for (int i = 0; i < MAX_DEPTH; ++i)
+        {
+            int count = 0;
+            for (int b = 0; b < colorizer_histogram_bands; ++b)
+                count += bands[b * MAX_DEPTH + i];
+            if (i)
+                cumulative += count;
+            _hist_data[i] = i ? cumulative : count;
+        }
+
+        // Only the depth values present in the frame are looked up
+        _lut.resize(MAX_DEPTH);
+        _lut_key = std::make_tuple(0.f, 0.f, 0.f, -1);
+        _lut[0] = lut_entry(nullptr, 0.f);
+        auto cm = _maps[_map_index];
+        auto total = (float)_hist_data[MAX_DEPTH - 1];
+        for (int i = 1; i < MAX_DEPTH; ++i)
+        {
+            if (i == 1 ? _hist_data[1] != 0 : _hist_data[i] != _hist_data[i - 1])
+                _lut[i] = lut_entry(cm, _hist_data[i] / total);
+        }
+    }
+
+    void colorizer::make_value_cropped_lut()
+    {
+        auto key = std::make_tuple(_min, _max, _depth_units, _map_index);
+        if (_lut.size() == MAX_DEPTH && key == _lut_key)
+            return;
+
+        _lut.resize(MAX_DEPTH);
+        _lut_key = key;
+        _lut[0] = lut_entry(nullptr, 0.f);
+        auto cm = _maps[_map_index];
+        for (int i = 1; i < MAX_DEPTH; ++i)
+        {
+            float data = float(i);
+            _lut[i] = lut_entry(cm, (_min >= _max) ? 0.f : (data * _depth_units - _min) / (_max - _min));
+        }
+    }
+
+    void colorizer::apply_lut(const uint16_t* depth_data, uint8_t* rgb_data, int width, int height) const
+    {
+        const int pixels = width * height;
+        const int strips = (pixels + colorizer_strip_size - 1) / colorizer_strip_size;
+        const uint32_t* lut = _lut.data();
+        const int bpp = _bpp;
+
+        parallel_for(strips, [&](int s)
+        {
+            int i = s * colorizer_strip_size;
+            const int end = std::min(pixels, i + colorizer_strip_size);
+            uint8_t* out = rgb_data + size_t(i) * bpp;
+
+#if defined(__SSSE3__)
+            // Gather 16 pixels, and store them whole, or packed to 3 bytes each
+            const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+            for (; i + 16 <= end; i += 16, out += 16 * bpp)
+            {
+                const uint16_t* d = depth_data + i;
+                __m128i v[4];
+                for (int k = 0; k < 4; ++k)
+                    v[k] = _mm_setr_epi32(int(lut[d[4 * k]]), int(lut[d[4 * k + 1]]), int(lut[d[4 * k + 2]]), int(lut[d[4 * k + 3]]));
+
+                __m128i* o = reinterpret_cast<__m128i*>(out);
+                if (bpp == 4)
+                {
+                    for (int k = 0; k < 4; ++k)
+                        _mm_storeu_si128(o + k, v[k]);
+                }
+                else
+                {
+                    for (int k = 0; k < 4; ++k)
+                        v[k] = _mm_shuffle_epi8(v[k], pack);
+                    _mm_storeu_si128(o, _mm_or_si128(v[0], _mm_slli_si128(v[1], 12)));
+                    _mm_storeu_si128(o + 1, _mm_or_si128(_mm_srli_si128(v[1], 4), _mm_slli_si128(v[2], 8)));
+                    _mm_storeu_si128(o + 2, _mm_or_si128(_mm_srli_si128(v[2], 8), _mm_slli_si128(v[3], 4)));
+                }
+            }
+#elif defined(__ARM_NEON)
+            // Gather 16 pixels, and store them whole, or without their 4th byte
+            for (; i + 16 <= end; i += 16, out += 16 * bpp)
+            {
+                uint32_t gathered[16];
+                for (int k = 0; k < 16; ++k)
+                    gathered[k] = lut[depth_data[i + k]];
+
+                uint8x16x4_t v = vld4q_u8(reinterpret_cast<const uint8_t*>(gathered));
+                if (bpp == 4)
+                    vst4q_u8(out, v);
+                else
+                {
+                    uint8x16x3_t rgb = { { v.val[0], v.val[1], v.val[2] } };
+                    vst3q_u8(out, rgb);
+                }
+            }
+#endif
+            for (; i < end; ++i, out += bpp)
+            {
+                uint32_t entry = lut[depth_data[i]];
+                memcpy(out, &entry, bpp);
+            }
+        });
+    }
 }
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <map>
+#include <tuple>
 #include <vector>
 
 namespace rs2
@@ -100,6 +101,9 @@ namespace librealsense {
     public:
         colorizer();
 
+        // Colorizes into RS2_FORMAT_RGB8, RS2_FORMAT_BGR8, RS2_FORMAT_RGBA8 or RS2_FORMAT_BGRA8
+        explicit colorizer(rs2_format output_format);
+
         template<typename T>
         static void update_histogram(int* hist, const T* depth_data, int w, int h)
         {
@@ -118,7 +122,7 @@ namespace librealsense {
         static const int MAX_DISPARITY = 0x2710;
 
     protected:
-        colorizer(const char* name);
+        colorizer(const char* name, rs2_format output_format = RS2_FORMAT_RGB8);
 
         bool should_process(const rs2::frame& frame) override;
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
@@ -137,22 +141,31 @@ namespace librealsense {
         template<typename T, typename F>
         void colorize_pixel(uint8_t* rgb_data, int idx, color_map* cm, T data, F coloring_func)
         {
+            uint8_t* pixel = rgb_data + idx * _bpp;
             if (data)
             {
                 auto f = coloring_func(data); // 0-255 based on histogram locationcolorize_pixel
                 auto c = cm->get(f);
-                rgb_data[idx * 3 + 0] = (uint8_t)c.x;
-                rgb_data[idx * 3 + 1] = (uint8_t)c.y;
-                rgb_data[idx * 3 + 2] = (uint8_t)c.z;
+                pixel[_red_offset] = (uint8_t)c.x;
+                pixel[1] = (uint8_t)c.y;
+                pixel[2 - _red_offset] = (uint8_t)c.z;
             }
             else
             {
-                rgb_data[idx * 3 + 0] = 0;
-                rgb_data[idx * 3 + 1] = 0;
-                rgb_data[idx * 3 + 2] = 0;
+                pixel[0] = 0;
+                pixel[1] = 0;
+                pixel[2] = 0;
             }
+            if (_bpp == 4)
+                pixel[3] = 0xff;
         }
 
+        // Z16 colorization through a lookup table of the output pixel of every depth value
+        uint32_t lut_entry(const color_map* cm, float value) const;
+        void make_equalized_lut(const uint16_t* depth_data, int width, int height);
+        void make_value_cropped_lut();
+        void apply_lut(const uint16_t* depth_data, uint8_t* rgb_data, int width, int height) const;
+
         float _min, _max;
         bool _equalize;
 
@@ -161,6 +174,13 @@ namespace librealsense {
 
         std::vector<int> _histogram;
         int* _hist_data;
+        std::vector<int> _band_histograms;      // A partial histogram for each band of the frame
+
+        rs2_format _output_format;
+        int _bpp;
+        int _red_offset;                        // 0 for RGB orders, 2 for BGR
+        std::vector<uint32_t> _lut;             // Output pixels, 4 bytes each, by depth value
+        std::tuple<float, float, float, int> _lut_key; // Min, max, units and map of a value-cropped LUT
 
         int _preset = 0;
         rs2::stream_profile _target_stream_profile;
@@ -0,0 +1,233 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "source.h"
+#include "proc/synthetic-stream.h"
+#include "proc/cross-device-syncer.h"
+
+namespace librealsense
+{
+    // Past this many captures pending, the oldest is emitted even if incomplete
+    static const size_t MAX_PENDING_CAPTURES = 8;
+
+    // A stream that delivered nothing for this long is no longer waited for
+    static const double STREAM_TIMEOUT_MS = 1000.;
+
+    // A counter offset is trusted only as long as the timestamps roughly agree with it; past this
+    // many tolerances, the counters were reset (e.g., the device restarted) and it is re-learned
+    static const double COUNTER_OFFSET_SLACK = 10.;
+
+    cross_device_syncer::cross_device_syncer( float tolerance_ms )
+        : processing_block( "Cross-Device Syncer" )
+        , _tolerance_ms( tolerance_ms )
+    {
+        // Called from the threads of all the devices; the output is emitted in capture order
+        auto f = [this]( frame_holder frame, synthetic_source_interface * source ) {
+            std::lock_guard< std::mutex > lock( _mutex );
+            if( auto composite = dynamic_cast< composite_frame * >( frame.frame ) )
+            {
+                // Framesets of a single device (e.g., from its own syncer) are matched per stream
+                for( size_t i = 0; i < composite->get_embedded_frames_count(); i++ )
+                {
+                    auto sub = composite->get_frame( int( i ) );
+                    sub->acquire();
+                    add( frame_holder( sub ), source );
+                }
+            }
+            else
+                add( std::move( frame ), source );
+        };
+        set_processing_callback( std::shared_ptr< rs2_frame_processor_callback >(
+            new internal_frame_processor_callback< decltype( f ) >( f ) ) );
+    }
+
+    cross_device_syncer::stream_state & cross_device_syncer::get_stream_state( frame_interface * f )
+    {
+        auto uid = f->get_stream()->get_unique_id();
+        auto it = _streams.find( uid );
+        if( it != _streams.end() )
+            return it->second;
+
+        stream_state s;
+        if( auto sensor = f->get_sensor() )
+        {
+            auto & dev = sensor->get_device();
+            if( dev.supports_info( RS2_CAMERA_INFO_SERIAL_NUMBER ) )
+                s.device = dev.get_info( RS2_CAMERA_INFO_SERIAL_NUMBER );
+            else
+            {
+                std::ostringstream ss;
+                ss << &dev;
+                s.device = ss.str();
+            }
+        }
+        return _streams[uid] = s;
+    }
+
+    cross_device_syncer::capture & cross_device_syncer::find_capture( int uid,
+                                                                      long long counter,
+                                                                      double timestamp,
+                                                                      double tolerance )
+    {
+        // Once the offset of this stream to the reference is known, its frame counter tells the capture
+        long long reference_counter = -1;
+        if( uid == _reference_stream )
+            reference_counter = counter;
+        else
+        {
+            auto offset = _counter_offsets.find( uid );
+            if( offset != _counter_offsets.end() )
+                reference_counter = counter - offset->second;
+        }
+        if( reference_counter >= 0 )
+        {
+            for( auto & c : _captures )
+            {
+                if( c.reference_counter != reference_counter || c.frames.count( uid ) )
+                    continue;
+                if( std::abs( c.timestamp - timestamp ) <= COUNTER_OFFSET_SLACK * tolerance )
+                    return c;
+                _counter_offsets.erase( uid );
+                reference_counter = -1;
+                break;
+            }
+        }
+
+        // Otherwise, the closest capture in time
+        capture * best = nullptr;
+        double best_diff = 0;
+        for( auto & c : _captures )
+        {
+            if( c.frames.count( uid ) )
+                continue;
+            // A capture already pinned to another counter is a different instant
+            if( reference_counter >= 0 && c.reference_counter >= 0 && c.reference_counter != reference_counter )
+                continue;
+            auto diff = std::abs( c.timestamp - timestamp );
+            if( diff <= tolerance && ( ! best || diff < best_diff ) )
+            {
+                best = &c;
+                best_diff = diff;
+            }
+        }
+        if( best )
+            return *best;
+
+        capture c;
+        c.timestamp = timestamp;
+        c.tolerance = tolerance;
+        auto it = std::find_if( _captures.begin(), _captures.end(), [timestamp]( capture const & other ) {
+            return other.timestamp > timestamp;
+        } );
+        return *_captures.insert( it, std::move( c ) );
+    }
+
+    void cross_device_syncer::learn_offsets( const capture & c )
+    {
+        if( c.reference_counter < 0 )
+            return;
+        for( auto & counter : c.counters )
+        {
+            if( counter.first != _reference_stream && ! _counter_offsets.count( counter.first ) )
+                _counter_offsets[counter.first] = counter.second - c.reference_counter;
+        }
+    }
+
+    void cross_device_syncer::add( frame_holder f, synthetic_source_interface * source )
+    {
+        auto uid = f->get_stream()->get_unique_id();
+        auto & s = get_stream_state( f.frame );
+        if( f->get_frame_timestamp_domain() != RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME && ! s.warned_domain )
+        {
+            LOG_WARNING( "Cross-device syncer: stream " << uid << " of device " << s.device
+                                                        << " is not in global time; enable global time on all devices" );
+            s.warned_domain = true;
+        }
+
+        auto timestamp = f->get_frame_timestamp();
+        auto counter = (long long)f->get_frame_number();
+        auto fps = f->get_stream()->get_framerate();
+        double tolerance = _tolerance_ms > 0 ? _tolerance_ms : ( fps ? 500. / fps : 500. / 30 );
+
+        s.last_timestamp = timestamp;
+        _latest_timestamp = std::max( _latest_timestamp, timestamp );
+
+        // Too late for its capture, which was emitted without it; a capture of its own would come
+        // out behind the ones already emitted
+        if( timestamp <= _last_emitted_timestamp + tolerance )
+        {
+            LOG_DEBUG( "Cross-device syncer: dropping late frame " << counter << " of stream " << uid << " at "
+                                                                     << timestamp );
+            return;
+        }
+
+        if( _reference_stream < 0 )
+            _reference_stream = uid;
+
+        auto & c = find_capture( uid, counter, timestamp, tolerance );
+        if( c.reference_counter < 0 )
+        {
+            if( uid == _reference_stream )
+                c.reference_counter = counter;
+            else
+            {
+                auto offset = _counter_offsets.find( uid );
+                if( offset != _counter_offsets.end() )
+                    c.reference_counter = counter - offset->second;
+            }
+        }
+        c.counters[uid] = counter;
+        c.frames[uid] = std::move( f );
+        learn_offsets( c );
+
+        while( ! _captures.empty() && is_ready( _captures.front() ) )
+        {
+            emit( _captures.front(), source );
+            _captures.pop_front();
+        }
+    }
+
+    bool cross_device_syncer::is_ready( const capture & c ) const
+    {
+        for( auto & s : _streams )
+        {
+            if( c.frames.count( s.first ) )
+                continue;
+            if( s.second.last_timestamp < _latest_timestamp - STREAM_TIMEOUT_MS )
+                continue;
+            // Frames of each stream arrive in order: past this capture, it will not be completed by it
+            if( s.second.last_timestamp > c.timestamp + c.tolerance )
+                continue;
+            return _captures.size() > MAX_PENDING_CAPTURES;
+        }
+        return true;
+    }
+
+    void cross_device_syncer::emit( capture & c, synthetic_source_interface * source )
+    {
+        _last_emitted_timestamp = std::max( _last_emitted_timestamp, c.timestamp );
+
+        // Frames of the same device are kept together, in a stable order
+        std::vector< std::pair< int, frame_holder > > ordered;
+        ordered.reserve( c.frames.size() );
+        for( auto & f : c.frames )
+            ordered.emplace_back( f.first, std::move( f.second ) );
+        std::stable_sort( ordered.begin(), ordered.end(),
+                          [this]( std::pair< int, frame_holder > const & a, std::pair< int, frame_holder > const & b ) {
+                              return _streams.at( a.first ).device < _streams.at( b.first ).device;
+                          } );
+
+        std::vector< frame_holder > frames;
+        frames.reserve( ordered.size() );
+        for( auto & f : ordered )
+            frames.push_back( std::move( f.second ) );
+
+        frame_holder composite( source->allocate_composite_frame( std::move( frames ) ) );
+        if( composite.frame )
+            source->frame_ready( std::move( composite ) );
+    }
+}
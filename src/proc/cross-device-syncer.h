@@ -0,0 +1,69 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <deque>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Matches the frames of several devices, typically hardware-synchronized with inter-cam sync,
+    // into one composite frame per capture instant.
+    //
+    // The devices should run with global time enabled, so that their timestamps are all on the host
+    // clock. Frames are grouped when their timestamps are within the tolerance of each other (by
+    // default, half a frame interval). Once frames of two streams were matched, the offset between
+    // their frame counters is remembered, and later frames are grouped by frame counter, which keeps
+    // working when the timestamps jitter past the tolerance.
+    //
+    // A frame that arrives after its capture was emitted, incomplete, is dropped rather than output
+    // on its own, out of order.
+    //
+    // The output composite frames reference the input frames; nothing is copied.
+    class cross_device_syncer : public processing_block
+    {
+    public:
+        // A tolerance of 0 means half the frame interval of each stream
+        explicit cross_device_syncer( float tolerance_ms = 0.f );
+
+    private:
+        struct capture
+        {
+            double timestamp;
+            double tolerance;
+            long long reference_counter = -1;      // Frame counter of the reference stream
+            std::map< int, long long > counters;   // By stream unique id
+            std::map< int, frame_holder > frames;  // By stream unique id
+        };
+
+        struct stream_state
+        {
+            std::string device;
+            double last_timestamp = 0;
+            bool warned_domain = false;
+        };
+
+        void add( frame_holder f, synthetic_source_interface * source );
+        stream_state & get_stream_state( frame_interface * f );
+        capture & find_capture( int uid, long long counter, double timestamp, double tolerance );
+        void learn_offsets( const capture & c );
+        bool is_ready( const capture & c ) const;
+        void emit( capture & c, synthetic_source_interface * source );
+
+        float _tolerance_ms;
+        std::mutex _mutex;
+
+        std::deque< capture > _captures;                 // Oldest first
+        std::map< int, stream_state > _streams;          // By stream unique id
+        int _reference_stream = -1;                      // First stream seen
+        std::map< int, long long > _counter_offsets;     // Stream counter minus reference counter
+        double _latest_timestamp = 0;
+        double _last_emitted_timestamp = std::numeric_limits< double >::lowest();
+    };
+}
@@ -7,12 +7,21 @@
 #include <numeric>
 #include <cmath>
 #include "environment.h"
+#include "thread-pool.h"
+#include "cpu-features.h"
 #include "option.h"
 #include "context.h"
 #include "core/video.h"
 #include "proc/synthetic-stream.h"
 #include "proc/decimation-filter.h"
 
+#include <algorithm>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #define PIX_SORT(a,b) { if ((a)>(b)) PIX_SWAP((a),(b)); }
 #define PIX_SWAP(a,b) { pixelvalue temp=(a);(a)=(b);(b)=temp; }
@@ -354,486 +363,477 @@ namespace librealsense
         return ret;
     }
 
-    void decimation_filter::decimate_depth(const uint16_t * frame_data_in, uint16_t * frame_data_out,
-        size_t width_in, size_t height_in, size_t scale)
+    // The median of the valid (non-zero) pixels of a scale x scale window; for an even count, the
+    // member one below the middle
+    static uint16_t median_of_valid(const uint16_t* p, size_t width_in, size_t scale, uint16_t* working_kernel)
     {
-        // Use median filtering
-        std::vector<uint16_t> working_kernel(_kernel_size);
-        auto wk_begin = working_kernel.data();
-        auto wk_itr = wk_begin;
-        std::vector<uint16_t*> pixel_raws(scale);
-        uint16_t* block_start = const_cast<uint16_t*>(frame_data_in);
-
-        if (scale == 2 || scale == 3)
+        auto wk_itr = working_kernel;
+        for (size_t n = 0; n < scale; ++n, p += width_in)
         {
-            for (int j = 0; j < _real_height; j++)
+            for (size_t m = 0; m < scale; ++m)
             {
-                uint16_t *p{};
-                // Mark the beginning of each of the N lines that the filter will run upon
-                for (size_t i = 0; i < pixel_raws.size(); i++)
-                    pixel_raws[i] = block_start + (width_in*i);
-
-                for (size_t i = 0, chunk_offset = 0; i < _real_width; i++)
-                {
-                    wk_itr = wk_begin;
-                    // extract data the kernel to process
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        p = pixel_raws[n] + chunk_offset;
-                        for (size_t m = 0; m < scale; ++m)
-                        {
-                            if (*(p + m))
-                                *wk_itr++ = *(p + m);
-                        }
-                    }
-
-                    // For even-size kernels pick the member one below the middle
-                    auto ks = (int)(wk_itr - wk_begin);
-                    if (ks == 0)
-                        *frame_data_out++ = 0;
-                    else
-                    {
-                        switch (ks)
-                        {
-                        case 1:
-                            *frame_data_out++ = working_kernel[0];
-                            break;
-                        case 2:
-                            *frame_data_out++ = PIX_MIN(working_kernel[0], working_kernel[1]);
-                            break;
-                        case 3:
-                            *frame_data_out++ = opt_med3<uint16_t>(working_kernel.data());
-                            break;
-                        case 4:
-                            *frame_data_out++ = opt_med4<uint16_t>(working_kernel.data());
-                            break;
-                        case 5:
-                            *frame_data_out++ = opt_med5<uint16_t>(working_kernel.data());
-                            break;
-                        case 6:
-                            *frame_data_out++ = opt_med6<uint16_t>(working_kernel.data());
-                            break;
-                        case 7:
-                            *frame_data_out++ = opt_med7<uint16_t>(working_kernel.data());
-                            break;
-                        case 8:
-                            *frame_data_out++ = opt_med8<uint16_t>(working_kernel.data());
-                            break;
-                        case 9:
-                            *frame_data_out++ = opt_med9<uint16_t>(working_kernel.data());
-                            break;
-                        }
-                    }
-
-                    chunk_offset += scale;
-                }
-
-                // Fill-in the padded colums with zeros
-                for (int j = _real_width; j < _padded_width; j++)
-                    *frame_data_out++ = 0;
-
-                // Skip N lines to the beginnig of the next processing segment
-                block_start += width_in * scale;
-            }
-        }
-        else
-        {
-            for (int j = 0; j < _real_height; j++)
-            {
-                uint16_t *p{};
-                // Mark the beginning of each of the N lines that the filter will run upon
-                for (size_t i = 0; i < pixel_raws.size(); i++)
-                    pixel_raws[i] = block_start + (width_in*i);
-
-                for (size_t i = 0, chunk_offset = 0; i < _real_width; i++)
-                {
-                    int sum = 0;
-                    int counter = 0;
-
-                    // extract data the kernel to process
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        p = pixel_raws[n] + chunk_offset;
-                        for (size_t m = 0; m < scale; ++m)
-                        {
-                            if (*(p + m))
-                            {
-                                sum += p[m];
-                                ++counter;
-                            }
-                        }
-                    }
-
-                    *frame_data_out++ = (counter == 0 ? 0 : sum / counter);
-                    chunk_offset += scale;
-                }
-
-                // Fill-in the padded colums with zeros
-                for (int j = _real_width; j < _padded_width; j++)
-                    *frame_data_out++ = 0;
-
-                // Skip N lines to the beginnig of the next processing segment
-                block_start += width_in * scale;
+                if (p[m])
+                    *wk_itr++ = p[m];
             }
         }
 
-        // Fill-in the padded rows with zeros
-        for (auto v = _real_height; v < _padded_height; ++v)
+        switch (wk_itr - working_kernel)
         {
-            for (auto u = 0; u < _padded_width; ++u)
-                *frame_data_out++ = 0;
+        case 0: return 0;
+        case 1: return working_kernel[0];
+        case 2: return PIX_MIN(working_kernel[0], working_kernel[1]);
+        case 3: return opt_med3<uint16_t>(working_kernel);
+        case 4: return opt_med4<uint16_t>(working_kernel);
+        case 5: return opt_med5<uint16_t>(working_kernel);
+        case 6: return opt_med6<uint16_t>(working_kernel);
+        case 7: return opt_med7<uint16_t>(working_kernel);
+        case 8: return opt_med8<uint16_t>(working_kernel);
+        default: return opt_med9<uint16_t>(working_kernel);
         }
     }
 
-    void decimation_filter::decimate_others(rs2_format format, const void * frame_data_in, void * frame_data_out,
-        size_t width_in, size_t height_in, size_t scale)
+#if defined(__SSSE3__) || defined(__ARM_NEON)
+    // Sorting networks for 4 and 9 values
+    static const int sort4_network[][2] = { {0,1}, {2,3}, {0,2}, {1,3}, {1,2} };
+    static const int sort9_network[][2] = {
+        {0,3}, {1,7}, {2,5}, {4,8}, {0,7}, {2,4}, {3,8}, {5,6}, {0,2}, {1,3}, {4,5}, {7,8},
+        {1,4}, {3,6}, {5,7}, {0,1}, {2,4}, {3,5}, {6,8}, {2,3}, {4,5}, {6,7}, {1,2}, {3,4}, {5,6} };
+
+    // Medians of 2x2 and 3x3 windows, 8 output pixels at a time. Every window is sorted whole with a
+    // sorting network, with the values decremented so that holes wrap around and sort last; the
+    // median of the k valid values is then the member (k - 1) / 2, and a window with no valid
+    // value gets back to 0 when incremented.
+    // Returns the index of the first output pixel left to compute.
+    static size_t median_depth_simd(const uint16_t* rows, size_t width_in, size_t scale, size_t real_width, uint16_t* out)
     {
-        int sum = 0;
-        auto patch_size = scale * scale;
-
-        switch (format)
-        {
-        case RS2_FORMAT_YUYV:
+        const size_t window = scale * scale;
+        size_t i = 0;
+#if defined(__SSSE3__)
+        // pshufb masks gathering every scale-th value, from each of the scale vectors of a row
+        __m128i gather[3][3];
+        for (size_t c = 0; c < scale; c++)
         {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
-
-            auto w_2 = width_in >> 1;
-            auto rw_2 = _real_width >> 1;
-            auto pw_2 = _padded_width >> 1;
-            auto s2 = scale >> 1;
-            bool odd = (scale & 1);
-            for (int j = 0; j < _real_height; ++j)
+            for (size_t v = 0; v < scale; v++)
             {
-                for (int i = 0; i < rw_2; ++i)
+                alignas(16) uint8_t mask[16];
+                for (size_t t = 0; t < 8; t++)
                 {
-                    p = from + scale * (j * w_2 + i) * 4;
-                    sum = 0;
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        for (size_t m = 0; m < scale; ++m)
-                            sum += p[m * 2];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-
-                    p = from + scale * (j * w_2 + i) * 4 + 1;
-                    sum = 0;
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        for (size_t m = 0; m < s2; ++m)
-                            sum += 2 * p[m * 4];
-
-                        if (odd)
-                            sum += p[s2 * 4];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-
-                    p = from + scale * (j * w_2 + i) * 4 + s2 * 4 + (odd ? 2 : 0);
-                    sum = 0;
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        for (size_t m = 0; m < scale; ++m)
-                            sum += p[m * 2];
+                    size_t e = c + scale * t;
+                    mask[2 * t] = (e / 8 == v) ? uint8_t(2 * (e % 8)) : 0x80;
+                    mask[2 * t + 1] = (e / 8 == v) ? uint8_t(2 * (e % 8) + 1) : 0x80;
+                }
+                gather[c][v] = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+            }
+        }
 
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
+        // Unsigned compare-exchange, on values biased to use the signed min/max of SSE2
+        const __m128i bias = _mm_set1_epi16(short(0x8000));
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i zero = _mm_setzero_si128();
 
-                    p = from + scale * (j * w_2 + i) * 4 + 3;
-                    sum = 0;
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        for (size_t m = 0; m < s2; ++m)
-                            sum += 2 * p[m * 4];
+        for (; (i + 8) * scale <= width_in && i + 8 <= real_width; i += 8)
+        {
+            __m128i values[9];
+            __m128i holes = zero;
+            for (size_t n = 0; n < scale; n++)
+            {
+                const uint16_t* row = rows + n * width_in + i * scale;
+                __m128i v[3];
+                for (size_t k = 0; k < scale; k++)
+                    v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 8 * k));
 
-                        if (odd)
-                            sum += p[s2 * 4];
+                for (size_t c = 0; c < scale; c++)
+                {
+                    __m128i g = _mm_shuffle_epi8(v[0], gather[c][0]);
+                    for (size_t k = 1; k < scale; k++)
+                        g = _mm_or_si128(g, _mm_shuffle_epi8(v[k], gather[c][k]));
 
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
+                    holes = _mm_sub_epi16(holes, _mm_cmpeq_epi16(g, zero));
+                    values[n * scale + c] = _mm_xor_si128(_mm_sub_epi16(g, one), bias);
                 }
+            }
 
-                for (int i = rw_2; i < pw_2; ++i)
+            auto sort = [&](const int (*network)[2], size_t size) {
+                for (size_t k = 0; k < size; k++)
                 {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
+                    __m128i& a = values[network[k][0]];
+                    __m128i& b = values[network[k][1]];
+                    __m128i lo = _mm_min_epi16(a, b);
+                    b = _mm_max_epi16(a, b);
+                    a = lo;
                 }
-            }
+            };
+            if (scale == 2)
+                sort(sort4_network, sizeof(sort4_network) / sizeof(sort4_network[0]));
+            else
+                sort(sort9_network, sizeof(sort9_network) / sizeof(sort9_network[0]));
 
-            for (int j = _real_height; j < _padded_height; ++j)
+            // With k = window - holes valid values, the median is member t once k >= 2t + 1
+            __m128i median = values[0];
+            for (size_t t = 1; 2 * t < window; t++)
             {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                }
+                __m128i select = _mm_cmpgt_epi16(_mm_set1_epi16(short(window - 2 * t)), holes);
+                median = _mm_or_si128(_mm_and_si128(select, values[t]), _mm_andnot_si128(select, median));
             }
+            median = _mm_add_epi16(_mm_xor_si128(median, bias), one);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), median);
         }
-        break;
+#else
+        const uint16x8_t one = vdupq_n_u16(1);
 
-        case RS2_FORMAT_UYVY:
+        for (; (i + 8) * scale <= width_in && i + 8 <= real_width; i += 8)
         {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
-
-            auto w_2 = width_in >> 1;
-            auto rw_2 = _real_width >> 1;
-            auto pw_2 = _padded_width >> 1;
-            auto s2 = scale >> 1;
-            bool odd = (scale & 1);
-            for (int j = 0; j < _real_height; ++j)
+            uint16x8_t values[9];
+            uint16x8_t holes = vdupq_n_u16(0);
+            for (size_t n = 0; n < scale; n++)
             {
-                for (int i = 0; i < rw_2; ++i)
+                const uint16_t* row = rows + n * width_in + i * scale;
+                uint16x8_t g[3];
+                if (scale == 2)
                 {
-                    p = from + scale * (j * w_2 + i) * 4;
-                    sum = 0;
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        for (size_t m = 0; m < s2; ++m)
-                            sum += 2 * p[m * 4];
-
-                        if (odd)
-                            sum += p[s2 * 4];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-
-                    p = from + scale * (j * w_2 + i) * 4 + 1;
-                    sum = 0;
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        for (size_t m = 0; m < scale; ++m)
-                            sum += p[m * 2];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-
-                    p = from + scale * (j * w_2 + i) * 4 + 2;
-                    sum = 0;
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        for (size_t m = 0; m < s2; ++m)
-                            sum += 2 * p[m * 4];
-
-                        if (odd)
-                            sum += p[s2 * 4];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-
-                    p = from + scale * (j * w_2 + i) * 4 + s2 * 4 + (odd ? 3 : 1);
-                    sum = 0;
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        for (size_t m = 0; m < scale; ++m)
-                            sum += p[m * 2];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
+                    uint16x8x2_t v = vld2q_u16(row);
+                    g[0] = v.val[0];
+                    g[1] = v.val[1];
+                }
+                else
+                {
+                    uint16x8x3_t v = vld3q_u16(row);
+                    g[0] = v.val[0];
+                    g[1] = v.val[1];
+                    g[2] = v.val[2];
                 }
 
-                for (int i = rw_2; i < pw_2; ++i)
+                for (size_t c = 0; c < scale; c++)
                 {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
+                    holes = vsubq_u16(holes, vceqq_u16(g[c], vdupq_n_u16(0)));
+                    values[n * scale + c] = vsubq_u16(g[c], one);
                 }
             }
 
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
+            auto sort = [&](const int (*network)[2], size_t size) {
+                for (size_t k = 0; k < size; k++)
                 {
-                    *q++ = 0;
-                    *q++ = 0;
+                    uint16x8_t& a = values[network[k][0]];
+                    uint16x8_t& b = values[network[k][1]];
+                    uint16x8_t lo = vminq_u16(a, b);
+                    b = vmaxq_u16(a, b);
+                    a = lo;
                 }
-            }
+            };
+            if (scale == 2)
+                sort(sort4_network, sizeof(sort4_network) / sizeof(sort4_network[0]));
+            else
+                sort(sort9_network, sizeof(sort9_network) / sizeof(sort9_network[0]));
+
+            // With k = window - holes valid values, the median is member t once k >= 2t + 1
+            uint16x8_t median = values[0];
+            for (size_t t = 1; 2 * t < window; t++)
+                median = vbslq_u16(vcltq_u16(holes, vdupq_n_u16(uint16_t(window - 2 * t))), values[t], median);
+            vst1q_u16(out + i, vaddq_u16(median, one));
         }
-        break;
+#endif
+        return i;
+    }
+#endif
 
-        case RS2_FORMAT_RGB8:
-        case RS2_FORMAT_BGR8:
+#if defined(__SSSE3__) || defined(__ARM_NEON)
+    // The vertical sums of sum_rows, 16 bytes at a time. Returns the index of the first element
+    // left to sum
+    template<bool count_valid>
+    static size_t sum_rows_simd(const uint8_t* from, size_t row_size, size_t scale, int* sums)
+    {
+        size_t x = 0;
+        for (; x + 16 <= row_size; x += 16)
         {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;;
-
-            for (int j = 0; j < _real_height; ++j)
+            // Up to 8 rows of bytes fit in 16 bits
+#if defined(__SSSE3__)
+            const __m128i zero = _mm_setzero_si128();
+            __m128i lo = zero, hi = zero;
+            for (size_t n = 0; n < scale; ++n)
             {
-                for (int i = 0; i < _real_width; ++i)
-                {
-                    for (int k = 0; k < 3; ++k)
-                    {
-                        p = from + scale * (j * width_in + i) * 3 + k;
-                        sum = 0;
-                        for (size_t n = 0; n < scale; ++n)
-                        {
-                            for (size_t m = 0; m < scale; ++m)
-                                sum += p[m * 3];
-
-                            p += width_in * 3;
-                        }
-
-                        *q++ = (uint8_t)(sum / patch_size);
-                    }
-                }
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + n * row_size + x));
+                lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+                hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + x), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + x + 4), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + x + 8), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + x + 12), _mm_unpackhi_epi16(hi, zero));
+#else
+            uint16x8_t lo = vdupq_n_u16(0), hi = vdupq_n_u16(0);
+            for (size_t n = 0; n < scale; ++n)
+            {
+                uint8x16_t v = vld1q_u8(from + n * row_size + x);
+                lo = vaddw_u8(lo, vget_low_u8(v));
+                hi = vaddw_u8(hi, vget_high_u8(v));
+            }
+            vst1q_s32(sums + x, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lo))));
+            vst1q_s32(sums + x + 4, vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(lo))));
+            vst1q_s32(sums + x + 8, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(hi))));
+            vst1q_s32(sums + x + 12, vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(hi))));
+#endif
+        }
+        return x;
+    }
 
-                for (int i = _real_width; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
+    // The vertical sums of sum_rows, 8 elements at a time
+    template<bool count_valid>
+    static size_t sum_rows_simd(const uint16_t* from, size_t row_size, size_t scale, int* sums)
+    {
+        size_t x = 0;
+        for (; x + 8 <= row_size; x += 8)
+        {
+#if defined(__SSSE3__)
+            const __m128i zero = _mm_setzero_si128();
+            __m128i lo = zero, hi = zero, holes = zero;
+            for (size_t n = 0; n < scale; ++n)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + n * row_size + x));
+                lo = _mm_add_epi32(lo, _mm_unpacklo_epi16(v, zero));
+                hi = _mm_add_epi32(hi, _mm_unpackhi_epi16(v, zero));
+                if (count_valid)
+                    holes = _mm_sub_epi16(holes, _mm_cmpeq_epi16(v, zero));
+            }
+            if (count_valid)
+            {
+                __m128i valid = _mm_sub_epi16(_mm_set1_epi16(short(scale)), holes);
+                lo = _mm_add_epi32(lo, _mm_slli_epi32(_mm_unpacklo_epi16(valid, zero), 26));
+                hi = _mm_add_epi32(hi, _mm_slli_epi32(_mm_unpackhi_epi16(valid, zero), 26));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + x), lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + x + 4), hi);
+#else
+            uint32x4_t lo = vdupq_n_u32(0), hi = vdupq_n_u32(0);
+            uint16x8_t holes = vdupq_n_u16(0);
+            for (size_t n = 0; n < scale; ++n)
+            {
+                uint16x8_t v = vld1q_u16(from + n * row_size + x);
+                lo = vaddw_u16(lo, vget_low_u16(v));
+                hi = vaddw_u16(hi, vget_high_u16(v));
+                if (count_valid)
+                    holes = vsubq_u16(holes, vceqq_u16(v, vdupq_n_u16(0)));
+            }
+            if (count_valid)
+            {
+                uint16x8_t valid = vsubq_u16(vdupq_n_u16(uint16_t(scale)), holes);
+                lo = vaddq_u32(lo, vshlq_n_u32(vmovl_u16(vget_low_u16(valid)), 26));
+                hi = vaddq_u32(hi, vshlq_n_u32(vmovl_u16(vget_high_u16(valid)), 26));
             }
+            vst1q_s32(sums + x, vreinterpretq_s32_u32(lo));
+            vst1q_s32(sums + x + 4, vreinterpretq_s32_u32(hi));
+#endif
+        }
+        return x;
+    }
+#endif
 
-            for (int j = _real_height; j < _padded_height; ++j)
+    // Sums each element of a row over the next scale rows. With count_valid, the number of non-zero
+    // elements is summed as well, above bit 26
+    template<bool count_valid, class T>
+    static void sum_rows(const T* from, size_t row_size, size_t scale, int* sums)
+    {
+        size_t x = 0;
+#if defined(__SSSE3__) || defined(__ARM_NEON)
+        if (cpu_simd_level() != simd_level::scalar)
+            x = sum_rows_simd<count_valid>(from, row_size, scale, sums);
+#endif
+        for (; x < row_size; ++x)
+        {
+            int sum = 0;
+            for (size_t n = 0; n < scale; ++n)
             {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
+                int v = from[n * row_size + x];
+                sum += count_valid ? (v | (v ? (1 << 26) : 0)) : v;
             }
+            sums[x] = sum;
         }
-        break;
+    }
 
-        case RS2_FORMAT_RGBA8:
-        case RS2_FORMAT_BGRA8:
+    // Output rows per band of the thread pool
+    static const int decimation_band_rows = 16;
+
+    // Box filtering, one output row at a time and in bands of rows on the thread pool: the input
+    // rows of a window are summed first, and 'horizontal' then sums the windows of the row,
+    // returning the number of elements it wrote
+    template<bool count_valid, class T, class F>
+    static void decimate_rows(const T* from, T* to, size_t row_size, size_t out_row_size,
+        size_t scale, int real_height, int padded_height, F horizontal)
+    {
+        const int bands = (real_height + decimation_band_rows - 1) / decimation_band_rows;
+        parallel_for(bands, [&](int b)
         {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
+            std::vector<int> sums(row_size);
 
-            for (int j = 0; j < _real_height; ++j)
+            const int end = std::min(real_height, (b + 1) * decimation_band_rows);
+            for (int j = b * decimation_band_rows; j < end; ++j)
             {
-                for (int i = 0; i < _real_width; ++i)
-                {
-                    for (int k = 0; k < 4; ++k)
-                    {
-                        p = from + scale * (j * width_in + i) * 4 + k;
-                        sum = 0;
-                        for (size_t n = 0; n < scale; ++n)
-                        {
-                            for (size_t m = 0; m < scale; ++m)
-                                sum += p[m * 4];
+                sum_rows<count_valid>(from + j * scale * row_size, row_size, scale, sums.data());
+                T* q = to + j * out_row_size;
 
-                            p += width_in * 4;
-                        }
+                // Fill-in the padded colums with zeros
+                std::fill(q + horizontal(sums.data(), q), q + out_row_size, T(0));
+            }
+        });
 
-                        *q++ = (uint8_t)(sum / patch_size);
-                    }
-                }
+        // Fill-in the padded rows with zeros
+        std::fill(to + real_height * out_row_size, to + padded_height * out_row_size, T(0));
+    }
 
-                for (int i = _real_width; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
+    void decimation_filter::decimate_depth(const uint16_t * frame_data_in, uint16_t * frame_data_out,
+        size_t width_in, size_t height_in, size_t scale)
+    {
+        const size_t real_width = _real_width;
+        const size_t padded_width = _padded_width;
 
-            for (int j = _real_height; j < _padded_height; ++j)
+        if (scale == 2 || scale == 3)
+        {
+            // Use median filtering, in bands of rows
+            const int real_height = int(_real_height);
+            const int bands = (real_height + decimation_band_rows - 1) / decimation_band_rows;
+            const bool vectorized = cpu_simd_level() != simd_level::scalar;
+            parallel_for(bands, [&](int b)
             {
-                for (int i = 0; i < _padded_width; ++i)
+                std::vector<uint16_t> working_kernel(_kernel_size);
+
+                const int end = std::min(real_height, (b + 1) * decimation_band_rows);
+                for (int j = b * decimation_band_rows; j < end; j++)
                 {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
+                    const uint16_t* rows = frame_data_in + j * scale * width_in;
+                    uint16_t* q = frame_data_out + j * padded_width;
+
+                    size_t i = 0;
+#if defined(__SSSE3__) || defined(__ARM_NEON)
+                    if (vectorized)
+                        i = median_depth_simd(rows, width_in, scale, real_width, q);
+#endif
+                    for (; i < real_width; i++)
+                        q[i] = median_of_valid(rows + i * scale, width_in, scale, working_kernel.data());
+
+                    // Fill-in the padded colums with zeros
+                    std::fill(q + real_width, q + padded_width, uint16_t(0));
                 }
-            }
-        }
-        break;
+            });
 
-        case RS2_FORMAT_Y8:
+            // Fill-in the padded rows with zeros
+            std::fill(frame_data_out + _real_height * padded_width, frame_data_out + _padded_height * padded_width, uint16_t(0));
+        }
+        else
         {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
-
-            for (int j = 0; j < _real_height; ++j)
-            {
-                for (int i = 0; i < _real_width; ++i)
-                {
-                    p = from + scale * (j * width_in + i);
-                    sum = 0;
-                    for (size_t n = 0; n < scale; ++n)
+            // The mean of the valid pixels
+            decimate_rows<true>(frame_data_in, frame_data_out, width_in, padded_width, scale, _real_height, _padded_height,
+                [&](const int* sums, uint16_t* q) {
+                    for (size_t i = 0; i < real_width; i++)
                     {
+                        int sum = 0;
+                        int counter = 0;
                         for (size_t m = 0; m < scale; ++m)
-                            sum += p[m];
-
-                        p += width_in;
+                        {
+                            sum += sums[i * scale + m] & 0x3ffffff;
+                            counter += sums[i * scale + m] >> 26;
+                        }
+                        q[i] = (counter == 0 ? 0 : sum / counter);
                     }
-
-                    *q++ = (uint8_t)(sum / patch_size);
-                }
-
-                for (int i = _real_width; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
+                    return real_width;
+                });
         }
-        break;
+    }
 
-        case RS2_FORMAT_Y16:
-        {
-            uint16_t* from = (uint16_t*)frame_data_in;
-            uint16_t* p = nullptr;
-            uint16_t* q = (uint16_t*)frame_data_out;
+    void decimation_filter::decimate_others(rs2_format format, const void * frame_data_in, void * frame_data_out,
+        size_t width_in, size_t height_in, size_t scale)
+    {
+        const int patch_size = int(scale * scale);
+        const size_t real_width = _real_width;
+        const size_t padded_width = _padded_width;
 
-            for (int j = 0; j < _real_height; ++j)
-            {
-                for (int i = 0; i < _real_width; ++i)
-                {
-                    p = from + scale * (j * width_in + i);
-                    sum = 0;
-                    for (size_t n = 0; n < scale; ++n)
+        switch (format)
+        {
+        case RS2_FORMAT_YUYV:
+        case RS2_FORMAT_UYVY:
+        {
+            // Each 4 bytes hold two pixels, with the chroma shared between the two; the luma and
+            // chroma positions swap between the formats
+            const size_t y0 = (format == RS2_FORMAT_YUYV) ? 0 : 1;
+            const size_t c0 = 1 - y0;
+            const size_t rw_2 = real_width >> 1;
+            const size_t s2 = scale >> 1;
+            const bool odd = (scale & 1);
+
+            decimate_rows<false>((const uint8_t*)frame_data_in, (uint8_t*)frame_data_out, (width_in >> 1) * 4, padded_width * 2,
+                scale, _real_height, _padded_height, [&](const int* sums, uint8_t* q) {
+                    for (size_t i = 0; i < rw_2; ++i)
                     {
+                        const int* p = sums + scale * i * 4;
+                        int luma[2] = { 0, 0 };
+                        int chroma[2] = { 0, 0 };
                         for (size_t m = 0; m < scale; ++m)
-                            sum += p[m];
+                        {
+                            luma[0] += p[y0 + m * 2];
+                            luma[1] += p[y0 + s2 * 4 + (odd ? 2 : 0) + m * 2];
+                        }
+                        for (size_t k = 0; k < 2; ++k)
+                        {
+                            for (size_t m = 0; m < s2; ++m)
+                                chroma[k] += 2 * p[c0 + 2 * k + m * 4];
+                            if (odd)
+                                chroma[k] += p[c0 + 2 * k + s2 * 4];
+                        }
 
-                        p += width_in;
+                        q[y0] = (uint8_t)(luma[0] / patch_size);
+                        q[c0] = (uint8_t)(chroma[0] / patch_size);
+                        q[y0 + 2] = (uint8_t)(luma[1] / patch_size);
+                        q[c0 + 2] = (uint8_t)(chroma[1] / patch_size);
+                        q += 4;
                     }
+                    return rw_2 * 4;
+                });
+        }
+        break;
 
-                    *q++ = (uint16_t)(sum / patch_size);
-                }
+        case RS2_FORMAT_RGB8:
+        case RS2_FORMAT_BGR8:
+            decimate_interleaved<uint8_t>(frame_data_in, frame_data_out, width_in, scale, 3);
+            break;
 
-                for (int i = _real_width; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
+        case RS2_FORMAT_RGBA8:
+        case RS2_FORMAT_BGRA8:
+            decimate_interleaved<uint8_t>(frame_data_in, frame_data_out, width_in, scale, 4);
+            break;
 
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
-        }
-        break;
+        case RS2_FORMAT_Y8:
+            decimate_interleaved<uint8_t>(frame_data_in, frame_data_out, width_in, scale, 1);
+            break;
+
+        case RS2_FORMAT_Y16:
+            decimate_interleaved<uint16_t>(frame_data_in, frame_data_out, width_in, scale, 1);
+            break;
 
         default:
             break;
         }
     }
-}
 
+    template<class T>
+    void decimation_filter::decimate_interleaved(const void * frame_data_in, void * frame_data_out,
+        size_t width_in, size_t scale, size_t channels)
+    {
+        const int patch_size = int(scale * scale);
+        const size_t real_width = _real_width;
+
+        decimate_rows<false>((const T*)frame_data_in, (T*)frame_data_out, width_in * channels, _padded_width * channels,
+            scale, _real_height, _padded_height, [&](const int* sums, T* q) {
+                for (size_t i = 0; i < real_width; ++i)
+                {
+                    for (size_t k = 0; k < channels; ++k)
+                    {
+                        const int* p = sums + scale * i * channels + k;
+                        int sum = 0;
+                        for (size_t m = 0; m < scale; ++m)
+                            sum += p[m * channels];
+
+                        *q++ = (T)(sum / patch_size);
+                    }
+                }
+                return real_width * channels;
+            });
+    }
+}
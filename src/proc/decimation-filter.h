@@ -23,11 +23,19 @@ namespace librealsense
 
         void decimate_others(rs2_format format, const void * frame_data_in, void * frame_data_out,
             size_t width_in, size_t height_in, size_t scale);
+
+        // The formats of interleaved channels, all of the same type
+        template<class T>
+        void decimate_interleaved(const void * frame_data_in, void * frame_data_out,
+            size_t width_in, size_t scale, size_t channels);
+
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
     private:
         void    update_output_profile(const rs2::frame& f);
 
+        friend class depth_post_processing;
+
         uint8_t                 _decimation_factor;
         uint8_t                 _control_val;
         uint8_t                 _patch_size;
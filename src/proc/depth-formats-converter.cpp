@@ -4,13 +4,108 @@
 #include "depth-formats-converter.h"
 
 #include "stream.h"
+#include "image-avx.h"
+#include "cpu-features.h"
 
 #ifdef RS2_USE_CUDA
 #include "cuda/cuda-conversion.cuh"
 #endif
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
 
 namespace librealsense
 {
+    // 10-bit pixels in 16 bits, to Y16 (<< 6) and to Y8 (>> 2, truncated to 8 bits)
+#ifdef __SSSE3__
+    static int unpack_y16_from_y16_10_ssse3(uint16_t * d, const uint16_t * s, int count)
+    {
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(d + i), _mm_slli_epi16(p, 6));
+        }
+        return i;
+    }
+
+    static int unpack_y8_from_y16_10_ssse3(uint8_t * d, const uint16_t * s, int count)
+    {
+        const __m128i low_byte = _mm_set1_epi16(0xff);
+        int i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i a = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i)), 2), low_byte);
+            __m128i b = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i + 8)), 2), low_byte);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(d + i), _mm_packus_epi16(a, b));
+        }
+        return i;
+    }
+#endif
+
+#ifdef __ARM_NEON
+    static int unpack_y16_from_y16_10_neon(uint16_t * d, const uint16_t * s, int count)
+    {
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+            vst1q_u16(d + i, vshlq_n_u16(vld1q_u16(s + i), 6));
+        return i;
+    }
+
+    static int unpack_y8_from_y16_10_neon(uint8_t * d, const uint16_t * s, int count)
+    {
+        int i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x8_t a = vmovn_u16(vshrq_n_u16(vld1q_u16(s + i), 2));
+            uint8x8_t b = vmovn_u16(vshrq_n_u16(vld1q_u16(s + i + 8), 2));
+            vst1q_u8(d + i, vcombine_u8(a, b));
+        }
+        return i;
+    }
+#endif
+
+    static void unpack_y16_from_y16_10(uint16_t * d, const uint16_t * s, int count)
+    {
+        int done = 0;
+        switch (cpu_simd_level())
+        {
+#if defined __SSSE3__ && ! defined ANDROID
+        case simd_level::avx2: done = unpack_y16_from_y16_10_avx(d, s, count); break;
+#endif
+#ifdef __SSSE3__
+        case simd_level::ssse3: done = unpack_y16_from_y16_10_ssse3(d, s, count); break;
+#endif
+#ifdef __ARM_NEON
+        case simd_level::neon: done = unpack_y16_from_y16_10_neon(d, s, count); break;
+#endif
+        default: break;
+        }
+        for (int i = done; i < count; ++i) d[i] = s[i] << 6;
+    }
+
+    static void unpack_y8_from_y16_10(uint8_t * d, const uint16_t * s, int count)
+    {
+        int done = 0;
+        switch (cpu_simd_level())
+        {
+#if defined __SSSE3__ && ! defined ANDROID
+        case simd_level::avx2: done = unpack_y8_from_y16_10_avx(d, s, count); break;
+#endif
+#ifdef __SSSE3__
+        case simd_level::ssse3: done = unpack_y8_from_y16_10_ssse3(d, s, count); break;
+#endif
+#ifdef __ARM_NEON
+        case simd_level::neon: done = unpack_y8_from_y16_10_neon(d, s, count); break;
+#endif
+        default: break;
+        }
+        for (int i = done; i < count; ++i) d[i] = s[i] >> 2;
+    }
+
     void unpack_z16_y8_from_sr300_inzi(byte * const dest[], const byte * source, int width, int height, int actual_size)
     {
         auto count = width * height;
@@ -20,7 +115,8 @@ namespace librealsense
         rscuda::unpack_z16_y8_from_sr300_inzi_cuda(out_ir, in, count);
         in += count;
 #else
-        for (int i = 0; i < count; ++i) *out_ir++ = *in++ >> 2;
+        unpack_y8_from_y16_10(out_ir, in, count);
+        in += count;
 #endif
         librealsense::copy(dest[0], in, count * 2);
     }
@@ -34,7 +130,8 @@ namespace librealsense
         rscuda::unpack_z16_y16_from_sr300_inzi_cuda(out_ir, in, count);
         in += count;
 #else
-        for (int i = 0; i < count; ++i) *out_ir++ = *in++ << 6;
+        unpack_y16_from_y16_10(out_ir, in, count);
+        in += count;
 #endif
         librealsense::copy(dest[0], in, count * 2);
     }
@@ -55,14 +152,8 @@ namespace librealsense
         }
     }
 
-    template<class SOURCE, class UNPACK> void unpack_pixels(byte * const dest[], int count, const SOURCE * source, UNPACK unpack, int actual_size)
-    {
-        auto out = reinterpret_cast<decltype(unpack(SOURCE())) *>(dest[0]);
-        for (int i = 0; i < count; ++i) *out++ = unpack(*source++);
-    }
-
-    void unpack_y16_from_y16_10(byte * const d[], const byte * s, int width, int height, int actual_size) { unpack_pixels(d, width * height, reinterpret_cast<const uint16_t*>(s), [](uint16_t pixel) -> uint16_t { return pixel << 6; }, actual_size); }
-    void unpack_y8_from_y16_10(byte * const d[], const byte * s, int width, int height, int actual_size) { unpack_pixels(d, width * height, reinterpret_cast<const uint16_t*>(s), [](uint16_t pixel) -> uint8_t { return pixel >> 2; }, actual_size); }
+    void unpack_y16_from_y16_10(byte * const d[], const byte * s, int width, int height, int actual_size) { unpack_y16_from_y16_10(reinterpret_cast<uint16_t*>(d[0]), reinterpret_cast<const uint16_t*>(s), width * height); }
+    void unpack_y8_from_y16_10(byte * const d[], const byte * s, int width, int height, int actual_size) { unpack_y8_from_y16_10(reinterpret_cast<uint8_t*>(d[0]), reinterpret_cast<const uint16_t*>(s), width * height); }
 
     void unpack_invi(rs2_format dst_format, byte * const d[], const byte * s, int width, int height, int actual_size)
     {
@@ -0,0 +1,197 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "option.h"
+#include "context.h"
+#include "software-device.h"
+#include "thread-pool.h"
+#include "proc/synthetic-stream.h"
+#include "proc/depth-post-processing.h"
+
+#include <algorithm>
+
+namespace librealsense
+{
+    // Pixels per strip of the per-pixel passes: small enough for a strip of disparity to stay in
+    // cache between the temporal filter and the conversion back to depth
+    const size_t post_processing_strip_size = 0x4000;
+
+    depth_post_processing::depth_post_processing() :
+        depth_processing_block("Depth Post-Processing"),
+        _decimation(std::make_shared<decimation_filter>()),
+        _depth_to_disparity(std::make_shared<disparity_transform>(true)),
+        _spatial(std::make_shared<spatial_filter>()),
+        _temporal(std::make_shared<temporal_filter>()),
+        _disparity_to_depth(std::make_shared<disparity_transform>(false)),
+        _hole_filling(std::make_shared<hole_filling_filter>()),
+        _stereoscopic_depth(false),
+        _width(0), _height(0)
+    {
+        _stream_filter.stream = RS2_STREAM_DEPTH;
+        _stream_filter.format = RS2_FORMAT_Z16;
+    }
+
+    std::shared_ptr<processing_block> depth_post_processing::get_stage(rs2_extension stage) const
+    {
+        switch (stage)
+        {
+        case RS2_EXTENSION_DECIMATION_FILTER: return _decimation;
+        case RS2_EXTENSION_SPATIAL_FILTER: return _spatial;
+        case RS2_EXTENSION_TEMPORAL_FILTER: return _temporal;
+        case RS2_EXTENSION_HOLE_FILLING_FILTER: return _hole_filling;
+        default:
+            throw invalid_value_exception(to_string()
+                << "Depth post-processing has no " << rs2_extension_type_to_string(stage) << " stage");
+        }
+    }
+
+    rs2::frame depth_post_processing::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        update_configuration(f);
+
+        // The only allocation: decimation writes into the output frame, and all the other stages
+        // work in place
+        rs2::frame tgt = source.allocate_video_frame(_decimated_profile, f, int(sizeof(uint16_t)),
+            int(_width), int(_height), int(_width * sizeof(uint16_t)), RS2_EXTENSION_DEPTH_FRAME);
+        if (!tgt)
+            return tgt;
+
+        auto src = f.as<rs2::video_frame>();
+        auto depth = static_cast<uint16_t*>(const_cast<void*>(tgt.get_data()));
+        {
+            std::lock_guard<std::mutex> lock(_decimation->_mutex);
+            _decimation->decimate_depth(static_cast<const uint16_t*>(src.get_data()), depth,
+                src.get_width(), src.get_height(), _decimation->_patch_size);
+        }
+
+        // Without a stereo baseline the disparity transforms pass the frame through, and the
+        // filters run on depth
+        if (_stereoscopic_depth)
+            smooth_disparity(depth);
+        else
+            smooth_depth(depth);
+
+        {
+            std::lock_guard<std::mutex> lock(_hole_filling->_mutex);
+            _hole_filling->apply_hole_filling<uint16_t>(depth);
+        }
+
+        return tgt;
+    }
+
+    void depth_post_processing::smooth_disparity(uint16_t* depth)
+    {
+        const size_t pixels = _width * _height;
+        const int strips = int((pixels + post_processing_strip_size - 1) / post_processing_strip_size);
+        auto disparity = _disparity.data();
+
+        parallel_for(strips, [&](int s)
+        {
+            size_t begin = s * post_processing_strip_size;
+            size_t end = std::min(pixels, begin + post_processing_strip_size);
+            _depth_to_disparity->convert<uint16_t, float>(depth + begin, disparity + begin, end - begin);
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(_spatial->_mutex);
+            _spatial->dxf_smooth<float>(disparity, _spatial->_spatial_alpha_param,
+                _spatial->_spatial_edge_threshold, _spatial->_spatial_iterations);
+        }
+
+        std::lock_guard<std::mutex> lock(_temporal->_mutex);
+        auto last_frame = reinterpret_cast<float*>(_temporal->_last_frame.data());
+        auto history = _temporal->_history.data();
+        unsigned char mask = 1 << _temporal->_cur_frame_index;
+
+        // The temporal filter and the conversion back to depth, strip by strip
+        parallel_for(strips, [&](int s)
+        {
+            size_t begin = s * post_processing_strip_size;
+            size_t end = std::min(pixels, begin + post_processing_strip_size);
+            _temporal->temp_jw_smooth_strip(disparity, last_frame, history, begin, end, mask);
+            _disparity_to_depth->convert<float, uint16_t>(disparity + begin, depth + begin, end - begin);
+        });
+
+        _temporal->_cur_frame_index = (_temporal->_cur_frame_index + 1) % 8;
+    }
+
+    void depth_post_processing::smooth_depth(uint16_t* depth)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_spatial->_mutex);
+            _spatial->dxf_smooth<uint16_t>(depth, _spatial->_spatial_alpha_param,
+                _spatial->_spatial_edge_threshold, _spatial->_spatial_iterations);
+        }
+
+        std::lock_guard<std::mutex> lock(_temporal->_mutex);
+        _temporal->temp_jw_smooth<uint16_t>(depth, _temporal->_last_frame.data(), _temporal->_history.data());
+    }
+
+    template<typename T>
+    void depth_post_processing::configure_stage(T& stage, size_t width, size_t height, rs2_extension type)
+    {
+        std::lock_guard<std::mutex> lock(stage._mutex);
+
+        // The stage is configured by hand here; on its own, it would reconfigure on the next frame
+        stage._source_stream_profile = rs2::stream_profile();
+        stage._extension_type = type;
+        stage._bpp = (type == RS2_EXTENSION_DISPARITY_FRAME) ? sizeof(float) : sizeof(uint16_t);
+        stage._width = width;
+        stage._height = height;
+        stage._stride = width * stage._bpp;
+        stage._current_frm_size_pixels = width * height;
+    }
+
+    void depth_post_processing::update_configuration(const rs2::frame& f)
+    {
+        bool changed = f.get_profile().get() != _source_stream_profile.get();
+        {
+            std::lock_guard<std::mutex> lock(_decimation->_mutex);
+            _decimation->update_output_profile(f);
+            changed |= _decimation->_target_stream_profile.get() != _decimated_profile.get();
+            _decimated_profile = _decimation->_target_stream_profile;
+            _width = _decimation->_padded_width;
+            _height = _decimation->_padded_height;
+        }
+
+        if (changed)
+        {
+            _source_stream_profile = f.get_profile();
+
+            // The conversion factor depends on the decimated focal length
+            auto info = disparity_info::update_info_from_frame(f, _decimated_profile.as<rs2::video_stream_profile>());
+            _stereoscopic_depth = info.stereoscopic_depth;
+            for (auto&& transform : { _depth_to_disparity, _disparity_to_depth })
+            {
+                std::lock_guard<std::mutex> lock(transform->_mutex);
+                transform->_source_stream_profile = rs2::stream_profile();
+                transform->_stereoscopic_depth = info.stereoscopic_depth;
+                transform->_depth_units = info.depth_units;
+                transform->_d2d_convert_factor = info.d2d_convert_factor;
+                transform->_width = _width;
+                transform->_height = _height;
+            }
+
+            auto type = _stereoscopic_depth ? RS2_EXTENSION_DISPARITY_FRAME : RS2_EXTENSION_DEPTH_FRAME;
+            configure_stage(*_spatial, _width, _height, type);
+            configure_stage(*_temporal, _width, _height, type);
+            configure_stage(*_hole_filling, _width, _height, RS2_EXTENSION_DEPTH_FRAME);
+
+            std::lock_guard<std::mutex> lock(_temporal->_mutex);
+            _temporal->_last_frame.clear();
+            _temporal->_history.clear();
+
+            _disparity.resize(_stereoscopic_depth ? _width * _height : 0);
+        }
+
+        // The temporal history is also reset when its options change
+        std::lock_guard<std::mutex> lock(_temporal->_mutex);
+        if (_temporal->_history.size() != _width * _height)
+        {
+            _temporal->_last_frame.assign(_width * _height * _temporal->_bpp, 0);
+            _temporal->_history.assign(_width * _height, 0);
+        }
+    }
+}
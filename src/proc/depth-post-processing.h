@@ -0,0 +1,61 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "proc/synthetic-stream.h"
+#include "proc/decimation-filter.h"
+#include "proc/disparity-transform.h"
+#include "proc/spatial-filter.h"
+#include "proc/temporal-filter.h"
+#include "proc/hole-filling-filter.h"
+
+namespace librealsense
+{
+    // The recommended depth post-processing chain in a single block:
+    //     decimation -> depth to disparity -> spatial -> temporal -> disparity to depth -> hole filling
+    //
+    // Chaining the individual blocks allocates and walks a new frame at every step. Here the stages
+    // run on the same buffers instead: decimation writes straight into the one output frame, the
+    // filters work in place on a single disparity buffer, and the temporal filter, the conversion
+    // back to depth and the copy to the output are done together, strip by strip.
+    //
+    // Each stage is an instance of the individual block, so its options are set through get_stage()
+    // exactly as on the individual block; the output is the same as that of the chain.
+    class depth_post_processing : public depth_processing_block
+    {
+    public:
+        depth_post_processing();
+
+        // The block of a stage: RS2_EXTENSION_DECIMATION_FILTER, RS2_EXTENSION_SPATIAL_FILTER,
+        // RS2_EXTENSION_TEMPORAL_FILTER or RS2_EXTENSION_HOLE_FILLING_FILTER
+        std::shared_ptr<processing_block> get_stage(rs2_extension stage) const;
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void update_configuration(const rs2::frame& f);
+
+        template<typename T>
+        void configure_stage(T& stage, size_t width, size_t height, rs2_extension type);
+
+        void smooth_disparity(uint16_t* depth);
+        void smooth_depth(uint16_t* depth);
+
+        std::shared_ptr<decimation_filter>      _decimation;
+        std::shared_ptr<disparity_transform>    _depth_to_disparity;
+        std::shared_ptr<spatial_filter>         _spatial;
+        std::shared_ptr<temporal_filter>        _temporal;
+        std::shared_ptr<disparity_transform>    _disparity_to_depth;
+        std::shared_ptr<hole_filling_filter>    _hole_filling;
+
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _decimated_profile;       // The output profile, as decimation sets it
+        bool                    _stereoscopic_depth;      // Filtered in the disparity domain
+        size_t                  _width, _height;          // Of the decimated frame
+        std::vector<float>      _disparity;
+    };
+}
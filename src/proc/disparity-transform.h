@@ -23,6 +23,12 @@ namespace librealsense
 
         template<typename Tin, typename Tout>
         void convert(const void* in_data, void* out_data)
+        {
+            convert<Tin, Tout>(in_data, out_data, _width * _height);
+        }
+
+        template<typename Tin, typename Tout>
+        void convert(const void* in_data, void* out_data, size_t pixels)
         {
             static_assert((std::is_arithmetic<Tin>::value), "disparity transform requires numeric type for input data");
             static_assert((std::is_arithmetic<Tout>::value), "disparity transform requires numeric type for output data");
@@ -35,16 +41,15 @@ namespace librealsense
 
             float input{};
             //TODO SSE optimize
-            for (size_t i = 0; i < _height; i++)
-                for (size_t j = 0; j < _width; j++)
-                {
-                    input = *in;
-                    if (std::isnormal(input))
-                        *out++ = static_cast<Tout>((_d2d_convert_factor / input)+round);
-                    else
-                        *out++ = 0;
-                    in++;
-                }
+            for (size_t i = 0; i < pixels; i++)
+            {
+                input = *in;
+                if (std::isnormal(input))
+                    *out++ = static_cast<Tout>((_d2d_convert_factor / input)+round);
+                else
+                    *out++ = 0;
+                in++;
+            }
         }
 
     private:
@@ -52,6 +57,8 @@ namespace librealsense
 
         void    on_set_mode(bool to_disparity);
 
+        friend class depth_post_processing;
+
         bool                    _transform_to_disparity;
         rs2::stream_profile     _source_stream_profile;
         rs2::stream_profile     _target_stream_profile;
@@ -75,6 +82,12 @@ namespace librealsense
         };
 
         static info update_info_from_frame(const rs2::frame& f)
+        {
+            return update_info_from_frame(f, f.get_profile().as<rs2::video_stream_profile>());
+        }
+
+        // The conversion factor for frames of the sensor of f, with the intrinsics of profile vp
+        static info update_info_from_frame(const rs2::frame& f, const rs2::video_stream_profile& vp)
         {
             // Check if the new frame originated from stereo-based depth sensor
             // and retrieve the stereo baseline parameter that will be used in transformations
@@ -107,7 +120,6 @@ namespace librealsense
 
             if (info.stereoscopic_depth)
             {
-                auto vp = f.get_profile().as<rs2::video_stream_profile>();
                 auto focal_lenght_mm = vp.get_intrinsics().fx;
                 const uint8_t fractional_bits = 5;
                 const uint8_t fractions = 1 << fractional_bits;
@@ -5,9 +5,54 @@
 #include "ds5/ds5-motion.h"
 #include "synthetic-stream.h"
 #include "motion-transform.h"
+#ifdef __SSE2__
+#include <emmintrin.h> // For SSE2 intrinsics
+#endif
 
 namespace librealsense
 {
+    // The Accelerometer input format: signed int 16bit. data units 1LSB=0.001g;
+    // Librealsense output format: floating point 32bit. units m/s^2,
+    static constexpr float gravity = 9.80665f;          // Standard Gravitation Acceleration
+    static constexpr double accelerator_transform_factor = 0.001*gravity;
+
+    // The Gyro input format: signed int 16bit. data units 1LSB=0.1deg/sec;
+    // Librealsense output format: floating point 32bit. units rad/sec,
+    static const double gyro_transform_factor = deg2rad(0.1);
+
+    static_assert(sizeof(hid_batch_sample) == sizeof(rs2_motion_sample), "Motion transforms keep the frame size");
+
+    // dst[i].data = m * src[i].data - bias, where m also converts the raw units
+    static void transform_motion_samples(rs2_motion_sample * dst, const hid_batch_sample * src, size_t count,
+        const float3x3 & m, const float3 & bias)
+    {
+        size_t i = 0;
+#ifdef __SSE2__
+        const __m128 x = _mm_setr_ps(m.x.x, m.x.y, m.x.z, 0.f);
+        const __m128 y = _mm_setr_ps(m.y.x, m.y.y, m.y.z, 0.f);
+        const __m128 z = _mm_setr_ps(m.z.x, m.z.y, m.z.z, 0.f);
+        const __m128 b = _mm_setr_ps(bias.x, bias.y, bias.z, 0.f);
+        for (; i < count; ++i)
+        {
+            auto&& raw = src[i].data;
+            __m128 xyz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(float(raw.x))),
+                                               _mm_mul_ps(y, _mm_set1_ps(float(raw.y)))),
+                                    _mm_mul_ps(z, _mm_set1_ps(float(raw.z))));
+            dst[i].timestamp = src[i].timestamp;
+            // Also zeroes the reserved float that follows the data
+            _mm_storeu_ps(&dst[i].data.x, _mm_sub_ps(xyz, b));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            auto&& raw = src[i].data;
+            auto xyz = m * float3{ float(raw.x), float(raw.y), float(raw.z) } - bias;
+            dst[i].timestamp = src[i].timestamp;
+            dst[i].data = { xyz.x, xyz.y, xyz.z };
+            dst[i].reserved = 0.f;
+        }
+    }
+
     template<rs2_format FORMAT> void copy_hid_axes(byte * const dest[], const byte * source, double factor)
     {
         using namespace librealsense;
@@ -18,22 +63,13 @@ namespace librealsense
         librealsense::copy(dest[0], &res, sizeof(float3));
     }
 
-    // The Accelerometer input format: signed int 16bit. data units 1LSB=0.001g;
-    // Librealsense output format: floating point 32bit. units m/s^2,
     template<rs2_format FORMAT> void unpack_accel_axes(byte * const dest[], const byte * source, int width, int height, int output_size)
     {
-        static constexpr float gravity = 9.80665f;          // Standard Gravitation Acceleration
-        static constexpr double accelerator_transform_factor = 0.001*gravity;
-
         copy_hid_axes<FORMAT>(dest, source, accelerator_transform_factor);
     }
 
-    // The Gyro input format: signed int 16bit. data units 1LSB=0.1deg/sec;
-    // Librealsense output format: floating point 32bit. units rad/sec,
     template<rs2_format FORMAT> void unpack_gyro_axes(byte * const dest[], const byte * source, int width, int height, int output_size)
     {
-        static const double gyro_transform_factor = deg2rad(0.1);
-
         copy_hid_axes<FORMAT>(dest, source, gyro_transform_factor);
     }
 
@@ -68,6 +104,9 @@ namespace librealsense
 
     rs2::frame motion_transform::process_frame(const rs2::frame_source& source, const rs2::frame& f)
     {
+        if (f.get_profile().format() == RS2_FORMAT_MOTION_BATCH)
+            return process_batch(source, f);
+
         auto&& ret = functional_processing_block::process_frame(source, f);
         correct_motion(&ret);
 
@@ -97,12 +136,45 @@ namespace librealsense
         }
     }
 
-    acceleration_transform::acceleration_transform(std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt)
-        : acceleration_transform("Acceleration Transform", mm_calib, mm_correct_opt)
+    // The samples of a batch all go through one transform, that is the unit conversion, the alignment
+    // and the correction of correct_motion() combined
+    rs2::frame motion_transform::process_batch(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        auto&& ret = prepare_frame(source, f);
+
+        float3x3 m = _imu2depth_cs_alignment_matrix;
+        float3 bias = { 0, 0, 0 };
+        if (_mm_correct_opt && _mm_correct_opt->query() > 0.f)
+        {
+            auto&& s = f.get_profile().stream_type();
+            if (s == RS2_STREAM_ACCEL)
+            {
+                m = _accel_sensitivity * m;
+                bias = _accel_bias;
+            }
+            if (s == RS2_STREAM_GYRO)
+            {
+                m = _gyro_sensitivity * m;
+                bias = _gyro_bias;
+            }
+        }
+        auto units = units_per_lsb();
+        m = { m.x * units, m.y * units, m.z * units };
+
+        transform_motion_samples((rs2_motion_sample*)ret.get_data(), (const hid_batch_sample*)f.get_data(),
+            f.get_data_size() / sizeof(hid_batch_sample), m, bias);
+
+        return ret;
+    }
+
+    acceleration_transform::acceleration_transform(std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt,
+        rs2_format target_format)
+        : acceleration_transform("Acceleration Transform", mm_calib, mm_correct_opt, target_format)
     {}
 
-    acceleration_transform::acceleration_transform(const char * name, std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt)
-        : motion_transform(name, RS2_FORMAT_MOTION_XYZ32F, RS2_STREAM_ACCEL, mm_calib, mm_correct_opt)
+    acceleration_transform::acceleration_transform(const char * name, std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt,
+        rs2_format target_format)
+        : motion_transform(name, target_format, RS2_STREAM_ACCEL, mm_calib, mm_correct_opt)
     {}
 
     void acceleration_transform::process_function(byte * const dest[], const byte * source, int width, int height, int output_size, int actual_size)
@@ -110,17 +182,29 @@ namespace librealsense
         unpack_accel_axes<RS2_FORMAT_MOTION_XYZ32F>(dest, source, width, height, actual_size);
     }
 
-    gyroscope_transform::gyroscope_transform(std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt)
-        : gyroscope_transform("Gyroscope Transform", mm_calib, mm_correct_opt)
+    float acceleration_transform::units_per_lsb() const
+    {
+        return float(accelerator_transform_factor);
+    }
+
+    gyroscope_transform::gyroscope_transform(std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt,
+        rs2_format target_format)
+        : gyroscope_transform("Gyroscope Transform", mm_calib, mm_correct_opt, target_format)
     {}
 
-    gyroscope_transform::gyroscope_transform(const char * name, std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt)
-        : motion_transform(name, RS2_FORMAT_MOTION_XYZ32F, RS2_STREAM_GYRO, mm_calib, mm_correct_opt)
+    gyroscope_transform::gyroscope_transform(const char * name, std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt,
+        rs2_format target_format)
+        : motion_transform(name, target_format, RS2_STREAM_GYRO, mm_calib, mm_correct_opt)
     {}
 
     void gyroscope_transform::process_function(byte * const dest[], const byte * source, int width, int height, int output_size, int actual_size)
     {
         unpack_gyro_axes<RS2_FORMAT_MOTION_XYZ32F>(dest, source, width, height, actual_size);
     }
+
+    float gyroscope_transform::units_per_lsb() const
+    {
+        return float(gyro_transform_factor);
+    }
 }
 
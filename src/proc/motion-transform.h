@@ -22,8 +22,12 @@ namespace librealsense
             std::shared_ptr<enable_motion_correction> mm_correct_opt);
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
+        // Of the output, for a raw reading of 1
+        virtual float units_per_lsb() const { return 1.f; }
+
     private:
         void correct_motion(rs2::frame* f);
+        rs2::frame process_batch(const rs2::frame_source& source, const rs2::frame& f);
 
         std::shared_ptr<enable_motion_correction> _mm_correct_opt = nullptr;
         float3x3            _accel_sensitivity;
@@ -33,24 +37,30 @@ namespace librealsense
         float3x3            _imu2depth_cs_alignment_matrix;     // Transform and align raw IMU axis [x,y,z] to be consistent with the Depth frame CS
     };
 
+    // target_format is RS2_FORMAT_MOTION_XYZ32F, or RS2_FORMAT_MOTION_BATCH for batches of samples
     class acceleration_transform : public motion_transform
     {
     public:
-        acceleration_transform(std::shared_ptr<mm_calib_handler> mm_calib = nullptr, std::shared_ptr<enable_motion_correction> mm_correct_opt = nullptr);
+        acceleration_transform(std::shared_ptr<mm_calib_handler> mm_calib = nullptr, std::shared_ptr<enable_motion_correction> mm_correct_opt = nullptr,
+            rs2_format target_format = RS2_FORMAT_MOTION_XYZ32F);
 
     protected:
-        acceleration_transform(const char* name, std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt);
+        acceleration_transform(const char* name, std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt,
+            rs2_format target_format = RS2_FORMAT_MOTION_XYZ32F);
         void process_function(byte * const dest[], const byte * source, int width, int height, int actual_size, int input_size) override;
-
+        float units_per_lsb() const override;
     };
 
     class gyroscope_transform : public motion_transform
     {
     public:
-        gyroscope_transform(std::shared_ptr<mm_calib_handler> mm_calib = nullptr, std::shared_ptr<enable_motion_correction> mm_correct_opt = nullptr);
+        gyroscope_transform(std::shared_ptr<mm_calib_handler> mm_calib = nullptr, std::shared_ptr<enable_motion_correction> mm_correct_opt = nullptr,
+            rs2_format target_format = RS2_FORMAT_MOTION_XYZ32F);
 
     protected:
-        gyroscope_transform(const char* name, std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt);
+        gyroscope_transform(const char* name, std::shared_ptr<mm_calib_handler> mm_calib, std::shared_ptr<enable_motion_correction> mm_correct_opt,
+            rs2_format target_format = RS2_FORMAT_MOTION_XYZ32F);
         void process_function(byte * const dest[], const byte * source, int width, int height, int actual_size, int input_size) override;
+        float units_per_lsb() const override;
     };
 }
@@ -0,0 +1,159 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rsutil.h>
+
+#include "neon-align.h"
+
+#ifdef __ARM_NEON
+
+#include <arm_neon.h>
+
+namespace librealsense
+{
+    static inline float32x4_t divide(float32x4_t a, float32x4_t b)
+    {
+#ifdef __aarch64__
+        return vdivq_f32(a, b);
+#else
+        // ARMv7 NEON has no division, and its reciprocal estimates are not exact
+        float va[4], vb[4];
+        vst1q_f32(va, a);
+        vst1q_f32(vb, b);
+        for (int i = 0; i < 4; ++i)
+            va[i] /= vb[i];
+        return vld1q_f32(va);
+#endif
+    }
+
+    // rs2_transform_point_to_point and rs2_project_point_to_pixel of 4 points at a time, where the
+    // modified and inverse Brown-Conrady models are the same projection. The corners land on the
+    // same pixels as those of the scalar code only if neither has its multiply-adds fused, so ARM
+    // builds use -ffp-contract=off
+    template<rs2_distortion MODEL>
+    struct corner_projection
+    {
+        float32x4_t r[9], t[3];
+        float32x4_t c0, c1, c2, c3, c4, c2x2, c3x2;
+        float32x4_t fx, fy, ppx, ppy;
+        float32x4_t one, two, half;
+
+        corner_projection(const rs2_intrinsics& intrin, const rs2_extrinsics& extr)
+        {
+            for (int i = 0; i < 9; ++i)
+                r[i] = vdupq_n_f32(extr.rotation[i]);
+            for (int i = 0; i < 3; ++i)
+                t[i] = vdupq_n_f32(extr.translation[i]);
+
+            c0 = vdupq_n_f32(intrin.coeffs[0]);
+            c1 = vdupq_n_f32(intrin.coeffs[1]);
+            c2 = vdupq_n_f32(intrin.coeffs[2]);
+            c3 = vdupq_n_f32(intrin.coeffs[3]);
+            c4 = vdupq_n_f32(intrin.coeffs[4]);
+            c2x2 = vdupq_n_f32(2 * intrin.coeffs[2]);
+            c3x2 = vdupq_n_f32(2 * intrin.coeffs[3]);
+            fx = vdupq_n_f32(intrin.fx);
+            fy = vdupq_n_f32(intrin.fy);
+            ppx = vdupq_n_f32(intrin.ppx);
+            ppy = vdupq_n_f32(intrin.ppy);
+            one = vdupq_n_f32(1.f);
+            two = vdupq_n_f32(2.f);
+            half = vdupq_n_f32(0.5f);
+        }
+
+        // The pixels of the points at depth z on 4 rays, or -1 where the mask is set
+        void map(int2* pixels, float32x4_t z, int32x4_t invalid, const float* ray_x, const float* ray_y) const
+        {
+            auto px = vmulq_f32(z, vld1q_f32(ray_x));
+            auto py = vmulq_f32(z, vld1q_f32(ray_y));
+
+            auto tx = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r[0], px), vmulq_f32(r[3], py)), vmulq_f32(r[6], z)), t[0]);
+            auto ty = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r[1], px), vmulq_f32(r[4], py)), vmulq_f32(r[7], z)), t[1]);
+            auto tz = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r[2], px), vmulq_f32(r[5], py)), vmulq_f32(r[8], z)), t[2]);
+
+            auto x = divide(tx, tz);
+            auto y = divide(ty, tz);
+
+            if (MODEL != RS2_DISTORTION_NONE)
+            {
+                auto r2 = vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y));
+                auto f = vaddq_f32(vaddq_f32(vaddq_f32(one, vmulq_f32(c0, r2)),
+                    vmulq_f32(vmulq_f32(c1, r2), r2)), vmulq_f32(vmulq_f32(vmulq_f32(c4, r2), r2), r2));
+                auto xf = vmulq_f32(x, f);
+                auto yf = vmulq_f32(y, f);
+
+                // Brown-Conrady adds the tangential distortion of the undistorted point
+                auto xt = (MODEL == RS2_DISTORTION_BROWN_CONRADY) ? x : xf;
+                auto yt = (MODEL == RS2_DISTORTION_BROWN_CONRADY) ? y : yf;
+                x = vaddq_f32(vaddq_f32(xf, vmulq_f32(vmulq_f32(c2x2, xt), yt)),
+                    vmulq_f32(c3, vaddq_f32(r2, vmulq_f32(vmulq_f32(two, xt), xt))));
+                y = vaddq_f32(vaddq_f32(yf, vmulq_f32(vmulq_f32(c3x2, xt), yt)),
+                    vmulq_f32(c2, vaddq_f32(r2, vmulq_f32(vmulq_f32(two, yt), yt))));
+            }
+
+            // Truncated as static_cast<int> does
+            auto u = vaddq_f32(vmulq_f32(x, fx), ppx);
+            auto v = vaddq_f32(vmulq_f32(y, fy), ppy);
+            int32x4x2_t pixel;
+            pixel.val[0] = vorrq_s32(invalid, vcvtq_s32_f32(vaddq_f32(u, half)));
+            pixel.val[1] = vorrq_s32(invalid, vcvtq_s32_f32(vaddq_f32(v, half)));
+            vst2q_s32(reinterpret_cast<int32_t*>(pixels), pixel);
+        }
+    };
+
+    template<rs2_distortion MODEL>
+    static int map_corners_neon(const align::corner_row& row, float z_scale,
+        const rs2_intrinsics& other_intrin, const rs2_extrinsics& depth_to_other,
+        int2* top_left, int2* bottom_right)
+    {
+        corner_projection<MODEL> projection(other_intrin, depth_to_other);
+        auto scale = vdupq_n_f32(z_scale);
+        auto zero = vdupq_n_f32(0.f);
+
+        int x = 0;
+        for (; x + 8 <= row.width; x += 8)
+        {
+            auto d = vld1q_u16(row.depth + x);
+            float32x4_t z[2] = {
+                vmulq_f32(scale, vcvtq_f32_u32(vmovl_u16(vget_low_u16(d)))),
+                vmulq_f32(scale, vcvtq_f32_u32(vmovl_u16(vget_high_u16(d)))) };
+            for (int half = 0; half < 2; ++half)
+            {
+                auto offset = x + half * 4;
+                auto invalid = vreinterpretq_s32_u32(vceqq_f32(z[half], zero));
+                projection.map(top_left + offset, z[half], invalid, row.top_x + offset, row.top_y + offset);
+                projection.map(bottom_right + offset, z[half], invalid, row.bottom_x + offset + 1, row.bottom_y + offset + 1);
+            }
+        }
+        return x;
+    }
+
+    void align_neon::map_corners(const corner_row& row, float z_scale,
+        const rs2_intrinsics& other_intrin, const rs2_extrinsics& depth_to_other,
+        int2* top_left, int2* bottom_right)
+    {
+        int done;
+        switch (other_intrin.model)
+        {
+        case RS2_DISTORTION_NONE:
+            done = map_corners_neon<RS2_DISTORTION_NONE>(row, z_scale, other_intrin, depth_to_other, top_left, bottom_right);
+            break;
+        case RS2_DISTORTION_BROWN_CONRADY:
+            done = map_corners_neon<RS2_DISTORTION_BROWN_CONRADY>(row, z_scale, other_intrin, depth_to_other, top_left, bottom_right);
+            break;
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+        case RS2_DISTORTION_INVERSE_BROWN_CONRADY:
+            done = map_corners_neon<RS2_DISTORTION_INVERSE_BROWN_CONRADY>(row, z_scale, other_intrin, depth_to_other, top_left, bottom_right);
+            break;
+        default:
+            done = 0;
+        }
+
+        // The rest of the row
+        corner_row rest = { row.depth + done, row.width - done,
+            row.top_x + done, row.top_y + done, row.bottom_x + done, row.bottom_y + done };
+        align::map_corners(rest, z_scale, other_intrin, depth_to_other, top_left + done, bottom_right + done);
+    }
+}
+
+#endif
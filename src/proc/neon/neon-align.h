@@ -0,0 +1,23 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "../align.h"
+
+namespace librealsense
+{
+    // The generic align, with the corners of 4 depth pixels at a time mapped onto the other image
+    // with NEON, for no, Brown-Conrady and (modified or inverse) Brown-Conrady distortion of the
+    // other stream; other models are mapped by the generic block.
+    class align_neon : public align
+    {
+    public:
+        align_neon(rs2_stream to_stream) : align(to_stream, "Align (NEON)") {}
+
+    protected:
+        void map_corners(const corner_row& row, float z_scale,
+                         const rs2_intrinsics& other_intrin,
+                         const rs2_extrinsics& depth_to_other,
+                         int2* top_left, int2* bottom_right) override;
+    };
+}
@@ -0,0 +1,233 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/rsutil.h>
+
+#include "../synthetic-stream.h"
+#include "../../thread-pool.h"
+#include "neon-pointcloud.h"
+
+#ifdef __ARM_NEON
+
+#include <arm_neon.h>
+
+namespace librealsense
+{
+    static inline float32x4_t divide(float32x4_t a, float32x4_t b)
+    {
+#ifdef __aarch64__
+        return vdivq_f32(a, b);
+#else
+        // ARMv7 NEON has no division, and its reciprocal estimates are not exact
+        float va[4], vb[4];
+        vst1q_f32(va, a);
+        vst1q_f32(vb, b);
+        for (int i = 0; i < 4; ++i)
+            va[i] /= vb[i];
+        return vld1q_f32(va);
+#endif
+    }
+
+    static inline float32x4_t keep_valid(uint32x4_t mask, float32x4_t v)
+    {
+        return vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(v)));
+    }
+
+    static void deproject_row(float* points, const uint16_t* depth,
+        const float* map_x, const float* map_y, int width, float depth_scale)
+    {
+        auto scale = vdupq_n_f32(depth_scale);
+
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            auto d = vld1q_u16(depth + x);
+            float32x4_t z[2] = {
+                vmulq_f32(scale, vcvtq_f32_u32(vmovl_u16(vget_low_u16(d)))),
+                vmulq_f32(scale, vcvtq_f32_u32(vmovl_u16(vget_high_u16(d)))) };
+            for (int half = 0; half < 2; ++half)
+            {
+                auto offset = x + half * 4;
+                float32x4x3_t p;
+                p.val[0] = vmulq_f32(z[half], vld1q_f32(map_x + offset));
+                p.val[1] = vmulq_f32(z[half], vld1q_f32(map_y + offset));
+                p.val[2] = z[half];
+                vst3q_f32(points + offset * 3, p);
+            }
+        }
+        for (; x < width; ++x)
+        {
+            float z = depth_scale * depth[x];
+            points[x * 3] = z * map_x[x];
+            points[x * 3 + 1] = z * map_y[x];
+            points[x * 3 + 2] = z;
+        }
+    }
+
+    // rs2_transform_point_to_point and rs2_project_point_to_pixel of one row of points, where the
+    // modified and inverse Brown-Conrady models are the same projection
+    template<rs2_distortion MODEL>
+    static void texture_row(float* tex, float* pixels, const float* points, int width,
+        const rs2_intrinsics& intrin, const rs2_extrinsics& extr)
+    {
+        float32x4_t r[9], t[3];
+        for (int i = 0; i < 9; ++i)
+            r[i] = vdupq_n_f32(extr.rotation[i]);
+        for (int i = 0; i < 3; ++i)
+            t[i] = vdupq_n_f32(extr.translation[i]);
+
+        auto one = vdupq_n_f32(1.f);
+        auto two = vdupq_n_f32(2.f);
+        auto c0 = vdupq_n_f32(intrin.coeffs[0]);
+        auto c1 = vdupq_n_f32(intrin.coeffs[1]);
+        auto c2 = vdupq_n_f32(intrin.coeffs[2]);
+        auto c3 = vdupq_n_f32(intrin.coeffs[3]);
+        auto c4 = vdupq_n_f32(intrin.coeffs[4]);
+        auto c2x2 = vdupq_n_f32(2 * intrin.coeffs[2]);
+        auto c3x2 = vdupq_n_f32(2 * intrin.coeffs[3]);
+        auto fx = vdupq_n_f32(intrin.fx);
+        auto fy = vdupq_n_f32(intrin.fy);
+        auto ppx = vdupq_n_f32(intrin.ppx);
+        auto ppy = vdupq_n_f32(intrin.ppy);
+        auto w = vdupq_n_f32(float(intrin.width));
+        auto h = vdupq_n_f32(float(intrin.height));
+        auto zero = vdupq_n_f32(0.f);
+
+        int i = 0;
+        for (; i + 4 <= width; i += 4)
+        {
+            auto p = vld3q_f32(points + i * 3);
+            auto valid = vmvnq_u32(vceqq_f32(p.val[2], zero));
+
+            auto tx = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r[0], p.val[0]), vmulq_f32(r[3], p.val[1])), vmulq_f32(r[6], p.val[2])), t[0]);
+            auto ty = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r[1], p.val[0]), vmulq_f32(r[4], p.val[1])), vmulq_f32(r[7], p.val[2])), t[1]);
+            auto tz = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(r[2], p.val[0]), vmulq_f32(r[5], p.val[1])), vmulq_f32(r[8], p.val[2])), t[2]);
+
+            auto x = divide(tx, tz);
+            auto y = divide(ty, tz);
+
+            if (MODEL != RS2_DISTORTION_NONE)
+            {
+                auto r2 = vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y));
+                auto f = vaddq_f32(vaddq_f32(vaddq_f32(one, vmulq_f32(c0, r2)),
+                    vmulq_f32(vmulq_f32(c1, r2), r2)), vmulq_f32(vmulq_f32(vmulq_f32(c4, r2), r2), r2));
+                auto xf = vmulq_f32(x, f);
+                auto yf = vmulq_f32(y, f);
+
+                // Brown-Conrady adds the tangential distortion of the undistorted point
+                auto xt = (MODEL == RS2_DISTORTION_BROWN_CONRADY) ? x : xf;
+                auto yt = (MODEL == RS2_DISTORTION_BROWN_CONRADY) ? y : yf;
+                x = vaddq_f32(vaddq_f32(xf, vmulq_f32(vmulq_f32(c2x2, xt), yt)),
+                    vmulq_f32(c3, vaddq_f32(r2, vmulq_f32(vmulq_f32(two, xt), xt))));
+                y = vaddq_f32(vaddq_f32(yf, vmulq_f32(vmulq_f32(c3x2, xt), yt)),
+                    vmulq_f32(c2, vaddq_f32(r2, vmulq_f32(vmulq_f32(two, yt), yt))));
+            }
+
+            float32x4x2_t pixel, texel;
+            pixel.val[0] = keep_valid(valid, vaddq_f32(vmulq_f32(x, fx), ppx));
+            pixel.val[1] = keep_valid(valid, vaddq_f32(vmulq_f32(y, fy), ppy));
+            texel.val[0] = divide(pixel.val[0], w);
+            texel.val[1] = divide(pixel.val[1], h);
+            vst2q_f32(pixels + i * 2, pixel);
+            vst2q_f32(tex + i * 2, texel);
+        }
+        for (; i < width; ++i)
+        {
+            const float* point = points + i * 3;
+            if (point[2])
+            {
+                float trans[3];
+                rs2_transform_point_to_point(trans, &extr, point);
+                rs2_project_point_to_pixel(pixels + i * 2, &intrin, trans);
+                tex[i * 2] = pixels[i * 2] / intrin.width;
+                tex[i * 2 + 1] = pixels[i * 2 + 1] / intrin.height;
+            }
+            else
+            {
+                pixels[i * 2] = pixels[i * 2 + 1] = 0.f;
+                tex[i * 2] = tex[i * 2 + 1] = 0.f;
+            }
+        }
+    }
+
+    pointcloud_neon::pointcloud_neon() : pointcloud("Pointcloud (NEON)") {}
+
+    void pointcloud_neon::preprocess()
+    {
+        auto& intrin = *_depth_intrinsics;
+        _pre_compute_map_x.resize(intrin.width * intrin.height);
+        _pre_compute_map_y.resize(intrin.width * intrin.height);
+
+        // The generic deprojection, whatever the model, is linear in depth
+        parallel_for(intrin.height, [&](int h)
+        {
+            for (int w = 0; w < intrin.width; ++w)
+            {
+                const float pixel[] = { (float)w, (float)h };
+                float point[3];
+                rs2_deproject_pixel_to_point(point, &intrin, pixel, 1.f);
+                _pre_compute_map_x[h * intrin.width + w] = point[0];
+                _pre_compute_map_y[h * intrin.width + w] = point[1];
+            }
+        });
+    }
+
+    const float3* pointcloud_neon::depth_to_points(rs2::points output,
+        const rs2_intrinsics &depth_intrinsics,
+        const rs2::depth_frame& depth_frame,
+        float depth_scale)
+    {
+        auto depth_image = (const uint16_t*)depth_frame.get_data();
+        auto points = (float*)output.get_vertices();
+        auto map_x = _pre_compute_map_x.data();
+        auto map_y = _pre_compute_map_y.data();
+        const int width = depth_intrinsics.width;
+
+        parallel_for(depth_intrinsics.height, [&](int y)
+        {
+            auto offset = y * width;
+            deproject_row(points + offset * 3, depth_image + offset, map_x + offset, map_y + offset, width, depth_scale);
+        });
+        return (float3*)points;
+    }
+
+    void pointcloud_neon::get_texture_map(rs2::points output,
+        const float3* points,
+        const unsigned int width,
+        const unsigned int height,
+        const rs2_intrinsics &other_intrinsics,
+        const rs2_extrinsics& extr,
+        float2* pixels_ptr)
+    {
+        void (*map_row)(float*, float*, const float*, int, const rs2_intrinsics&, const rs2_extrinsics&);
+        switch (other_intrinsics.model)
+        {
+        case RS2_DISTORTION_NONE:
+            map_row = texture_row<RS2_DISTORTION_NONE>;
+            break;
+        case RS2_DISTORTION_BROWN_CONRADY:
+            map_row = texture_row<RS2_DISTORTION_BROWN_CONRADY>;
+            break;
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+        case RS2_DISTORTION_INVERSE_BROWN_CONRADY:
+            map_row = texture_row<RS2_DISTORTION_INVERSE_BROWN_CONRADY>;
+            break;
+        default:
+            pointcloud::get_texture_map(output, points, width, height, other_intrinsics, extr, pixels_ptr);
+            return;
+        }
+
+        auto tex_ptr = (float*)output.get_texture_coordinates();
+        auto pixels = (float*)pixels_ptr;
+        auto xyz = (const float*)points;
+
+        parallel_for(int(height), [&](int y)
+        {
+            auto offset = size_t(y) * width;
+            map_row(tex_ptr + offset * 2, pixels + offset * 2, xyz + offset * 3, int(width), other_intrinsics, extr);
+        });
+    }
+}
+
+#endif
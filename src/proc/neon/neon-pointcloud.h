@@ -0,0 +1,40 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "../pointcloud.h"
+
+namespace librealsense
+{
+    // Deprojection and texture mapping with NEON, several pixels at a time and one row per thread.
+    //
+    // The points are those of the generic block, bit for bit, whatever the depth distortion model.
+    // The texture coordinates are computed in the same order of operations as rs2_project_point_to_pixel
+    // (up to the multiply-adds the compiler may fuse), for no, Brown-Conrady and (modified or inverse)
+    // Brown-Conrady distortion of the other stream.
+    class pointcloud_neon : public pointcloud
+    {
+    public:
+        pointcloud_neon();
+
+    private:
+        void preprocess() override;
+        const float3 * depth_to_points(
+            rs2::points output,
+            const rs2_intrinsics &depth_intrinsics,
+            const rs2::depth_frame& depth_frame,
+            float depth_scale) override;
+        void get_texture_map(
+            rs2::points output,
+            const float3* points,
+            const unsigned int width,
+            const unsigned int height,
+            const rs2_intrinsics &other_intrinsics,
+            const rs2_extrinsics& extr,
+            float2* pixels_ptr) override;
+
+        // The deprojection of every depth pixel at a depth of 1
+        std::vector<float> _pre_compute_map_x;
+        std::vector<float> _pre_compute_map_y;
+    };
+}
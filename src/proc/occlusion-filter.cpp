@@ -5,9 +5,11 @@
 #include "../include/librealsense2/rsutil.h"
 #include "proc/synthetic-stream.h"
 #include "proc/occlusion-filter.h"
+#include "thread-pool.h"
 //#include  "../../common/tiny-profiler.h"
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 
 namespace librealsense
@@ -31,6 +33,12 @@ namespace librealsense
         case occlusion_monotonic_scan:
             monotonic_heuristic_invalidation(points, uv_map, pix_coord, depth);
             break;
+        case occlusion_parallel_scan:
+            if (_occlusion_scanning == vertical)
+                monotonic_column_invalidation(points, pix_coord);
+            else
+                monotonic_row_invalidation(points, pix_coord);
+            break;
         default:
             throw std::runtime_error(to_string() << "Unsupported occlusion filter type " << _occlusion_filter << " requested");
             break;
@@ -106,6 +114,82 @@ namespace librealsense
        delete[] buffer;
  
    }
+
+   // Columns scanned together by the vertical monotonic scan, so that it walks the frame row by row
+   static const int occlusion_scan_band = 64;
+
+   namespace
+   {
+       // The monotonic scan along one line of depth pixels: a point is occluded when it is mapped
+       // before the furthest texel mapped so far in the line, or onto it from further away. The first
+       // visible point after an occlusion is removed as well
+       struct monotonic_scan
+       {
+           float max_in_line = -1;
+           float max_z = 0;
+           int dilation_left = 0;
+
+           // Without branches on the holes, which are too irregular for the branch predictor
+           void next(float3& point, float mapped)
+           {
+               const float occZTh = 0.1f; //meters
+               const int occDilationSz = 1;
+
+               bool valid = point.z != 0;
+               bool occluded = valid && (mapped < max_in_line || (mapped == max_in_line && (point.z - max_z) > occZTh));
+               bool visible = valid && !occluded;
+               bool dilated = visible && dilation_left > 0;
+
+               max_in_line = visible ? mapped : max_in_line;
+               max_z = visible ? point.z : max_z;
+               dilation_left = occluded ? occDilationSz : dilation_left - int(dilated);
+               if (occluded || dilated)
+                   point = { 0, 0, 0 };
+           }
+       };
+   }
+
+   // Each row is scanned from left to right on its own
+   void occlusion_filter::monotonic_row_invalidation(float3* points, const std::vector<float2>& pix_coord) const
+   {
+       auto width = _depth_intrinsics->width;
+       auto height = _depth_intrinsics->height;
+
+       parallel_for(height, [&](int y)
+       {
+           monotonic_scan scan;
+           auto row = y * width;
+           for (int x = 0; x < width; ++x)
+               scan.next(points[row + x], pix_coord[row + x].x);
+       });
+   }
+
+   // The vertical counterpart of the row scan, for the one vertical placement find_scanning_direction()
+   // selects it for: a depth-to-color translation that is positive in Y, as on the L500. Each column
+   // is scanned from top to bottom on its own, so the mapped Y must rise monotonically; a color
+   // sensor on the other side would need the scan from bottom to top.
+   // Unlike the vertical scan of occlusion_monotonic_scan, it needs neither the rotated depth frame
+   // nor the search windows around the depth jumps
+   void occlusion_filter::monotonic_column_invalidation(float3* points, const std::vector<float2>& pix_coord) const
+   {
+       auto width = _depth_intrinsics->width;
+       auto height = _depth_intrinsics->height;
+       const int bands = (width + occlusion_scan_band - 1) / occlusion_scan_band;
+
+       parallel_for(bands, [&](int b)
+       {
+           monotonic_scan scans[occlusion_scan_band];
+           auto begin = b * occlusion_scan_band;
+           auto end = std::min(width, begin + occlusion_scan_band);
+           for (int y = 0; y < height; ++y)
+           {
+               auto row = y * width;
+               for (int x = begin; x < end; ++x)
+                   scans[x - begin].next(points[row + x], pix_coord[row + x].y);
+           }
+       });
+   }
+
     // IMPORTANT! This implementation is based on the assumption that the RGB sensor is positioned strictly to the left of the depth sensor.
     // namely D415/D435 and SR300. The implementation WILL NOT work properly for different setups
     // Heuristic occlusion invalidation algorithm:
@@ -116,51 +200,15 @@ namespace librealsense
     //    with a invalidation color such as black/magenta according to the purpose (production/debugging)
    void occlusion_filter::monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2>& pix_coord, const rs2::depth_frame& depth) const
    {
-       float occZTh = 0.1f; //meters
-       int occDilationSz = 1;
        auto points_width = _depth_intrinsics->width;
        auto points_height = _depth_intrinsics->height;
-       auto pixels_ptr = pix_coord.data();
        auto points_ptr = points;
        auto uv_map_ptr = uv_map;
        float maxInLine = -1;
-       float maxZ = 0;
 
        if (_occlusion_scanning == horizontal)
        {
-           for( int y = 0; y < points_height; ++y )
-           {
-               maxInLine = -1;
-               maxZ = 0;
-               int occDilationLeft = 0;
-
-               for(int x = 0; x < points_width; ++x )
-               {
-                   if( points_ptr->z )
-                   {
-                       // Occlusion detection
-                       if( pixels_ptr->x < maxInLine
-                           || ( pixels_ptr->x == maxInLine && ( points_ptr->z - maxZ ) > occZTh ) )
-                       {
-                           *points_ptr = { 0, 0, 0 };
-                           occDilationLeft = occDilationSz;
-                       }
-                       else
-                       {
-                           maxInLine = pixels_ptr->x;
-                           maxZ = points_ptr->z;
-                           if( occDilationLeft > 0 )
-                           {
-                               *points_ptr = { 0, 0, 0 };
-                               occDilationLeft--;
-                           }
-                       }
-                   }
-                   ++points_ptr;
-                   ++uv_map_ptr;
-                   ++pixels_ptr;
-               }
-           }
+           monotonic_row_invalidation(points, pix_coord);
        }
        else if (_occlusion_scanning == vertical)
        {
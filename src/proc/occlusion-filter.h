@@ -15,6 +15,7 @@ namespace librealsense
         occlusion_min,
         occlusion_none,
         occlusion_monotonic_scan,
+        occlusion_parallel_scan,
         occlusion_max
     };
 
@@ -58,6 +59,8 @@ namespace librealsense
         friend class pointcloud;
 
         void monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord, const rs2::depth_frame& depth) const;
+        void monotonic_row_invalidation(float3* points, const std::vector<float2> & pix_coord) const;
+        void monotonic_column_invalidation(float3* points, const std::vector<float2> & pix_coord) const;
         void comprehensive_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const;
 
         optional_value<rs2_intrinsics>              _depth_intrinsics;
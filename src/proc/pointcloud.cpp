@@ -13,12 +13,17 @@
 #include "../stream.h"
 #include <iostream>
 #include "device-calibration.h"
+#include "cpu-features.h"
 
 #ifdef RS2_USE_CUDA
 #include "proc/cuda/cuda-pointcloud.h"
 #endif
 #ifdef __SSSE3__
 #include "proc/sse/sse-pointcloud.h"
+#include "proc/avx/avx-pointcloud.h"
+#endif
+#ifdef __ARM_NEON
+#include "proc/neon/neon-pointcloud.h"
 #endif
 
 namespace librealsense
@@ -318,6 +323,7 @@ namespace librealsense
         });
         occlusion_invalidation->set_description(1.f, "Off");
         occlusion_invalidation->set_description(2.f, "On");
+        occlusion_invalidation->set_description(3.f, "Parallel");
         register_option(RS2_OPTION_FILTER_MAGNITUDE, occlusion_invalidation);
     }
 
@@ -395,7 +401,11 @@ namespace librealsense
             return std::make_shared<librealsense::pointcloud_cuda>();
         #else
         #ifdef __SSSE3__
+            if (cpu_has_avx2())
+                return std::make_shared<librealsense::pointcloud_avx2>();
             return std::make_shared<librealsense::pointcloud_sse>();
+        #elif defined(__ARM_NEON)
+            return std::make_shared<librealsense::pointcloud_neon>();
         #else
             return std::make_shared<librealsense::pointcloud>();
         #endif
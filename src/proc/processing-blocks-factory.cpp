@@ -5,8 +5,15 @@
 
 #include "sse/sse-align.h"
 #include "cuda/cuda-align.h"
+#ifdef __SSSE3__
+#include "avx/avx-align.h"
+#endif
+#ifdef __ARM_NEON
+#include "neon/neon-align.h"
+#endif
 
 #include "stream.h"
+#include "cpu-features.h"
 
 namespace librealsense
 {
@@ -19,8 +26,15 @@ namespace librealsense
 #ifdef __SSSE3__
     std::shared_ptr<librealsense::align> create_align(rs2_stream align_to)
     {
+        if (cpu_has_avx2())
+            return std::make_shared<librealsense::align_avx2>(align_to);
         return std::make_shared<librealsense::align_sse>(align_to);
     }
+#elif defined(__ARM_NEON)
+    std::shared_ptr<librealsense::align> create_align(rs2_stream align_to)
+    {
+        return std::make_shared<librealsense::align_neon>(align_to);
+    }
 #else // No optimizations
     std::shared_ptr<librealsense::align> create_align(rs2_stream align_to)
     {
@@ -5,12 +5,22 @@
 #include "../include/librealsense2/hpp/rs_processing.hpp"
 #include "option.h"
 #include "environment.h"
+#include "thread-pool.h"
+#include "cpu-features.h"
 #include "context.h"
 #include "software-device.h"
 #include "proc/synthetic-stream.h"
 #include "proc/hole-filling-filter.h"
 #include "proc/spatial-filter.h"
 
+#include <algorithm>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace librealsense
 {
     enum spatial_holes_filling_types : uint8_t
@@ -226,13 +236,392 @@ namespace librealsense
         return tgt;
     }
 
+    // Vertical passes run on strips of this many columns, small enough to stay in the cache
+    const size_t column_strip_width = 64;
+
+    // Recursive filter over the columns [begin, end), starting at first_row and moving 'step'
+    // pixels at a time. A valid (positive) disparity that is close enough to the previous one is
+    // blended with the filter state. Each column has its own state, so several are filtered at
+    // once; the result is the same as filtering them one by one.
+    static void smooth_columns_fp(float * first_row, ptrdiff_t step, size_t rows, size_t begin, size_t end,
+        float alpha, float deltaZ)
+    {
+        size_t u = begin;
+        const bool vectorized = cpu_simd_level() != simd_level::scalar;
+#if defined(__SSSE3__)
+        const __m128 a = _mm_set1_ps(alpha);
+        const __m128 b = _mm_set1_ps(1.0f - alpha);
+        const __m128 dz = _mm_set1_ps(deltaZ);
+        const __m128 ndz = _mm_set1_ps(-deltaZ);
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; vectorized && u + 4 <= end; u += 4)
+        {
+            float * im = first_row + u;
+            __m128 state = _mm_loadu_ps(im);
+            __m128 previous = state;
+            __m128 valid = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_castps_si128(state), zero));
+
+            for (size_t v = 1; v < rows; v++)
+            {
+                im += step;
+                __m128 innovation = _mm_loadu_ps(im);
+                __m128 innovation_valid = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_castps_si128(innovation), zero));
+                __m128 delta = _mm_sub_ps(previous, innovation);
+                __m128 small_difference = _mm_and_ps(_mm_cmplt_ps(delta, dz), _mm_cmpgt_ps(delta, ndz));
+                __m128 filtered = _mm_add_ps(_mm_mul_ps(innovation, a), _mm_mul_ps(state, b));
+
+                __m128 smooth = _mm_and_ps(_mm_and_ps(valid, innovation_valid), small_difference);
+                __m128 result = _mm_or_ps(_mm_and_ps(smooth, filtered), _mm_andnot_ps(smooth, innovation));
+                _mm_storeu_ps(im, result);
+
+                state = _mm_or_ps(_mm_and_ps(innovation_valid, result), _mm_andnot_ps(innovation_valid, state));
+                previous = innovation;
+                valid = innovation_valid;
+            }
+        }
+#elif defined(__ARM_NEON)
+        const float32x4_t a = vdupq_n_f32(alpha);
+        const float32x4_t b = vdupq_n_f32(1.0f - alpha);
+        const float32x4_t dz = vdupq_n_f32(deltaZ);
+        const float32x4_t ndz = vdupq_n_f32(-deltaZ);
+        const int32x4_t zero = vdupq_n_s32(0);
+
+        for (; vectorized && u + 4 <= end; u += 4)
+        {
+            float * im = first_row + u;
+            float32x4_t state = vld1q_f32(im);
+            float32x4_t previous = state;
+            uint32x4_t valid = vcgtq_s32(vreinterpretq_s32_f32(state), zero);
+
+            for (size_t v = 1; v < rows; v++)
+            {
+                im += step;
+                float32x4_t innovation = vld1q_f32(im);
+                uint32x4_t innovation_valid = vcgtq_s32(vreinterpretq_s32_f32(innovation), zero);
+                float32x4_t delta = vsubq_f32(previous, innovation);
+                uint32x4_t small_difference = vandq_u32(vcltq_f32(delta, dz), vcgtq_f32(delta, ndz));
+                float32x4_t filtered = vaddq_f32(vmulq_f32(innovation, a), vmulq_f32(state, b));
+
+                uint32x4_t smooth = vandq_u32(vandq_u32(valid, innovation_valid), small_difference);
+                float32x4_t result = vbslq_f32(smooth, filtered, innovation);
+                vst1q_f32(im, result);
+
+                state = vbslq_f32(innovation_valid, result, state);
+                previous = innovation;
+                valid = innovation_valid;
+            }
+        }
+#endif
+        for (; u < end; u++)
+        {
+            float * im = first_row + u;
+            float state = *im;
+            float previousInnovation = state;
+            bool valid = *(int*)&previousInnovation > 0;
+
+            for (size_t v = 1; v < rows; v++)
+            {
+                im += step;
+                float innovation = *im;
+                bool innovation_valid = *(int*)&innovation > 0;
+
+                if (innovation_valid)
+                {
+                    float delta = previousInnovation - innovation;
+                    bool smallDifference = delta < deltaZ && delta > -deltaZ;
+
+                    if (valid && smallDifference) {
+                        float filtered = innovation * alpha + state * (1.0f - alpha);
+                        *im = state = filtered;
+                    }
+                    else {
+                        state = innovation;
+                    }
+                }
+                previousInnovation = innovation;
+                valid = innovation_valid;
+            }
+        }
+    }
+
+#if defined(__SSSE3__)
+    // cur * alpha + other * (1 - alpha), rounded the same way as the scalar code
+    static inline __m128i weighted_z16(__m128i cur, __m128i other, __m128 a, __m128 b)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 half = _mm_set1_ps(0.5f);
+        __m128 lo = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(cur, zero)), a),
+                               _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(other, zero)), b));
+        __m128 hi = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(cur, zero)), a),
+                               _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(other, zero)), b));
+        __m128i lo32 = _mm_cvttps_epi32(_mm_add_ps(lo, half));
+        __m128i hi32 = _mm_cvttps_epi32(_mm_add_ps(hi, half));
+
+        // Unsigned 32 to 16-bit pack, with the signed saturating pack of SSE2
+        const __m128i bias32 = _mm_set1_epi32(0x8000);
+        const __m128i bias16 = _mm_set1_epi16(short(0x8000));
+        return _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(lo32, bias32), _mm_sub_epi32(hi32, bias32)), bias16);
+    }
+
+    static inline __m128i select_z16(__m128i mask, __m128i if_set, __m128i if_clear)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, if_set), _mm_andnot_si128(mask, if_clear));
+    }
+#elif defined(__ARM_NEON)
+    // cur * alpha + other * (1 - alpha), rounded the same way as the scalar code
+    static inline uint16x8_t weighted_z16(uint16x8_t cur, uint16x8_t other, float32x4_t a, float32x4_t b)
+    {
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        float32x4_t lo = vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(cur))), a),
+                                   vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(other))), b));
+        float32x4_t hi = vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(cur))), a),
+                                   vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(other))), b));
+        return vcombine_u16(vmovn_u32(vcvtq_u32_f32(vaddq_f32(lo, half))),
+                            vmovn_u32(vcvtq_u32_f32(vaddq_f32(hi, half))));
+    }
+#endif
+
+    // Recursive filter over the columns [begin, end) of a Z16 image, starting at first_row and
+    // moving 'step' pixels at a time: each pixel is blended with the (already filtered) previous
+    // one when they are close enough.
+    static void smooth_columns_z16(uint16_t * first_row, ptrdiff_t step, size_t rows, size_t begin, size_t end,
+        float alpha, uint16_t delta_z, bool valid_only)
+    {
+        const bool vectorized = cpu_simd_level() != simd_level::scalar;
+        uint16_t * previous = first_row;
+        for (size_t v = 1; v < rows; v++, previous += step)
+        {
+            uint16_t * current = previous + step;
+            size_t u = begin;
+#if defined(__SSSE3__)
+            const __m128 a = _mm_set1_ps(alpha);
+            const __m128 b = _mm_set1_ps(1.f - alpha);
+            const __m128i dz = _mm_set1_epi16(short(delta_z));
+            const __m128i zero = _mm_setzero_si128();
+
+            for (; vectorized && u + 8 <= end; u += 8)
+            {
+                __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current + u));
+                __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + u));
+
+                // Keep the pixels that differ by delta_z or more, or are invalid
+                __m128i diff = _mm_or_si128(_mm_subs_epu16(cur, prev), _mm_subs_epu16(prev, cur));
+                __m128i keep = _mm_cmpeq_epi16(_mm_subs_epu16(dz, diff), zero);
+                if (valid_only)
+                    keep = _mm_or_si128(keep, _mm_or_si128(_mm_cmpeq_epi16(cur, zero), _mm_cmpeq_epi16(prev, zero)));
+                if (_mm_movemask_epi8(keep) == 0xffff)
+                    continue;
+
+                __m128i result = select_z16(keep, cur, weighted_z16(cur, prev, a, b));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(current + u), result);
+            }
+#elif defined(__ARM_NEON)
+            const float32x4_t a = vdupq_n_f32(alpha);
+            const float32x4_t b = vdupq_n_f32(1.f - alpha);
+            const uint16x8_t dz = vdupq_n_u16(delta_z);
+            const uint16x8_t zero = vdupq_n_u16(0);
+
+            for (; vectorized && u + 8 <= end; u += 8)
+            {
+                uint16x8_t cur = vld1q_u16(current + u);
+                uint16x8_t prev = vld1q_u16(previous + u);
+
+                // Keep the pixels that differ by delta_z or more, or are invalid
+                uint16x8_t keep = vcgeq_u16(vabdq_u16(cur, prev), dz);
+                if (valid_only)
+                    keep = vorrq_u16(keep, vorrq_u16(vceqq_u16(cur, zero), vceqq_u16(prev, zero)));
+
+                vst1q_u16(current + u, vbslq_u16(keep, cur, weighted_z16(cur, prev, a, b)));
+            }
+#endif
+            for (; u < end; u++)
+            {
+                uint16_t cur = current[u];
+                uint16_t prev = previous[u];
+                if (valid_only && (!cur || !prev))
+                    continue;
+
+                uint16_t diff = static_cast<uint16_t>(std::abs(cur - prev));
+                if (diff < delta_z)
+                {
+                    float filtered = cur * alpha + prev * (1.f - alpha);
+                    current[u] = static_cast<uint16_t>(filtered + 0.5f);
+                }
+            }
+        }
+    }
+
+#if defined(__SSSE3__) || defined(__ARM_NEON)
+    // Rows are filtered horizontally this many at a time, one per SIMD lane
+    const size_t row_lanes = 8;
+
+    // The horizontal recursive filter of recursive_filter_horizontal<uint16_t>, on 8 rows at once.
+    // The rows are interleaved: lanes[u * 8 + r] is pixel u of row r.
+    static void smooth_rows_z16(uint16_t * lanes, size_t width, float alpha, uint16_t delta_z, uint8_t holes_filling_radius)
+    {
+#if defined(__SSSE3__)
+        const __m128 a = _mm_set1_ps(alpha);
+        const __m128 b = _mm_set1_ps(1.f - alpha);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i ones = _mm_cmpeq_epi16(zero, zero);
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i dz = _mm_set1_epi16(short(delta_z));
+        const __m128i radius = _mm_set1_epi16(holes_filling_radius);
+        const __m128i fill_enabled = holes_filling_radius ? ones : zero;
+        __m128i * px = reinterpret_cast<__m128i*>(lanes);
+
+        // left to right
+        __m128i val0 = _mm_loadu_si128(px);
+        __m128i cur_fill = zero;
+        for (size_t u = 1; u < width - 1; u++)
+        {
+            __m128i val1 = _mm_loadu_si128(px + u);
+            __m128i invalid0 = _mm_cmpeq_epi16(val0, zero);
+            __m128i invalid1 = _mm_cmpeq_epi16(val1, zero);
+            __m128i diff = _mm_or_si128(_mm_subs_epu16(val1, val0), _mm_subs_epu16(val0, val1));
+
+            // Both valid: smooth when 1 <= diff <= delta_z
+            __m128i not_both_valid = _mm_or_si128(invalid0, invalid1);
+            __m128i above_delta = _mm_xor_si128(_mm_cmpeq_epi16(_mm_subs_epu16(diff, dz), zero), ones);
+            __m128i no_smooth = _mm_or_si128(not_both_valid, _mm_or_si128(_mm_cmpeq_epi16(diff, zero), above_delta));
+            cur_fill = _mm_and_si128(cur_fill, not_both_valid);
+
+            // Only the old value is valid: holes filling
+            __m128i hole = _mm_and_si128(_mm_andnot_si128(invalid0, invalid1), fill_enabled);
+            cur_fill = _mm_adds_epu16(cur_fill, _mm_and_si128(hole, one));
+            __m128i fill = _mm_andnot_si128(_mm_cmpeq_epi16(_mm_subs_epu16(radius, cur_fill), zero), hole);
+
+            val1 = select_z16(no_smooth, select_z16(fill, val0, val1), weighted_z16(val1, val0, a, b));
+            _mm_storeu_si128(px + u, val1);
+            val0 = val1;
+        }
+
+        // right to left
+        __m128i val1 = _mm_loadu_si128(px + width - 1);
+        cur_fill = zero;
+        for (size_t u = width - 1; u-- > 0;)
+        {
+            val0 = _mm_loadu_si128(px + u);
+            __m128i invalid1 = _mm_cmpeq_epi16(val1, zero);
+            __m128i invalid0 = _mm_cmpeq_epi16(_mm_subs_epu16(val0, one), zero);  // Not above 1
+            __m128i diff = _mm_or_si128(_mm_subs_epu16(val1, val0), _mm_subs_epu16(val0, val1));
+
+            // Both valid: smooth when diff <= delta_z
+            __m128i not_both_valid = _mm_or_si128(invalid0, invalid1);
+            __m128i above_delta = _mm_xor_si128(_mm_cmpeq_epi16(_mm_subs_epu16(diff, dz), zero), ones);
+            __m128i no_smooth = _mm_or_si128(not_both_valid, above_delta);
+            cur_fill = _mm_and_si128(cur_fill, not_both_valid);
+
+            // 'inertial' hole filling
+            __m128i hole = _mm_and_si128(_mm_andnot_si128(invalid1, invalid0), fill_enabled);
+            cur_fill = _mm_adds_epu16(cur_fill, _mm_and_si128(hole, one));
+            __m128i fill = _mm_andnot_si128(_mm_cmpeq_epi16(_mm_subs_epu16(radius, cur_fill), zero), hole);
+
+            val0 = select_z16(no_smooth, select_z16(fill, val1, val0), weighted_z16(val0, val1, a, b));
+            _mm_storeu_si128(px + u, val0);
+            val1 = val0;
+        }
+#else
+        const float32x4_t a = vdupq_n_f32(alpha);
+        const float32x4_t b = vdupq_n_f32(1.f - alpha);
+        const uint16x8_t zero = vdupq_n_u16(0);
+        const uint16x8_t one = vdupq_n_u16(1);
+        const uint16x8_t dz = vdupq_n_u16(delta_z);
+        const uint16x8_t radius = vdupq_n_u16(holes_filling_radius);
+        const uint16x8_t fill_enabled = vdupq_n_u16(holes_filling_radius ? 0xffff : 0);
+
+        // left to right
+        uint16x8_t val0 = vld1q_u16(lanes);
+        uint16x8_t cur_fill = zero;
+        for (size_t u = 1; u < width - 1; u++)
+        {
+            uint16x8_t val1 = vld1q_u16(lanes + u * row_lanes);
+            uint16x8_t invalid0 = vceqq_u16(val0, zero);
+            uint16x8_t invalid1 = vceqq_u16(val1, zero);
+            uint16x8_t diff = vabdq_u16(val1, val0);
+
+            // Both valid: smooth when 1 <= diff <= delta_z
+            uint16x8_t not_both_valid = vorrq_u16(invalid0, invalid1);
+            uint16x8_t smooth = vbicq_u16(vandq_u16(vtstq_u16(diff, diff), vcleq_u16(diff, dz)), not_both_valid);
+            cur_fill = vandq_u16(cur_fill, not_both_valid);
+
+            // Only the old value is valid: holes filling
+            uint16x8_t hole = vandq_u16(vbicq_u16(invalid1, invalid0), fill_enabled);
+            cur_fill = vqaddq_u16(cur_fill, vandq_u16(hole, one));
+            uint16x8_t fill = vandq_u16(vcltq_u16(cur_fill, radius), hole);
+
+            val1 = vbslq_u16(smooth, weighted_z16(val1, val0, a, b), vbslq_u16(fill, val0, val1));
+            vst1q_u16(lanes + u * row_lanes, val1);
+            val0 = val1;
+        }
+
+        // right to left
+        uint16x8_t val1 = vld1q_u16(lanes + (width - 1) * row_lanes);
+        cur_fill = zero;
+        for (size_t u = width - 1; u-- > 0;)
+        {
+            val0 = vld1q_u16(lanes + u * row_lanes);
+            uint16x8_t invalid1 = vceqq_u16(val1, zero);
+            uint16x8_t invalid0 = vcleq_u16(val0, one);  // Not above 1
+            uint16x8_t diff = vabdq_u16(val1, val0);
+
+            // Both valid: smooth when diff <= delta_z
+            uint16x8_t not_both_valid = vorrq_u16(invalid0, invalid1);
+            uint16x8_t smooth = vbicq_u16(vcleq_u16(diff, dz), not_both_valid);
+            cur_fill = vandq_u16(cur_fill, not_both_valid);
+
+            // 'inertial' hole filling
+            uint16x8_t hole = vandq_u16(vbicq_u16(invalid0, invalid1), fill_enabled);
+            cur_fill = vqaddq_u16(cur_fill, vandq_u16(hole, one));
+            uint16x8_t fill = vandq_u16(vcltq_u16(cur_fill, radius), hole);
+
+            val0 = vbslq_u16(smooth, weighted_z16(val0, val1, a, b), vbslq_u16(fill, val1, val0));
+            vst1q_u16(lanes + u * row_lanes, val0);
+            val1 = val0;
+        }
+#endif
+    }
+#endif
+
+    void spatial_filter::recursive_filter_horizontal_z16(void * image_data, float alpha, float deltaZ)
+    {
+        uint16_t *image = reinterpret_cast<uint16_t*>(image_data);
+        size_t vector_rows = 0;
+
+#if defined(__SSSE3__) || defined(__ARM_NEON)
+        const uint16_t delta_z = static_cast<uint16_t>(deltaZ);
+        const int groups = cpu_simd_level() != simd_level::scalar ? int(_height / row_lanes) : 0;
+        vector_rows = groups * row_lanes;
+
+        parallel_for(groups, [&](int g)
+        {
+            std::vector<uint16_t> lanes(_width * row_lanes);
+            uint16_t * rows = image + g * row_lanes * _width;
+
+            for (size_t r = 0; r < row_lanes; r++)
+                for (size_t u = 0; u < _width; u++)
+                    lanes[u * row_lanes + r] = rows[r * _width + u];
+
+            smooth_rows_z16(lanes.data(), _width, alpha, delta_z, _holes_filling_radius);
+
+            for (size_t r = 0; r < row_lanes; r++)
+                for (size_t u = 0; u < _width; u++)
+                    rows[r * _width + u] = lanes[u * row_lanes + r];
+        });
+#endif
+        // The remaining rows, one at a time
+        recursive_filter_horizontal<uint16_t>(image_data, alpha, deltaZ, vector_rows);
+    }
+
     void spatial_filter::recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ)
     {
         float *image = reinterpret_cast<float*>(image_data);
 
-        int v, u;
+        parallel_for(int(_height), [&](int v)
+        {
+            int u;
 
-        for (v = 0; v < _height;) {
             // left to right
             float *im = image + v * _width;
             float state = *im;
@@ -350,138 +739,40 @@ namespace librealsense
                 }
             }
         DoneRL:
-            v++;
-        }
+            ;
+        });
     }
 
     void spatial_filter::recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ)
     {
         float *image = reinterpret_cast<float*>(image_data);
+        const int strips = int((_width + column_strip_width - 1) / column_strip_width);
 
-        int v, u;
-
-        // we'll do one column at a time, top to bottom, bottom to top, left to right,
-
-        for (u = 0; u < _width;) {
-
-            float *im = image + u;
-            float state = im[0];
-            float previousInnovation = state;
-
-            v = int(_height) - 1;
-            im += _width;
-            float innovation = *im;
-
-            if (!(*(int*)&previousInnovation > 0))
-                goto CurrentlyInvalidTB;
-            // else fall through
-
-        CurrentlyValidTB:
-            for (;;) {
-                if (*(int*)&innovation > 0) {
-                    float delta = previousInnovation - innovation;
-                    bool smallDifference = delta < deltaZ && delta > -deltaZ;
-
-                    if (smallDifference) {
-                        float filtered = innovation * alpha + state * (1.0f - alpha);
-                        *im = state = filtered;
-                    }
-                    else {
-                        state = innovation;
-                    }
-                    v--;
-                    if (v <= 0)
-                        goto DoneTB;
-                    previousInnovation = innovation;
-                    im += _width;
-                    innovation = *im;
-                }
-                else {  // switch to CurrentlyInvalid state
-                    v--;
-                    if (v <= 0)
-                        goto DoneTB;
-                    previousInnovation = innovation;
-                    im += _width;
-                    innovation = *im;
-                    goto CurrentlyInvalidTB;
-                }
-            }
+        parallel_for(strips, [&](int s)
+        {
+            size_t begin = s * column_strip_width;
+            size_t end = std::min(_width, begin + column_strip_width);
 
-        CurrentlyInvalidTB:
-            for (;;) {
-                v--;
-                if (v <= 0)
-                    goto DoneTB;
-                if (*(int*)&innovation > 0) { // switch to CurrentlyValid state
-                    previousInnovation = state = innovation;
-                    im += _width;
-                    innovation = *im;
-                    goto CurrentlyValidTB;
-                }
-                else {
-                    im += _width;
-                    innovation = *im;
-                }
-            }
-        DoneTB:
+            // top to bottom, then bottom to top
+            smooth_columns_fp(image, ptrdiff_t(_width), _height, begin, end, alpha, deltaZ);
+            smooth_columns_fp(image + (_height - 1) * _width, -ptrdiff_t(_width), _height, begin, end, alpha, deltaZ);
+        });
+    }
 
-            im = image + u + (_height - 2) * _width;
-            state = im[_width];
-            previousInnovation = state;
-            innovation = *im;
-            v = int(_height) - 1;
-            if (!(*(int*)&previousInnovation > 0))
-                goto CurrentlyInvalidBT;
-            // else fall through
-        CurrentlyValidBT:
-            for (;;) {
-                if (*(int*)&innovation > 0) {
-                    float delta = previousInnovation - innovation;
-                    bool smallDifference = delta < deltaZ && delta > -deltaZ;
+    void spatial_filter::recursive_filter_vertical_z16(void * image_data, float alpha, float deltaZ)
+    {
+        uint16_t *image = reinterpret_cast<uint16_t*>(image_data);
+        const uint16_t delta_z = static_cast<uint16_t>(deltaZ);
+        const int strips = int((_width + column_strip_width - 1) / column_strip_width);
 
-                    if (smallDifference) {
-                        float filtered = innovation * alpha + state * (1.0f - alpha);
-                        *im = state = filtered;
-                    }
-                    else {
-                        state = innovation;
-                    }
-                    v--;
-                    if (v <= 0)
-                        goto DoneBT;
-                    previousInnovation = innovation;
-                    im -= _width;
-                    innovation = *im;
-                }
-                else {  // switch to CurrentlyInvalid state
-                    v--;
-                    if (v <= 0)
-                        goto DoneBT;
-                    previousInnovation = innovation;
-                    im -= _width;
-                    innovation = *im;
-                    goto CurrentlyInvalidBT;
-                }
-            }
+        parallel_for(strips, [&](int s)
+        {
+            size_t begin = s * column_strip_width;
+            size_t end = std::min(_width, begin + column_strip_width);
 
-        CurrentlyInvalidBT:
-            for (;;) {
-                v--;
-                if (v <= 0)
-                    goto DoneBT;
-                if (*(int*)&innovation > 0) { // switch to CurrentlyValid state
-                    previousInnovation = state = innovation;
-                    im -= _width;
-                    innovation = *im;
-                    goto CurrentlyValidBT;
-                }
-                else {
-                    im -= _width;
-                    innovation = *im;
-                }
-            }
-        DoneBT:
-            u++;
-        }
+            // top to bottom, then bottom to top where only valid pixels are smoothed
+            smooth_columns_z16(image, ptrdiff_t(_width), _height, begin, end, alpha, delta_z, false);
+            smooth_columns_z16(image + (_height - 1) * _width, -ptrdiff_t(_width), _height, begin, end, alpha, delta_z, true);
+        });
     }
 }
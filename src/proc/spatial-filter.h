@@ -12,6 +12,7 @@
 
 #include "../include/librealsense2/hpp/rs_frame.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "thread-pool.h"
 
 namespace librealsense
 {
@@ -30,6 +31,8 @@ namespace librealsense
         void dxf_smooth(void *frame_data, float alpha, float delta, int iterations)
         {
             static_assert((std::is_arithmetic<T>::value), "Spatial filter assumes numeric types");
+            static_assert((std::is_floating_point<T>::value || std::is_same<T, uint16_t>::value),
+                "Spatial filter supports Z16 depth and float disparity");
             bool fp = (std::is_floating_point<T>::value);
 
             for (int i = 0; i < iterations; i++)
@@ -41,8 +44,8 @@ namespace librealsense
                 }
                 else
                 {
-                    recursive_filter_horizontal<T>(frame_data, alpha, delta);
-                    recursive_filter_vertical<T>(frame_data, alpha, delta);
+                    recursive_filter_horizontal_z16(frame_data, alpha, delta);
+                    recursive_filter_vertical_z16(frame_data, alpha, delta);
                 }
             }
 
@@ -52,14 +55,19 @@ namespace librealsense
                 intertial_holes_fill<T>(static_cast<T*>(frame_data));
         }
 
+        // Rows are filtered independently, in parallel on the thread pool. Z16 rows are also
+        // filtered several at a time with SIMD.
         void recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ);
+        void recursive_filter_horizontal_z16(void * image_data, float alpha, float deltaZ);
+
+        // Columns are filtered several at a time with SIMD, in strips that run in parallel on the
+        // thread pool. The results are identical to filtering one column at a time.
         void recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ);
+        void recursive_filter_vertical_z16(void * image_data, float alpha, float deltaZ);
 
         template <typename T>
-        void  recursive_filter_horizontal(void * image_data, float alpha, float deltaZ)
+        void  recursive_filter_horizontal(void * image_data, float alpha, float deltaZ, size_t first_row = 0)
         {
-            size_t v{}, u{};
-
             // Handle conversions for invalid input data
             bool fp = (std::is_floating_point<T>::value);
 
@@ -70,14 +78,17 @@ namespace librealsense
             const T delta_z = static_cast<T>(deltaZ);
 
             auto image = reinterpret_cast<T*>(image_data);
-            size_t cur_fill = 0;
 
-            for (v = 0; v < _height; v++)
+            // Rows are independent of each other
+            parallel_for(int(_height - first_row), [&](int row)
             {
+                const int v = int(first_row) + row;
+                size_t u{};
+
                 // left to right
                 T *im = image + v * _width;
                 T val0 = im[0];
-                cur_fill = 0;
+                size_t cur_fill = 0;
 
                 for (u = 1; u < _width - 1; u++)
                 {
@@ -147,73 +158,7 @@ namespace librealsense
                     val1 = val0;
                     im -= 1;
                 }
-            }
-        }
-
-        template <typename T>
-        void recursive_filter_vertical(void * image_data, float alpha, float deltaZ)
-        {
-            size_t v{}, u{};
-
-            // Handle conversions for invalid input data
-            bool fp = (std::is_floating_point<T>::value);
-
-            // Filtering integer values requires round-up to the nearest discrete value
-            const float round = fp ? 0.f : 0.5f;
-            // define invalid range
-            const T valid_threshold = fp ? static_cast<T>(std::numeric_limits<T>::epsilon()) : static_cast<T>(1);
-            const T delta_z = static_cast<T>(deltaZ);
-
-            auto image = reinterpret_cast<T*>(image_data);
-
-            // we'll do one row at a time, top to bottom, then bottom to top
-
-            // top to bottom
-
-            T *im = image;
-            T im0{};
-            T imw{};
-            for (v = 1; v < _height; v++)
-            {
-                for (u = 0; u < _width; u++)
-                {
-                    im0 = im[0];
-                    imw = im[_width];
-
-                    //if ((fabs(im0) >= valid_threshold) && (fabs(imw) >= valid_threshold))
-                    {
-                        T diff = static_cast<T>(fabs(im0 - imw));
-                        if (diff < delta_z)
-                        {
-                            float filtered = imw * alpha + im0 * (1.f - alpha);
-                            im[_width] = static_cast<T>(filtered + round);
-                        }
-                    }
-                    im += 1;
-                }
-            }
-
-            // bottom to top
-            im = image + (_height - 2) * _width;
-            for (v = 1; v < _height; v++, im -= (_width * 2))
-            {
-                for (u = 0; u < _width; u++)
-                {
-                    im0 = im[0];
-                    imw = im[_width];
-
-                    if ((fabs(im0) >= valid_threshold) && (fabs(imw) >= valid_threshold))
-                    {
-                        T diff = static_cast<T>(fabs(im0 - imw));
-                        if (diff < delta_z)
-                        {
-                            float filtered = im0 * alpha + imw * (1.f - alpha);
-                            im[0] = static_cast<T>(filtered + round);
-                        }
-                    }
-                    im += 1;
-                }
-            }
+            });
         }
 
         template<typename T>
@@ -264,6 +209,7 @@ namespace librealsense
         }
 
     private:
+        friend class depth_post_processing;
 
         float                   _spatial_alpha_param;
         uint8_t                 _spatial_delta_param;
@@ -26,6 +26,9 @@ namespace librealsense
         _source_wrapper(_source)
     {
         register_option(RS2_OPTION_FRAMES_QUEUE_SIZE, _source.get_published_size_option());
+        for (auto counter : { RS2_OPTION_FRAMES_POOL_HITS, RS2_OPTION_FRAMES_POOL_MISSES, RS2_OPTION_FRAMES_POOL_EVICTIONS })
+            register_option(counter, _source.get_buffers_statistics_option(counter));
+        register_option(RS2_OPTION_FRAMES_POOL_RETENTION, _source.get_buffers_retention_option());
         register_info(RS2_CAMERA_INFO_NAME, name);
         _source.init(std::shared_ptr<metadata_parser_map>());
     }
@@ -397,6 +400,7 @@ namespace librealsense
         if (!res) throw wrong_api_call_sequence_exception("Out of frame resources!");
         vf = dynamic_cast<video_frame*>(res);
         vf->metadata_parsers = of->metadata_parsers;
+        vf->metadata_table = of->metadata_table;
         vf->assign(width, height, stride, bpp);
         vf->set_sensor(original->get_sensor());
         res->set_stream(stream);
@@ -420,6 +424,7 @@ namespace librealsense
         if (!res) throw wrong_api_call_sequence_exception("Out of frame resources!");
         auto mf = dynamic_cast<motion_frame*>(res);
         mf->metadata_parsers = of->metadata_parsers;
+        mf->metadata_table = of->metadata_table;
         mf->set_sensor(original->get_sensor());
         res->set_stream(stream);
 
@@ -6,10 +6,19 @@
 #include "source.h"
 #include "option.h"
 #include "environment.h"
+#include "cpu-features.h"
 #include "context.h"
 #include "proc/synthetic-stream.h"
 #include "proc/temporal-filter.h"
 
+#include <algorithm>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace librealsense
 {
     const size_t PERSISTENCE_MAP_NUM = 9;
@@ -171,7 +180,7 @@ namespace librealsense
             _last_frame.resize(_current_frm_size_pixels*_bpp);
 
             _history.clear();
-            _history.resize(_current_frm_size_pixels*_bpp);
+            _history.resize(_current_frm_size_pixels);
 
         }
     }
@@ -185,6 +194,246 @@ namespace librealsense
         return tgt;
     }
 
+#if defined(__SSSE3__) || (defined(__ARM_NEON) && defined(__aarch64__))
+    // Whether a history is credible at the current phase, looked up 16 histories at a time: by the
+    // history's high nibble, 'low' and 'high' hold the bits of the histories with a low nibble of
+    // 0-7 and 8-15 respectively
+    struct credible_lut
+    {
+        alignas(16) uint8_t low[16];
+        alignas(16) uint8_t high[16];
+
+        credible_lut(const std::array<uint8_t, PRESISTENCY_LUT_SIZE>& persistence_map, unsigned char mask)
+        {
+            for (int hi = 0; hi < 16; hi++)
+            {
+                low[hi] = high[hi] = 0;
+                for (int lo = 0; lo < 8; lo++)
+                {
+                    if (persistence_map[hi * 16 + lo] & mask)
+                        low[hi] |= 1 << lo;
+                    if (persistence_map[hi * 16 + lo + 8] & mask)
+                        high[hi] |= 1 << lo;
+                }
+            }
+        }
+    };
+#endif
+
+#if defined(__SSSE3__)
+    // 0xff for the histories that are credible, 0 otherwise
+    static inline __m128i credible(__m128i hist, __m128i low, __m128i high)
+    {
+        const __m128i nibble = _mm_set1_epi8(0x0f);
+        const __m128i eight = _mm_set1_epi8(8);
+        const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, char(128), 1, 2, 4, 8, 16, 32, 64, char(128));
+
+        __m128i lo = _mm_and_si128(hist, nibble);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(hist, 4), nibble);
+        __m128i use_high = _mm_cmpeq_epi8(_mm_and_si128(lo, eight), eight);
+        __m128i row = _mm_or_si128(_mm_and_si128(use_high, _mm_shuffle_epi8(high, hi)),
+                                   _mm_andnot_si128(use_high, _mm_shuffle_epi8(low, hi)));
+        __m128i bit = _mm_shuffle_epi8(bits, lo);
+        return _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+    }
+
+    static inline __m128i select(__m128i mask, __m128i if_set, __m128i if_clear)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, if_set), _mm_andnot_si128(mask, if_clear));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    // 0xff for the histories that are credible, 0 otherwise
+    static inline uint8x8_t credible(uint8x8_t hist, uint8x16_t low, uint8x16_t high)
+    {
+        uint8x8_t lo = vand_u8(hist, vdup_n_u8(0x0f));
+        uint8x8_t hi = vshr_n_u8(hist, 4);
+        uint8x8_t row = vbsl_u8(vtst_u8(lo, vdup_n_u8(8)), vqtbl1_u8(high, hi), vqtbl1_u8(low, hi));
+        uint8x8_t bit = vshl_u8(vdup_n_u8(1), vreinterpret_s8_u8(vand_u8(lo, vdup_n_u8(7))));
+        return vtst_u8(row, bit);
+    }
+#endif
+
+    size_t temporal_filter::temp_jw_smooth_simd(uint16_t* frame, uint16_t* last_frame, uint8_t *history, size_t begin, size_t end, unsigned char mask) const
+    {
+        size_t i = begin;
+        if (cpu_simd_level() == simd_level::scalar)
+            return i;
+#if defined(__SSSE3__)
+        credible_lut lut(_persistence_map, mask);
+        const __m128i low = _mm_load_si128(reinterpret_cast<const __m128i*>(lut.low));
+        const __m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(lut.high));
+        const __m128 a = _mm_set1_ps(_alpha_param);
+        const __m128 b = _mm_set1_ps(_one_minus_alpha);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i dz = _mm_set1_epi16(static_cast<uint16_t>(_delta_param));
+        const __m128i m = _mm_set1_epi8(char(mask));
+
+        for (; i + 8 <= end; i += 8)
+        {
+            __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frame + i));
+            __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last_frame + i));
+            __m128i hist = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(history + i));
+
+            __m128i no_cur = _mm_cmpeq_epi16(cur, zero);
+            __m128i no_prev = _mm_cmpeq_epi16(prev, zero);
+            __m128i diff = _mm_or_si128(_mm_subs_epu16(cur, prev), _mm_subs_epu16(prev, cur));
+            __m128i disagree = _mm_cmpeq_epi16(_mm_subs_epu16(dz, diff), zero);
+            __m128i smooth = _mm_andnot_si128(_mm_or_si128(disagree, _mm_or_si128(no_cur, no_prev)), _mm_cmpeq_epi16(zero, zero));
+
+            __m128 lo = _mm_add_ps(_mm_mul_ps(a, _mm_cvtepi32_ps(_mm_unpacklo_epi16(cur, zero))),
+                                   _mm_mul_ps(b, _mm_cvtepi32_ps(_mm_unpacklo_epi16(prev, zero))));
+            __m128 hi = _mm_add_ps(_mm_mul_ps(a, _mm_cvtepi32_ps(_mm_unpackhi_epi16(cur, zero))),
+                                   _mm_mul_ps(b, _mm_cvtepi32_ps(_mm_unpackhi_epi16(prev, zero))));
+            // Unsigned 32 to 16-bit pack, with the signed saturating pack of SSE2
+            const __m128i bias32 = _mm_set1_epi32(0x8000);
+            __m128i filtered = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(_mm_cvttps_epi32(lo), bias32),
+                                                             _mm_sub_epi32(_mm_cvttps_epi32(hi), bias32)),
+                                             _mm_set1_epi16(short(0x8000)));
+
+            __m128i cred = credible(hist, low, high);
+            __m128i persist = _mm_andnot_si128(no_prev, _mm_and_si128(no_cur, _mm_unpacklo_epi8(cred, cred)));
+
+            __m128i result = select(smooth, filtered, select(persist, prev, cur));
+            __m128i last = select(no_cur, prev, select(smooth, filtered, cur));
+
+            __m128i no_cur8 = _mm_packs_epi16(no_cur, no_cur);
+            __m128i smooth8 = _mm_packs_epi16(smooth, smooth);
+            hist = select(no_cur8, _mm_andnot_si128(m, hist), select(smooth8, _mm_or_si128(hist, m), m));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + i), result);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(last_frame + i), last);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(history + i), hist);
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        credible_lut lut(_persistence_map, mask);
+        const uint8x16_t low = vld1q_u8(lut.low);
+        const uint8x16_t high = vld1q_u8(lut.high);
+        const float32x4_t a = vdupq_n_f32(_alpha_param);
+        const float32x4_t b = vdupq_n_f32(_one_minus_alpha);
+        const uint16x8_t zero = vdupq_n_u16(0);
+        const uint16x8_t dz = vdupq_n_u16(static_cast<uint16_t>(_delta_param));
+        const uint8x8_t m = vdup_n_u8(mask);
+
+        for (; i + 8 <= end; i += 8)
+        {
+            uint16x8_t cur = vld1q_u16(frame + i);
+            uint16x8_t prev = vld1q_u16(last_frame + i);
+            uint8x8_t hist = vld1_u8(history + i);
+
+            uint16x8_t no_cur = vceqq_u16(cur, zero);
+            uint16x8_t no_prev = vceqq_u16(prev, zero);
+            uint16x8_t smooth = vbicq_u16(vcltq_u16(vabdq_u16(cur, prev), dz), vorrq_u16(no_cur, no_prev));
+
+            float32x4_t lo = vaddq_f32(vmulq_f32(a, vcvtq_f32_u32(vmovl_u16(vget_low_u16(cur)))),
+                                       vmulq_f32(b, vcvtq_f32_u32(vmovl_u16(vget_low_u16(prev)))));
+            float32x4_t hi = vaddq_f32(vmulq_f32(a, vcvtq_f32_u32(vmovl_u16(vget_high_u16(cur)))),
+                                       vmulq_f32(b, vcvtq_f32_u32(vmovl_u16(vget_high_u16(prev)))));
+            uint16x8_t filtered = vcombine_u16(vmovn_u32(vcvtq_u32_f32(lo)), vmovn_u32(vcvtq_u32_f32(hi)));
+
+            uint16x8_t cred = vreinterpretq_u16_s16(vmovl_s8(vreinterpret_s8_u8(credible(hist, low, high))));
+            uint16x8_t persist = vbicq_u16(vandq_u16(no_cur, cred), no_prev);
+
+            vst1q_u16(frame + i, vbslq_u16(smooth, filtered, vbslq_u16(persist, prev, cur)));
+            vst1q_u16(last_frame + i, vbslq_u16(no_cur, prev, vbslq_u16(smooth, filtered, cur)));
+            vst1_u8(history + i, vbsl_u8(vmovn_u16(no_cur), vbic_u8(hist, m), vbsl_u8(vmovn_u16(smooth), vorr_u8(hist, m), m)));
+        }
+#endif
+        return i;
+    }
+
+    size_t temporal_filter::temp_jw_smooth_simd(float* frame, float* last_frame, uint8_t *history, size_t begin, size_t end, unsigned char mask) const
+    {
+        size_t i = begin;
+        if (cpu_simd_level() == simd_level::scalar)
+            return i;
+#if defined(__SSSE3__)
+        credible_lut lut(_persistence_map, mask);
+        const __m128i low = _mm_load_si128(reinterpret_cast<const __m128i*>(lut.low));
+        const __m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(lut.high));
+        const __m128 a = _mm_set1_ps(_alpha_param);
+        const __m128 b = _mm_set1_ps(_one_minus_alpha);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 sign = _mm_set1_ps(-0.f);
+        const __m128 dz = _mm_set1_ps(static_cast<float>(_delta_param));
+        const __m128i m = _mm_set1_epi8(char(mask));
+
+        for (; i + 4 <= end; i += 4)
+        {
+            __m128 cur = _mm_loadu_ps(frame + i);
+            __m128 prev = _mm_loadu_ps(last_frame + i);
+            int packed_hist;
+            memcpy(&packed_hist, history + i, sizeof(packed_hist));
+            __m128i hist = _mm_cvtsi32_si128(packed_hist);
+
+            __m128 no_cur = _mm_cmpeq_ps(cur, zero);
+            __m128 no_prev = _mm_cmpeq_ps(prev, zero);
+            __m128 agree = _mm_cmplt_ps(_mm_andnot_ps(sign, _mm_sub_ps(cur, prev)), dz);
+            __m128 smooth = _mm_andnot_ps(_mm_or_ps(no_cur, no_prev), agree);
+            __m128 filtered = _mm_add_ps(_mm_mul_ps(a, cur), _mm_mul_ps(b, prev));
+
+            __m128i cred = credible(hist, low, high);
+            cred = _mm_unpacklo_epi8(cred, cred);
+            cred = _mm_unpacklo_epi16(cred, cred);
+            __m128 persist = _mm_andnot_ps(no_prev, _mm_and_ps(no_cur, _mm_castsi128_ps(cred)));
+
+            __m128 result = _mm_or_ps(_mm_and_ps(smooth, filtered),
+                                      _mm_andnot_ps(smooth, _mm_or_ps(_mm_and_ps(persist, prev), _mm_andnot_ps(persist, cur))));
+            __m128 kept = _mm_or_ps(_mm_and_ps(smooth, filtered), _mm_andnot_ps(smooth, cur));
+            __m128 last = _mm_or_ps(_mm_and_ps(no_cur, prev), _mm_andnot_ps(no_cur, kept));
+
+            __m128i no_cur8 = _mm_castps_si128(no_cur);
+            no_cur8 = _mm_packs_epi16(_mm_packs_epi32(no_cur8, no_cur8), _mm_setzero_si128());
+            __m128i smooth8 = _mm_castps_si128(smooth);
+            smooth8 = _mm_packs_epi16(_mm_packs_epi32(smooth8, smooth8), _mm_setzero_si128());
+            hist = select(no_cur8, _mm_andnot_si128(m, hist), select(smooth8, _mm_or_si128(hist, m), m));
+
+            _mm_storeu_ps(frame + i, result);
+            _mm_storeu_ps(last_frame + i, last);
+            packed_hist = _mm_cvtsi128_si32(hist);
+            memcpy(history + i, &packed_hist, sizeof(packed_hist));
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        credible_lut lut(_persistence_map, mask);
+        const uint8x16_t low = vld1q_u8(lut.low);
+        const uint8x16_t high = vld1q_u8(lut.high);
+        const float32x4_t a = vdupq_n_f32(_alpha_param);
+        const float32x4_t b = vdupq_n_f32(_one_minus_alpha);
+        const float32x4_t zero = vdupq_n_f32(0.f);
+        const float32x4_t dz = vdupq_n_f32(static_cast<float>(_delta_param));
+        const uint8x8_t m = vdup_n_u8(mask);
+
+        for (; i + 4 <= end; i += 4)
+        {
+            float32x4_t cur = vld1q_f32(frame + i);
+            float32x4_t prev = vld1q_f32(last_frame + i);
+            uint32_t packed_hist;
+            memcpy(&packed_hist, history + i, sizeof(packed_hist));
+            uint8x8_t hist = vreinterpret_u8_u32(vdup_n_u32(packed_hist));
+
+            uint32x4_t no_cur = vceqq_f32(cur, zero);
+            uint32x4_t no_prev = vceqq_f32(prev, zero);
+            uint32x4_t smooth = vbicq_u32(vcltq_f32(vabdq_f32(cur, prev), dz), vorrq_u32(no_cur, no_prev));
+            float32x4_t filtered = vaddq_f32(vmulq_f32(a, cur), vmulq_f32(b, prev));
+
+            int16x8_t cred16 = vmovl_s8(vreinterpret_s8_u8(credible(hist, low, high)));
+            uint32x4_t cred = vreinterpretq_u32_s32(vmovl_s16(vget_low_s16(cred16)));
+            uint32x4_t persist = vbicq_u32(vandq_u32(no_cur, cred), no_prev);
+
+            vst1q_f32(frame + i, vbslq_f32(smooth, filtered, vbslq_f32(persist, prev, cur)));
+            vst1q_f32(last_frame + i, vbslq_f32(no_cur, prev, vbslq_f32(smooth, filtered, cur)));
+
+            uint16x4_t no_cur16 = vmovn_u32(no_cur);
+            uint16x4_t smooth16 = vmovn_u32(smooth);
+            uint8x8_t no_cur8 = vmovn_u16(vcombine_u16(no_cur16, no_cur16));
+            uint8x8_t smooth8 = vmovn_u16(vcombine_u16(smooth16, smooth16));
+            hist = vbsl_u8(no_cur8, vbic_u8(hist, m), vbsl_u8(smooth8, vorr_u8(hist, m), m));
+            packed_hist = vget_lane_u32(vreinterpret_u32_u8(hist), 0);
+            memcpy(history + i, &packed_hist, sizeof(packed_hist));
+        }
+#endif
+        return i;
+    }
+
     void temporal_filter::recalc_persistence_map()
     {
         _persistence_map.fill(0);
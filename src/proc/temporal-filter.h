@@ -3,6 +3,7 @@
 
 #pragma once
 #include "types.h"
+#include "thread-pool.h"
 
 namespace librealsense
 {
@@ -24,17 +25,40 @@ namespace librealsense
         {
             static_assert((std::is_arithmetic<T>::value), "temporal filter assumes numeric types");
 
-            const bool fp = (std::is_floating_point<T>::value);
-
-            T delta_z = static_cast<T>(_delta_param);
-
             auto frame          = reinterpret_cast<T*>(frame_data);
             auto _last_frame    = reinterpret_cast<T*>(_last_frame_data);
 
             unsigned char mask = 1 << _cur_frame_index;
 
-            // pass one -- go through image and update all
-            for (size_t i = 0; i < _current_frm_size_pixels; i++)
+            // Pixels are independent of each other: the frame is split into strips that run in
+            // parallel on the thread pool, each vectorized as far as possible
+            const size_t strip_size = 0x4000;
+            const int strips = int((_current_frm_size_pixels + strip_size - 1) / strip_size);
+
+            parallel_for(strips, [&](int s)
+            {
+                size_t begin = s * strip_size;
+                temp_jw_smooth_strip(frame, _last_frame, history, begin, std::min(_current_frm_size_pixels, begin + strip_size), mask);
+            });
+
+            _cur_frame_index = (_cur_frame_index + 1) % 8;  // at end of cycle
+        }
+
+        // Pixels [begin, end) of the frame; the caller advances _cur_frame_index once all the frame is done
+        template<typename T>
+        void temp_jw_smooth_strip(T* frame, T* _last_frame, uint8_t *history, size_t begin, size_t end, unsigned char mask)
+        {
+            begin = temp_jw_smooth_simd(frame, _last_frame, history, begin, end, mask);
+            temp_jw_smooth_pixels(frame, _last_frame, history, begin, end, mask);
+        }
+
+        // One pixel at a time, for pixels [begin, end)
+        template<typename T>
+        void temp_jw_smooth_pixels(T* frame, T* _last_frame, uint8_t *history, size_t begin, size_t end, unsigned char mask)
+        {
+            T delta_z = static_cast<T>(_delta_param);
+
+            for (size_t i = begin; i < end; i++)
             {
                 T cur_val = frame[i];
                 T prev_val = _last_frame[i];
@@ -79,16 +103,22 @@ namespace librealsense
                     history[i] &= ~mask;
                 }
             }
-
-            _cur_frame_index = (_cur_frame_index + 1) % 8;  // at end of cycle
         }
 
+        // Same as temp_jw_smooth_pixels, several pixels at a time with SIMD; returns the index of
+        // the first pixel left for temp_jw_smooth_pixels
+        size_t temp_jw_smooth_simd(uint16_t* frame, uint16_t* last_frame, uint8_t *history, size_t begin, size_t end, unsigned char mask) const;
+        size_t temp_jw_smooth_simd(float* frame, float* last_frame, uint8_t *history, size_t begin, size_t end, unsigned char mask) const;
+
     private:
         void on_set_persistence_control(uint8_t val);
         void on_set_alpha(float val);
         void on_set_delta(float val);
 
         void recalc_persistence_map();
+
+        friend class depth_post_processing;
+
         uint8_t                 _persistence_param;
 
         float                   _alpha_param;               // The normalized weight of the current pixel
@@ -3,12 +3,65 @@
 
 #include "y12i-to-y16y16.h"
 #include "stream.h"
+#include "cpu-features.h"
 #ifdef RS2_USE_CUDA
 #include "cuda/cuda-conversion.cuh"
 #endif
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
 
 namespace librealsense
 {
+#ifdef __SSSE3__
+    static int unpack_y16_y16_from_y12i_10_ssse3(byte * const d[], const byte * s, int count)
+    {
+        // 4 pixels of 3 bytes, to the 16 bits that hold the left pixels (>> 4 to align them) and
+        // then the 16 bits that hold the right ones (& 0xfff)
+        const __m128i split = _mm_setr_epi8(1, 2, 4, 5, 7, 8, 10, 11, 0, 1, 3, 4, 6, 7, 9, 10);
+        const __m128i right_mask = _mm_set1_epi16(0xfff);
+        auto left = reinterpret_cast<uint16_t *>(d[0]);
+        auto right = reinterpret_cast<uint16_t *>(d[1]);
+        int i = 0;
+        // The second load reads 4 bytes past the 8 pixels
+        for (; (i + 8) * 3 + 4 <= count * 3; i += 8)
+        {
+            __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i * 3)), split);
+            __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i * 3 + 12)), split);
+            __m128i l = _mm_srli_epi16(_mm_unpacklo_epi64(a, b), 4);
+            __m128i r = _mm_and_si128(_mm_unpackhi_epi64(a, b), right_mask);
+
+            // 10-bit data to 16-bit data, as the scalar code does
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(left + i), _mm_or_si128(_mm_slli_epi16(l, 6), _mm_srli_epi16(l, 4)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(right + i), _mm_or_si128(_mm_slli_epi16(r, 6), _mm_srli_epi16(r, 4)));
+        }
+        return i;
+    }
+#endif
+
+#ifdef __ARM_NEON
+    static int unpack_y16_y16_from_y12i_10_neon(byte * const d[], const byte * s, int count)
+    {
+        auto left = reinterpret_cast<uint16_t *>(d[0]);
+        auto right = reinterpret_cast<uint16_t *>(d[1]);
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint8x8x3_t p = vld3_u8(s + i * 3);
+            uint16x8_t l = vorrq_u16(vshll_n_u8(p.val[2], 4), vmovl_u8(vshr_n_u8(p.val[1], 4)));
+            uint16x8_t r = vorrq_u16(vshll_n_u8(vand_u8(p.val[1], vdup_n_u8(0xf)), 8), vmovl_u8(p.val[0]));
+
+            // 10-bit data to 16-bit data, as the scalar code does
+            vst1q_u16(left + i, vorrq_u16(vshlq_n_u16(l, 6), vshrq_n_u16(l, 4)));
+            vst1q_u16(right + i, vorrq_u16(vshlq_n_u16(r, 6), vshrq_n_u16(r, 4)));
+        }
+        return i;
+    }
+#endif
+
     struct y12i_pixel { uint8_t rl : 8, rh : 4, ll : 4, lh : 8; int l() const { return lh << 4 | ll; } int r() const { return rh << 8 | rl; } };
     void unpack_y16_y16_from_y12i_10(byte * const dest[], const byte * source, int width, int height, int actual_size)
     {
@@ -16,7 +69,22 @@ namespace librealsense
 #ifdef RS2_USE_CUDA
         rscuda::split_frame_y16_y16_from_y12i_cuda(dest, count, reinterpret_cast<const y12i_pixel *>(source));
 #else
-        split_frame(dest, count, reinterpret_cast<const y12i_pixel*>(source),
+        int done = 0;
+        switch (cpu_simd_level())
+        {
+#ifdef __SSSE3__
+        // The 3 byte pixels make for more shuffling than AVX2 wins back
+        case simd_level::avx2:
+        case simd_level::ssse3: done = unpack_y16_y16_from_y12i_10_ssse3(dest, source, count); break;
+#endif
+#ifdef __ARM_NEON
+        case simd_level::neon: done = unpack_y16_y16_from_y12i_10_neon(dest, source, count); break;
+#endif
+        default: break;
+        }
+
+        byte * const rest[] = { dest[0] + done * 2, dest[1] + done * 2 };
+        split_frame(rest, count - done, reinterpret_cast<const y12i_pixel*>(source) + done,
             [](const y12i_pixel & p) -> uint16_t { return p.l() << 6 | p.l() >> 4; },  // We want to convert 10-bit data to 16-bit data
             [](const y12i_pixel & p) -> uint16_t { return p.r() << 6 | p.r() >> 4; }); // Multiply by 64 1/16 to efficiently approximate 65535/1023
 #endif
@@ -4,13 +4,52 @@
 #include "y8i-to-y8y8.h"
 
 #include "stream.h"
+#include "image-avx.h"
+#include "cpu-features.h"
 
 #ifdef RS2_USE_CUDA
 #include "cuda/cuda-conversion.cuh"
 #endif
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
 
 namespace librealsense
 {
+#ifdef __SSSE3__
+    static int unpack_y8_y8_from_y8i_ssse3(byte * const d[], const byte * s, int count)
+    {
+        const __m128i split = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+        int i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            // 8 left pixels and then 8 right ones
+            __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i * 2)), split);
+            __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i * 2 + 16)), split);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(d[0] + i), _mm_unpacklo_epi64(a, b));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(d[1] + i), _mm_unpackhi_epi64(a, b));
+        }
+        return i;
+    }
+#endif
+
+#ifdef __ARM_NEON
+    static int unpack_y8_y8_from_y8i_neon(byte * const d[], const byte * s, int count)
+    {
+        int i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x2_t lr = vld2q_u8(s + i * 2);
+            vst1q_u8(d[0] + i, lr.val[0]);
+            vst1q_u8(d[1] + i, lr.val[1]);
+        }
+        return i;
+    }
+#endif
+
     struct y8i_pixel { uint8_t l, r; };
     void unpack_y8_y8_from_y8i(byte * const dest[], const byte * source, int width, int height, int actual_size)
     {
@@ -18,7 +57,23 @@ namespace librealsense
 #ifdef RS2_USE_CUDA
         rscuda::split_frame_y8_y8_from_y8i_cuda(dest, count, reinterpret_cast<const y8i_pixel *>(source));
 #else
-        split_frame(dest, count, reinterpret_cast<const y8i_pixel*>(source),
+        int done = 0;
+        switch (cpu_simd_level())
+        {
+#if defined __SSSE3__ && ! defined ANDROID
+        case simd_level::avx2: done = unpack_y8_y8_from_y8i_avx(dest, source, count); break;
+#endif
+#ifdef __SSSE3__
+        case simd_level::ssse3: done = unpack_y8_y8_from_y8i_ssse3(dest, source, count); break;
+#endif
+#ifdef __ARM_NEON
+        case simd_level::neon: done = unpack_y8_y8_from_y8i_neon(dest, source, count); break;
+#endif
+        default: break;
+        }
+
+        byte * const rest[] = { dest[0] + done, dest[1] + done };
+        split_frame(rest, count - done, reinterpret_cast<const y8i_pixel*>(source) + done,
             [](const y8i_pixel & p) -> uint8_t { return p.l; },
             [](const y8i_pixel & p) -> uint8_t { return p.r; });
 #endif
@@ -25,10 +25,12 @@
 #include "proc/units-transform.h"
 #include "proc/disparity-transform.h"
 #include "proc/syncer-processing-block.h"
+#include "proc/cross-device-syncer.h"
 #include "proc/decimation-filter.h"
 #include "proc/spatial-filter.h"
 #include "proc/zero-order.h"
 #include "proc/hole-filling-filter.h"
+#include "proc/depth-post-processing.h"
 #include "proc/color-formats-converter.h"
 #include "proc/rates-printer.h"
 #include "proc/hdr-merge.h"
@@ -107,8 +109,8 @@ struct rs2_pipeline_profile
 
 struct rs2_frame_queue
 {
-    explicit rs2_frame_queue(int cap)
-        : queue(cap)
+    explicit rs2_frame_queue(int cap, queue_type type = queue_type::locked, unsigned int spin_count = 0)
+        : queue(cap, type, spin_count)
     {
     }
 
@@ -851,6 +853,32 @@ rs2_metadata_type rs2_get_frame_metadata(const rs2_frame* frame, rs2_frame_metad
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame, frame_metadata)
 
+int rs2_get_all_frame_metadata(const rs2_frame* frame, rs2_metadata_type* values, unsigned char* supported, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(values);
+    VALIDATE_NOT_NULL(supported);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    frame_metadata_values metadata;
+    ((frame_interface*)frame)->get_all_frame_metadata(metadata);
+
+    // Applications built against a newer version may ask for more values than we know of
+    int supported_count = 0;
+    std::fill(supported, supported + (count + 7) / 8, 0);
+    for (int i = 0; i < count; ++i)
+    {
+        bool is_supported = i < ::RS2_FRAME_METADATA_COUNT && metadata.supported[i];
+        values[i] = is_supported ? metadata.values[i] : 0;
+        if (is_supported)
+        {
+            supported[i / 8] |= 1 << (i % 8);
+            ++supported_count;
+        }
+    }
+    return supported_count;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, frame, values, supported, count)
+
 const char* rs2_get_notification_description(rs2_notification* notification, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(notification);
@@ -1033,6 +1061,14 @@ rs2_frame_queue* rs2_create_frame_queue(int capacity, rs2_error** error) BEGIN_A
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, capacity)
 
+rs2_frame_queue* rs2_create_lock_free_frame_queue(int capacity, int spin_count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_RANGE(capacity, 1, std::numeric_limits<int>::max());
+    VALIDATE_RANGE(spin_count, 0, std::numeric_limits<int>::max());
+    return new rs2_frame_queue(capacity, queue_type::lock_free, spin_count);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, capacity, spin_count)
+
 void rs2_delete_frame_queue(rs2_frame_queue* queue) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(queue);
@@ -1553,6 +1589,21 @@ void rs2_context_unload_tracking_module(rs2_context* ctx, rs2_error** error) BEG
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, ctx)
 
+void rs2_context_set_processing_threads(rs2_context* ctx, int threads, int pinned, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_RANGE(threads, 0, 1024);
+    environment::get_instance().set_processing_threads(threads, pinned != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, ctx, threads, pinned)
+
+int rs2_context_get_processing_threads(const rs2_context* ctx, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    return environment::get_instance().get_thread_pool()->get_threads();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, ctx)
+
 const char* rs2_playback_device_get_file_path(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -2067,6 +2118,15 @@ rs2_processing_block* rs2_create_sync_processing_block(rs2_error** error) BEGIN_
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+rs2_processing_block* rs2_create_cross_device_sync_processing_block(float tolerance_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_RANGE(tolerance_ms, 0.f, std::numeric_limits<float>::max());
+    auto block = std::make_shared<librealsense::cross_device_syncer>(tolerance_ms);
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, tolerance_ms)
+
 void rs2_start_processing(rs2_processing_block* block, rs2_frame_callback* on_frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(block);
@@ -2228,6 +2288,15 @@ rs2_processing_block* rs2_create_colorizer(rs2_error** error) BEGIN_API_CALL
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+rs2_processing_block* rs2_create_colorizer_with_format(rs2_format format, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_ENUM(format);
+    auto block = std::make_shared<librealsense::colorizer>(format);
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, format)
+
 
 rs2_processing_block* rs2_create_decimation_filter_block(rs2_error** error) BEGIN_API_CALL
 {
@@ -2269,6 +2338,26 @@ rs2_processing_block* rs2_create_hole_filling_filter_block(rs2_error** error) BE
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+rs2_processing_block* rs2_create_depth_post_processing_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_post_processing>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_get_depth_post_processing_stage(rs2_processing_block* block, rs2_extension stage, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_ENUM(stage);
+    auto post_processing = std::dynamic_pointer_cast<librealsense::depth_post_processing>(block->block);
+    if (!post_processing)
+        throw std::runtime_error("Object does not support \"librealsense::depth_post_processing\" interface! ");
+
+    return new rs2_processing_block{ post_processing->get_stage(stage) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, block, stage)
+
 rs2_processing_block* rs2_create_rates_printer_block(rs2_error** error) BEGIN_API_CALL
 {
     auto block = std::make_shared<librealsense::rates_printer>();
@@ -2419,6 +2508,28 @@ void rs2_extract_target_dimensions(const rs2_frame* frame_ref, rs2_calib_target_
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, frame_ref, calib_type, target_dims, target_dims_size)
 
+void rs2_set_frame_allocator(rs2_frame_allocate_ptr on_allocate, rs2_frame_deallocate_ptr on_deallocate, void* user, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(on_allocate);
+    VALIDATE_NOT_NULL(on_deallocate);
+    librealsense::frame_allocator_ptr allocator(new librealsense::frame_allocator(on_allocate, on_deallocate, user), [](rs2_frame_allocator* p) { p->release(); });
+    environment::get_instance().set_frame_allocator(allocator);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, on_allocate, on_deallocate, user)
+
+void rs2_set_frame_allocator_cpp(rs2_frame_allocator* allocator, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(allocator);
+    environment::get_instance().set_frame_allocator({ allocator, [](rs2_frame_allocator* p) { p->release(); } });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, allocator)
+
+void rs2_reset_frame_allocator(rs2_error** error) BEGIN_API_CALL
+{
+    environment::get_instance().set_frame_allocator(nullptr);
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN_VOID()
+
 rs2_time_t rs2_get_time(rs2_error** error) BEGIN_API_CALL
 {
     return environment::get_instance().get_time_service()->get_time();
@@ -40,6 +40,9 @@ namespace librealsense
     })
     {
         register_option(RS2_OPTION_FRAMES_QUEUE_SIZE, _source.get_published_size_option());
+        for (auto counter : { RS2_OPTION_FRAMES_POOL_HITS, RS2_OPTION_FRAMES_POOL_MISSES, RS2_OPTION_FRAMES_POOL_EVICTIONS })
+            register_option(counter, _source.get_buffers_statistics_option(counter));
+        register_option(RS2_OPTION_FRAMES_POOL_RETENTION, _source.get_buffers_retention_option());
 
         register_metadata(RS2_FRAME_METADATA_TIME_OF_ARRIVAL, std::make_shared<librealsense::md_time_of_arrival_parser>());
 
@@ -245,9 +248,9 @@ namespace librealsense
     {
         auto system_time = environment::get_instance().get_time_service()->get_time();
         auto fr = std::make_shared<frame>();
-        byte* pix = (byte*)fo.pixels;
-        std::vector<byte> pixels(pix, pix + fo.frame_size);
-        fr->data = pixels;
+        // The intermediate frame only lives for the duration of the backend callback,
+        // so it borrows the backend buffer instead of copying it
+        fr->attach_continuation(frame_continuation([]() {}, fo.pixels));
         fr->set_stream(profile);
 
         // generate additional data
@@ -276,6 +279,35 @@ namespace librealsense
     /////////////////// UVC Sensor ///////////////////////
     //////////////////////////////////////////////////////
 
+    bool zero_copy_frames::hold(std::function<void()>& continuation)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_held >= _max_held)
+                return false;
+            ++_held;
+        }
+        auto self = shared_from_this();
+        auto release_buffer = std::move(continuation);
+        continuation = [self, release_buffer]()
+        {
+            release_buffer();
+            {
+                std::lock_guard<std::mutex> lock(self->_mutex);
+                --self->_held;
+            }
+            self->_released.notify_all();
+        };
+        return true;
+    }
+
+    int zero_copy_frames::wait_released(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _released.wait_for(lock, timeout, [this]() { return _held == 0; });
+        return _held;
+    }
+
     uvc_sensor::~uvc_sensor()
     {
         try
@@ -302,6 +334,7 @@ namespace librealsense
 
         auto on = std::unique_ptr<power>(new power(std::dynamic_pointer_cast<uvc_sensor>(shared_from_this())));
 
+        _zero_copy_frames.clear();
         _source.init(_metadata_parsers);
         _source.set_sensor(_source_owner->shared_from_this());
 
@@ -312,14 +345,24 @@ namespace librealsense
             auto&& req_profile_base = std::dynamic_pointer_cast<stream_profile_base>(req_profile);
             try
             {
+                // Zero-copy frames do not use the archive buffers
+                if (!is_zero_copy_enabled())
+                {
+                    if (auto vsp = As<video_stream_profile, stream_profile_interface>(req_profile))
+                        _source.prewarm(stream_to_frame_types(req_profile_base->get_stream_type()),
+                            vsp->get_width() * vsp->get_height() * get_image_bpp(req_profile_base->get_format()) / 8,
+                            DEFAULT_V4L2_FRAME_BUFFERS);
+                }
+
                 unsigned long long last_frame_number = 0;
                 rs2_time_t last_timestamp = 0;
+                auto zero_copy = std::make_shared<zero_copy_frames>(max_zero_copy_inflight);
+                _zero_copy_frames.push_back(zero_copy);
                 _device->probe_and_commit(req_profile_base->get_backend_profile(),
-                    [this, req_profile_base, req_profile, last_frame_number, last_timestamp](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation) mutable
+                    [this, req_profile_base, req_profile, last_frame_number, last_timestamp, zero_copy](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation) mutable
                 {
                     const auto&& system_time = environment::get_instance().get_time_service()->get_time();
                     const auto&& fr = generate_frame_from_data(f, _timestamp_reader.get(), last_timestamp, last_frame_number, req_profile_base);
-                    const auto&& requires_processing = true; // TODO - Ariel add option
                     const auto&& timestamp_domain = _timestamp_reader->get_frame_timestamp_domain(fr);
                     const auto&& bpp = get_image_bpp(req_profile_base->get_format());
                     auto&& frame_counter = fr->additional_data.frame_number;
@@ -334,6 +377,9 @@ namespace librealsense
                         return;
                     }
 
+                    // Zero-copy frames hold on to the backend buffer until released, so fall back to copying
+                    // once enough buffers are held downstream that the driver would be left without one to fill
+                    const bool requires_processing = !(is_zero_copy_enabled() && zero_copy->hold(continuation));
                     frame_continuation release_and_enqueue(continuation, f.pixels);
 
                     LOG_DEBUG("FrameAccepted," << librealsense::get_string(req_profile_base->get_stream_type())
@@ -359,7 +405,8 @@ namespace librealsense
 
                     if (fh.frame)
                     {
-                        memcpy((void*)fh->get_frame_data(), fr->data.data(), sizeof(byte)*fr->data.size());
+                        if (requires_processing)
+                            memcpy((void*)fh->get_frame_data(), fr->get_frame_data(), sizeof(byte)*fr->get_frame_data_size());
                         auto&& video = (video_frame*)fh.frame;
                         video->assign(width, height, width * bpp / 8, bpp);
                         video->set_timestamp_domain(timestamp_domain);
@@ -445,6 +492,14 @@ namespace librealsense
         else if (!_is_opened)
             throw wrong_api_call_sequence_exception("close() failed. UVC device was not opened!");
 
+        // Closing the device releases its buffers, which zero-copy frames may still be holding
+        for (auto&& frames : _zero_copy_frames)
+        {
+            if (auto held = frames->wait_released(std::chrono::milliseconds(zero_copy_release_timeout_ms)))
+                LOG_WARNING("close(): " << held << " zero-copy frames are still held, so the device buffers they hold cannot be released yet");
+        }
+        _zero_copy_frames.clear();
+
         for (auto&& profile : _internal_config)
         {
             try // Handle disconnect event
@@ -696,6 +751,7 @@ namespace librealsense
     stream_profiles hid_sensor::get_sensor_profiles(std::string sensor_name) const
     {
         stream_profiles profiles{};
+        stream_profiles batch_profiles{};
         for (auto&& elem : _sensor_name_and_hid_profiles)
         {
             if (!elem.first.compare(sensor_name))
@@ -708,8 +764,20 @@ namespace librealsense
                 profile->set_format(p.format);
                 profile->set_framerate(p.fps);
                 profiles.push_back(profile);
+
+                // Each IMU profile also comes in a batched flavor, where the samples of a read make one frame
+                if (p.stream == RS2_STREAM_ACCEL || p.stream == RS2_STREAM_GYRO)
+                {
+                    auto batch_profile = std::make_shared<motion_stream_profile>(sp);
+                    batch_profile->set_stream_index(p.index);
+                    batch_profile->set_stream_type(p.stream);
+                    batch_profile->set_format(RS2_FORMAT_MOTION_BATCH);
+                    batch_profile->set_framerate(p.fps);
+                    batch_profiles.push_back(batch_profile);
+                }
             }
         }
+        profiles.insert(profiles.end(), batch_profiles.begin(), batch_profiles.end());
 
         return profiles;
     }
@@ -786,6 +854,11 @@ namespace librealsense
         _source.init(_metadata_parsers);
         _source.set_sensor(_source_owner->shared_from_this());
 
+        // Created ahead, as the sensors call back from threads of their own
+        for (auto&& profile : _configured_profiles)
+            if (profile.second->get_format() == RS2_FORMAT_MOTION_BATCH)
+                _batches[profile.first].clear();
+
         unsigned long long last_frame_number = 0;
         rs2_time_t last_timestamp = 0;
         raise_on_before_streaming_changes(true); //Required to be just before actual start allow recording to work
@@ -842,13 +915,39 @@ namespace librealsense
 
             last_frame_number = frame_counter;
             last_timestamp = timestamp;
-            frame_holder frame = _source.alloc_frame(RS2_EXTENSION_MOTION_FRAME, data_size, fr->additional_data, true);
-            memcpy((void*)frame->get_frame_data(), fr->data.data(), sizeof(byte)*fr->data.size());
+
+            // The samples of a batch are held until the last one read along with them, whose
+            // additional data the frame gets
+            std::vector<hid_batch_sample>* batch = nullptr;
+            if (request->get_format() == RS2_FORMAT_MOTION_BATCH)
+            {
+                batch = &_batches.at(sensor_name);
+                hid_batch_sample sample{};
+                sample.timestamp = timestamp;
+                memcpy(&sample.data, sensor_data.fo.pixels, std::min(sizeof(sample.data), sensor_data.fo.frame_size));
+                batch->push_back(sample);
+                if (sensor_data.batch_continues)
+                    return;
+            }
+
+            frame_holder frame = _source.alloc_frame(RS2_EXTENSION_MOTION_FRAME,
+                batch ? batch->size() * sizeof(hid_batch_sample) : data_size, fr->additional_data, true);
             if (!frame)
             {
                 LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+                if (batch)
+                    batch->clear();
                 return;
             }
+            if (batch)
+            {
+                memcpy((void*)frame->get_frame_data(), batch->data(), batch->size() * sizeof(hid_batch_sample));
+                batch->clear();
+            }
+            else
+            {
+                memcpy((void*)frame->get_frame_data(), fr->get_frame_data(), sizeof(byte)*fr->get_frame_data_size());
+            }
             frame->set_stream(request);
             frame->set_timestamp_domain(timestamp_domain);
             _source.invoke_callback(std::move(frame));
@@ -865,6 +964,7 @@ namespace librealsense
 
         _hid_device->stop_capture();
         _is_streaming = false;
+        _batches.clear();
         _source.flush();
         _source.reset();
         _hid_iio_timestamp_reader->reset();
@@ -1039,6 +1139,10 @@ namespace librealsense
         auto& raw_fourcc_to_rs2_stream_map = _raw_sensor->get_fourcc_to_rs2_stream_map();
         _fourcc_to_rs2_stream = std::make_shared<std::map<uint32_t, rs2_stream>>(fourcc_to_rs2_stream_map);
         raw_fourcc_to_rs2_stream_map = _fourcc_to_rs2_stream;
+
+        // Frame buffers are allocated by the raw sensor
+        for (auto opt : { RS2_OPTION_FRAMES_POOL_HITS, RS2_OPTION_FRAMES_POOL_MISSES, RS2_OPTION_FRAMES_POOL_EVICTIONS, RS2_OPTION_FRAMES_POOL_RETENTION })
+            sensor_base::register_option(opt, _raw_sensor->get_option_handler(opt));
     }
 
     synthetic_sensor::~synthetic_sensor()
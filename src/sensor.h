@@ -13,6 +13,8 @@
 #include <limits.h>
 #include <atomic>
 #include <functional>
+#include <mutex>
+#include <condition_variable>
 #include "core/debug.h"
 
 #include "archive.h"
@@ -314,6 +316,7 @@ namespace librealsense
         std::vector<platform::hid_sensor> _hid_sensors;
         std::unique_ptr<frame_timestamp_reader> _hid_iio_timestamp_reader;
         std::unique_ptr<frame_timestamp_reader> _custom_hid_timestamp_reader;
+        std::map<std::string, std::vector<hid_batch_sample>> _batches; // Of the sensors streaming RS2_FORMAT_MOTION_BATCH
 
         stream_profiles get_sensor_profiles(std::string sensor_name) const;
 
@@ -324,6 +327,27 @@ namespace librealsense
         uint32_t fps_to_sampling_frequency(rs2_stream stream, uint32_t fps) const;
     };
 
+    // The zero-copy frames of a stream that are held downstream. Each holds a backend buffer, which
+    // the driver gets back only once the frame is released; frames can outlive the sensor, so their
+    // continuations share this with it.
+    class zero_copy_frames : public std::enable_shared_from_this<zero_copy_frames>
+    {
+    public:
+        explicit zero_copy_frames(int max_held) : _max_held(max_held), _held(0) {}
+
+        // Makes the continuation release the frame's hold, unless max_held frames are held already
+        bool hold(std::function<void()>& continuation);
+
+        // Waits until no frame is held, for up to the timeout; returns the frames still held
+        int wait_released(std::chrono::milliseconds timeout);
+
+    private:
+        const int _max_held;
+        int _held;
+        std::mutex _mutex;
+        std::condition_variable _released;
+    };
+
     class uvc_sensor : public sensor_base
     {
     public:
@@ -360,6 +384,21 @@ namespace librealsense
         void release_power();
         void reset_streaming();
 
+        // Zero-copy delivery is opted into with ENABLE_ZERO_COPY: the published frame wraps the backend
+        // buffer, and the buffer is handed back to the driver when the last reference is released
+        static constexpr bool is_zero_copy_enabled()
+        {
+#ifdef ZERO_COPY
+            return true;
+#else
+            return false;
+#endif
+        }
+        // Keep at least one buffer queued to the driver per stream
+        static const int max_zero_copy_inflight = DEFAULT_V4L2_FRAME_BUFFERS - 1;
+        // How long close() waits for the zero-copy frames to be released
+        static const int zero_copy_release_timeout_ms = 1000;
+
         struct power
         {
             explicit power(std::weak_ptr<uvc_sensor> owner)
@@ -394,6 +433,7 @@ namespace librealsense
         std::vector<platform::extension_unit> _xus;
         std::unique_ptr<power> _power;
         std::unique_ptr<frame_timestamp_reader> _timestamp_reader;
+        std::vector<std::shared_ptr<zero_copy_frames>> _zero_copy_frames;  // Of each opened stream
     };
 
     processing_blocks get_color_recommended_proccesing_blocks();
@@ -36,11 +36,86 @@ namespace librealsense
         std::atomic<uint32_t>* _ptr;
     };
 
+    class frame_pool_counter : public readonly_option
+    {
+    public:
+        frame_pool_counter(const frame_source* source, rs2_option counter)
+            : _source(source), _counter(counter)
+        {}
+
+        float query() const override
+        {
+            auto stats = _source->get_buffers_statistics();
+            switch (_counter)
+            {
+            case RS2_OPTION_FRAMES_POOL_HITS: return static_cast<float>(stats.hits);
+            case RS2_OPTION_FRAMES_POOL_MISSES: return static_cast<float>(stats.misses);
+            default: return static_cast<float>(stats.evictions);
+            }
+        }
+
+        option_range get_range() const override { return { 0, std::numeric_limits<float>::max(), 1, 0 }; }
+
+        bool is_enabled() const override { return true; }
+
+        const char* get_description() const override
+        {
+            switch (_counter)
+            {
+            case RS2_OPTION_FRAMES_POOL_HITS: return "Debug: number of frames whose buffer was reused from the frame buffers pool";
+            case RS2_OPTION_FRAMES_POOL_MISSES: return "Debug: number of frames that required a new buffer allocation";
+            default: return "Debug: number of buffers dropped from the frame buffers pool, either expired or overflowing";
+            }
+        }
+    private:
+        const frame_source* _source;
+        rs2_option _counter;
+    };
+
+    class frame_pool_retention : public option_base
+    {
+    public:
+        frame_pool_retention(frame_source* source, const option_range& opt_range)
+            : option_base(opt_range),
+              _source(source)
+        {}
+
+        void set(float value) override
+        {
+            if (!is_valid(value))
+                throw invalid_value_exception(to_string() << "set(frame_pool_retention) failed! Given value " << value << " is out of range.");
+
+            _source->set_buffers_retention(value);
+            _recording_function(*this);
+        }
+
+        float query() const override { return static_cast<float>(_source->get_buffers_retention()); }
+
+        bool is_enabled() const override { return true; }
+
+        const char* get_description() const override
+        {
+            return "Time in milliseconds an unused frame buffer is kept in the frame buffers pool for reuse. Longer keeps more memory, shorter allocates more often";
+        }
+    private:
+        frame_source* _source;
+    };
+
     std::shared_ptr<option> frame_source::get_published_size_option()
     {
         return std::make_shared<frame_queue_size>(&_max_publish_list_size, option_range{ 0, 32, 1, 16 });
     }
 
+    std::shared_ptr<option> frame_source::get_buffers_statistics_option(rs2_option counter)
+    {
+        return std::make_shared<frame_pool_counter>(this, counter);
+    }
+
+    std::shared_ptr<option> frame_source::get_buffers_retention_option()
+    {
+        return std::make_shared<frame_pool_retention>(this, option_range{ 0, 60000, 1, 1000 });
+    }
+
     frame_source::frame_source(uint32_t max_publish_list_size)
             : _callback(nullptr, [](rs2_frame_callback*) {}),
               _max_publish_list_size(max_publish_list_size),
@@ -59,12 +134,19 @@ namespace librealsense
                                                RS2_EXTENSION_MOTION_FRAME,
                                                RS2_EXTENSION_POSE_FRAME };
 
+        // The parsers are all registered by the time the sensor starts streaming
+        std::shared_ptr<const metadata_parser_table> metadata_table;
+        if (metadata_parsers)
+            metadata_table = std::make_shared<metadata_parser_table>(*metadata_parsers);
+
         for (auto type : supported)
         {
-            _archive[type] = make_archive(type, &_max_publish_list_size, _ts, metadata_parsers);
+            _archive[type] = make_archive(type, &_max_publish_list_size, _ts, metadata_parsers, metadata_table);
+            _archive[type]->set_buffers_retention(_buffers_retention);
         }
 
         _metadata_parsers = metadata_parsers;
+        _metadata_table = metadata_table;
     }
 
     callback_invocation_holder frame_source::begin_callback()
@@ -91,6 +173,46 @@ namespace librealsense
         return it->second->alloc_and_track(size, additional_data, requires_memory);
     }
 
+    void frame_source::prewarm(rs2_extension type, size_t size, int count)
+    {
+        auto it = _archive.find(type);
+        if (it == _archive.end()) throw wrong_api_call_sequence_exception("Requested frame type is not supported!");
+        it->second->prewarm(size, count);
+    }
+
+    void frame_source::set_buffers_retention(rs2_time_t retention)
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        _buffers_retention = retention;
+        for (auto&& kvp : _archive)
+        {
+            if (kvp.second)
+                kvp.second->set_buffers_retention(retention);
+        }
+    }
+
+    rs2_time_t frame_source::get_buffers_retention() const
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        return _buffers_retention;
+    }
+
+    frame_buffer_pool::statistics frame_source::get_buffers_statistics() const
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        frame_buffer_pool::statistics res{ 0, 0, 0 };
+        for (auto&& kvp : _archive)
+        {
+            if (!kvp.second)
+                continue;
+            auto stats = kvp.second->get_buffers_statistics();
+            res.hits += stats.hits;
+            res.misses += stats.misses;
+            res.evictions += stats.evictions;
+        }
+        return res;
+    }
+
     void frame_source::set_sensor(const std::shared_ptr<sensor_interface>& s)
     {
         for (auto&& a : _archive)
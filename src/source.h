@@ -25,6 +25,8 @@ namespace librealsense
         void reset();
 
         std::shared_ptr<option> get_published_size_option();
+        std::shared_ptr<option> get_buffers_statistics_option(rs2_option counter);
+        std::shared_ptr<option> get_buffers_retention_option();
 
         frame_interface* alloc_frame(rs2_extension type, size_t size, frame_additional_data additional_data, bool requires_memory) const;
 
@@ -44,11 +46,18 @@ namespace librealsense
         template<class T>
         void add_extension(rs2_extension ex)
         {
-            _archive[ex] = std::make_shared<frame_archive<T>>(&_max_publish_list_size, _ts, _metadata_parsers);
+            _archive[ex] = std::make_shared<frame_archive<T>>(&_max_publish_list_size, _ts, _metadata_parsers, _metadata_table);
+            _archive[ex]->set_buffers_retention(_buffers_retention);
         }
 
         void set_max_publish_list_size(int qsize) {_max_publish_list_size = qsize; }
 
+        // Allocate frame buffers ahead of streaming, so that the first frames are served from the pool
+        void prewarm(rs2_extension type, size_t size, int count);
+        void set_buffers_retention(rs2_time_t retention);
+        rs2_time_t get_buffers_retention() const;
+        frame_buffer_pool::statistics get_buffers_statistics() const;
+
     private:
         friend class syncer_process_unit;
 
@@ -57,8 +66,10 @@ namespace librealsense
         std::map<rs2_extension, std::shared_ptr<archive_interface>> _archive;
 
         std::atomic<uint32_t> _max_publish_list_size;
+        rs2_time_t _buffers_retention = 1000.;
         frame_callback_ptr _callback;
         std::shared_ptr<platform::time_service> _ts;
         std::shared_ptr<metadata_parser_map> _metadata_parsers;
+        std::shared_ptr<const metadata_parser_table> _metadata_table;
     };
 }
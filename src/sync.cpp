@@ -541,10 +541,7 @@ namespace librealsense
 
     void timestamp_composite_matcher::update_last_arrived(frame_holder& f, matcher* m)
     {
-        if(f->supports_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS))
-            _fps[m] = (uint32_t)f->get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS);
-        else
-            _fps[m] = f->get_stream()->get_framerate();
+        _fps[m] = get_fps(f);
 
         auto const now = environment::get_instance().get_time_service()->get_time();
         //LOG_DEBUG( _name << ": _last_arrived[" << m->get_name() << "] = " << now );
@@ -567,6 +564,13 @@ namespace librealsense
             fps = f.frame->get_stream()->get_framerate();
             //LOG_DEBUG( "fps " << fps << " from stream framerate" );
         }
+        // Batches of motion samples arrive at the sample rate over the number of samples in each
+        if( f.frame->get_stream()->get_format() == RS2_FORMAT_MOTION_BATCH )
+        {
+            auto samples = f.frame->get_frame_data_size() / sizeof( rs2_motion_sample );
+            if( samples > 1 )
+                fps = std::max( 1u, unsigned( fps / samples ) );
+        }
         return fps;
     }
 
@@ -650,6 +654,261 @@ namespace librealsense
         return abs(a - b) < (gap / 2);
     }
 
+    void timestamp_indexed_matcher::slot::push( pending_frame && f, bool blocking )
+    {
+        if( ring.empty() )
+            ring.resize( QUEUE_MAX_SIZE );
+        if( count == ring.size() )
+        {
+            if( ! blocking )
+            {
+                pop();
+            }
+            else
+            {
+                std::vector< pending_frame > grown( ring.size() * 2 );
+                for( size_t i = 0; i < count; ++i )
+                    grown[i] = std::move( ring[( head + i ) % ring.size()] );
+                ring.swap( grown );
+                head = 0;
+            }
+        }
+        ring[( head + count ) % ring.size()] = std::move( f );
+        ++count;
+    }
+
+    frame_holder timestamp_indexed_matcher::slot::pop()
+    {
+        frame_holder f = std::move( ring[head].frame );
+        head = ( head + 1 ) % ring.size();
+        --count;
+        return f;
+    }
+
+    timestamp_indexed_matcher::timestamp_indexed_matcher(
+        std::vector< std::shared_ptr< matcher > > const & matchers )
+        : timestamp_composite_matcher( matchers )
+        , _stopped( false )
+    {
+        _slots.reserve( _matchers.size() );
+        _arrived.reserve( _matchers.size() );
+        _synced.reserve( _matchers.size() );
+        _missing.reserve( _matchers.size() );
+    }
+
+    size_t timestamp_indexed_matcher::get_slot( matcher * m )
+    {
+        auto it = std::lower_bound( _slots.begin(), _slots.end(), m,
+                                    []( slot const & s, matcher * m ) { return s.owner < m; } );
+        if( it != _slots.end() && it->owner == m )
+            return it - _slots.begin();
+
+        // A new matcher may have replaced others (see find_matcher); drop their slots
+        _slots.erase( std::remove_if( _slots.begin(), _slots.end(),
+                                      [this]( slot const & s ) {
+                                          for( auto & sm : _matchers )
+                                              if( sm.second.get() == s.owner )
+                                                  return false;
+                                          return true;
+                                      } ),
+                      _slots.end() );
+
+        it = std::lower_bound( _slots.begin(), _slots.end(), m,
+                               []( slot const & s, matcher * m ) { return s.owner < m; } );
+        slot s;
+        s.owner = m;
+        it = _slots.insert( it, std::move( s ) );
+        return it - _slots.begin();
+    }
+
+    void timestamp_indexed_matcher::erase_marked_slots()
+    {
+        _slots.erase( std::remove_if( _slots.begin(), _slots.end(),
+                                      []( slot const & s ) { return s.erase; } ),
+                      _slots.end() );
+    }
+
+    bool timestamp_indexed_matcher::are_equivalent( pending_frame & a, pending_frame & b )
+    {
+        auto min_fps = std::min( a.fps, b.fps );
+        if( a.domain == b.domain )
+            return timestamp_composite_matcher::are_equivalent( a.timestamp, b.timestamp, min_fps );
+
+        auto ts = extract_timestamps( a.frame, b.frame );
+        return timestamp_composite_matcher::are_equivalent( ts.first, ts.second, min_fps );
+    }
+
+    bool timestamp_indexed_matcher::is_smaller_than( pending_frame & a, pending_frame & b )
+    {
+        if( a.domain == b.domain )
+            return a.timestamp < b.timestamp;
+
+        auto ts = extract_timestamps( a.frame, b.frame );
+        return ts.first < ts.second;
+    }
+
+    bool timestamp_indexed_matcher::skip_missing_stream( slot & synced,
+                                                         slot & missing,
+                                                         const syncronization_environment & env )
+    {
+        // See timestamp_composite_matcher::skip_missing_stream
+        if( ! missing.owner->get_active() )
+            return true;
+
+        auto & synced_frame = synced.front();
+        if( missing.next_expected_domain != synced_frame.domain )
+            return false;
+
+        auto next_expected = missing.next_expected;
+        auto timestamp = synced_frame.timestamp;
+        if( timestamp > next_expected )
+        {
+            auto gap = 1000.f / (float)synced_frame.fps;
+            auto threshold = 10 * gap;
+            if( timestamp - next_expected < threshold )
+                return false;
+
+            LOG_IF_ENABLE( "...     exceeded threshold of {10*gap}" << threshold << "; deactivating matcher!", env );
+
+            missing.erase = true;
+            missing.owner->set_active( false );
+        }
+
+        return ! timestamp_composite_matcher::are_equivalent( timestamp, next_expected, synced_frame.fps );
+    }
+
+    void timestamp_indexed_matcher::stop()
+    {
+        _stopped = true;
+        {
+            std::lock_guard< std::mutex > lock( _slots_mutex );
+            _slots.clear();
+        }
+        composite_matcher::stop();
+    }
+
+    void timestamp_indexed_matcher::sync( frame_holder f, const syncronization_environment & env )
+    {
+        auto matcher = find_matcher( f );
+        if( ! matcher )
+        {
+            LOG_ERROR( "didn't find any matcher for " << frame_holder_to_string( f ) << " will not be synchronized" );
+            _callback( std::move( f ), env );
+            return;
+        }
+        std::lock_guard< std::mutex > lock( _slots_mutex );
+        if( _stopped )
+            return;
+
+        auto & s = _slots[get_slot( matcher.get() )];
+
+        pending_frame pf;
+        pf.timestamp = f->get_frame_timestamp();
+        pf.domain = f->get_frame_timestamp_domain();
+        pf.fps = get_fps( f );
+        s.next_expected = pf.timestamp + 1000.f / (float)pf.fps;
+        s.next_expected_domain = pf.domain;
+        auto blocking = f.is_blocking();
+        pf.frame = std::move( f );
+        s.push( std::move( pf ), blocking );
+
+        while( true )
+        {
+            _arrived.clear();
+            _missing.clear();
+            for( size_t i = 0; i < _slots.size(); ++i )
+            {
+                if( _slots[i].count )
+                {
+                    LOG_IF_ENABLE( "... have " << *_slots[i].front().frame.frame, env );
+                    _arrived.push_back( i );
+                }
+                else
+                    _missing.push_back( i );
+            }
+
+            if( _arrived.empty() )
+                break;
+
+            // Check that everything we have matches together
+            auto curr_sync = _arrived[0];
+            _synced.clear();
+            _synced.push_back( curr_sync );
+
+            auto old_frames = false;
+            for( size_t i = 1; i < _arrived.size(); i++ )
+            {
+                auto & curr = _slots[curr_sync].front();
+                auto & other = _slots[_arrived[i]].front();
+                if( are_equivalent( curr, other ) )
+                {
+                    _synced.push_back( _arrived[i] );
+                }
+                else if( is_smaller_than( other, curr ) )
+                {
+                    old_frames = true;
+                    _synced.clear();
+                    _synced.push_back( _arrived[i] );
+                    curr_sync = _arrived[i];
+                }
+                else
+                {
+                    old_frames = true;
+                }
+            }
+
+            bool release_synced_frames = true;
+            if( ! old_frames )
+            {
+                for( auto i : _missing )
+                {
+                    LOG_IF_ENABLE( "... missing " << _slots[i].owner->get_name() << ", next expected " << _slots[i].next_expected, env );
+                    if( skip_missing_stream( _slots[_synced[0]], _slots[i], env ) )
+                    {
+                        LOG_IF_ENABLE( "...     ignoring it", env );
+                        continue;
+                    }
+
+                    LOG_IF_ENABLE( "...     waiting for it", env );
+                    release_synced_frames = false;
+                }
+            }
+            if( ! release_synced_frames )
+            {
+                erase_marked_slots();
+                break;
+            }
+
+            std::vector< frame_holder > match;
+            match.reserve( _synced.size() );
+            for( auto i : _synced )
+            {
+                match.push_back( _slots[i].pop() );
+                if( old_frames )
+                {
+                    LOG_IF_ENABLE( "--> " << frame_holder_to_string( match.back() ), env );
+                }
+            }
+            erase_marked_slots();
+
+            // The frameset should always be with the same order of streams (the first stream carries extra
+            // meaning because it decides the frameset properties) -- so we sort them...
+            std::sort( match.begin(),
+                       match.end(),
+                       []( const frame_holder & f1, const frame_holder & f2 ) {
+                           return ( (frame_interface *)f1 )->get_stream()->get_unique_id()
+                                > ( (frame_interface *)f2 )->get_stream()->get_unique_id();
+                       } );
+
+            frame_holder composite = env.source->allocate_composite_frame( std::move( match ) );
+            if( composite.frame )
+            {
+                auto cb = begin_callback();
+                _callback( std::move( composite ), env );
+            }
+        }
+    }
+
     composite_identity_matcher::composite_identity_matcher(
         std::vector< std::shared_ptr< matcher > > const & matchers )
         : composite_matcher( matchers, "CI: " )
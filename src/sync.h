@@ -10,6 +10,7 @@
 #include <vector>
 #include <mutex>
 #include <memory>
+#include <atomic>
 
 namespace librealsense
 {
@@ -212,11 +213,69 @@ namespace librealsense
         void update_next_expected( std::shared_ptr< matcher > const & matcher,
                                    const frame_holder & f ) override;
 
-    private:
+    protected:
         unsigned int get_fps(const frame_holder & f);
         bool are_equivalent(double a, double b, int fps);
+
+    private:
         std::map<matcher*, double> _last_arrived;
         std::map<matcher*, unsigned int> _fps;
 
     };
+
+    // Makes exactly the same decisions as timestamp_composite_matcher, but keeps the frames waiting
+    // for a match in a flat array of per-matcher slots (in the same order _frames_queue would have
+    // them), each holding its frames oldest-first along with the timestamp, domain and fps read once
+    // on arrival. A slot is found by binary search, and the scan done on every frame does no map
+    // lookup and allocates nothing.
+    class timestamp_indexed_matcher : public timestamp_composite_matcher
+    {
+    public:
+        timestamp_indexed_matcher( std::vector< std::shared_ptr< matcher > > const & matchers );
+
+        void sync(frame_holder f, const syncronization_environment& env) override;
+        void stop() override;
+
+    private:
+        struct pending_frame
+        {
+            frame_holder frame;
+            double timestamp;
+            rs2_timestamp_domain domain;
+            unsigned int fps;
+        };
+
+        // The frames of one matcher, oldest first, in a ring that drops the oldest frame when full
+        // like single_consumer_frame_queue does (blocking frames make it grow instead)
+        struct slot
+        {
+            matcher * owner = nullptr;
+            std::vector< pending_frame > ring;
+            size_t head = 0;
+            size_t count = 0;
+            double next_expected = 0;
+            rs2_timestamp_domain next_expected_domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
+            bool erase = false;
+
+            pending_frame & front() { return ring[head]; }
+            void push( pending_frame && f, bool blocking );
+            frame_holder pop();
+        };
+
+        size_t get_slot( matcher * m );
+        void erase_marked_slots();
+        bool are_equivalent( pending_frame & a, pending_frame & b );
+        bool is_smaller_than( pending_frame & a, pending_frame & b );
+        bool skip_missing_stream( slot & synced, slot & missing, const syncronization_environment & env );
+
+        // Held by sync(), and by stop() which comes from another thread than the frames
+        std::mutex _slots_mutex;
+        std::vector< slot > _slots;  // sorted by owner
+        std::atomic< bool > _stopped;
+
+        // Scratch space reused by every sync(), holding indices into _slots
+        std::vector< size_t > _arrived;
+        std::vector< size_t > _synced;
+        std::vector< size_t > _missing;
+    };
 }
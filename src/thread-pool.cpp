@@ -0,0 +1,138 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include "thread-pool.h"
+#include "environment.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace librealsense
+{
+    // Set on the workers: bands that call parallel_for() again run the nested bands themselves
+    static thread_local bool is_pool_worker = false;
+
+    static void pin_current_thread(int core)
+    {
+        int cores = std::max(1, int(std::thread::hardware_concurrency()));
+        core %= cores;
+#ifdef _WIN32
+        if (core < int(sizeof(DWORD_PTR) * 8))
+            SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core);
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+#endif
+    }
+
+    thread_pool::thread_pool(int threads, bool pinned)
+        : _pinned(pinned), _stopping(false)
+    {
+        for (int i = 1; i < threads; ++i)
+            _workers.emplace_back(&thread_pool::work, this, i);
+    }
+
+    thread_pool::~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _pending.notify_all();
+        for (auto&& worker : _workers)
+            worker.join();
+    }
+
+    void thread_pool::run(job& j)
+    {
+        int done = 0;
+        std::exception_ptr error;
+        for (int b = j.next++; b < j.bands; b = j.next++, ++done)
+        {
+            try
+            {
+                j.band(b);
+            }
+            catch (...)
+            {
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+
+        if (done)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (error && !j.error)
+                j.error = error;
+            j.finished += done;
+            if (j.finished == j.bands)
+                _finished.notify_all();
+        }
+    }
+
+    void thread_pool::work(int index)
+    {
+        is_pool_worker = true;
+        if (_pinned)
+            pin_current_thread(index);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _pending.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+            if (_stopping)
+                return;
+
+            auto j = _jobs.front();
+            lock.unlock();
+            run(*j);
+            lock.lock();
+
+            // All its bands are claimed
+            auto it = std::find(_jobs.begin(), _jobs.end(), j);
+            if (it != _jobs.end())
+                _jobs.erase(it);
+        }
+    }
+
+    void thread_pool::parallel_for(int bands, const std::function<void(int)>& band)
+    {
+        if (_workers.empty() || bands <= 1 || is_pool_worker)
+        {
+            for (int b = 0; b < bands; ++b)
+                band(b);
+            return;
+        }
+
+        auto j = std::make_shared<job>(bands, band);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.push_back(j);
+        }
+        _pending.notify_all();
+
+        run(*j);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto it = std::find(_jobs.begin(), _jobs.end(), j);
+        if (it != _jobs.end())
+            _jobs.erase(it);
+        _finished.wait(lock, [&]() { return j->finished == j->bands; });
+
+        if (j->error)
+            std::rethrow_exception(j->error);
+    }
+
+    void parallel_for(int bands, const std::function<void(int)>& band)
+    {
+        environment::get_instance().get_thread_pool()->parallel_for(bands, band);
+    }
+}
@@ -0,0 +1,72 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace librealsense
+{
+    // Worker threads shared by all the CPU processing blocks, which split each frame into bands (of
+    // rows, of columns or of pixels) and run them through parallel_for().
+    //
+    // The thread that calls parallel_for() works on its own bands too, so a pool of N threads has
+    // N - 1 workers. Idle workers take bands from any pending call, so blocks that run at the same
+    // time share the workers instead of each starting threads of its own, and a block that runs
+    // alone gets all of them. Bands are claimed one at a time from a counter, so uneven bands
+    // balance out by themselves.
+    class LRS_EXTENSION_API thread_pool
+    {
+    public:
+        // threads: including the calling thread; 1 runs everything on the calling thread
+        // pinned:  each worker is bound to a core of its own (Linux and Windows only)
+        thread_pool(int threads, bool pinned);
+        ~thread_pool();
+
+        int get_threads() const { return int(_workers.size()) + 1; }
+        bool is_pinned() const { return _pinned; }
+
+        // Runs band(0) ... band(bands - 1), and returns once all of them are done. The first
+        // exception thrown by a band is rethrown here, after the other bands have finished
+        void parallel_for(int bands, const std::function<void(int)>& band);
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+    private:
+        struct job
+        {
+            job(int bands, const std::function<void(int)>& band) : bands(bands), band(band), next(0), finished(0) {}
+
+            const int bands;
+            const std::function<void(int)>& band;
+            std::atomic<int> next;        // The next band to claim
+            int finished;                 // Under the pool mutex
+            std::exception_ptr error;     // Under the pool mutex
+        };
+
+        void work(int index);
+        void run(job& j);
+
+        std::vector<std::thread>        _workers;
+        bool                            _pinned;
+        std::mutex                      _mutex;
+        std::condition_variable         _pending;     // A job was queued, or the pool is stopping
+        std::condition_variable         _finished;    // A job has finished
+        std::deque<std::shared_ptr<job>> _jobs;       // Jobs with bands left to claim
+        bool                            _stopping;
+    };
+
+    // Runs the bands on the thread pool of the library, set by rs2_context_set_processing_threads()
+    LRS_EXTENSION_API void parallel_for(int bands, const std::function<void(int)>& band);
+}
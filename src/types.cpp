@@ -444,6 +444,10 @@ namespace librealsense
             CASE(AUTO_GAIN_LIMIT)
             CASE(AUTO_RX_SENSITIVITY)
             CASE(TRANSMITTER_FREQUENCY)
+            CASE(FRAMES_POOL_HITS)
+            CASE(FRAMES_POOL_MISSES)
+            CASE(FRAMES_POOL_EVICTIONS)
+            CASE(FRAMES_POOL_RETENTION)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -484,6 +488,7 @@ namespace librealsense
             CASE(W10)
             CASE(Z16H)
             CASE(FG)
+            CASE(MOTION_BATCH)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -87,6 +87,15 @@ namespace librealsense
         byte reserved3[2];
     };
 
+    // A sample of a RS2_FORMAT_MOTION_BATCH frame as the HID sensor delivers it, before the motion
+    // transform turns it into a rs2_motion_sample of the same size
+    struct hid_batch_sample
+    {
+        double timestamp;
+        hid_data data;
+        byte reserved[4];
+    };
+
 #pragma pack(pop)
 
     static const double TIMESTAMP_USEC_TO_MSEC = 0.001;
@@ -1012,6 +1021,20 @@ namespace librealsense
         void release() override { delete this; }
     };
 
+    class frame_allocator : public rs2_frame_allocator
+    {
+        rs2_frame_allocate_ptr aptr;
+        rs2_frame_deallocate_ptr dptr;
+        void * user;
+    public:
+        frame_allocator(rs2_frame_allocate_ptr on_allocate, rs2_frame_deallocate_ptr on_deallocate, void * user)
+            : aptr(on_allocate), dptr(on_deallocate), user(user) {}
+
+        void* allocate(size_t size) override { return aptr(size, user); }
+        void deallocate(void* buffer, size_t size) override { dptr(buffer, size, user); }
+        void release() override { delete this; }
+    };
+
     typedef void(*notifications_callback_function_ptr)(rs2_notification * notification, void * user);
 
     class notifications_callback : public rs2_notifications_callback
@@ -1115,6 +1138,7 @@ namespace librealsense
     typedef std::shared_ptr<rs2_software_device_destruction_callback> software_device_destruction_callback_ptr;
     typedef std::shared_ptr<rs2_devices_changed_callback> devices_changed_callback_ptr;
     typedef std::shared_ptr<rs2_update_progress_callback> update_progress_callback_ptr;
+    typedef std::shared_ptr<rs2_frame_allocator> frame_allocator_ptr;
 
     using internal_callback = std::function<void(rs2_device_list* removed, rs2_device_list* added)>;
     class devices_changed_callback_internal : public rs2_devices_changed_callback
@@ -1199,48 +1223,92 @@ namespace librealsense
         return (c0 << 24) | (c1 << 16) | (c2 << 8) | c3;
     }
 
+    // Fixed-capacity pool of T objects, shared between the threads producing and releasing frames.
+    // Free slots are kept on a lock-free stack of indices so allocate and deallocate are O(1) and never
+    // block; the mutex and condition variable are only used by wait_until_empty, which is woken when
+    // the last outstanding item is returned.
     template<class T, int C>
     class small_heap
     {
+        static const uint32_t END_OF_LIST = C;
+
         T buffer[C];
-        bool is_free[C];
+        std::atomic<uint32_t> next[C];
+        // Index of the first free slot in the low 32 bits; the high 32 bits are bumped on every update
+        // so that a pop racing with a pop + push of the same slot (ABA) fails its compare-exchange
+        std::atomic<uint64_t> free_head;
+        std::atomic<bool> keep_allocating;
+        std::atomic<int> size;
         std::mutex mutex;
-        bool keep_allocating = true;
         std::condition_variable cv;
-        int size = 0;
+
+        static uint64_t make_head(uint64_t head, uint32_t index)
+        {
+            return (((head >> 32) + 1) << 32) | index;
+        }
+
+        bool pop_free(uint32_t& index)
+        {
+            auto head = free_head.load(std::memory_order_acquire);
+            do
+            {
+                index = static_cast<uint32_t>(head);
+                if (index == END_OF_LIST) return false;
+            } while (!free_head.compare_exchange_weak(head, make_head(head, next[index].load(std::memory_order_relaxed)),
+                std::memory_order_acquire, std::memory_order_acquire));
+            return true;
+        }
+
+        void push_free(uint32_t index)
+        {
+            auto head = free_head.load(std::memory_order_relaxed);
+            do
+            {
+                next[index].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            } while (!free_head.compare_exchange_weak(head, make_head(head, index),
+                std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        void release_one()
+        {
+            if (size.fetch_sub(1) == 1)
+            {
+                // Taking the lock orders this notification after a waiter has checked the size
+                { std::lock_guard<std::mutex> lock(mutex); }
+                cv.notify_all();
+            }
+        }
 
     public:
         static const int CAPACITY = C;
 
         small_heap()
+            : free_head(0), keep_allocating(true), size(0)
         {
             for (auto i = 0; i < C; i++)
             {
-                is_free[i] = true;
+                next[i] = i + 1;
                 buffer[i] = std::move(T());
             }
         }
 
         T * allocate()
         {
-            std::unique_lock<std::mutex> lock(mutex);
-            if (!keep_allocating) return nullptr;
-
-            for (auto i = 0; i < C; i++)
+            // Count the item before checking keep_allocating, so that stop_allocation followed by
+            // wait_until_empty either sees it or prevents it
+            size.fetch_add(1);
+            uint32_t i;
+            if (!keep_allocating || !pop_free(i))
             {
-                if (is_free[i])
-                {
-                    is_free[i] = false;
-                    size++;
-                    return &buffer[i];
-                }
+                release_one();
+                return nullptr;
             }
-            return nullptr;
+            return &buffer[i];
         }
 
         void deallocate(T * item)
         {
-             if (item < buffer || item >= buffer + C)
+            if (item < buffer || item >= buffer + C)
             {
                 throw invalid_value_exception("Trying to return item to a heap that didn't allocate it!");
             }
@@ -1248,23 +1316,12 @@ namespace librealsense
             auto old_value = std::move(buffer[i]);
             buffer[i] = std::move(T());
 
-            {
-                std::unique_lock<std::mutex> lock(mutex);
-
-                is_free[i] = true;
-                size--;
-
-                if (size == 0)
-                {
-                    lock.unlock();
-                    cv.notify_one();
-                }
-            }
+            push_free(static_cast<uint32_t>(i));
+            release_one();
         }
 
         void stop_allocation()
         {
-            std::unique_lock<std::mutex> lock(mutex);
             keep_allocating = false;
         }
 
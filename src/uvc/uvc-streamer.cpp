@@ -92,7 +92,13 @@ namespace librealsense
                 if (_queue.dequeue(&fp, DEQUEUE_MILLISECONDS_TIMEOUT))
                 {
                     if(_publish_frames && running())
-                        _context.user_cb(_context.profile, fp->fo, []() mutable {});
+                    {
+                        // The frame is returned to the archive by the continuation, allowing the
+                        // consumer to keep referencing the buffer past the callback (zero-copy)
+                        auto archive = _frames_archive;
+                        std::shared_ptr<backend_frame> frame(fp.release(), fp.get_deleter());
+                        _context.user_cb(_context.profile, frame->fo, [archive, frame]() mutable { frame.reset(); });
+                    }
                 }
             });
 
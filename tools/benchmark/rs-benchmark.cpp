@@ -117,6 +117,22 @@ private:
     std::string _name;
 };
 
+// Runs a depth block on disparity frames, converting outside of the timed step
+template<class T>
+class disparity_test : public pb_test<T>
+{
+public:
+    disparity_test(std::string name)
+        : pb_test<T>(std::move(name)) {}
+
+    frame prepare(frame f) override
+    {
+        return _to_disparity.process(f);
+    }
+private:
+    disparity_transform _to_disparity;
+};
+
 template<class T>
 class gl_test : public pb_test<T>
 {
@@ -161,6 +177,7 @@ public:
 };
 
 #define REGISTER_TEST(x) tests.push_back(make_shared<pb_test<x>>(#x))
+#define REGISTER_DISPARITY_TEST(x) tests.push_back(make_shared<disparity_test<x>>(#x " (disparity)"))
 
 class processing_blocks : public suite
 {
@@ -174,6 +191,7 @@ public:
             REGISTER_TEST(pointcloud);
             REGISTER_TEST(spatial_filter);
             REGISTER_TEST(temporal_filter);
+            REGISTER_DISPARITY_TEST(temporal_filter);
             REGISTER_TEST(disparity_transform);
             REGISTER_TEST(threshold_filter);
             REGISTER_TEST(decimation_filter);
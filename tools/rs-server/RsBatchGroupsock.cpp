@@ -0,0 +1,92 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2020 Intel Corporation. All Rights Reserved.
+
+#include "RsBatchGroupsock.h"
+#include <GroupsockHelper.hh>
+
+#include <cstring>
+
+#define RTP_HEADER_SIZE 12
+
+RsBatchGroupsock::RsBatchGroupsock(UsageEnvironment& t_env, struct sockaddr_storage const& t_groupAddr, Port t_port, u_int8_t t_ttl)
+    : Groupsock(t_env, t_groupAddr, t_port, t_ttl)
+    , m_timestamp(0)
+{
+    m_offsets.push_back(0);
+}
+
+RsBatchGroupsock::~RsBatchGroupsock()
+{
+    flush();
+}
+
+Boolean RsBatchGroupsock::output(UsageEnvironment& t_env, unsigned char* t_buffer, unsigned t_bufferSize)
+{
+#ifdef __linux__
+    bool batch = fDests != NULL && fDests->fNext == NULL && !IsMulticastAddress(fDests->fGroupEId.groupAddress());
+    if(!batch || t_bufferSize < RTP_HEADER_SIZE)
+    {
+        return flush() && Groupsock::output(t_env, t_buffer, t_bufferSize);
+    }
+
+    // The packets of a frame share their timestamp, a new one means the marker of the last frame was lost
+    u_int32_t timestamp;
+    memcpy(&timestamp, t_buffer + 4, sizeof(timestamp));
+    if(m_offsets.size() > 1 && timestamp != m_timestamp && !flush())
+    {
+        return False;
+    }
+    m_timestamp = timestamp;
+
+    m_packets.insert(m_packets.end(), t_buffer, t_buffer + t_bufferSize);
+    m_offsets.push_back(m_packets.size());
+
+    bool marker = (t_buffer[1] & 0x80) != 0;
+    if(marker || m_offsets.size() > RS_BATCH_MAX_PACKETS)
+    {
+        return flush();
+    }
+    return True;
+#else
+    return Groupsock::output(t_env, t_buffer, t_bufferSize);
+#endif
+}
+
+Boolean RsBatchGroupsock::flush()
+{
+    size_t count = m_offsets.size() - 1;
+    if(count == 0)
+    {
+        return True;
+    }
+
+    Boolean success = True;
+#ifdef __linux__
+    if(fDests != NULL)
+    {
+        struct sockaddr_storage const& dest = fDests->fGroupEId.groupAddress();
+        bool usedGso = m_sender.usesGso();
+        success = m_sender.send(socketNum(), dest, addressSize(dest), m_packets.data(), m_offsets.data(), count);
+        if(usedGso && !m_sender.usesGso())
+        {
+            env() << "UDP GSO is not supported, sending RTP packets with sendmmsg\n";
+        }
+        if(!success)
+        {
+            env().setResultErrMsg("Sending RTP packets failed: ");
+        }
+    }
+#endif
+
+    if(success)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            statsOutgoing.countPacket(unsigned(m_offsets[i + 1] - m_offsets[i]));
+            statsGroupOutgoing.countPacket(unsigned(m_offsets[i + 1] - m_offsets[i]));
+        }
+    }
+    m_packets.clear();
+    m_offsets.resize(1);
+    return success;
+}
@@ -0,0 +1,35 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2020 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <liveMedia.hh>
+
+#include "RsBatchSocket.h"
+
+#include <vector>
+
+#define RS_BATCH_MAX_PACKETS 4096 // Sent early if a frame has more packets
+
+// A groupsock that sends the RTP packets of a frame together, once the last one (with the marker
+// bit) is built, instead of making a system call for each packet (see RsBatchSender). Packets for
+// multicast or for more than one destination are sent one by one, as Groupsock does.
+class RsBatchGroupsock : public Groupsock
+{
+public:
+    RsBatchGroupsock(UsageEnvironment& t_env, struct sockaddr_storage const& t_groupAddr, Port t_port, u_int8_t t_ttl);
+    virtual ~RsBatchGroupsock();
+
+    virtual Boolean output(UsageEnvironment& t_env, unsigned char* t_buffer, unsigned t_bufferSize);
+
+    // Sends the packets that are waiting
+    Boolean flush();
+
+private:
+#ifdef __linux__
+    RsBatchSender m_sender;
+#endif
+    std::vector<unsigned char> m_packets;
+    std::vector<size_t> m_offsets; // Of each packet in m_packets, and of the end
+    u_int32_t m_timestamp;         // RTP timestamp of the frame the packets belong to
+};
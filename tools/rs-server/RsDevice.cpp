@@ -11,8 +11,9 @@ int RsDevice::getPhysicalSensorUniqueKey(rs2_stream stream_type, int sensors_ind
     return stream_type * 10 + sensors_index;
 }
 
-RsDevice::RsDevice(UsageEnvironment* t_env)
-    : env(t_env)
+RsDevice::RsDevice(UsageEnvironment* t_env, ZipMethod t_depthMethod)
+    : m_depthMethod(t_depthMethod)
+    , env(t_env)
 {
     //get LRS device
     // The context represents the current platform with respect to connected devices
@@ -52,7 +53,7 @@ RsDevice::RsDevice(UsageEnvironment* t_env)
     //get RS sensors
     for(auto& sensor : m_device.query_sensors())
     {
-        m_sensors.push_back(RsSensor(env, sensor, m_device));
+        m_sensors.push_back(RsSensor(env, sensor, m_device, m_depthMethod));
     }
 }
 
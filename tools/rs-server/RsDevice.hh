@@ -6,12 +6,13 @@
 #include <librealsense2/rs.hpp>
 #include "RsUsageEnvironment.h"
 #include "RsSensor.hh"
+#include "compression/CompressionFactory.h"
 #include <map>
 
 class RsDevice
 {
 public:
-    RsDevice(UsageEnvironment* t_env);
+    RsDevice(UsageEnvironment* t_env, ZipMethod t_depthMethod);
     ~RsDevice();
     std::vector<RsSensor>& getSensors()
     {
@@ -31,9 +32,16 @@ public:
         return m_device;
     }
 
+    // How the depth streams of this server are compressed, announced in the depth_compression SDP field
+    ZipMethod getDepthMethod()
+    {
+        return m_depthMethod;
+    }
+
 private:
     rs2::device m_device;
     std::vector<RsSensor> m_sensors;
+    ZipMethod m_depthMethod;
 
     UsageEnvironment* env;
 };
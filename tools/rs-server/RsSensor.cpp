@@ -11,10 +11,11 @@
 #include <math.h>
 #include <thread>
 
-RsSensor::RsSensor(UsageEnvironment* t_env, rs2::sensor t_sensor, rs2::device t_device)
+RsSensor::RsSensor(UsageEnvironment* t_env, rs2::sensor t_sensor, rs2::device t_device, ZipMethod t_depthMethod)
     : env(t_env)
     , m_sensor(t_sensor)
     , m_device(t_device)
+    , m_depthMethod(t_depthMethod)
 {
     for(rs2::stream_profile streamProfile : m_sensor.get_stream_profiles())
     {
@@ -25,7 +26,7 @@ RsSensor::RsSensor(UsageEnvironment* t_env, rs2::sensor t_sensor, rs2::device t_
             m_prevSample.emplace(getStreamProfileKey(streamProfile), std::chrono::high_resolution_clock::now());
         }
     }
-    m_memPool = new MemoryPool();
+    m_memPool = std::make_shared<MemoryPool>();
 }
 
 int RsSensor::open(std::unordered_map<long long int, rs2::frame_queue>& t_streamProfilesQueues)
@@ -39,7 +40,7 @@ int RsSensor::open(std::unordered_map<long long int, rs2::frame_queue>& t_stream
         if(CompressionFactory::isCompressionSupported(m_streamProfiles.at(streamProfileKey).format(), m_streamProfiles.at(streamProfileKey).stream_type()))
         {
             rs2::video_stream_profile vsp = m_streamProfiles.at(streamProfileKey);
-            std::shared_ptr<ICompression> compressPtr = CompressionFactory::getObject(vsp.width(), vsp.height(), vsp.format(), vsp.stream_type(), getStreamProfileBpp(vsp.format()));
+            std::shared_ptr<ICompression> compressPtr = CompressionFactory::getObject(vsp.width(), vsp.height(), vsp.format(), vsp.stream_type(), getStreamProfileBpp(vsp.format()), m_depthMethod);
             if(compressPtr != nullptr)
             {
                 m_iCompress.insert(std::pair<long long int, std::shared_ptr<ICompression>>(streamProfileKey, compressPtr));
@@ -77,7 +78,8 @@ int RsSensor::start(std::unordered_map<long long int, rs2::frame_queue>& t_strea
             std::chrono::duration<double> timeSpan = std::chrono::duration_cast<std::chrono::duration<double>>(curSample - m_prevSample[profileKey]);
             if(CompressionFactory::isCompressionSupported(frame.get_profile().format(), frame.get_profile().stream_type()))
             {
-                unsigned char* buff = m_memPool->getNextMem();
+                // Frames that do not compress to their own size are dropped, rather than written past it
+                unsigned char* buff = m_memPool->getNextMem(frame.get_data_size());
                 int frameSize = m_iCompress.at(profileKey)->compressBuffer((unsigned char*)frame.get_data(), frame.get_data_size(), buff);
                 if(frameSize == -1)
                 {
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "compression/CompressionFactory.h"
 #include "compression/ICompression.h"
 #include <chrono>
 #include <ipDeviceCommon/MemoryPool.h>
@@ -19,7 +20,7 @@ typedef struct RsOption
 class RsSensor
 {
 public:
-    RsSensor(UsageEnvironment* t_env, rs2::sensor t_sensor, rs2::device t_device);
+    RsSensor(UsageEnvironment* t_env, rs2::sensor t_sensor, rs2::device t_device, ZipMethod t_depthMethod);
     int open(std::unordered_map<long long int, rs2::frame_queue>& t_streamProfilesQueues);
     int start(std::unordered_map<long long int, rs2::frame_queue>& t_streamProfilesQueues);
     int close();
@@ -46,6 +47,7 @@ private:
     std::unordered_map<long long int, rs2::video_stream_profile> m_streamProfiles;
     std::unordered_map<long long int, std::shared_ptr<ICompression>> m_iCompress;
     rs2::device m_device;
-    MemoryPool* m_memPool;
+    ZipMethod m_depthMethod;
+    std::shared_ptr<MemoryPool> m_memPool;
     std::unordered_map<long long int, std::chrono::high_resolution_clock::time_point> m_prevSample;
 };
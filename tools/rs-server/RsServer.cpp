@@ -42,10 +42,12 @@ struct server
         SwitchArg arg_enable_compression("c", "enable-compression", "Enable video compression");
         ValueArg<std::string> arg_address("i", "interface-address", "Address of the interface to bind on", false, "", "string");
         ValueArg<unsigned int> arg_port("p", "port", "RTSP port to listen on", false, 8554, "integer");
+        ValueArg<std::string> arg_depth_compression("d", "depth-compression", "Depth compression: lz4, or rvl (not decoded by older clients)", false, "lz4", "string");
 
         cmd.add(arg_enable_compression);
         cmd.add(arg_address);
         cmd.add(arg_port);
+        cmd.add(arg_depth_compression);
 
         cmd.parse(argc, argv);
 
@@ -55,6 +57,16 @@ struct server
             CompressionFactory::getIsEnabled() = 1;
         }
 
+        ZipMethod depthMethod = ZipMethod::lz;
+        if (arg_depth_compression.getValue() == "rvl")
+        {
+            depthMethod = ZipMethod::rvl;
+        }
+        else if (arg_depth_compression.getValue() != "lz4")
+        {
+            std::cerr << "Unknown depth compression " << arg_depth_compression.getValue() << ", using lz4\n";
+        }
+
         if (arg_address.isSet()) 
         {
             ReceivingInterfaceAddr = inet_addr(arg_address.getValue().c_str());
@@ -71,7 +83,7 @@ struct server
         scheduler = BasicTaskScheduler::createNew();
         env = RSUsageEnvironment::createNew(*scheduler);
 
-        rsDevice = std::make_shared<RsDevice>(env);
+        rsDevice = std::make_shared<RsDevice>(env, depthMethod);
         rtspServer = RsRTSPServer::createNew(*env, rsDevice, port);
 
         if(rtspServer == NULL)
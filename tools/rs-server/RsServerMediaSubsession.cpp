@@ -2,6 +2,7 @@
 // Copyright(c) 2020 Intel Corporation. All Rights Reserved.
 
 #include "RsServerMediaSubsession.h"
+#include "RsBatchGroupsock.h"
 #include "RsCommon.h"
 #include "RsServerMediaSession.h"
 #include "RsSimpleRTPSink.h"
@@ -42,4 +43,10 @@ FramedSource* RsServerMediaSubsession::createNewStreamSource(unsigned /*t_client
 RTPSink* RsServerMediaSubsession ::createNewRTPSink(Groupsock* t_rtpGroupsock, unsigned char t_rtpPayloadTypeIfDynamic, FramedSource* /*t_inputSource*/)
 {
     return RsSimpleRTPSink::createNew(envir(), t_rtpGroupsock, 96 + m_videoStreamProfile.stream_type(), RTP_TIMESTAMP_FREQ, RS_MEDIA_TYPE.c_str(), RS_PAYLOAD_FORMAT.c_str(), m_videoStreamProfile, m_rsDevice);
-}
\ No newline at end of file
+}
+
+Groupsock* RsServerMediaSubsession::createGroupsock(struct sockaddr_storage const& t_addr, Port t_port)
+{
+    // Sends the packets of each frame in a few system calls
+    return new RsBatchGroupsock(envir(), t_addr, t_port, 255);
+}
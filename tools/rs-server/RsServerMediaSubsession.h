@@ -24,6 +24,7 @@ protected:
     virtual ~RsServerMediaSubsession();
     virtual FramedSource* createNewStreamSource(unsigned t_clientSessionId, unsigned& t_estBitrate);
     virtual RTPSink* createNewRTPSink(Groupsock* t_rtpGroupsock, unsigned char t_rtpPayloadTypeIfDynamic, FramedSource* t_inputSource);
+    virtual Groupsock* createGroupsock(struct sockaddr_storage const& t_addr, Port t_port);
 
 private:
     rs2::video_stream_profile m_videoStreamProfile;
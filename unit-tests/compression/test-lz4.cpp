@@ -0,0 +1,87 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+//#cmake:add-file ../../src/compression/Lz4Compression.cpp ../../third-party/realsense-file/lz4/lz4.c
+//#cmake:include-dir ../../src ../../src/ipDeviceCommon ../../third-party/realsense-file/lz4
+
+#include "../catch.h"
+
+#include <src/ipDeviceCommon/MemoryPool.h>
+#include <src/compression/Lz4Compression.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const int width = 1280, height = 720, bpp = 2;
+static const int frame_size = width * height * bpp;  // 450 pages exactly: no slack in a pool buffer
+
+
+TEST_CASE( "lz4 round trip through the memory pool", "[compression]" )
+{
+    // Depth-like: runs of holes and slow ramps
+    std::vector< unsigned char > frame( frame_size );
+    auto pixels = reinterpret_cast< uint16_t * >( frame.data() );
+    for( int i = 0; i < width * height; ++i )
+        pixels[i] = ( i % width < 100 ) ? 0 : uint16_t( 1000 + i / width );
+
+    MemoryPool pool;
+    Lz4Compression lz4( width, height, RS2_FORMAT_Z16, bpp );
+    unsigned char * compressed = pool.getNextMem( frame_size );
+    int compressed_size = lz4.compressBuffer( frame.data(), frame_size, compressed );
+    REQUIRE( compressed_size > int( sizeof( int ) ) );
+    CHECK( compressed_size < frame_size / 4 );
+
+    int size;
+    memcpy( &size, compressed, sizeof( size ) );
+    CHECK( size == compressed_size - int( sizeof( int ) ) );
+    std::vector< unsigned char > decompressed( frame_size );
+    CHECK( lz4.decompressBuffer( compressed + sizeof( int ), size, decompressed.data() ) == frame_size );
+    CHECK( decompressed == frame );
+    pool.returnMem( compressed );
+}
+
+TEST_CASE( "lz4 never writes past the frame size", "[compression]" )
+{
+    std::mt19937 gen( 19 );
+    std::uniform_int_distribution< int > byte( 0, 255 );
+    std::vector< unsigned char > frame( frame_size );
+    for( auto & b : frame )
+        b = uint8_t( byte( gen ) );
+
+    Lz4Compression lz4( width, height, RS2_FORMAT_Z16, bpp );
+
+    SECTION( "into a guarded buffer" )
+    {
+        // Noise grows when compressed: nothing is written past the frame, and the frame is dropped
+        const int guard = 64 * 1024;
+        std::vector< unsigned char > compressed( frame_size + guard, 0xcd );
+        CHECK( lz4.compressBuffer( frame.data(), frame_size, compressed.data() ) == -1 );
+        CHECK( std::count( compressed.begin() + frame_size, compressed.end(), 0xcd ) == guard );
+    }
+
+    SECTION( "into a pool buffer" )
+    {
+        MemoryPool pool;
+        unsigned char * compressed = pool.getNextMem( frame_size );
+        CHECK( lz4.compressBuffer( frame.data(), frame_size, compressed ) == -1 );
+        pool.returnMem( compressed );
+
+        // The buffer is reused, so its size and pool are intact
+        CHECK( pool.getNextMem( frame_size ) == compressed );
+        pool.returnMem( compressed );
+        auto stats = pool.getStatistics();
+        CHECK( stats.allocated == 1 );
+        CHECK( stats.reused == 1 );
+        CHECK( stats.inUse == 0 );
+    }
+
+    SECTION( "tiny frames" )
+    {
+        unsigned char tiny[4] = { 1, 2, 3, 4 };
+        unsigned char compressed[4];
+        CHECK( lz4.compressBuffer( tiny, sizeof( tiny ), compressed ) == -1 );
+    }
+}
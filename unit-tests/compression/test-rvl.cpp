@@ -0,0 +1,98 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+//#cmake:add-file ../../src/compression/RvlCompression.cpp
+//#cmake:include-dir ../../src ../../src/ipDeviceCommon
+
+#include "../catch.h"
+
+#include <src/compression/RvlCompression.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const int width = 640, height = 481;  // Not a multiple of the slices
+static const int frame_size = width * height * 2;
+
+
+// Depth-like: holes, edges and noise on slow ramps
+static std::vector< unsigned char > depth_frame()
+{
+    std::mt19937 gen( 17 );
+    std::uniform_int_distribution< int > noise( -3, 3 );
+    std::vector< unsigned char > frame( frame_size );
+    auto pixels = reinterpret_cast< short * >( frame.data() );
+    for( int y = 0; y < height; ++y )
+        for( int x = 0; x < width; ++x )
+            pixels[y * width + x] = ( x % 97 < 20 || y % 61 < 5 ) ? 0 : short( 800 + x + 3 * y + noise( gen ) );
+    return frame;
+}
+
+static std::vector< unsigned char > compress( RvlCompression & rvl, std::vector< unsigned char > & frame )
+{
+    std::vector< unsigned char > compressed( frame_size );
+    int size = rvl.compressBuffer( frame.data(), frame_size, compressed.data() );
+    REQUIRE( size > 0 );
+    compressed.resize( size );
+    return compressed;
+}
+
+static int header( std::vector< unsigned char > const & compressed, int i )
+{
+    int value;
+    memcpy( &value, compressed.data() + i * sizeof( int ), sizeof( int ) );
+    return value;
+}
+
+static std::vector< unsigned char > decompress( std::vector< unsigned char > & compressed )
+{
+    RvlCompression rvl( width, height, RS2_FORMAT_Z16, 2 );
+    std::vector< unsigned char > decompressed( frame_size );
+    CHECK( rvl.decompressBuffer( compressed.data(), int( compressed.size() ), decompressed.data() ) == frame_size );
+    return decompressed;
+}
+
+
+TEST_CASE( "rvl sliced round trip", "[compression]" )
+{
+    auto frame = depth_frame();
+    for( int slices : { 2, 7, 16 } )
+    {
+        RvlCompression rvl( width, height, RS2_FORMAT_Z16, 2, slices );
+        auto compressed = compress( rvl, frame );
+        CHECK( header( compressed, 0 ) == int( RVL_SLICED_TAG | RVL_SLICED_VERSION ) );
+        CHECK( header( compressed, 1 ) == slices );
+        CHECK( compressed.size() < frame_size / 2 );
+        CHECK( decompress( compressed ) == frame );
+    }
+}
+
+TEST_CASE( "rvl legacy round trip", "[compression]" )
+{
+    auto frame = depth_frame();
+    RvlCompression rvl( width, height, RS2_FORMAT_Z16, 2, 1 );
+    auto compressed = compress( rvl, frame );
+
+    // The size of the words, then the words
+    CHECK( header( compressed, 0 ) == int( compressed.size() - sizeof( int ) ) );
+    CHECK( decompress( compressed ) == frame );
+}
+
+TEST_CASE( "rvl frames of an unknown version are rejected", "[compression]" )
+{
+    auto frame = depth_frame();
+    RvlCompression rvl( width, height, RS2_FORMAT_Z16, 2, 4 );
+    auto compressed = compress( rvl, frame );
+
+    int tag = int( RVL_SLICED_TAG | ( RVL_SLICED_VERSION + 1 ) );
+    memcpy( compressed.data(), &tag, sizeof( tag ) );
+    std::vector< unsigned char > decompressed( frame_size );
+    CHECK( rvl.decompressBuffer( compressed.data(), int( compressed.size() ), decompressed.data() ) == -1 );
+
+    // Nor is a frame cut short
+    tag = int( RVL_SLICED_TAG | RVL_SLICED_VERSION );
+    memcpy( compressed.data(), &tag, sizeof( tag ) );
+    CHECK( rvl.decompressBuffer( compressed.data(), int( compressed.size() ) - 4, decompressed.data() ) == -1 );
+}
@@ -0,0 +1,240 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include "../catch.h"
+
+#include <src/source.h>
+#include <src/stream.h>
+#include <src/metadata-parser.h>
+#include <src/metadata.h>
+#include <src/environment.h>
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+using namespace librealsense;
+
+
+// Metadata as the software device lays it out, for md_constant_parser: pairs of attribute and value
+static frame_additional_data make_metadata( std::map< rs2_frame_metadata_value, rs2_metadata_type > const & values )
+{
+    frame_additional_data data;
+    // Whatever is past the pairs is no attribute
+    data.metadata_blob.fill( 0xff );
+    for( auto & v : values )
+    {
+        memcpy( data.metadata_blob.data() + data.metadata_size, &v.first, sizeof( v.first ) );
+        data.metadata_size += sizeof( v.first );
+        memcpy( data.metadata_blob.data() + data.metadata_size, &v.second, sizeof( v.second ) );
+        data.metadata_size += sizeof( v.second );
+    }
+    return data;
+}
+
+static void check_metadata( frame_interface const & f, std::map< rs2_frame_metadata_value, rs2_metadata_type > const & expected )
+{
+    frame_metadata_values all;
+    f.get_all_frame_metadata( all );
+    CHECK( all.supported.count() == expected.size() );
+    for( int i = 0; i < ::RS2_FRAME_METADATA_COUNT; ++i )
+    {
+        auto md = rs2_frame_metadata_value( i );
+        CAPTURE( get_string( md ) );
+        auto it = expected.find( md );
+        bool supported = it != expected.end();
+        CHECK( all.supported[i] == supported );
+        CHECK( f.supports_frame_metadata( md ) == supported );
+        if( supported )
+        {
+            CHECK( all.values[i] == it->second );
+            CHECK( f.get_frame_metadata( md ) == it->second );
+        }
+        else
+        {
+            CHECK( all.values[i] == 0 );
+            CHECK_THROWS_AS( f.get_frame_metadata( md ), invalid_value_exception );
+        }
+    }
+}
+
+
+TEST_CASE( "all the metadata of a frame at once", "[metadata]" )
+{
+    // Normally set up by the context
+    environment::get_instance().set_time_service( std::make_shared< platform::os_time_service >() );
+
+    frame_source source( 0 );
+    source.init( md_constant_parser::create_metadata_parser_map() );
+    auto profile = std::make_shared< video_stream_profile >( platform::stream_profile{ 640, 480, 30, 0 } );
+    profile->set_stream_type( RS2_STREAM_DEPTH );
+
+    std::map< rs2_frame_metadata_value, rs2_metadata_type > const values = {
+        { RS2_FRAME_METADATA_FRAME_COUNTER, 1234 },
+        { RS2_FRAME_METADATA_ACTUAL_EXPOSURE, 8500 },
+        { RS2_FRAME_METADATA_GAIN_LEVEL, 16 },
+        { RS2_FRAME_METADATA_ACTUAL_FPS, 30 },
+        { RS2_FRAME_METADATA_SEQUENCE_SIZE, -1 },
+    };
+
+    SECTION( "published frames" )
+    {
+        frame_holder f( source.alloc_frame( RS2_EXTENSION_VIDEO_FRAME, 0, make_metadata( values ), true ) );
+        REQUIRE( f );
+        f->set_stream( profile );
+        check_metadata( *f.frame, values );
+        // Read from what was decoded the first time
+        check_metadata( *f.frame, values );
+
+        // Decoded again after a change
+        auto fr = dynamic_cast< frame * >( f.frame );
+        auto changed = values;
+        changed[RS2_FRAME_METADATA_GAIN_LEVEL] = 32;
+        fr->additional_data = make_metadata( changed );
+        fr->invalidate_metadata();
+        check_metadata( *f.frame, changed );
+    }
+
+    SECTION( "invalidated while read" )
+    {
+        frame_holder f( source.alloc_frame( RS2_EXTENSION_VIDEO_FRAME, 0, make_metadata( values ), true ) );
+        REQUIRE( f );
+        f->set_stream( profile );
+        auto fr = dynamic_cast< frame * >( f.frame );
+
+        // The metadata does not change, so the readers must never see anything else, in particular
+        // what a decoder has not filled yet
+        std::atomic< bool > done( false );
+        std::atomic< int > wrong( 0 );
+        std::vector< std::thread > readers;
+        for( int t = 0; t < 3; ++t )
+            readers.emplace_back( [&]() {
+                while( ! done )
+                {
+                    frame_metadata_values all;
+                    f->get_all_frame_metadata( all );
+                    if( all.values[RS2_FRAME_METADATA_GAIN_LEVEL] != 16 || all.supported.count() != values.size() )
+                        ++wrong;
+                    if( f->get_frame_metadata( RS2_FRAME_METADATA_ACTUAL_EXPOSURE ) != 8500 )
+                        ++wrong;
+                    if( ! f->supports_frame_metadata( RS2_FRAME_METADATA_FRAME_COUNTER ) )
+                        ++wrong;
+                }
+            } );
+        for( int i = 0; i < 20000; ++i )
+            fr->invalidate_metadata();
+        done = true;
+        for( auto & t : readers )
+            t.join();
+        CHECK( wrong == 0 );
+        check_metadata( *f.frame, values );
+    }
+
+    SECTION( "frames no archive owns" )
+    {
+        frame f;
+        f.additional_data = make_metadata( values );
+        f.metadata_parsers = md_constant_parser::create_metadata_parser_map();
+        f.set_stream( profile );
+        check_metadata( f, values );
+    }
+
+    SECTION( "frames without metadata" )
+    {
+        frame_holder f( source.alloc_frame( RS2_EXTENSION_VIDEO_FRAME, 0, make_metadata( {} ), true ) );
+        REQUIRE( f );
+        f->set_stream( profile );
+        check_metadata( *f.frame, {} );
+    }
+}
+
+
+// What the parsers give, one attribute at a time and the first of them that can
+static frame_metadata_values parse_metadata( frame const & f, metadata_parser_map const & parsers )
+{
+    frame_metadata_values expected{};
+    for( auto & p : parsers )
+    {
+        if( expected.supported[p.first] || ! p.second->supports( f ) )
+            continue;
+        try
+        {
+            expected.values[p.first] = p.second->get( f );
+            expected.supported.set( p.first );
+        }
+        catch( invalid_value_exception & )
+        {
+        }
+    }
+    return expected;
+}
+
+TEST_CASE( "metadata tables read the blob as the parsers do", "[metadata]" )
+{
+    environment::get_instance().set_time_service( std::make_shared< platform::os_time_service >() );
+
+    // As the D400 depth sensor registers them: fields of the UVC header and of md_depth_control,
+    // and parsers that cannot be fields
+    auto const offset = offsetof( metadata_raw, mode ) + offsetof( md_depth_mode, depth_y_mode )
+                      + offsetof( md_depth_y_normal_mode, intel_depth_control );
+    auto parsers = std::make_shared< metadata_parser_map >();
+    parsers->emplace( RS2_FRAME_METADATA_FRAME_TIMESTAMP, make_uvc_header_parser( &platform::uvc_header::timestamp ) );
+    parsers->emplace( RS2_FRAME_METADATA_GAIN_LEVEL, make_attribute_parser( &md_depth_control::manual_gain, md_depth_control_attributes::gain_attribute, offset ) );
+    parsers->emplace( RS2_FRAME_METADATA_ACTUAL_EXPOSURE, make_attribute_parser( &md_depth_control::manual_exposure, md_depth_control_attributes::exposure_attribute, offset ) );
+    parsers->emplace( RS2_FRAME_METADATA_FRAME_LASER_POWER_MODE, make_attribute_parser( &md_depth_control::emitterMode, md_depth_control_attributes::emitter_mode_attribute, offset,
+        []( const rs2_metadata_type & param ) { return param == 1 ? 1 : 0; } ) );
+    parsers->emplace( RS2_FRAME_METADATA_FRAME_LED_POWER, make_attribute_parser( &md_depth_control::ledPower, md_depth_control_attributes::led_power_attribute, offset ) );
+    parsers->emplace( RS2_FRAME_METADATA_ACTUAL_FPS, std::make_shared< md_constant_parser >( RS2_FRAME_METADATA_ACTUAL_FPS ) );
+    // A second parser for an attribute is used only when the first cannot
+    parsers->emplace( RS2_FRAME_METADATA_GAIN_LEVEL, std::make_shared< md_constant_parser >( RS2_FRAME_METADATA_GAIN_LEVEL ) );
+
+    metadata_parser_table const table( *parsers );
+    frame_source source( 0 );
+    source.init( parsers );
+    auto profile = std::make_shared< video_stream_profile >( platform::stream_profile{ 640, 480, 30, 0 } );
+    profile->set_stream_type( RS2_STREAM_DEPTH );
+
+    std::mt19937 gen( 7 );
+    std::uniform_int_distribution< int > byte( 0, 255 );
+    std::uniform_int_distribution< int > coin( 0, 1 );
+    // Around the sizes the parsers check
+    uint32_t const sizes[] = { 0, platform::uvc_header_size - 1u, platform::uvc_header_size,
+                               uint32_t( offset + sizeof( md_depth_control ) ), MAX_META_DATA_SIZE };
+    for( int i = 0; i < 500; ++i )
+    {
+        frame f;
+        f.metadata_parsers = parsers;
+        f.set_stream( profile );
+        auto & data = f.additional_data;
+        for( auto & b : data.metadata_blob )
+            b = uint8_t( byte( gen ) );
+        data.metadata_size = sizes[i % 5];
+
+        // Mostly a valid md_depth_control, with some of its flags
+        if( coin( gen ) || coin( gen ) )
+        {
+            md_header header = { md_type::META_DATA_INTEL_DEPTH_CONTROL_ID,
+                                 uint32_t( sizeof( md_depth_control ) - coin( gen ) ) };
+            memcpy( data.metadata_blob.data() + offset, &header, sizeof( header ) );
+            data.metadata_blob[offset + offsetof( md_depth_control, emitterMode )] = uint8_t( coin( gen ) + coin( gen ) );
+        }
+
+        CAPTURE( i );
+        auto expected = parse_metadata( f, *parsers );
+        frame_metadata_values all{};
+        table.decode( f, all );
+        CHECK( all.supported == expected.supported );
+        CHECK( all.values == expected.values );
+
+        // As published frames are decoded
+        frame_holder published( source.alloc_frame( RS2_EXTENSION_VIDEO_FRAME, 0, data, true ) );
+        REQUIRE( published );
+        published->set_stream( profile );
+        frame_metadata_values decoded{};
+        published->get_all_frame_metadata( decoded );
+        CHECK( decoded.supported == expected.supported );
+        CHECK( decoded.values == expected.values );
+    }
+}
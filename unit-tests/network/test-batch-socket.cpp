@@ -0,0 +1,201 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+//#cmake:add-file ../../src/ipDeviceCommon/RsBatchSocket.cpp
+
+#include "../catch.h"
+
+#ifdef __linux__
+
+#include <src/ipDeviceCommon/RsBatchSocket.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+
+// A UDP socket bound to a free port on the loopback interface
+struct loopback_socket
+{
+    int fd;
+    sockaddr_storage address;
+    socklen_t size;
+
+    loopback_socket()
+        : fd( socket( AF_INET, SOCK_DGRAM, 0 ) )
+        , address()
+        , size( sizeof( sockaddr_in ) )
+    {
+        REQUIRE( fd >= 0 );
+        auto & in = reinterpret_cast< sockaddr_in & >( address );
+        in.sin_family = AF_INET;
+        in.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        REQUIRE( bind( fd, reinterpret_cast< sockaddr * >( &address ), size ) == 0 );
+        REQUIRE( getsockname( fd, reinterpret_cast< sockaddr * >( &address ), &size ) == 0 );
+        int buffer = 1 << 20;
+        setsockopt( fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof( buffer ) );
+    }
+    ~loopback_socket() { close( fd ); }
+};
+
+// Packets laid out back to back, as RsBatchSender takes them; each is filled with its index
+struct packets
+{
+    std::vector< unsigned char > data;
+    std::vector< size_t > offsets;
+
+    explicit packets( std::vector< size_t > const & sizes )
+        : offsets( 1, 0 )
+    {
+        for( size_t i = 0; i < sizes.size(); i++ )
+        {
+            data.insert( data.end(), sizes[i], (unsigned char)i );
+            offsets.push_back( data.size() );
+        }
+    }
+    size_t count() const { return offsets.size() - 1; }
+};
+
+// Replaces the system calls of the sender, to fail GSO sends and send fewer packets than asked
+class test_sender : public RsBatchSender
+{
+public:
+    int gso_error = 0;            // Set by GSO sends, unless 0
+    unsigned max_messages = 0;    // Sent by a sendmmsg() call, unless 0
+    int segmented_sends = 0;
+    int message_sends = 0;
+
+protected:
+    ssize_t sendSegmented( int t_socket, msghdr const * t_message ) override
+    {
+        ++segmented_sends;
+        if( gso_error )
+        {
+            errno = gso_error;
+            return -1;
+        }
+        return RsBatchSender::sendSegmented( t_socket, t_message );
+    }
+
+    int sendMessages( int t_socket, mmsghdr * t_messages, unsigned t_count ) override
+    {
+        ++message_sends;
+        if( max_messages && t_count > max_messages )
+            t_count = max_messages;
+        return RsBatchSender::sendMessages( t_socket, t_messages, t_count );
+    }
+};
+
+// Receives count packets, or what arrives within a second, and checks they are the ones sent
+static void check_received( loopback_socket & s, packets const & sent )
+{
+    RsBatchReceiver receiver;
+    size_t received = 0;
+    while( received < sent.count() )
+    {
+        pollfd p = { s.fd, POLLIN, 0 };
+        if( poll( &p, 1, 1000 ) <= 0 )
+            break;
+        int n = receiver.receive( s.fd );
+        for( int i = 0; i < n && received < sent.count(); i++, received++ )
+        {
+            size_t size = sent.offsets[received + 1] - sent.offsets[received];
+            REQUIRE( receiver.size( i ) == size );
+            CHECK_FALSE( receiver.truncated( i ) );
+            CHECK( std::memcmp( receiver.packet( i ), &sent.data[sent.offsets[received]], size ) == 0 );
+        }
+    }
+    CHECK( received == sent.count() );
+    CHECK( receiver.receive( s.fd ) == 0 );
+}
+
+static bool send( RsBatchSender & sender, loopback_socket & s, packets const & p )
+{
+    return sender.send( s.fd, s.address, s.size, p.data.data(), p.offsets.data(), p.count() );
+}
+
+
+TEST_CASE( "batch socket sends and receives over loopback", "[network]" )
+{
+    loopback_socket s;
+
+    // Runs of equal packets, one ending with a shorter packet, and growing packets that go on
+    // their own
+    std::vector< size_t > sizes( 10, 1000 );
+    sizes.push_back( 300 );
+    sizes.insert( sizes.end(), 3, 500 );
+    sizes.push_back( 1200 );
+    sizes.push_back( 1300 );
+    packets p( sizes );
+
+    SECTION( "runs of equal packets go out in single sends" )
+    {
+        test_sender sender;
+        REQUIRE( send( sender, s, p ) );
+        check_received( s, p );
+        // Two GSO sends and the two packets on their own, unless this kernel can't segment UDP
+        // and the first GSO send fell back to sendmmsg(), as does everything after it
+        if( sender.usesGso() )
+            CHECK( sender.segmented_sends == 2 );
+        else
+            CHECK( sender.segmented_sends == 1 );
+        CHECK( sender.message_sends == 2 );
+    }
+
+    SECTION( "GSO that is not supported falls back to sendmmsg" )
+    {
+        test_sender sender;
+        sender.gso_error = EIO;
+        REQUIRE( send( sender, s, p ) );
+        check_received( s, p );
+        CHECK_FALSE( sender.usesGso() );
+        CHECK( sender.segmented_sends == 1 );
+
+        // And is not tried again
+        REQUIRE( send( sender, s, p ) );
+        check_received( s, p );
+        CHECK( sender.segmented_sends == 1 );
+        CHECK( sender.message_sends == 3 );
+    }
+
+    SECTION( "GSO sends that fail for other reasons are errors" )
+    {
+        test_sender sender;
+        sender.gso_error = EPERM;
+        CHECK_FALSE( send( sender, s, p ) );
+        CHECK( errno == EPERM );
+        CHECK( sender.usesGso() );
+        CHECK( sender.message_sends == 0 );
+    }
+
+    SECTION( "sendmmsg sending fewer packets than asked is resumed" )
+    {
+        test_sender sender;
+        sender.gso_error = EINVAL;
+        sender.max_messages = 3;
+        REQUIRE( send( sender, s, p ) );
+        check_received( s, p );
+        // The 11 packets of the failed GSO send, then the 5 left
+        CHECK( sender.message_sends == 4 + 2 );
+    }
+
+    SECTION( "packets longer than the receive buffer are truncated" )
+    {
+        packets big( std::vector< size_t >{ RS_BATCH_RECEIVE_PACKET_SIZE + 100 } );
+        test_sender sender;
+        REQUIRE( send( sender, s, big ) );
+        pollfd poll_s = { s.fd, POLLIN, 0 };
+        REQUIRE( poll( &poll_s, 1, 1000 ) == 1 );
+        RsBatchReceiver receiver;
+        REQUIRE( receiver.receive( s.fd ) == 1 );
+        CHECK( receiver.truncated( 0 ) );
+    }
+}
+
+#endif
@@ -0,0 +1,154 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+//#cmake:include-dir ../../src ../../src/ipDeviceCommon ../../src/ethernet
+
+#include "../catch.h"
+
+#ifdef __linux__
+
+#include <src/ethernet/rs_rtp_stream.hh>
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+
+// A frame in a buffer of the memory pool, laid out as the RTP sink hands it to the callback: the
+// network header, the metadata and the pixels. The frame number goes in the timestamp
+static void queue_frame( rs_rtp_stream & stream, int number )
+{
+    auto mem = rs_rtp_stream::get_memory_pool().getNextMem( 1024 );
+    auto buffer = reinterpret_cast< char * >( mem ) + sizeof( RsNetworkHeader );
+    reinterpret_cast< RsMetadataHeader * >( buffer )->data.timestamp = number;
+    stream.insert_frame( Raw_Frame( buffer, 1024 - int( sizeof( RsNetworkHeader ) ), timeval() ) );
+}
+
+static int buffers_in_use()
+{
+    return rs_rtp_stream::get_memory_pool().getStatistics().inUse;
+}
+
+// Takes the frames of a stream until it is stopped, as the injecting thread of ip_device does,
+// and releases them as the software sensor does
+class consumer
+{
+    rs_rtp_stream & _stream;
+    std::mutex _mutex;
+    std::vector< int > _received;
+    std::promise< void > _done;
+    std::thread _thread;
+
+public:
+    explicit consumer( rs_rtp_stream & stream )
+        : _stream( stream )
+    {
+        _thread = std::thread( [this]() {
+            Raw_Frame frame;
+            while( _stream.extract_frame( frame ) )
+            {
+                {
+                    std::lock_guard< std::mutex > lock( _mutex );
+                    _received.push_back( int( frame.m_metadata->data.timestamp ) );
+                }
+                _stream.frame_data_buff.deleter( frame.m_buffer );
+            }
+            _done.set_value();
+        } );
+    }
+    ~consumer()
+    {
+        _stream.stop();
+        if( _thread.joinable() )
+            _thread.join();
+    }
+
+    std::vector< int > received()
+    {
+        std::lock_guard< std::mutex > lock( _mutex );
+        return _received;
+    }
+
+    // Waits up to a second for count frames
+    bool wait_for( size_t count )
+    {
+        for( int i = 0; i < 100 && received().size() < count; ++i )
+            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        return received().size() >= count;
+    }
+
+    // Whether extract_frame() returned within a second
+    bool stopped()
+    {
+        if( _done.get_future().wait_for( std::chrono::seconds( 1 ) ) != std::future_status::ready )
+            return false;
+        _thread.join();
+        return true;
+    }
+};
+
+TEST_CASE( "rtp stream delivers frames to a waiting thread", "[network]" )
+{
+    int const in_use = buffers_in_use();
+    rs2_video_stream video = {};
+    rs_rtp_stream stream( video, rs2::stream_profile() );
+    stream.start();
+
+    consumer c( stream );
+
+    // Frames that come one at a time, each to a consumer that sleeps until it arrives, then in bursts
+    std::vector< int > expected;
+    for( int n = 0; n < 5; ++n )
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+        queue_frame( stream, n );
+        expected.push_back( n );
+        REQUIRE( c.wait_for( expected.size() ) );
+    }
+    for( int n = 5; n < 25; ++n )
+    {
+        queue_frame( stream, n );
+        expected.push_back( n );
+    }
+    REQUIRE( c.wait_for( expected.size() ) );
+    CHECK( c.received() == expected );
+    CHECK( stream.queue_size() == 0 );
+
+    // The consumer waits for the next frame, and stop() wakes it up
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    stream.stop();
+    CHECK( c.stopped() );
+    CHECK( buffers_in_use() == in_use );
+}
+
+TEST_CASE( "rtp stream returns the frames it does not deliver", "[network]" )
+{
+    int const in_use = buffers_in_use();
+    rs2_video_stream video = {};
+    rs_rtp_stream stream( video, rs2::stream_profile() );
+
+    // Not started yet
+    queue_frame( stream, 0 );
+    CHECK( stream.queue_size() == 0 );
+    CHECK( buffers_in_use() == in_use );
+
+    // Past the queue size, frames are dropped
+    stream.start();
+    for( int n = 0; n < RTP_QUEUE_MAX_SIZE + 10; ++n )
+        queue_frame( stream, n );
+    CHECK( stream.queue_size() == RTP_QUEUE_MAX_SIZE + 1 );
+    CHECK( buffers_in_use() == in_use + RTP_QUEUE_MAX_SIZE + 1 );
+
+    // Once stopped, the frames left are not delivered; the new ones go straight back to the pool
+    stream.stop();
+    Raw_Frame frame;
+    CHECK_FALSE( stream.extract_frame( frame ) );
+    queue_frame( stream, 0 );
+    stream.reset_queue();
+    CHECK( stream.queue_size() == 0 );
+    CHECK( buffers_in_use() == in_use );
+}
+
+#endif
@@ -0,0 +1,114 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <src/proc/synthetic-stream.h>
+#include <src/source.h>
+#include <src/stream.h>
+#include <src/image.h>
+#include <src/environment.h>
+#include <src/cpu-features.h>
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+
+// Feeds images to a processing block, one frame at a time as a sensor would, and keeps what comes out
+template< class Filter >
+class filter_runner
+{
+    librealsense::frame_source _source;
+    Filter _filter;
+    std::shared_ptr< librealsense::video_stream_profile > _profile;
+    rs2_extension _frame_type;
+    int _bpp;
+    librealsense::frame_holder _result;
+    std::shared_ptr< librealsense::stream_profile_interface > _output_profile;
+
+public:
+    filter_runner( int width, int height, rs2_format format, rs2_stream stream = RS2_STREAM_DEPTH )
+        : _source( 0 )
+        , _bpp( librealsense::get_image_bpp( format ) / 8 )
+    {
+        using namespace librealsense;
+
+        // Normally set up by the context
+        environment::get_instance().set_time_service( std::make_shared< platform::os_time_service >() );
+
+        _source.init( nullptr );
+        _profile = std::make_shared< video_stream_profile >( platform::stream_profile{ uint32_t( width ), uint32_t( height ), 30, 0 } );
+        _profile->set_unique_id( 1 );
+        _profile->set_stream_type( stream );
+        _profile->set_format( format );
+        _profile->set_framerate( 30 );
+        _profile->set_dims( width, height );
+        _profile->set_intrinsics( [=]() {
+            return rs2_intrinsics{ width, height, width / 2.f, height / 2.f, 600.f, 600.f, RS2_DISTORTION_NONE, { 0 } };
+        } );
+
+        if( format == RS2_FORMAT_DISPARITY32 )
+            _frame_type = RS2_EXTENSION_DISPARITY_FRAME;
+        else if( stream == RS2_STREAM_DEPTH )
+            _frame_type = RS2_EXTENSION_DEPTH_FRAME;
+        else
+            _frame_type = RS2_EXTENSION_VIDEO_FRAME;
+
+        auto on_frame = [this]( frame_interface * f ) {
+            _result = frame_holder( f );
+        };
+        _filter.set_output_callback( std::make_shared< internal_frame_callback< decltype( on_frame ) > >( on_frame ) );
+    }
+
+    Filter & filter() { return _filter; }
+
+    // Of the last frame that came out
+    std::shared_ptr< librealsense::stream_profile_interface > const & output_profile() const { return _output_profile; }
+
+    // The output image, of height * stride bytes; ms is the time the block took
+    template< class T >
+    std::vector< T > process( std::vector< T > const & image, double & ms )
+    {
+        using namespace librealsense;
+
+        frame_additional_data data;
+        auto f = _source.alloc_frame( _frame_type, image.size() * sizeof( T ), data, true );
+        f->set_stream( _profile );
+        auto vf = dynamic_cast< video_frame * >( f );
+        vf->assign( _profile->get_width(), _profile->get_height(), _profile->get_width() * _bpp, _bpp * 8 );
+        memcpy( (void *)f->get_frame_data(), image.data(), image.size() * sizeof( T ) );
+
+        auto start = std::chrono::high_resolution_clock::now();
+        _filter.invoke( frame_holder( f ) );
+        ms = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+
+        REQUIRE( _result.frame );
+        auto out = dynamic_cast< video_frame * >( _result.frame );
+        REQUIRE( out );
+        auto begin = reinterpret_cast< const T * >( out->get_frame_data() );
+        std::vector< T > result( begin, begin + out->get_height() * out->get_stride() / sizeof( T ) );
+        _output_profile = out->get_stream();
+        _result = frame_holder();
+        return result;
+    }
+
+    template< class T >
+    std::vector< T > process( std::vector< T > const & image )
+    {
+        double ms;
+        return process( image, ms );
+    }
+};
+
+// Returns f(), computed without the vectorized code paths: the reference they must match
+template< class F >
+auto scalar_code( F f ) -> decltype( f() )
+{
+    struct restore_limit
+    {
+        librealsense::simd_level previous;
+        ~restore_limit() { librealsense::set_simd_limit( previous ); }
+    } restore{ librealsense::set_simd_limit( librealsense::simd_level::scalar ) };
+    return f();
+}
@@ -0,0 +1,201 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// The scalar, single-threaded temporal filter as it was before vectorization: the output of the
+// library must stay identical to it, bit for bit
+struct reference_temporal_filter
+{
+    uint8_t _persistence_param;
+    float _alpha_param;
+    float _one_minus_alpha;
+    uint8_t _delta_param;
+    size_t _current_frm_size_pixels;
+    uint8_t _cur_frame_index = 0;
+    std::array< uint8_t, 256 > _persistence_map;
+
+    template<typename T>
+    void temp_jw_smooth(void* frame_data, void * _last_frame_data, uint8_t *history)
+    {
+        static_assert((std::is_arithmetic<T>::value), "temporal filter assumes numeric types");
+
+        T delta_z = static_cast<T>(_delta_param);
+
+        auto frame          = reinterpret_cast<T*>(frame_data);
+        auto _last_frame    = reinterpret_cast<T*>(_last_frame_data);
+
+        unsigned char mask = 1 << _cur_frame_index;
+
+        // pass one -- go through image and update all
+        for (size_t i = 0; i < _current_frm_size_pixels; i++)
+        {
+            T cur_val = frame[i];
+            T prev_val = _last_frame[i];
+
+            if (cur_val)
+            {
+                if (!prev_val)
+                {
+                    _last_frame[i] = cur_val;
+                    history[i] = mask;
+                }
+                else
+                {  // old and new val
+                    T diff = static_cast<T>(fabs(cur_val - prev_val));
+
+                    if (diff < delta_z)
+                    {  // old and new val agree
+                        history[i] |= mask;
+                        float filtered = _alpha_param * cur_val + _one_minus_alpha * prev_val;
+                        T result = static_cast<T>(filtered);
+                        frame[i] = result;
+                        _last_frame[i] = result;
+                    }
+                    else
+                    {
+                        _last_frame[i] = cur_val;
+                        history[i] = mask;
+                    }
+                }
+            }
+            else
+            {  // no cur_val
+                if (prev_val)
+                { // only case we can help
+                    unsigned char hist = history[i];
+                    unsigned char classification = _persistence_map[hist];
+                    if (classification & mask)
+                    { // we have had enough samples lately
+                        frame[i] = prev_val;
+                    }
+                }
+                history[i] &= ~mask;
+            }
+        }
+
+        _cur_frame_index = (_cur_frame_index + 1) % 8;  // at end of cycle
+    }
+
+    void recalc_persistence_map()
+    {
+        _persistence_map.fill(0);
+
+        for (size_t i = 0; i < _persistence_map.size(); i++)
+        {
+            unsigned char last_7 = !!(i & 1);  // old
+            unsigned char last_6 = !!(i & 2);
+            unsigned char last_5 = !!(i & 4);
+            unsigned char last_4 = !!(i & 8);
+            unsigned char last_3 = !!(i & 16);
+            unsigned char last_2 = !!(i & 32);
+            unsigned char last_1 = !!(i & 64);
+            unsigned char lastFrame = !!(i & 128); // new
+
+            if (_persistence_param == 1)
+            {
+                int sum = lastFrame + last_1 + last_2 + last_3 + last_4 + last_5 + last_6 + last_7;
+                if (sum >= 8)  // valid in eight of the last eight frames
+                    _persistence_map[i] = 1;
+            }
+            else if (_persistence_param == 2) // <--- default choice in current libRS implementation
+            {
+                int sum = lastFrame + last_1 + last_2;
+                if (sum >= 2) // valid in two of the last three frames
+                    _persistence_map[i] = 1;
+            }
+            else if (_persistence_param == 3) // <--- default choice recommended
+            {
+                int sum = lastFrame + last_1 + last_2 + last_3;
+                if (sum >= 2)  // valid in two of the last four frames
+                    _persistence_map[i] = 1;
+            }
+            else if (_persistence_param == 4)
+            {
+                int sum = lastFrame + last_1 + last_2 + last_3 + last_4 + last_5 + last_6 + last_7;
+                if (sum >= 2) // valid in two of the last eight frames
+                    _persistence_map[i] = 1;
+            }
+            else if (_persistence_param == 5)
+            {
+                int sum = lastFrame + last_1;
+                if (sum >= 1) // valid in one of the last two frames
+                    _persistence_map[i] = 1;
+            }
+            else if (_persistence_param == 6)
+            {
+                int sum = lastFrame + last_1 + last_2 + last_3 + last_4;
+                if (sum >= 1)  // valid in one of the last five frames
+                    _persistence_map[i] = 1;
+            }
+            else if (_persistence_param == 7) //  <--- most filling
+            {
+                int sum = lastFrame + last_1 + last_2 + last_3 + last_4 + last_5 + last_6 + last_7;
+                if (sum >= 1) // valid in one of the last eight frames
+                    _persistence_map[i] = 1;
+            }
+            else if (_persistence_param == 8) //  <--- all 1's
+            {
+                _persistence_map[i] = 1;
+            }
+            else // all others, including 0, no persistance
+            {
+            }
+        }
+
+        // Convert to credible enough
+        std::array<uint8_t, 256> credible_threshold;
+        credible_threshold.fill(0);
+
+        for (auto phase = 0; phase < 8; phase++)
+        {
+            // evaluating last phase
+            //int ephase = (phase + 7) % 8;
+            unsigned char mask = 1 << phase;
+            int i;
+
+            for (i = 0; i < 256; i++) {
+                unsigned char pos = (unsigned char)((i << (8 - phase)) | (i >> phase));
+                if (_persistence_map[pos])
+                    credible_threshold[i] |= mask;
+            }
+        }
+        // Store results
+        _persistence_map = credible_threshold;
+    }
+};
+
+// Runs a sequence of frames through the scalar reference, the same way the block does
+template< class T >
+class reference_sequence
+{
+    reference_temporal_filter _ref;
+    std::vector< T > _last_frame;
+    std::vector< uint8_t > _history;
+
+public:
+    reference_sequence( size_t pixels, uint8_t persistence, float alpha, uint8_t delta )
+        : _last_frame( pixels ), _history( pixels )
+    {
+        _ref._persistence_param = persistence;
+        _ref._alpha_param = alpha;
+        _ref._one_minus_alpha = 1.f - alpha;
+        _ref._delta_param = delta;
+        _ref._current_frm_size_pixels = pixels;
+        _ref.recalc_persistence_map();
+    }
+
+    std::vector< T > process( std::vector< T > frame )
+    {
+        _ref.temp_jw_smooth< T >( frame.data(), _last_frame.data(), _history.data() );
+        return frame;
+    }
+};
+
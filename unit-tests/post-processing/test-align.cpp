@@ -0,0 +1,335 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/rsutil.h>
+#include <librealsense2/hpp/rs_internal.hpp>
+#include <src/cpu-features.h>
+#include <src/proc/synthetic-stream.h>
+#include <src/proc/align.h>
+#ifdef __SSSE3__
+#include <src/proc/sse/sse-align.h>
+#include <src/proc/avx/avx-align.h>
+#endif
+#ifdef __ARM_NEON
+#include <src/proc/neon/neon-align.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace librealsense;
+
+
+// The per-pixel align as it was before the ray tables: the output of the blocks must stay
+// identical to it
+template< class TRANSFER_PIXEL >
+void reference_align_images( const rs2_intrinsics & depth_intrin, const rs2_extrinsics & depth_to_other,
+                             const rs2_intrinsics & other_intrin, const uint16_t * z_pixels, float z_scale,
+                             TRANSFER_PIXEL transfer_pixel )
+{
+    for( int depth_y = 0; depth_y < depth_intrin.height; ++depth_y )
+    {
+        int depth_pixel_index = depth_y * depth_intrin.width;
+        for( int depth_x = 0; depth_x < depth_intrin.width; ++depth_x, ++depth_pixel_index )
+        {
+            if( float depth = z_scale * z_pixels[depth_pixel_index] )
+            {
+                float depth_pixel[2] = { depth_x - 0.5f, depth_y - 0.5f }, depth_point[3], other_point[3], other_pixel[2];
+                rs2_deproject_pixel_to_point( depth_point, &depth_intrin, depth_pixel, depth );
+                rs2_transform_point_to_point( other_point, &depth_to_other, depth_point );
+                rs2_project_point_to_pixel( other_pixel, &other_intrin, other_point );
+                const int other_x0 = static_cast< int >( other_pixel[0] + 0.5f );
+                const int other_y0 = static_cast< int >( other_pixel[1] + 0.5f );
+
+                depth_pixel[0] = depth_x + 0.5f; depth_pixel[1] = depth_y + 0.5f;
+                rs2_deproject_pixel_to_point( depth_point, &depth_intrin, depth_pixel, depth );
+                rs2_transform_point_to_point( other_point, &depth_to_other, depth_point );
+                rs2_project_point_to_pixel( other_pixel, &other_intrin, other_point );
+                const int other_x1 = static_cast< int >( other_pixel[0] + 0.5f );
+                const int other_y1 = static_cast< int >( other_pixel[1] + 0.5f );
+
+                if( other_x0 < 0 || other_y0 < 0 || other_x1 >= other_intrin.width || other_y1 >= other_intrin.height )
+                    continue;
+
+                for( int y = other_y0; y <= other_y1; ++y )
+                    for( int x = other_x0; x <= other_x1; ++x )
+                        transfer_pixel( depth_pixel_index, y * other_intrin.width + x );
+            }
+        }
+    }
+}
+
+// The vectorized blocks available on this CPU
+std::vector< std::shared_ptr< align > > make_backends( rs2_stream to )
+{
+    std::vector< std::shared_ptr< align > > backends;
+#ifdef __SSSE3__
+    if( cpu_has_avx2() )
+        backends.push_back( std::make_shared< align_avx2 >( to ) );
+#endif
+#ifdef __ARM_NEON
+    backends.push_back( std::make_shared< align_neon >( to ) );
+#endif
+    return backends;
+}
+
+rs2::filter wrap( std::shared_ptr< align > block )
+{
+    return rs2::filter( std::shared_ptr< rs2_processing_block >( new rs2_processing_block( block ), rs2_delete_processing_block ) );
+}
+
+// A bumpy surface with a fifth of the pixels missing
+std::vector< uint16_t > make_depth( int width, int height, unsigned seed )
+{
+    std::mt19937 gen( seed );
+    std::normal_distribution< float > noise( 0.f, 20.f );
+    std::uniform_int_distribution< int > percent( 0, 99 );
+
+    std::vector< uint16_t > depth( width * height );
+    for( int y = 0; y < height; ++y )
+        for( int x = 0; x < width; ++x )
+        {
+            float z = 900.f + 3.f * x + 300.f * std::sin( y * 0.05f ) + noise( gen );
+            depth[y * width + x] = percent( gen ) < 20 ? 0 : uint16_t( z );
+        }
+    return depth;
+}
+
+// Depth and color frames of a software device, with the color camera 15mm to the side and slightly
+// rotated, bundled into framesets
+class depth_color_source
+{
+    rs2::software_device _dev;
+    rs2::software_sensor _depth_sensor;
+    rs2::software_sensor _color_sensor;
+    rs2::stream_profile _depth_profile;
+    rs2::stream_profile _color_profile;
+    rs2::frame_queue _depth_queue;
+    rs2::frame_queue _color_queue;
+    int _width, _height;
+    int _color_width, _color_height;
+    int _frame_number = 0;
+
+public:
+    rs2_intrinsics depth_intrinsics, color_intrinsics;
+    rs2_extrinsics depth_to_color;
+    std::vector< uint8_t > color;
+
+    depth_color_source( int width, int height, rs2_distortion depth_model, int color_width, int color_height,
+                        rs2_distortion color_model, float ppx_offset = 3.5f )
+        : _depth_sensor( _dev.add_sensor( "Depth" ) )
+        , _color_sensor( _dev.add_sensor( "Color" ) )
+        , _depth_queue( 10, true )
+        , _color_queue( 10, true )
+        , _width( width )
+        , _height( height )
+        , _color_width( color_width )
+        , _color_height( color_height )
+        , color( color_width * color_height * 3 )
+    {
+        depth_intrinsics = { width, height, width / 2.f + ppx_offset, height / 2.f - 2.25f, 0.75f * width, 0.75f * width,
+                             depth_model, { 0.11f, -0.23f, 0.0012f, -0.0009f, 0.07f } };
+        color_intrinsics = { color_width, color_height, color_width / 2.f - 1.5f, color_height / 2.f + 4.75f,
+                             0.7f * color_width, 0.7f * color_width, color_model, { -0.05f, 0.06f, -0.0007f, 0.0011f, -0.02f } };
+        if( color_model == RS2_DISTORTION_KANNALA_BRANDT4 )
+            color_intrinsics.coeffs[4] = 0.f;
+        depth_to_color = { { 0.9998f, 0.0174f, -0.0052f,
+                             -0.0175f, 0.9998f, -0.0087f,
+                             0.0050f, 0.0088f, 0.9999f },
+                           { 0.015f, -0.0002f, 0.0004f } };
+
+        std::mt19937 gen( color_width );
+        std::uniform_int_distribution< int > byte( 0, 255 );
+        for( auto & c : color )
+            c = uint8_t( byte( gen ) );
+
+        _depth_profile = _depth_sensor.add_video_stream( { RS2_STREAM_DEPTH, 0, 0, width, height, 30, 2, RS2_FORMAT_Z16, depth_intrinsics } );
+        _color_profile = _color_sensor.add_video_stream( { RS2_STREAM_COLOR, 0, 1, color_width, color_height, 30, 3, RS2_FORMAT_RGB8, color_intrinsics } );
+        _depth_sensor.add_read_only_option( RS2_OPTION_DEPTH_UNITS, 0.001f );
+        _depth_profile.register_extrinsics_to( _color_profile, depth_to_color );
+
+        _depth_sensor.open( _depth_profile );
+        _depth_sensor.start( _depth_queue );
+        _color_sensor.open( _color_profile );
+        _color_sensor.start( _color_queue );
+    }
+
+    rs2::frameset get( std::vector< uint16_t > & depth )
+    {
+        ++_frame_number;
+        _depth_sensor.on_video_frame( { depth.data(), []( void * ) {}, _width * 2, 2, rs2_time_t( _frame_number ),
+                                        RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, _frame_number, _depth_profile } );
+        _color_sensor.on_video_frame( { color.data(), []( void * ) {}, _color_width * 3, 3, rs2_time_t( _frame_number ),
+                                        RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, _frame_number, _color_profile } );
+        std::vector< rs2::frame > frames = { _depth_queue.wait_for_frame(), _color_queue.wait_for_frame() };
+
+        rs2::frame_queue bundled( 1, true );
+        rs2::processing_block bundle( [&]( rs2::frame, const rs2::frame_source & source ) {
+            source.frame_ready( source.allocate_composite_frame( frames ) );
+        } );
+        bundle.start( bundled );
+        bundle.invoke( frames.front() );
+        return bundled.wait_for_frame();
+    }
+
+    // The depth in the color image
+    std::vector< uint16_t > expected_depth( std::vector< uint16_t > const & depth )
+    {
+        std::vector< uint16_t > out( _color_width * _color_height, 0 );
+        reference_align_images( depth_intrinsics, depth_to_color, color_intrinsics, depth.data(), 0.001f,
+                                [&]( int z, int other ) { out[other] = out[other] ? std::min( out[other], depth[z] ) : depth[z]; } );
+        return out;
+    }
+
+    // The color in the depth image
+    std::vector< uint8_t > expected_color( std::vector< uint16_t > const & depth )
+    {
+        std::vector< uint8_t > out( _width * _height * 3, 0 );
+        reference_align_images( depth_intrinsics, depth_to_color, color_intrinsics, depth.data(), 0.001f,
+                                [&]( int z, int other ) { std::copy( &color[other * 3], &color[other * 3 + 3], &out[z * 3] ); } );
+        return out;
+    }
+};
+
+template< class T >
+size_t count_mismatches( rs2::frameset aligned, rs2_stream stream, std::vector< T > const & expected )
+{
+    auto f = aligned.first( stream ).as< rs2::video_frame >();
+    REQUIRE( f );
+    REQUIRE( size_t( f.get_height() * f.get_stride_in_bytes() ) == expected.size() * sizeof( T ) );
+    auto actual = reinterpret_cast< const T * >( f.get_data() );
+    size_t mismatches = 0;
+    for( size_t i = 0; i < expected.size(); ++i )
+        if( actual[i] != expected[i] )
+            ++mismatches;
+    return mismatches;
+}
+
+TEST_CASE( "align matches the per-pixel implementation", "[post-processing]" )
+{
+    for( auto depth_model : { RS2_DISTORTION_BROWN_CONRADY, RS2_DISTORTION_INVERSE_BROWN_CONRADY, RS2_DISTORTION_NONE } )
+    {
+        for( auto color_model : { RS2_DISTORTION_NONE, RS2_DISTORTION_BROWN_CONRADY, RS2_DISTORTION_MODIFIED_BROWN_CONRADY,
+                                  RS2_DISTORTION_INVERSE_BROWN_CONRADY, RS2_DISTORTION_KANNALA_BRANDT4 } )
+        {
+            // Odd width: the rows are not a multiple of the vector size
+            for( int width : { 848, 853 } )
+            {
+                int const height = 61;
+                CAPTURE( rs2_distortion_to_string( depth_model ), rs2_distortion_to_string( color_model ), width );
+
+                depth_color_source source( width, height, depth_model, 1280, 720, color_model );
+                auto depth = make_depth( width, height, unsigned( width ) );
+                auto expected_depth = source.expected_depth( depth );
+                auto expected_color = source.expected_color( depth );
+
+                auto to_color = make_backends( RS2_STREAM_COLOR );
+                to_color.insert( to_color.begin(), std::make_shared< align >( RS2_STREAM_COLOR ) );
+                for( auto & backend : to_color )
+                {
+                    CAPTURE( backend->get_info( RS2_CAMERA_INFO_NAME ) );
+                    auto block = wrap( backend );
+                    // Twice: the second frame reuses the rays of the first. Exact, also on ARM, where the
+                    // build turns off FMA contraction for that
+                    for( int i = 0; i < 2; ++i )
+                        CHECK( count_mismatches( block.process( source.get( depth ) ), RS2_STREAM_DEPTH, expected_depth ) == 0 );
+                }
+
+                auto to_depth = make_backends( RS2_STREAM_DEPTH );
+                to_depth.insert( to_depth.begin(), std::make_shared< align >( RS2_STREAM_DEPTH ) );
+                for( auto & backend : to_depth )
+                {
+                    CAPTURE( backend->get_info( RS2_CAMERA_INFO_NAME ) );
+                    auto block = wrap( backend );
+                    for( int i = 0; i < 2; ++i )
+                        CHECK( count_mismatches( block.process( source.get( depth ) ), RS2_STREAM_COLOR, expected_color ) == 0 );
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE( "align rebuilds its rays for new depth intrinsics", "[post-processing]" )
+{
+    int const width = 640, height = 48;
+    auto depth = make_depth( width, height, 5 );
+
+    auto blocks = make_backends( RS2_STREAM_COLOR );
+    blocks.insert( blocks.begin(), std::make_shared< align >( RS2_STREAM_COLOR ) );
+    for( auto & backend : blocks )
+    {
+        CAPTURE( backend->get_info( RS2_CAMERA_INFO_NAME ) );
+        auto block = wrap( backend );
+
+        // The same resolution, from another camera
+        for( float ppx_offset : { 3.5f, -20.f, 3.5f } )
+        {
+            depth_color_source source( width, height, RS2_DISTORTION_INVERSE_BROWN_CONRADY, 1280, 720,
+                                       RS2_DISTORTION_BROWN_CONRADY, ppx_offset );
+            CHECK( count_mismatches( block.process( source.get( depth ) ), RS2_STREAM_DEPTH, source.expected_depth( depth ) ) == 0 );
+        }
+    }
+}
+
+// Run it with "[!benchmark]"; compares each backend with the per-pixel align on this CPU
+TEST_CASE( "align ms/frame", "[!benchmark]" )
+{
+    int const width = 1280, height = 720, frames = 20;
+    depth_color_source source( width, height, RS2_DISTORTION_BROWN_CONRADY, 1920, 1080, RS2_DISTORTION_INVERSE_BROWN_CONRADY );
+    auto depth = make_depth( width, height, 3 );
+
+    for( auto to : { RS2_STREAM_COLOR, RS2_STREAM_DEPTH } )
+    {
+        auto blocks = make_backends( to );
+#ifdef __SSSE3__
+        blocks.insert( blocks.begin(), std::make_shared< align_sse >( to ) );
+#endif
+        blocks.insert( blocks.begin(), std::make_shared< align >( to ) );
+
+        double reference_total = 0;
+        for( int i = 0; i < frames / 4; ++i )
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            if( to == RS2_STREAM_COLOR )
+                source.expected_depth( depth );
+            else
+                source.expected_color( depth );
+            reference_total += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+        }
+        std::cout << width << "x" << height << " to " << rs2_stream_to_string( to ) << " per pixel: "
+                  << reference_total / ( frames / 4 ) << " ms/frame" << std::endl;
+
+        for( auto & backend : blocks )
+        {
+            // The first frame also prepares the block for its intrinsics
+            auto block = wrap( backend );
+            block.process( source.get( depth ) );
+
+            double total = 0;
+            for( int i = 0; i < frames; ++i )
+            {
+                auto fs = source.get( depth );
+                auto start = std::chrono::high_resolution_clock::now();
+                block.process( fs );
+                total += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+            }
+            std::cout << width << "x" << height << " to " << rs2_stream_to_string( to ) << " "
+                      << backend->get_info( RS2_CAMERA_INFO_NAME ) << ": " << total / frames << " ms/frame" << std::endl;
+        }
+    }
+}
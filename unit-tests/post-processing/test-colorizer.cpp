@@ -0,0 +1,260 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+#include <src/proc/synthetic-stream.h>
+#include <src/proc/colorizer.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+
+// The per-pixel Z16 colorization as it was before the lookup tables: the output of the block must
+// stay identical to it, bit for bit
+struct reference_colorizer : librealsense::colorizer
+{
+    template<typename T, typename F>
+    void make_rgb_data(const T* depth_data, uint8_t* rgb_data, int width, int height, F coloring_func)
+    {
+        auto cm = _maps[_map_index];
+        for (auto i = 0; i < width*height; ++i)
+        {
+            auto d = depth_data[i];
+            colorize_pixel(rgb_data, i, cm, d, coloring_func);
+        }
+    }
+
+    template<typename T, typename F>
+    void colorize_pixel(uint8_t* rgb_data, int idx, librealsense::color_map* cm, T data, F coloring_func)
+    {
+        if (data)
+        {
+            auto f = coloring_func(data); // 0-255 based on histogram locationcolorize_pixel
+            auto c = cm->get(f);
+            rgb_data[idx * 3 + 0] = (uint8_t)c.x;
+            rgb_data[idx * 3 + 1] = (uint8_t)c.y;
+            rgb_data[idx * 3 + 2] = (uint8_t)c.z;
+        }
+        else
+        {
+            rgb_data[idx * 3 + 0] = 0;
+            rgb_data[idx * 3 + 1] = 0;
+            rgb_data[idx * 3 + 2] = 0;
+        }
+    }
+
+    // RGB8
+    std::vector< uint8_t > colorize( std::vector< uint16_t > const & depth, int w, int h,
+                                     bool equalize, int map_index, float min, float max, float depth_units )
+    {
+        _map_index = map_index;
+        _depth_units = depth_units;
+        std::vector< uint8_t > rgb( w * h * 3 );
+        auto rgb_data = rgb.data();
+        auto depth_data = depth.data();
+
+        if( equalize )
+        {
+            auto coloring_function = [&, this](float data) {
+                auto hist_data = _hist_data[(int)data];
+                auto pixels = (float)_hist_data[MAX_DEPTH - 1];
+                return (hist_data / pixels);
+            };
+            update_histogram(_hist_data, depth_data, w, h);
+            make_rgb_data<uint16_t>(depth_data, rgb_data, w, h, coloring_function);
+        }
+        else
+        {
+            auto coloring_function = [&, this](float data) {
+                if (min >= max) return 0.f;
+                return (data * _depth_units - min) / (max - min);
+            };
+            make_rgb_data<uint16_t>(depth_data, rgb_data, w, h, coloring_function);
+        }
+        return rgb;
+    }
+};
+
+// The RGB8 reference in another output format
+std::vector< uint8_t > convert( std::vector< uint8_t > const & rgb, rs2_format format )
+{
+    bool const bgr = ( format == RS2_FORMAT_BGR8 || format == RS2_FORMAT_BGRA8 );
+    bool const alpha = ( format == RS2_FORMAT_RGBA8 || format == RS2_FORMAT_BGRA8 );
+    std::vector< uint8_t > result;
+    for( size_t i = 0; i < rgb.size(); i += 3 )
+    {
+        result.push_back( rgb[bgr ? i + 2 : i] );
+        result.push_back( rgb[i + 1] );
+        result.push_back( rgb[bgr ? i : i + 2] );
+        if( alpha )
+            result.push_back( 0xff );
+    }
+    return result;
+}
+
+// A slanted plane with noise, holes, and far outliers that stretch the histogram
+std::vector< uint16_t > make_depth( int width, int height, unsigned seed )
+{
+    std::mt19937 gen( seed );
+    std::normal_distribution< float > noise( 0.f, 30.f );
+    std::uniform_int_distribution< int > percent( 0, 99 );
+
+    std::vector< uint16_t > depth( width * height );
+    for( int y = 0; y < height; ++y )
+        for( int x = 0; x < width; ++x )
+        {
+            float z = 400.f + 6.f * x + 2.f * y + noise( gen );
+            int p = percent( gen );
+            depth[y * width + x] = p < 15 ? 0 : p == 99 ? uint16_t( 60000 + x ) : uint16_t( z );
+        }
+    return depth;
+}
+
+// Depth frames of a software sensor
+class depth_source
+{
+    rs2::software_device _dev;
+    rs2::software_sensor _sensor;
+    rs2::stream_profile _profile;
+    rs2::frame_queue _queue;
+    int _width, _height;
+    int _frame_number = 0;
+
+public:
+    depth_source( int width, int height )
+        : _sensor( _dev.add_sensor( "Depth" ) )
+        , _queue( 10, true )
+        , _width( width )
+        , _height( height )
+    {
+        rs2_intrinsics intrinsics = { width, height, width / 2.f, height / 2.f, 640.f, 640.f, RS2_DISTORTION_BROWN_CONRADY, { 0, 0, 0, 0, 0 } };
+        _profile = _sensor.add_video_stream( { RS2_STREAM_DEPTH, 0, 0, width, height, 30, 2, RS2_FORMAT_Z16, intrinsics } );
+        _sensor.add_read_only_option( RS2_OPTION_DEPTH_UNITS, 0.001f );
+        _sensor.open( _profile );
+        _sensor.start( _queue );
+    }
+
+    rs2::frame get( std::vector< uint16_t > & pixels )
+    {
+        ++_frame_number;
+        _sensor.on_video_frame( { pixels.data(), []( void * ) {}, _width * 2, 2, rs2_time_t( _frame_number ),
+                                  RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, _frame_number, _profile } );
+        return _queue.wait_for_frame();
+    }
+};
+
+std::vector< uint8_t > bytes_of( rs2::frame f, rs2_format format )
+{
+    auto vf = f.as< rs2::video_frame >();
+    REQUIRE( vf );
+    REQUIRE( vf.get_profile().format() == format );
+    auto data = reinterpret_cast< const uint8_t * >( vf.get_data() );
+    return std::vector< uint8_t >( data, data + vf.get_height() * vf.get_stride_in_bytes() );
+}
+
+TEST_CASE( "colorizer matches the per-pixel implementation", "[post-processing]" )
+{
+    // Odd width: the frame is not a multiple of the vector size
+    for( int width : { 848, 853 } )
+    {
+        int const height = 97;
+        CAPTURE( width );
+        depth_source source( width, height );
+        auto depth = make_depth( width, height, unsigned( width ) );
+        std::vector< uint16_t > holes( width * height, 0 );
+
+        for( auto format : { RS2_FORMAT_RGB8, RS2_FORMAT_BGR8, RS2_FORMAT_RGBA8, RS2_FORMAT_BGRA8 } )
+        {
+            CAPTURE( rs2_format_to_string( format ) );
+            rs2::colorizer colorizer( format );
+            reference_colorizer ref;
+
+            for( int map_index : { 0, 2, 7, 9 } )
+            {
+                CAPTURE( map_index );
+                colorizer.set_option( RS2_OPTION_COLOR_SCHEME, float( map_index ) );
+
+                colorizer.set_option( RS2_OPTION_HISTOGRAM_EQUALIZATION_ENABLED, 1.f );
+                for( auto pixels : { &depth, &holes } )
+                {
+                    auto actual = bytes_of( colorizer.process( source.get( *pixels ) ), format );
+                    auto expected = convert( ref.colorize( *pixels, width, height, true, map_index, 0.f, 0.f, 0.001f ), format );
+                    REQUIRE( actual == expected );
+                }
+
+                colorizer.set_option( RS2_OPTION_HISTOGRAM_EQUALIZATION_ENABLED, 0.f );
+                for( auto range : { std::make_pair( 0.f, 6.f ), std::make_pair( 1.f, 2.5f ), std::make_pair( 3.f, 3.f ) } )
+                {
+                    CAPTURE( range.first, range.second );
+                    colorizer.set_option( RS2_OPTION_MIN_DISTANCE, range.first );
+                    colorizer.set_option( RS2_OPTION_MAX_DISTANCE, range.second );
+                    auto actual = bytes_of( colorizer.process( source.get( depth ) ), format );
+                    auto expected = convert( ref.colorize( depth, width, height, false, map_index,
+                                                           colorizer.get_option( RS2_OPTION_MIN_DISTANCE ),
+                                                           colorizer.get_option( RS2_OPTION_MAX_DISTANCE ), 0.001f ), format );
+                    REQUIRE( actual == expected );
+                }
+                colorizer.set_option( RS2_OPTION_MIN_DISTANCE, 0.f );
+            }
+        }
+    }
+}
+
+TEST_CASE( "colorizer rejects other output formats", "[post-processing]" )
+{
+    REQUIRE_THROWS( rs2::colorizer( RS2_FORMAT_Z16 ) );
+    REQUIRE_THROWS( rs2::colorizer( RS2_FORMAT_YUYV ) );
+}
+
+// Run it with "[!benchmark]"; compares the lookup tables with the per-pixel colorization
+TEST_CASE( "colorizer ms/frame", "[!benchmark]" )
+{
+    int const width = 1280, height = 720, frames = 30;
+    depth_source source( width, height );
+    auto depth = make_depth( width, height, 3 );
+    reference_colorizer ref;
+
+    for( bool equalize : { true, false } )
+    {
+        for( auto format : { RS2_FORMAT_RGB8, RS2_FORMAT_RGBA8 } )
+        {
+            rs2::colorizer colorizer( format );
+            colorizer.set_option( RS2_OPTION_HISTOGRAM_EQUALIZATION_ENABLED, equalize ? 1.f : 0.f );
+
+            double total = 0;
+            for( int i = 0; i < frames; ++i )
+            {
+                auto f = source.get( depth );
+                auto start = std::chrono::high_resolution_clock::now();
+                colorizer.process( f );
+                total += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+            }
+
+            double reference_total = 0;
+            for( int i = 0; i < frames; ++i )
+            {
+                auto start = std::chrono::high_resolution_clock::now();
+                ref.colorize( depth, width, height, equalize, 0, 0.f, 6.f, 0.001f );
+                reference_total += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+            }
+
+            std::cout << width << "x" << height << ( equalize ? " equalized " : " fixed range " )
+                      << rs2_format_to_string( format ) << ": " << total / frames
+                      << " ms/frame (per pixel: " << reference_total / frames << ")" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,150 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include "../catch.h"
+#include "filter-runner.h"
+#include "decimation-reference.h"
+
+#include <src/proc/decimation-filter.h>
+
+#include <iostream>
+#include <random>
+
+using namespace librealsense;
+
+
+struct format_info
+{
+    rs2_format format;
+    rs2_stream stream;
+    int bpp;    // Bytes per pixel
+};
+
+std::vector< format_info > const formats = {
+    { RS2_FORMAT_Z16, RS2_STREAM_DEPTH, 2 },    { RS2_FORMAT_YUYV, RS2_STREAM_COLOR, 2 },
+    { RS2_FORMAT_UYVY, RS2_STREAM_COLOR, 2 },   { RS2_FORMAT_RGB8, RS2_STREAM_COLOR, 3 },
+    { RS2_FORMAT_BGRA8, RS2_STREAM_COLOR, 4 },  { RS2_FORMAT_Y8, RS2_STREAM_INFRARED, 1 },
+    { RS2_FORMAT_Y16, RS2_STREAM_INFRARED, 2 },
+};
+
+// Random bytes, where depth gets a smooth surface with a fifth of the pixels dropping out, and
+// runs of holes wide enough to empty whole windows
+std::vector< uint8_t > make_image( format_info const & fi, int width, int height, unsigned seed )
+{
+    std::mt19937 gen( seed );
+    std::vector< uint8_t > image( width * height * fi.bpp );
+    if( fi.format != RS2_FORMAT_Z16 )
+    {
+        std::uniform_int_distribution< int > byte( 0, 255 );
+        for( auto & b : image )
+            b = uint8_t( byte( gen ) );
+        return image;
+    }
+
+    std::normal_distribution< float > noise( 0.f, 40.f );
+    std::uniform_int_distribution< int > percent( 0, 99 );
+    auto depth = reinterpret_cast< uint16_t * >( image.data() );
+    for( int y = 0; y < height; ++y )
+    {
+        for( int x = 0; x < width; ++x )
+        {
+            float z = 600.f + 5.f * x + 3.f * y + noise( gen );
+            bool hole = percent( gen ) < 20 || ( x / 7 + y / 5 ) % 11 == 0;
+            // Values at both ends of the range, to catch a wrong signedness
+            if( percent( gen ) == 0 )
+                z = ( x & 1 ) ? 65535.f : 1.f;
+            depth[y * width + x] = hole ? 0 : uint16_t( z );
+        }
+    }
+    return image;
+}
+
+void configure( decimation_filter & filter, format_info const & fi, int scale )
+{
+    filter.get_option( RS2_OPTION_STREAM_FILTER ).set( float( fi.stream ) );
+    filter.get_option( RS2_OPTION_STREAM_FORMAT_FILTER ).set( float( fi.format ) );
+    filter.get_option( RS2_OPTION_FILTER_MAGNITUDE ).set( float( scale ) );
+}
+
+std::vector< uint8_t > decimate( format_info const & fi, std::vector< uint8_t > const & image,
+                                 int width, int height, int scale )
+{
+    filter_runner< decimation_filter > runner( width, height, fi.format, fi.stream );
+    configure( runner.filter(), fi, scale );
+    return runner.process( image );
+}
+
+// The decimated image as the filter produced it before vectorization
+std::vector< uint8_t > decimate_reference( format_info const & fi, std::vector< uint8_t > const & image,
+                                           int width, int height, int scale )
+{
+    reference::decimation_filter ref;
+    ref._kernel_size = uint8_t( scale * scale );
+    ref._real_width = uint16_t( width / scale );
+    ref._real_height = uint16_t( height / scale );
+    ref._padded_width = uint16_t( ( ref._real_width + 3 ) / 4 * 4 );
+    ref._padded_height = uint16_t( ( ref._real_height + 3 ) / 4 * 4 );
+
+    std::vector< uint8_t > result( ref._padded_width * ref._padded_height * fi.bpp, 0xcd );
+    if( fi.format == RS2_FORMAT_Z16 )
+        ref.decimate_depth( reinterpret_cast< const uint16_t * >( image.data() ),
+                            reinterpret_cast< uint16_t * >( result.data() ), width, height, scale );
+    else
+        ref.decimate_others( fi.format, image.data(), result.data(), width, height, scale );
+    return result;
+}
+
+TEST_CASE( "decimation filter matches the original implementation", "[post-processing]" )
+{
+    for( auto & fi : formats )
+    {
+        CAPTURE( rs2_format_to_string( fi.format ) );
+        // Sizes that leave partial windows, and rows that are not a multiple of the vector size
+        for( auto size : { std::make_pair( 848, 480 ), std::make_pair( 854, 243 ), std::make_pair( 100, 38 ) } )
+        {
+            int const width = size.first, height = size.second;
+            CAPTURE( width );
+            CAPTURE( height );
+            auto image = make_image( fi, width, height, unsigned( width + fi.format ) );
+
+            for( int scale = 1; scale <= 8; ++scale )
+            {
+                CAPTURE( scale );
+                // The scalar code keeps the output of the original, and the vectorized code that of the scalar
+                auto scalar = scalar_code( [&]() { return decimate( fi, image, width, height, scale ); } );
+                REQUIRE( scalar == decimate_reference( fi, image, width, height, scale ) );
+                REQUIRE( decimate( fi, image, width, height, scale ) == scalar );
+            }
+        }
+    }
+}
+
+// Run it with "[!benchmark]"; compares the vectorized code with the scalar code on this CPU
+TEST_CASE( "decimation filter ms/frame", "[!benchmark]" )
+{
+    int const width = 1280, height = 720, frames = 30;
+    for( auto & fi : { formats[0], formats[1] } )
+    {
+        auto image = make_image( fi, width, height, 5 );
+        for( int scale : { 2, 3, 4 } )
+        {
+            filter_runner< decimation_filter > runner( width, height, fi.format, fi.stream );
+            configure( runner.filter(), fi, scale );
+            auto ms_per_frame = [&]() {
+                double total = 0, ms;
+                for( int i = 0; i < frames; ++i )
+                {
+                    runner.process( image, ms );
+                    total += ms;
+                }
+                return total / frames;
+            };
+
+            auto scalar_ms = scalar_code( ms_per_frame );
+            std::cout << width << "x" << height << " " << rs2_format_to_string( fi.format ) << " scale " << scale
+                      << ": " << ms_per_frame() << " ms/frame (scalar: " << scalar_ms << ")" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,202 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+
+// A noisy slanted plane with a fifth of the pixels missing at random, different in every frame
+std::vector< std::vector< uint16_t > > make_sequence( int width, int height, int frames, unsigned seed )
+{
+    std::mt19937 gen( seed );
+    std::normal_distribution< float > noise( 0.f, 4.f );
+    std::uniform_int_distribution< int > percent( 0, 99 );
+
+    std::vector< std::vector< uint16_t > > sequence;
+    for( int n = 0; n < frames; ++n )
+    {
+        std::vector< uint16_t > depth( width * height );
+        for( int y = 0; y < height; ++y )
+            for( int x = 0; x < width; ++x )
+            {
+                float z = 700.f + x + 0.5f * y + noise( gen );
+                if( x > width / 3 && x < width / 2 )
+                    z += 1500.f;
+                depth[y * width + x] = percent( gen ) < 20 ? 0 : uint16_t( z );
+            }
+        sequence.push_back( depth );
+    }
+    return sequence;
+}
+
+// Depth frames of a software stereo sensor
+class depth_source
+{
+    rs2::software_device _dev;
+    rs2::software_sensor _sensor;
+    rs2::stream_profile _profile;
+    rs2::frame_queue _queue;
+    int _width, _height;
+    int _frame_number = 0;
+
+public:
+    depth_source( int width, int height, bool stereo )
+        : _sensor( _dev.add_sensor( "Depth" ) )
+        , _queue( 10, true )
+        , _width( width )
+        , _height( height )
+    {
+        rs2_intrinsics intrinsics = { width, height, width / 2.f, height / 2.f, 640.f, 640.f, RS2_DISTORTION_BROWN_CONRADY, { 0, 0, 0, 0, 0 } };
+        _profile = _sensor.add_video_stream( { RS2_STREAM_DEPTH, 0, 0, width, height, 30, 2, RS2_FORMAT_Z16, intrinsics } );
+        _sensor.add_read_only_option( RS2_OPTION_DEPTH_UNITS, 0.001f );
+        if( stereo )
+            _sensor.add_read_only_option( RS2_OPTION_STEREO_BASELINE, 50.f );
+        _sensor.open( _profile );
+        _sensor.start( _queue );
+    }
+
+    rs2::frame get( std::vector< uint16_t > & pixels )
+    {
+        ++_frame_number;
+        _sensor.on_video_frame( { pixels.data(), []( void * ) {}, _width * 2, 2, rs2_time_t( _frame_number ),
+                                  RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, _frame_number, _profile } );
+        return _queue.wait_for_frame();
+    }
+};
+
+std::vector< uint16_t > pixels_of( rs2::frame f )
+{
+    auto vf = f.as< rs2::video_frame >();
+    REQUIRE( vf );
+    REQUIRE( vf.get_bytes_per_pixel() == 2 );
+    auto data = reinterpret_cast< const uint16_t * >( vf.get_data() );
+    return std::vector< uint16_t >( data, data + vf.get_width() * vf.get_height() );
+}
+
+// The same options on the individual blocks and on the stages
+void configure( rs2::decimation_filter dec, rs2::spatial_filter spat, rs2::temporal_filter temp, rs2::hole_filling_filter holes,
+                int magnitude, int spatial_holes, int persistence, int holes_mode )
+{
+    dec.set_option( RS2_OPTION_FILTER_MAGNITUDE, float( magnitude ) );
+    spat.set_option( RS2_OPTION_FILTER_SMOOTH_ALPHA, 0.55f );
+    spat.set_option( RS2_OPTION_FILTER_SMOOTH_DELTA, 8.f );
+    spat.set_option( RS2_OPTION_HOLES_FILL, float( spatial_holes ) );
+    temp.set_option( RS2_OPTION_FILTER_SMOOTH_ALPHA, 0.4f );
+    temp.set_option( RS2_OPTION_FILTER_SMOOTH_DELTA, 20.f );
+    temp.set_option( RS2_OPTION_HOLES_FILL, float( persistence ) );
+    holes.set_option( RS2_OPTION_HOLES_FILL, float( holes_mode ) );
+}
+
+struct chain
+{
+    rs2::decimation_filter dec;
+    rs2::disparity_transform to_disparity{ true };
+    rs2::spatial_filter spat;
+    rs2::temporal_filter temp;
+    rs2::disparity_transform to_depth{ false };
+    rs2::hole_filling_filter holes;
+
+    rs2::frame process( rs2::frame f )
+    {
+        f = dec.process( f );
+        f = to_disparity.process( f );
+        f = spat.process( f );
+        f = temp.process( f );
+        f = to_depth.process( f );
+        return holes.process( f );
+    }
+};
+
+TEST_CASE( "depth post-processing matches the chain of filters", "[post-processing]" )
+{
+    int const width = 424, height = 240;
+    auto sequence = make_sequence( width, height, 10, 21 );
+
+    struct config { bool stereo; int magnitude, spatial_holes, persistence, holes_mode; };
+    for( auto c : { config{ true, 2, 0, 3, 1 }, config{ true, 3, 2, 8, 0 }, config{ true, 1, 0, 0, 2 }, config{ false, 2, 0, 3, 1 } } )
+    {
+        CAPTURE( c.stereo, c.magnitude, c.spatial_holes, c.persistence, c.holes_mode );
+        depth_source source( width, height, c.stereo );
+
+        chain individual;
+        configure( individual.dec, individual.spat, individual.temp, individual.holes,
+                   c.magnitude, c.spatial_holes, c.persistence, c.holes_mode );
+
+        rs2::depth_post_processing fused;
+        configure( fused.decimation(), fused.spatial(), fused.temporal(), fused.hole_filling(),
+                   c.magnitude, c.spatial_holes, c.persistence, c.holes_mode );
+        CHECK( fused.temporal().get_option( RS2_OPTION_HOLES_FILL ) == float( c.persistence ) );
+
+        for( size_t n = 0; n < sequence.size(); ++n )
+        {
+            CAPTURE( n );
+            auto f = source.get( sequence[n] );
+            auto expected = individual.process( f );
+            auto actual = fused.process( f );
+
+            auto evf = expected.as< rs2::video_frame >();
+            auto avf = actual.as< rs2::video_frame >();
+            REQUIRE( avf.get_width() == evf.get_width() );
+            REQUIRE( avf.get_height() == evf.get_height() );
+            CHECK( actual.get_profile().format() == RS2_FORMAT_Z16 );
+            CHECK( actual.is< rs2::depth_frame >() );
+            REQUIRE( pixels_of( actual ) == pixels_of( expected ) );
+        }
+    }
+}
+
+TEST_CASE( "depth post-processing rejects other stages", "[post-processing]" )
+{
+    rs2_error * e = nullptr;
+    auto block = rs2_create_depth_post_processing_block( &e );
+    REQUIRE( block );
+    REQUIRE_FALSE( e );
+
+    CHECK_FALSE( rs2_get_depth_post_processing_stage( block, RS2_EXTENSION_DISPARITY_FILTER, &e ) );
+    CHECK( e );
+    rs2_free_error( e );
+    rs2_delete_processing_block( block );
+}
+
+// Run it with "[!benchmark]"; compares the fused block with the chain of individual filters
+TEST_CASE( "depth post-processing ms/frame", "[!benchmark]" )
+{
+    int const width = 848, height = 480, frames = 30;
+    auto sequence = make_sequence( width, height, 4, 5 );
+    depth_source source( width, height, true );
+
+    chain individual;
+    rs2::depth_post_processing fused;
+
+    double chain_total = 0, fused_total = 0;
+    for( int i = 0; i < frames; ++i )
+    {
+        auto f = source.get( sequence[i % sequence.size()] );
+
+        auto start = std::chrono::high_resolution_clock::now();
+        individual.process( f );
+        auto middle = std::chrono::high_resolution_clock::now();
+        fused.process( f );
+        auto end = std::chrono::high_resolution_clock::now();
+
+        chain_total += std::chrono::duration< double, std::milli >( middle - start ).count();
+        fused_total += std::chrono::duration< double, std::milli >( end - middle ).count();
+    }
+
+    std::cout << width << "x" << height << ": " << fused_total / frames << " ms/frame (chain: "
+              << chain_total / frames << ")" << std::endl;
+}
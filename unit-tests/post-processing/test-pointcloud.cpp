@@ -0,0 +1,350 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+#include <src/cpu-features.h>
+#include <src/proc/synthetic-stream.h>
+#include <src/proc/pointcloud.h>
+#include <src/proc/occlusion-filter.h>
+#ifdef __SSSE3__
+#include <src/proc/sse/sse-pointcloud.h>
+#include <src/proc/avx/avx-pointcloud.h>
+#endif
+#ifdef __ARM_NEON
+#include <src/proc/neon/neon-pointcloud.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+using namespace librealsense;
+
+
+// The vectorized blocks available on this CPU
+std::vector< std::shared_ptr< pointcloud > > make_backends()
+{
+    std::vector< std::shared_ptr< pointcloud > > backends;
+#ifdef __SSSE3__
+    if( cpu_has_avx2() )
+        backends.push_back( std::make_shared< pointcloud_avx2 >() );
+#endif
+#ifdef __ARM_NEON
+    backends.push_back( std::make_shared< pointcloud_neon >() );
+#endif
+    return backends;
+}
+
+rs2::filter wrap( std::shared_ptr< pointcloud > block )
+{
+    // The texture of the color stream, without occlusion removal
+    rs2::filter f( std::shared_ptr< rs2_processing_block >( new rs2_processing_block( block ), rs2_delete_processing_block ) );
+    f.set_option( RS2_OPTION_STREAM_FILTER, float( RS2_STREAM_COLOR ) );
+    f.set_option( RS2_OPTION_STREAM_FORMAT_FILTER, float( RS2_FORMAT_RGB8 ) );
+    f.set_option( RS2_OPTION_STREAM_INDEX_FILTER, 0.f );
+    f.set_option( RS2_OPTION_FILTER_MAGNITUDE, 1.f );
+    return f;
+}
+
+// A bumpy surface with a fifth of the pixels missing
+std::vector< uint16_t > make_depth( int width, int height, unsigned seed )
+{
+    std::mt19937 gen( seed );
+    std::normal_distribution< float > noise( 0.f, 20.f );
+    std::uniform_int_distribution< int > percent( 0, 99 );
+
+    std::vector< uint16_t > depth( width * height );
+    for( int y = 0; y < height; ++y )
+        for( int x = 0; x < width; ++x )
+        {
+            float z = 900.f + 3.f * x + 300.f * std::sin( y * 0.05f ) + noise( gen );
+            depth[y * width + x] = percent( gen ) < 20 ? 0 : uint16_t( z );
+        }
+    return depth;
+}
+
+// The bumpy surface behind a near box, whose edges hide some of the surface from the color camera
+std::vector< uint16_t > make_occluding_depth( int width, int height, unsigned seed )
+{
+    auto depth = make_depth( width, height, seed );
+    for( int y = height / 3; y < height * 2 / 3; ++y )
+        for( int x = width / 3; x < width * 2 / 3; ++x )
+            depth[y * width + x] = uint16_t( 400 + ( x + y ) % 7 );
+    return depth;
+}
+
+// Depth and color frames of a software device, with the color camera 15mm to the side (or above)
+// and slightly rotated
+class depth_color_source
+{
+    rs2::software_device _dev;
+    rs2::software_sensor _depth_sensor;
+    rs2::software_sensor _color_sensor;
+    rs2::stream_profile _depth_profile;
+    rs2::stream_profile _color_profile;
+    rs2::frame_queue _depth_queue;
+    rs2::frame_queue _color_queue;
+    int _width, _height;
+    int _color_width, _color_height;
+    std::vector< uint8_t > _color;
+    int _frame_number = 0;
+
+public:
+    depth_color_source( int width, int height, rs2_distortion depth_model, int color_width, int color_height,
+                        rs2_distortion color_model, bool vertical_baseline = false )
+        : _depth_sensor( _dev.add_sensor( "Depth" ) )
+        , _color_sensor( _dev.add_sensor( "Color" ) )
+        , _depth_queue( 10, true )
+        , _color_queue( 10, true )
+        , _width( width )
+        , _height( height )
+        , _color_width( color_width )
+        , _color_height( color_height )
+        , _color( color_width * color_height * 3, 0x80 )
+    {
+        rs2_intrinsics depth_intrinsics = { width, height, width / 2.f + 3.5f, height / 2.f - 2.25f, 0.75f * width, 0.75f * width,
+                                            depth_model, { 0.11f, -0.23f, 0.0012f, -0.0009f, 0.07f } };
+        rs2_intrinsics color_intrinsics = { color_width, color_height, color_width / 2.f - 1.5f, color_height / 2.f + 4.75f,
+                                            0.7f * color_width, 0.7f * color_width, color_model, { -0.05f, 0.06f, -0.0007f, 0.0011f, -0.02f } };
+        if( color_model == RS2_DISTORTION_KANNALA_BRANDT4 )
+            color_intrinsics.coeffs[4] = 0.f;
+
+        _depth_profile = _depth_sensor.add_video_stream( { RS2_STREAM_DEPTH, 0, 0, width, height, 30, 2, RS2_FORMAT_Z16, depth_intrinsics } );
+        _color_profile = _color_sensor.add_video_stream( { RS2_STREAM_COLOR, 0, 1, color_width, color_height, 30, 3, RS2_FORMAT_RGB8, color_intrinsics } );
+        _depth_sensor.add_read_only_option( RS2_OPTION_DEPTH_UNITS, 0.001f );
+        _depth_profile.register_extrinsics_to( _color_profile, { { 0.9998f, 0.0174f, -0.0052f,
+                                                                   -0.0175f, 0.9998f, -0.0087f,
+                                                                   0.0050f, 0.0088f, 0.9999f },
+                                                                 { vertical_baseline ? 0.0002f : 0.015f,
+                                                                   vertical_baseline ? 0.015f : -0.0002f, 0.0004f } } );
+
+        _depth_sensor.open( _depth_profile );
+        _depth_sensor.start( _depth_queue );
+        _color_sensor.open( _color_profile );
+        _color_sensor.start( _color_queue );
+    }
+
+    rs2::frame color()
+    {
+        ++_frame_number;
+        _color_sensor.on_video_frame( { _color.data(), []( void * ) {}, _color_width * 3, 3, rs2_time_t( _frame_number ),
+                                        RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, _frame_number, _color_profile } );
+        return _color_queue.wait_for_frame();
+    }
+
+    rs2::frame depth( std::vector< uint16_t > & pixels )
+    {
+        ++_frame_number;
+        _depth_sensor.on_video_frame( { pixels.data(), []( void * ) {}, _width * 2, 2, rs2_time_t( _frame_number ),
+                                        RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, _frame_number, _depth_profile } );
+        return _depth_queue.wait_for_frame();
+    }
+};
+
+rs2::points calculate( rs2::filter & block, depth_color_source & source, std::vector< uint16_t > & depth )
+{
+    block.process( source.color() );
+    auto points = block.process( source.depth( depth ) ).as< rs2::points >();
+    REQUIRE( points );
+    return points;
+}
+
+TEST_CASE( "vectorized pointclouds match the generic one", "[post-processing]" )
+{
+    if( make_backends().empty() )
+    {
+        WARN( "No vectorized pointcloud on this CPU" );
+        return;
+    }
+
+    for( auto depth_model : { RS2_DISTORTION_BROWN_CONRADY, RS2_DISTORTION_INVERSE_BROWN_CONRADY, RS2_DISTORTION_NONE } )
+    {
+        for( auto color_model : { RS2_DISTORTION_NONE, RS2_DISTORTION_BROWN_CONRADY, RS2_DISTORTION_MODIFIED_BROWN_CONRADY,
+                                  RS2_DISTORTION_INVERSE_BROWN_CONRADY, RS2_DISTORTION_KANNALA_BRANDT4 } )
+        {
+            // Odd width: the rows are not a multiple of the vector size
+            for( int width : { 848, 853 } )
+            {
+                int const height = 61;
+                CAPTURE( rs2_distortion_to_string( depth_model ), rs2_distortion_to_string( color_model ), width );
+
+                depth_color_source source( width, height, depth_model, 1280, 720, color_model );
+                auto depth = make_depth( width, height, unsigned( width ) );
+
+                auto generic = wrap( std::make_shared< pointcloud >() );
+                auto expected = calculate( generic, source, depth );
+                auto expected_vertices = reinterpret_cast< const float * >( expected.get_vertices() );
+                auto expected_texture = reinterpret_cast< const float * >( expected.get_texture_coordinates() );
+
+                for( auto & backend : make_backends() )
+                {
+                    CAPTURE( backend->get_info( RS2_CAMERA_INFO_NAME ) );
+                    auto block = wrap( backend );
+                    auto actual = calculate( block, source, depth );
+                    REQUIRE( actual.size() == expected.size() );
+
+                    REQUIRE( std::memcmp( actual.get_vertices(), expected.get_vertices(), expected.size() * sizeof( rs2::vertex ) ) == 0 );
+
+                    // Exact, also on ARM, where the build turns off FMA contraction for that
+                    auto actual_texture = reinterpret_cast< const float * >( actual.get_texture_coordinates() );
+                    size_t mismatches = 0;
+                    for( size_t i = 0; i < expected.size() * 2; ++i )
+                    {
+                        if( actual_texture[i] != expected_texture[i] )
+                            ++mismatches;
+                    }
+                    CHECK( mismatches == 0 );
+
+                    // Holes map to nothing
+                    for( size_t i = 0; i < expected.size(); ++i )
+                        if( expected_vertices[i * 3 + 2] == 0.f )
+                            REQUIRE( ( actual_texture[i * 2] == 0.f && actual_texture[i * 2 + 1] == 0.f ) );
+                }
+            }
+        }
+    }
+}
+
+// Run it with "[!benchmark]"; times each backend available on this CPU
+TEST_CASE( "pointcloud ms/frame", "[!benchmark]" )
+{
+    int const width = 1280, height = 720, frames = 20;
+    depth_color_source source( width, height, RS2_DISTORTION_BROWN_CONRADY, 1920, 1080, RS2_DISTORTION_INVERSE_BROWN_CONRADY );
+    auto depth = make_depth( width, height, 3 );
+
+    auto blocks = make_backends();
+#ifdef __SSSE3__
+    blocks.insert( blocks.begin(), std::make_shared< pointcloud_sse >() );
+#endif
+    blocks.insert( blocks.begin(), std::make_shared< pointcloud >() );
+
+    for( auto & backend : blocks )
+    {
+        // The first depth frame also prepares the block for its intrinsics
+        auto block = wrap( backend );
+        calculate( block, source, depth );
+
+        double total = 0;
+        for( int i = 0; i < frames; ++i )
+        {
+            auto f = source.depth( depth );
+            auto start = std::chrono::high_resolution_clock::now();
+            block.process( f );
+            total += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+        }
+        std::cout << width << "x" << height << " " << backend->get_info( RS2_CAMERA_INFO_NAME ) << ": "
+                  << total / frames << " ms/frame" << std::endl;
+    }
+}
+
+// Whether the texture coordinates of the points that remain rise monotonically along every row, or
+// along every column
+bool is_monotonic( rs2::points const & points, int width, int height, bool vertical )
+{
+    auto vertices = points.get_vertices();
+    auto texture = points.get_texture_coordinates();
+    int const lines = vertical ? width : height;
+    int const length = vertical ? height : width;
+    for( int line = 0; line < lines; ++line )
+    {
+        float max_in_line = -1.f;
+        for( int i = 0; i < length; ++i )
+        {
+            int index = vertical ? i * width + line : line * width + i;
+            if( ! vertices[index].z )
+                continue;
+            float mapped = vertical ? texture[index].v : texture[index].u;
+            if( mapped < max_in_line )
+                return false;
+            max_in_line = mapped;
+        }
+    }
+    return true;
+}
+
+size_t count_points( rs2::points const & points )
+{
+    size_t count = 0;
+    for( size_t i = 0; i < points.size(); ++i )
+        if( points.get_vertices()[i].z )
+            ++count;
+    return count;
+}
+
+TEST_CASE( "parallel occlusion removal", "[post-processing]" )
+{
+    int const width = 848, height = 480;
+    auto depth = make_occluding_depth( width, height, 5 );
+
+    for( bool vertical : { false, true } )
+    {
+        CAPTURE( vertical );
+        depth_color_source source( width, height, RS2_DISTORTION_BROWN_CONRADY, 1280, 720,
+                                   RS2_DISTORTION_INVERSE_BROWN_CONRADY, vertical );
+
+        auto block = wrap( pointcloud::create() );
+        auto all = calculate( block, source, depth );
+        REQUIRE( ! is_monotonic( all, width, height, vertical ) );
+
+        block.set_option( RS2_OPTION_FILTER_MAGNITUDE, float( occlusion_parallel_scan ) );
+        auto visible = calculate( block, source, depth );
+        CHECK( is_monotonic( visible, width, height, vertical ) );
+        CHECK( count_points( visible ) < count_points( all ) );
+        CHECK( count_points( visible ) > count_points( all ) * 9 / 10 );
+
+        // Along the rows, the serial scan does the same
+        if( ! vertical )
+        {
+            block.set_option( RS2_OPTION_FILTER_MAGNITUDE, float( occlusion_monotonic_scan ) );
+            auto serial = calculate( block, source, depth );
+            REQUIRE( std::memcmp( serial.get_vertices(), visible.get_vertices(), visible.size() * sizeof( rs2::vertex ) ) == 0 );
+        }
+    }
+}
+
+// Run it with "[!benchmark]"; times each occlusion removal mode
+TEST_CASE( "occlusion removal ms/frame", "[!benchmark]" )
+{
+    int const width = 1280, height = 720, frames = 20;
+    auto depth = make_occluding_depth( width, height, 3 );
+
+    for( bool vertical : { false, true } )
+    {
+        depth_color_source source( width, height, RS2_DISTORTION_BROWN_CONRADY, 1920, 1080,
+                                   RS2_DISTORTION_INVERSE_BROWN_CONRADY, vertical );
+
+        for( auto mode : { occlusion_none, occlusion_monotonic_scan, occlusion_parallel_scan } )
+        {
+            auto block = wrap( pointcloud::create() );
+            block.set_option( RS2_OPTION_FILTER_MAGNITUDE, float( mode ) );
+            calculate( block, source, depth );
+
+            double total = 0;
+            for( int i = 0; i < frames; ++i )
+            {
+                auto f = source.depth( depth );
+                auto start = std::chrono::high_resolution_clock::now();
+                block.process( f );
+                total += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+            }
+            std::cout << width << "x" << height << ( vertical ? " vertical" : " horizontal" ) << " occlusion removal "
+                      << block.get_option_value_description( RS2_OPTION_FILTER_MAGNITUDE, float( mode ) ) << ": "
+                      << total / frames << " ms/frame" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,138 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include "../catch.h"
+#include "filter-runner.h"
+#include "spatial-reference.h"
+
+#include <src/proc/spatial-filter.h>
+
+#include <iostream>
+#include <random>
+
+using namespace librealsense;
+
+
+// A depth scene: a slanted floor, a few boxes with sharp edges, sensor noise, and holes (both
+// scattered pixels and the shadows next to the boxes)
+std::vector< uint16_t > make_depth( int width, int height, unsigned seed )
+{
+    std::mt19937 gen( seed );
+    std::normal_distribution< float > noise( 0.f, 3.f );
+    std::uniform_int_distribution< int > percent( 0, 99 );
+
+    std::vector< uint16_t > depth( width * height );
+    for( int y = 0; y < height; ++y )
+    {
+        for( int x = 0; x < width; ++x )
+        {
+            float z = 3000.f - 2000.f * y / height;
+            if( x > width / 4 && x < width / 2 && y > height / 3 )
+                z = 900.f + x % 7;
+            if( x > 2 * width / 3 && x < 2 * width / 3 + 60 && y > height / 5 )
+                z = 1500.f;
+            z += noise( gen );
+            bool hole = percent( gen ) < 4 || ( x >= width / 2 && x < width / 2 + 12 && y > height / 3 );
+            depth[y * width + x] = hole ? 0 : uint16_t( z );
+        }
+    }
+    return depth;
+}
+
+std::vector< uint16_t > smooth( std::vector< uint16_t > const & depth, int width, int height, float alpha, uint8_t holes )
+{
+    filter_runner< spatial_filter > runner( width, height, RS2_FORMAT_Z16 );
+    runner.filter().get_option( RS2_OPTION_FILTER_SMOOTH_ALPHA ).set( alpha );
+    runner.filter().get_option( RS2_OPTION_FILTER_SMOOTH_DELTA ).set( 20 );
+    runner.filter().get_option( RS2_OPTION_FILTER_MAGNITUDE ).set( 2 );
+    runner.filter().get_option( RS2_OPTION_HOLES_FILL ).set( holes );
+    return runner.process( depth );
+}
+
+// The image as the filter smoothed it before vectorization. Disparity is compared exactly too: ARM
+// builds turn off FMA contraction (-ffp-contract=off), which would round the vectorized, scalar and
+// reference code differently
+template< class T >
+std::vector< T > reference( std::vector< T > image, int width, int height, float alpha, float delta, int iterations, uint8_t holes_mode )
+{
+    reference_spatial_filter ref;
+    ref._width = width;
+    ref._height = height;
+    ref._holes_filling_mode = holes_mode;
+    ref._holes_filling_radius = holes_mode == 0 ? 0 : holes_mode == 5 ? 0xff : uint8_t( 1 << holes_mode );
+    ref.dxf_smooth< T >( image.data(), alpha, delta, iterations );
+    return image;
+}
+
+TEST_CASE( "spatial filter matches the original implementation", "[post-processing]" )
+{
+    // Odd width: the last columns are not a multiple of the vector size
+    for( int width : { 848, 853 } )
+    {
+        int const height = 480;
+        CAPTURE( width );
+        auto depth = make_depth( width, height, 17 );
+
+        for( uint8_t holes : { 0, 2, 5 } )
+        {
+            for( float alpha : { 0.25f, 0.5f, 0.8f } )
+            {
+                CAPTURE( int( holes ), alpha );
+                // The scalar code keeps the output of the original, and the vectorized code that of the scalar
+                auto scalar = scalar_code( [&]() { return smooth( depth, width, height, alpha, holes ); } );
+                CHECK( scalar == reference( depth, width, height, alpha, 20.f, 2, holes ) );
+                CHECK( smooth( depth, width, height, alpha, holes ) == scalar );
+            }
+        }
+    }
+}
+
+TEST_CASE( "spatial filter on disparity matches the original implementation", "[post-processing]" )
+{
+    int const width = 853, height = 480;
+    auto depth = make_depth( width, height, 5 );
+    std::vector< float > disparity( depth.size() );
+    for( size_t i = 0; i < depth.size(); ++i )
+        disparity[i] = depth[i] ? 50000.f / depth[i] : 0.f;
+
+    for( uint8_t holes : { 0, 3 } )
+    {
+        CAPTURE( int( holes ) );
+        auto filter = [&]() {
+            filter_runner< spatial_filter > runner( width, height, RS2_FORMAT_DISPARITY32 );
+            runner.filter().get_option( RS2_OPTION_FILTER_SMOOTH_ALPHA ).set( 0.5f );
+            runner.filter().get_option( RS2_OPTION_FILTER_SMOOTH_DELTA ).set( 2 );
+            runner.filter().get_option( RS2_OPTION_HOLES_FILL ).set( holes );
+            return runner.process( disparity );
+        };
+        auto scalar = scalar_code( filter );
+        auto original = reference( disparity, width, height, 0.5f, 2.f, 2, holes );
+        REQUIRE( scalar.size() == original.size() );
+        CHECK( memcmp( scalar.data(), original.data(), scalar.size() * sizeof( float ) ) == 0 );
+        auto actual = filter();
+        REQUIRE( actual.size() == scalar.size() );
+        CHECK( memcmp( actual.data(), scalar.data(), actual.size() * sizeof( float ) ) == 0 );
+    }
+}
+
+// Run it with "[!benchmark]"; compares the vectorized code with the scalar code on this CPU
+TEST_CASE( "spatial filter ms/frame", "[!benchmark]" )
+{
+    int const width = 848, height = 480, frames = 30;
+    auto depth = make_depth( width, height, 3 );
+    filter_runner< spatial_filter > runner( width, height, RS2_FORMAT_Z16 );
+    auto ms_per_frame = [&]() {
+        double total = 0, ms;
+        for( int i = 0; i < frames; ++i )
+        {
+            runner.process( depth, ms );
+            total += ms;
+        }
+        return total / frames;
+    };
+
+    auto scalar_ms = scalar_code( ms_per_frame );
+    std::cout << width << "x" << height << " Z16: " << ms_per_frame() << " ms/frame (scalar: " << scalar_ms << ")" << std::endl;
+}
@@ -0,0 +1,152 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include "../catch.h"
+#include "filter-runner.h"
+#include "temporal-reference.h"
+
+#include <src/proc/temporal-filter.h>
+
+#include <iostream>
+#include <random>
+
+using namespace librealsense;
+
+
+// A noisy scene where a fifth of the pixels drop out at random in each frame, and a band of
+// pixels jumps far beyond the filter delta every few frames
+std::vector< std::vector< uint16_t > > make_sequence( int width, int height, int frames, unsigned seed )
+{
+    std::mt19937 gen( seed );
+    std::normal_distribution< float > noise( 0.f, 6.f );
+    std::uniform_int_distribution< int > percent( 0, 99 );
+
+    std::vector< std::vector< uint16_t > > sequence;
+    for( int n = 0; n < frames; ++n )
+    {
+        std::vector< uint16_t > depth( width * height );
+        for( int y = 0; y < height; ++y )
+        {
+            for( int x = 0; x < width; ++x )
+            {
+                float z = 800.f + 2.f * x + y;
+                if( y < height / 4 && n % 3 == 0 )
+                    z += 3000.f;
+                z += noise( gen );
+                bool hole = percent( gen ) < 20;
+                depth[y * width + x] = hole ? 0 : uint16_t( z );
+            }
+        }
+        sequence.push_back( depth );
+    }
+    return sequence;
+}
+
+std::vector< float > to_disparity( std::vector< uint16_t > const & depth )
+{
+    std::vector< float > disparity( depth.size() );
+    for( size_t i = 0; i < depth.size(); ++i )
+        disparity[i] = depth[i] ? 50000.f / depth[i] : 0.f;
+    return disparity;
+}
+
+// Two filters fed the same frames, one of them running the scalar code, and the original
+// implementation: the filter keeps state from frame to frame, so each frame is compared as the
+// sequence goes
+template< class T >
+class scalar_twin
+{
+    filter_runner< temporal_filter > _vectorized, _scalar;
+    reference_sequence< T > _reference;
+
+public:
+    scalar_twin( int width, int height, rs2_format format, uint8_t persistence, float alpha, uint8_t delta )
+        : _vectorized( width, height, format )
+        , _scalar( width, height, format )
+        , _reference( size_t( width ) * height, persistence, alpha, delta )
+    {
+        for( auto runner : { &_vectorized, &_scalar } )
+        {
+            runner->filter().get_option( RS2_OPTION_HOLES_FILL ).set( persistence );
+            runner->filter().get_option( RS2_OPTION_FILTER_SMOOTH_ALPHA ).set( alpha );
+            runner->filter().get_option( RS2_OPTION_FILTER_SMOOTH_DELTA ).set( delta );
+        }
+    }
+
+    void check( std::vector< T > const & frame )
+    {
+        auto original = _reference.process( frame );
+        auto expected = scalar_code( [&]() { return _scalar.process( frame ); } );
+        REQUIRE( expected.size() == original.size() );
+        REQUIRE( memcmp( expected.data(), original.data(), expected.size() * sizeof( T ) ) == 0 );
+
+        auto actual = _vectorized.process( frame );
+        REQUIRE( actual.size() == expected.size() );
+        REQUIRE( memcmp( actual.data(), expected.data(), actual.size() * sizeof( T ) ) == 0 );
+    }
+};
+
+TEST_CASE( "temporal filter matches the original implementation", "[post-processing]" )
+{
+    // Odd width: the frame is not a multiple of the vector size
+    for( int width : { 848, 853 } )
+    {
+        int const height = 120;
+        CAPTURE( width );
+        auto sequence = make_sequence( width, height, 20, 11 );
+
+        for( uint8_t persistence = 0; persistence <= 8; ++persistence )
+        {
+            CAPTURE( int( persistence ) );
+            for( float alpha : { 0.1f, 0.4f, 0.9f } )
+            {
+                CAPTURE( alpha );
+                scalar_twin< uint16_t > twin( width, height, RS2_FORMAT_Z16, persistence, alpha, 20 );
+                for( size_t n = 0; n < sequence.size(); ++n )
+                {
+                    CAPTURE( n );
+                    twin.check( sequence[n] );
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE( "temporal filter on disparity matches the original implementation", "[post-processing]" )
+{
+    int const width = 853, height = 120;
+    auto sequence = make_sequence( width, height, 20, 7 );
+
+    for( uint8_t persistence : { 0, 3, 7, 8 } )
+    {
+        CAPTURE( int( persistence ) );
+        scalar_twin< float > twin( width, height, RS2_FORMAT_DISPARITY32, persistence, 0.6f, 2 );
+        for( size_t n = 0; n < sequence.size(); ++n )
+        {
+            CAPTURE( n );
+            twin.check( to_disparity( sequence[n] ) );
+        }
+    }
+}
+
+// Run it with "[!benchmark]"; compares the vectorized code with the scalar code on this CPU
+TEST_CASE( "temporal filter ms/frame", "[!benchmark]" )
+{
+    int const width = 848, height = 480, frames = 30;
+    auto sequence = make_sequence( width, height, 8, 3 );
+    filter_runner< temporal_filter > runner( width, height, RS2_FORMAT_Z16 );
+    auto ms_per_frame = [&]() {
+        double total = 0, ms;
+        for( int i = 0; i < frames; ++i )
+        {
+            runner.process( sequence[i % sequence.size()], ms );
+            total += ms;
+        }
+        return total / frames;
+    };
+
+    auto scalar_ms = scalar_code( ms_per_frame );
+    std::cout << width << "x" << height << " Z16: " << ms_per_frame() << " ms/frame (scalar: " << scalar_ms << ")" << std::endl;
+}
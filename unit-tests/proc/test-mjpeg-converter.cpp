@@ -0,0 +1,189 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include "../catch.h"
+#include "../post-processing/filter-runner.h"
+
+#include <src/proc/color-formats-converter.h>
+
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include "../../third-party/stb_image.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+using namespace librealsense;
+
+
+// A 38x22 gradient, 4:2:2 as cameras send MJPEG; the size does not divide by 4
+int const jpeg_width = 38, jpeg_height = 22;
+std::vector< uint8_t > const jpeg = {
+    0xff, 0xd8, 0xff, 0xdb, 0x00, 0x43, 0x00, 0x03, 0x02, 0x02, 0x03, 0x02, 0x02, 0x03, 0x03, 0x03,
+    0x03, 0x04, 0x03, 0x03, 0x04, 0x05, 0x08, 0x05, 0x05, 0x04, 0x04, 0x05, 0x0a, 0x07, 0x07, 0x06,
+    0x08, 0x0c, 0x0a, 0x0c, 0x0c, 0x0b, 0x0a, 0x0b, 0x0b, 0x0d, 0x0e, 0x12, 0x10, 0x0d, 0x0e, 0x11,
+    0x0e, 0x0b, 0x0b, 0x10, 0x16, 0x10, 0x11, 0x13, 0x14, 0x15, 0x15, 0x15, 0x0c, 0x0f, 0x17, 0x18,
+    0x16, 0x14, 0x18, 0x12, 0x14, 0x15, 0x14, 0xff, 0xdb, 0x00, 0x43, 0x01, 0x03, 0x04, 0x04, 0x05,
+    0x04, 0x05, 0x09, 0x05, 0x05, 0x09, 0x14, 0x0d, 0x0b, 0x0d, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0xff, 0xc0, 0x00, 0x11,
+    0x08, 0x00, 0x16, 0x00, 0x26, 0x03, 0x01, 0x21, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xff,
+    0xc4, 0x00, 0x18, 0x00, 0x01, 0x01, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x02, 0x03, 0x08, 0xff, 0xc4, 0x00, 0x1e, 0x10, 0x00, 0x01,
+    0x04, 0x03, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04,
+    0x06, 0x22, 0x31, 0x03, 0x21, 0xa1, 0x32, 0x12, 0x41, 0xff, 0xc4, 0x00, 0x17, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x09,
+    0x02, 0x08, 0xff, 0xc4, 0x00, 0x1f, 0x11, 0x00, 0x01, 0x04, 0x03, 0x00, 0x03, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x05, 0x21, 0x31, 0x01, 0x02, 0x03, 0x12,
+    0x22, 0x23, 0x13, 0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3f,
+    0x00, 0xe6, 0xa4, 0xad, 0x6a, 0x87, 0x06, 0x12, 0xb5, 0xaa, 0x1c, 0x3a, 0x35, 0xd5, 0xc6, 0xe4,
+    0xd3, 0x32, 0xfa, 0x91, 0x94, 0x8d, 0x6a, 0x80, 0xca, 0x56, 0xb5, 0x43, 0x80, 0xdb, 0xab, 0x8d,
+    0xc8, 0xea, 0xcc, 0xbe, 0xa4, 0x5d, 0x3b, 0x5a, 0x3e, 0x08, 0x31, 0xec, 0xe3, 0xef, 0x99, 0x17,
+    0x38, 0x2f, 0xf9, 0xe2, 0x4c, 0x52, 0xb5, 0xaa, 0x1c, 0x19, 0x48, 0xd6, 0xa8, 0x70, 0x64, 0x75,
+    0x71, 0xb9, 0x27, 0x53, 0x32, 0xea, 0x91, 0x84, 0x8d, 0x6a, 0x87, 0x06, 0x52, 0x35, 0xaa, 0x1c,
+    0x06, 0xdd, 0x5c, 0x6e, 0x47, 0x56, 0x65, 0xf5, 0x22, 0xe9, 0xda, 0xd1, 0xf0, 0x41, 0x8f, 0x67,
+    0x1f, 0x7c, 0xc8, 0xb7, 0xc1, 0x7f, 0xcf, 0x12, 0x69, 0x4a, 0xdf, 0xc5, 0xaa, 0x18, 0x4a, 0xdf,
+    0xc5, 0xaa, 0x1a, 0x1d, 0x56, 0xed, 0x24, 0xed, 0x66, 0x59, 0xb4, 0x0c, 0xa5, 0x6f, 0xe2, 0xd5,
+    0x0c, 0xa4, 0x6f, 0xe2, 0xd5, 0x03, 0x6e, 0xab, 0x76, 0x91, 0xd9, 0x99, 0x66, 0xd0, 0x2e, 0x9d,
+    0xbf, 0x8b, 0xe7, 0xf0, 0x83, 0x1e, 0xcb, 0x76, 0xf3, 0xc8, 0xb9, 0xc1, 0x5e, 0xdf, 0x9e, 0x0f,
+    0xff, 0xd9
+};
+
+template< rs2_format Format >
+class mjpeg_to : public mjpeg_converter
+{
+public:
+    mjpeg_to() : mjpeg_converter( Format ) {}
+};
+
+// The image as stb_image decodes it, in the components of the format
+std::vector< uint8_t > stb_decode( rs2_format format )
+{
+    int components = format == RS2_FORMAT_Y8 ? 1 : ( format == RS2_FORMAT_RGBA8 || format == RS2_FORMAT_BGRA8 ) ? 4 : 3;
+    int w, h, n;
+    auto pixels = stbi_load_from_memory( jpeg.data(), int( jpeg.size() ), &w, &h, &n, components );
+    REQUIRE( pixels );
+    REQUIRE( w == jpeg_width );
+    REQUIRE( h == jpeg_height );
+    std::vector< uint8_t > image( pixels, pixels + w * h * components );
+    stbi_image_free( pixels );
+
+    if( format == RS2_FORMAT_BGR8 || format == RS2_FORMAT_BGRA8 )
+        for( size_t i = 0; i < image.size(); i += components )
+            std::swap( image[i], image[i + 2] );
+    return image;
+}
+
+// The image averaged over blocks of scale x scale pixels, the last ones cut at the edges
+std::vector< uint8_t > downscale( std::vector< uint8_t > const & image, int components, int scale )
+{
+    int width = ( jpeg_width + scale - 1 ) / scale, height = ( jpeg_height + scale - 1 ) / scale;
+    std::vector< uint8_t > result;
+    for( int y = 0; y < height; ++y )
+        for( int x = 0; x < width; ++x )
+            for( int c = 0; c < components; ++c )
+            {
+                int sum = 0, count = 0;
+                for( int j = y * scale; j < std::min( ( y + 1 ) * scale, jpeg_height ); ++j )
+                    for( int i = x * scale; i < std::min( ( x + 1 ) * scale, jpeg_width ); ++i, ++count )
+                        sum += image[( j * jpeg_width + i ) * components + c];
+                result.push_back( uint8_t( ( sum + count / 2 ) / count ) );
+            }
+    return result;
+}
+
+int max_difference( std::vector< uint8_t > const & a, std::vector< uint8_t > const & b )
+{
+    REQUIRE( a.size() == b.size() );
+    int difference = 0;
+    for( size_t i = 0; i < a.size(); ++i )
+        difference = std::max( difference, std::abs( a[i] - b[i] ) );
+    return difference;
+}
+
+template< rs2_format Format >
+void check_format()
+{
+    CAPTURE( Format );
+    filter_runner< mjpeg_to< Format > > runner( jpeg_width, jpeg_height, RS2_FORMAT_MJPEG, RS2_STREAM_COLOR );
+    // The two decoders upsample the chroma and convert the colors differently, most of all at the
+    // edges of an image this small
+    CHECK( max_difference( runner.process( jpeg ), stb_decode( Format ) ) <= 8 );
+}
+
+TEST_CASE( "MJPEG decodes as stb_image does", "[proc]" )
+{
+    check_format< RS2_FORMAT_RGB8 >();
+#ifdef RS2_USE_LIBJPEG_TURBO
+    check_format< RS2_FORMAT_BGR8 >();
+    check_format< RS2_FORMAT_RGBA8 >();
+    check_format< RS2_FORMAT_BGRA8 >();
+    check_format< RS2_FORMAT_Y8 >();
+#endif
+}
+
+TEST_CASE( "MJPEG that does not decode gives a black frame", "[proc]" )
+{
+    filter_runner< mjpeg_to< RS2_FORMAT_RGB8 > > runner( jpeg_width, jpeg_height, RS2_FORMAT_MJPEG, RS2_STREAM_COLOR );
+    std::vector< uint8_t > const black( jpeg_width * jpeg_height * 3, 0 );
+
+    std::mt19937 gen( 5 );
+    std::uniform_int_distribution< int > byte( 0, 255 );
+    std::vector< uint8_t > garbage( jpeg.size() );
+    for( auto & b : garbage )
+        b = uint8_t( byte( gen ) );
+
+    // A good frame first, so the frame buffers hold an image
+    auto image = runner.process( jpeg );
+    REQUIRE( image != black );
+    CHECK( runner.process( garbage ) == black );
+
+    // Cut in the header, so no image can come out of it
+    std::vector< uint8_t > truncated( jpeg.begin(), jpeg.begin() + 100 );
+    runner.process( jpeg );
+    CHECK( runner.process( truncated ) == black );
+}
+
+#ifdef RS2_USE_LIBJPEG_TURBO
+TEST_CASE( "MJPEG decodes at a reduced size", "[proc]" )
+{
+    filter_runner< mjpeg_to< RS2_FORMAT_RGB8 > > runner( jpeg_width, jpeg_height, RS2_FORMAT_MJPEG, RS2_STREAM_COLOR );
+    auto full = stb_decode( RS2_FORMAT_RGB8 );
+
+    for( int scale : { 2, 4 } )
+    {
+        CAPTURE( scale );
+        runner.filter().get_option( RS2_OPTION_FILTER_MAGNITUDE ).set( float( scale ) );
+        auto image = runner.process( jpeg );
+
+        // Rounded up, as libjpeg does
+        int width = ( jpeg_width + scale - 1 ) / scale, height = ( jpeg_height + scale - 1 ) / scale;
+        auto profile = std::dynamic_pointer_cast< video_stream_profile_interface >( runner.output_profile() );
+        REQUIRE( profile );
+        CHECK( profile->get_format() == RS2_FORMAT_RGB8 );
+        CHECK( int( profile->get_width() ) == width );
+        CHECK( int( profile->get_height() ) == height );
+
+        // Scaled from those of the source, as the decimation filter does
+        auto intrinsics = profile->get_intrinsics();
+        CHECK( intrinsics.width == width );
+        CHECK( intrinsics.height == height );
+        CHECK( intrinsics.fx == 600.f / scale );
+        CHECK( intrinsics.fy == 600.f / scale );
+        CHECK( intrinsics.ppx == jpeg_width / 2.f / scale );
+        CHECK( intrinsics.ppy == jpeg_height / 2.f / scale );
+
+        // libjpeg scales in the DCT, which is close to averaging the pixels
+        REQUIRE( image.size() == size_t( width * height * 3 ) );
+        CHECK( max_difference( image, downscale( full, 3, scale ) ) <= 12 );
+    }
+
+    CHECK_THROWS( runner.filter().get_option( RS2_OPTION_FILTER_MAGNITUDE ).set( 3.f ) );
+    runner.filter().get_option( RS2_OPTION_FILTER_MAGNITUDE ).set( 1.f );
+    CHECK( max_difference( runner.process( jpeg ), full ) <= 8 );
+}
+#endif
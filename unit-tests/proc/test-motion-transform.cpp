@@ -0,0 +1,173 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include "../catch.h"
+
+#include <src/ds5/ds5-motion.h>
+#include <src/ds5/ds5-options.h>
+#include <src/proc/synthetic-stream.h>
+#include <src/proc/motion-transform.h>
+#include <src/source.h>
+#include <src/stream.h>
+#include <src/environment.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace librealsense;
+
+
+// A D435i-like calibration: the IMU axes flipped against the depth, a sensitivity that is not the
+// identity and a bias
+class fake_calib_parser : public mm_calib_parser
+{
+public:
+    rs2_extrinsics get_extrinsic_to( rs2_stream ) override { return { { 1, 0, 0, 0, 1, 0, 0, 0, 1 }, { 0, 0, 0 } }; }
+    ds::imu_intrinsic get_intrinsic( rs2_stream stream ) override
+    {
+        if( stream == RS2_STREAM_ACCEL )
+            return { { { 1.02f, 0.01f, 0 }, { -0.01f, 0.98f, 0.02f }, { 0, 0.03f, 1.01f } }, { 0.1f, -0.2f, 0.05f }, {}, {} };
+        return { { { 0.99f, 0, 0.02f }, { 0.01f, 1.03f, 0 }, { -0.02f, 0, 0.97f } }, { 0.002f, 0.001f, -0.003f }, {}, {} };
+    }
+    float3x3 imu_to_depth_alignment() override { return { { -1, 0, 0 }, { 0, 1, 0 }, { 0, 0, -1 } }; }
+};
+
+class motion_transform_runner
+{
+    frame_source _source;
+    std::shared_ptr< motion_transform > _transform;
+    std::shared_ptr< motion_stream_profile > _profile;
+    rs2::frame _result;
+
+public:
+    motion_transform_runner( std::shared_ptr< motion_transform > transform, rs2_stream stream, rs2_format format )
+        : _source( 0 )
+        , _transform( transform )
+    {
+        // Normally set up by the context
+        environment::get_instance().set_time_service( std::make_shared< platform::os_time_service >() );
+
+        _source.init( nullptr );
+        _profile = std::make_shared< motion_stream_profile >( platform::stream_profile{ 0, 0, 200, 0 } );
+        _profile->set_unique_id( 1 );
+        _profile->set_stream_type( stream );
+        _profile->set_format( format );
+        _profile->set_framerate( 200 );
+
+        auto on_frame = [this]( frame_interface * f ) {
+            _result = rs2::frame( (rs2_frame *)f );
+        };
+        _transform->set_output_callback( std::make_shared< internal_frame_callback< decltype( on_frame ) > >( on_frame ) );
+    }
+
+    rs2::motion_frame process( const void * raw, size_t size )
+    {
+        frame_additional_data data;
+        auto f = _source.alloc_frame( RS2_EXTENSION_MOTION_FRAME, size, data, true );
+        f->set_stream( _profile );
+        memcpy( (void *)f->get_frame_data(), raw, size );
+        _transform->invoke( frame_holder( f ) );
+
+        REQUIRE( _result );
+        rs2::motion_frame result = _result;
+        _result = rs2::frame();
+        return result;
+    }
+};
+
+static std::vector< hid_batch_sample > samples( size_t count )
+{
+    std::vector< hid_batch_sample > batch( count );
+    for( size_t i = 0; i < count; ++i )
+    {
+        batch[i] = {};
+        batch[i].timestamp = 1000. + i * 5.;
+        batch[i].data.x = short( 30 * i - 1000 );
+        batch[i].data.y = short( 977 - 17 * i );
+        batch[i].data.z = short( i % 2 ? -32768 : 32767 );
+    }
+    return batch;
+}
+
+static void check_batch( std::shared_ptr< motion_transform > single, std::shared_ptr< motion_transform > batch,
+                         rs2_stream stream )
+{
+    const size_t count = 7;  // Not a multiple of any vector width
+    auto raw = samples( count );
+
+    motion_transform_runner batch_runner( batch, stream, RS2_FORMAT_MOTION_BATCH );
+    auto out = batch_runner.process( raw.data(), raw.size() * sizeof( hid_batch_sample ) );
+    CHECK( out.get_profile().format() == RS2_FORMAT_MOTION_BATCH );
+    REQUIRE( out.get_sample_count() == count );
+
+    motion_transform_runner single_runner( single, stream, RS2_FORMAT_MOTION_RAW );
+    for( size_t i = 0; i < count; ++i )
+    {
+        auto expected = single_runner.process( &raw[i].data, sizeof( hid_data ) ).get_motion_data();
+        auto && actual = out.get_samples()[i];
+        CHECK( actual.timestamp == raw[i].timestamp );
+        CHECK( actual.data.x == Approx( expected.x ).epsilon( 1e-5 ).margin( 1e-5 ) );
+        CHECK( actual.data.y == Approx( expected.y ).epsilon( 1e-5 ).margin( 1e-5 ) );
+        CHECK( actual.data.z == Approx( expected.z ).epsilon( 1e-5 ).margin( 1e-5 ) );
+        CHECK( actual.reserved == 0.f );
+    }
+
+    // The last sample stands for the frame
+    auto last = out.get_motion_data();
+    CHECK( last.x == out.get_samples()[count - 1].data.x );
+    CHECK( last.y == out.get_samples()[count - 1].data.y );
+    CHECK( last.z == out.get_samples()[count - 1].data.z );
+}
+
+TEST_CASE( "motion batch matches single samples", "[motion]" )
+{
+    auto calib = std::make_shared< mm_calib_handler >( std::make_shared< fake_calib_parser >() );
+    auto correction = std::make_shared< enable_motion_correction >( nullptr, option_range{ 0, 1, 1, 1 } );
+
+    SECTION( "no calibration" )
+    {
+        check_batch( std::make_shared< acceleration_transform >(),
+                     std::make_shared< acceleration_transform >( nullptr, nullptr, RS2_FORMAT_MOTION_BATCH ),
+                     RS2_STREAM_ACCEL );
+        check_batch( std::make_shared< gyroscope_transform >(),
+                     std::make_shared< gyroscope_transform >( nullptr, nullptr, RS2_FORMAT_MOTION_BATCH ),
+                     RS2_STREAM_GYRO );
+    }
+
+    SECTION( "with motion correction" )
+    {
+        correction->set( 1 );
+        check_batch( std::make_shared< acceleration_transform >( calib, correction ),
+                     std::make_shared< acceleration_transform >( calib, correction, RS2_FORMAT_MOTION_BATCH ),
+                     RS2_STREAM_ACCEL );
+        check_batch( std::make_shared< gyroscope_transform >( calib, correction ),
+                     std::make_shared< gyroscope_transform >( calib, correction, RS2_FORMAT_MOTION_BATCH ),
+                     RS2_STREAM_GYRO );
+    }
+
+    SECTION( "without motion correction" )
+    {
+        // Only the alignment applies
+        correction->set( 0 );
+        check_batch( std::make_shared< acceleration_transform >( calib, correction ),
+                     std::make_shared< acceleration_transform >( calib, correction, RS2_FORMAT_MOTION_BATCH ),
+                     RS2_STREAM_ACCEL );
+        check_batch( std::make_shared< gyroscope_transform >( calib, correction ),
+                     std::make_shared< gyroscope_transform >( calib, correction, RS2_FORMAT_MOTION_BATCH ),
+                     RS2_STREAM_GYRO );
+    }
+}
+
+TEST_CASE( "motion frames other than batches have no samples", "[motion]" )
+{
+    motion_transform_runner runner( std::make_shared< acceleration_transform >(), RS2_STREAM_ACCEL, RS2_FORMAT_MOTION_RAW );
+    hid_data raw = { 1000, {}, -2000, {}, 500, {} };
+    auto out = runner.process( &raw, sizeof( raw ) );
+    CHECK( out.get_sample_count() == 0 );
+    auto xyz = out.get_motion_data();
+    CHECK( xyz.x == Approx( 1000 * 0.001 * 9.80665 ) );
+    CHECK( xyz.y == Approx( -2000 * 0.001 * 9.80665 ) );
+    CHECK( xyz.z == Approx( 500 * 0.001 * 9.80665 ) );
+}
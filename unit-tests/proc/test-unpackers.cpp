@@ -0,0 +1,177 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <librealsense2/rs.hpp>
+#include <src/cpu-features.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace librealsense;
+
+// The unpackers are not in any header
+namespace librealsense
+{
+    typedef uint8_t byte;
+    void unpack_y8_y8_from_y8i( byte * const dest[], const byte * source, int width, int height, int actual_size );
+    void unpack_y16_y16_from_y12i_10( byte * const dest[], const byte * source, int width, int height, int actual_size );
+    void unpack_inzi( rs2_format dst_ir_format, byte * const d[], const byte * s, int width, int height, int actual_size );
+    void unpack_invi( rs2_format dst_format, byte * const d[], const byte * s, int width, int height, int actual_size );
+    void unpack_rgb_from_bgr( byte * const dest[], const byte * source, int width, int height, int actual_size );
+    void unpack_yuy2( rs2_format dst_format, rs2_stream dst_stream, byte * const d[], const byte * s, int w, int h, int actual_size );
+}
+
+
+struct unpacker
+{
+    const char * name;
+    int source_bpp;                  // Bytes per pixel
+    std::vector< int > target_bpp;   // Of each output
+    int tolerance;                   // The vectorized YUY2 to RGB math rounds differently
+    std::function< void( byte * const dest[], const byte * source, int width, int height ) > unpack;
+};
+
+static std::vector< unpacker > unpackers()
+{
+    return {
+        { "Y8I", 2, { 1, 1 }, 0, []( byte * const d[], const byte * s, int w, int h ) { unpack_y8_y8_from_y8i( d, s, w, h, 0 ); } },
+        { "Y12I", 3, { 2, 2 }, 0, []( byte * const d[], const byte * s, int w, int h ) { unpack_y16_y16_from_y12i_10( d, s, w, h, 0 ); } },
+        { "INZI to Y8", 4, { 2, 1 }, 0, []( byte * const d[], const byte * s, int w, int h ) { unpack_inzi( RS2_FORMAT_Y8, d, s, w, h, 0 ); } },
+        { "INZI to Y16", 4, { 2, 2 }, 0, []( byte * const d[], const byte * s, int w, int h ) { unpack_inzi( RS2_FORMAT_Y16, d, s, w, h, 0 ); } },
+        { "Y16_10 to Y8", 2, { 1 }, 0, []( byte * const d[], const byte * s, int w, int h ) { unpack_invi( RS2_FORMAT_Y8, d, s, w, h, 0 ); } },
+        { "Y16_10 to Y16", 2, { 2 }, 0, []( byte * const d[], const byte * s, int w, int h ) { unpack_invi( RS2_FORMAT_Y16, d, s, w, h, 0 ); } },
+        { "BGR8 to RGB8", 3, { 3 }, 0, []( byte * const d[], const byte * s, int w, int h ) { unpack_rgb_from_bgr( d, s, w, h, 0 ); } },
+        { "YUY2 to Y8", 2, { 1 }, 0, []( byte * const d[], const byte * s, int w, int h ) { unpack_yuy2( RS2_FORMAT_Y8, RS2_STREAM_COLOR, d, s, w, h, 0 ); } },
+        { "YUY2 to Y16", 2, { 2 }, 0, []( byte * const d[], const byte * s, int w, int h ) { unpack_yuy2( RS2_FORMAT_Y16, RS2_STREAM_COLOR, d, s, w, h, 0 ); } },
+        { "YUY2 to RGB8", 2, { 3 }, 2, []( byte * const d[], const byte * s, int w, int h ) { unpack_yuy2( RS2_FORMAT_RGB8, RS2_STREAM_COLOR, d, s, w, h, 0 ); } },
+        { "YUY2 to RGBA8", 2, { 4 }, 2, []( byte * const d[], const byte * s, int w, int h ) { unpack_yuy2( RS2_FORMAT_RGBA8, RS2_STREAM_COLOR, d, s, w, h, 0 ); } },
+        { "YUY2 to BGR8", 2, { 3 }, 2, []( byte * const d[], const byte * s, int w, int h ) { unpack_yuy2( RS2_FORMAT_BGR8, RS2_STREAM_COLOR, d, s, w, h, 0 ); } },
+        { "YUY2 to BGRA8", 2, { 4 }, 2, []( byte * const d[], const byte * s, int w, int h ) { unpack_yuy2( RS2_FORMAT_BGRA8, RS2_STREAM_COLOR, d, s, w, h, 0 ); } },
+    };
+}
+
+// The code paths this CPU can run, from the slowest
+static std::vector< simd_level > simd_levels()
+{
+    std::vector< simd_level > levels;
+    auto previous = set_simd_limit( simd_level::scalar );
+    for( auto limit : { simd_level::scalar, simd_level::ssse3, simd_level::avx2 } )
+    {
+        set_simd_limit( limit );
+        if( levels.empty() || levels.back() != cpu_simd_level() )
+            levels.push_back( cpu_simd_level() );
+    }
+    set_simd_limit( previous );
+    return levels;
+}
+
+static const char * simd_name( simd_level level )
+{
+    switch( level )
+    {
+    case simd_level::ssse3: return "SSSE3";
+    case simd_level::avx2: return "AVX2";
+    case simd_level::neon: return "NEON";
+    default: return "scalar";
+    }
+}
+
+struct frame_buffers
+{
+    std::vector< byte > source;
+    std::vector< std::vector< byte > > targets;
+    std::vector< byte * > planes;
+
+    frame_buffers( unpacker const & u, int width, int height, unsigned seed )
+        : source( width * height * u.source_bpp )
+    {
+        std::mt19937 gen( seed );
+        std::uniform_int_distribution< int > dist( 0, 255 );
+        for( auto & b : source )
+            b = byte( dist( gen ) );
+        for( auto bpp : u.target_bpp )
+            targets.emplace_back( width * height * bpp, 0xcd );
+        for( auto & t : targets )
+            planes.push_back( t.data() );
+    }
+};
+
+static int max_difference( std::vector< byte > const & a, std::vector< byte > const & b )
+{
+    int diff = 0;
+    for( size_t i = 0; i < a.size(); ++i )
+        diff = std::max( diff, std::abs( int( a[i] ) - int( b[i] ) ) );
+    return diff;
+}
+
+static void unpack_at( simd_level limit, unpacker const & u, frame_buffers & f, int width, int height )
+{
+    auto previous = set_simd_limit( limit );
+    u.unpack( f.planes.data(), f.source.data(), width, height );
+    set_simd_limit( previous );
+}
+
+
+TEST_CASE( "vectorized unpackers match the scalar code", "[proc]" )
+{
+    auto levels = simd_levels();
+    INFO( "fastest code path: " << simd_name( levels.back() ) );
+
+    // An odd size leaves pixels to the scalar code after the vector loops; YUY2 needs multiples of 16
+    for( auto & u : unpackers() )
+    {
+        bool yuy2 = std::string( u.name ).find( "YUY2" ) == 0;
+        for( auto size : { std::make_pair( 640, 480 ), yuy2 ? std::make_pair( 48, 3 ) : std::make_pair( 643, 7 ) } )
+        {
+            frame_buffers expected( u, size.first, size.second, 7 );
+            unpack_at( simd_level::scalar, u, expected, size.first, size.second );
+
+            for( auto level : levels )
+            {
+                INFO( u.name << " " << size.first << "x" << size.second << " with " << simd_name( level ) );
+                frame_buffers actual( u, size.first, size.second, 7 );
+                unpack_at( level, u, actual, size.first, size.second );
+                for( size_t t = 0; t < expected.targets.size(); ++t )
+                    CHECK( max_difference( actual.targets[t], expected.targets[t] ) <= u.tolerance );
+            }
+        }
+    }
+}
+
+// Run it with "[!benchmark]"; compares the code paths on this CPU, e.g. for builds without -mavx2
+TEST_CASE( "unpacker throughput", "[!benchmark]" )
+{
+    const int width = 1280, height = 720, repeat = 100;
+    auto levels = simd_levels();
+    for( auto & u : unpackers() )
+    {
+        frame_buffers f( u, width, height, 7 );
+        for( auto level : levels )
+        {
+            unpack_at( level, u, f, width, height ); // Touch the buffers
+            auto start = std::chrono::high_resolution_clock::now();
+            for( int i = 0; i < repeat; ++i )
+                unpack_at( level, u, f, width, height );
+            std::chrono::duration< double, std::micro > duration = std::chrono::high_resolution_clock::now() - start;
+            std::cout << u.name << " (" << simd_name( level ) << "): " << duration.count() / repeat << " us per "
+                      << width << "x" << height << " frame" << std::endl;
+        }
+    }
+}
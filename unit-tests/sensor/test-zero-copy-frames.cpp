@@ -0,0 +1,96 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include "../catch.h"
+
+#include <src/sensor.h>
+#include <src/stream.h>
+#include <src/environment.h>
+
+#include <thread>
+
+using namespace librealsense;
+
+
+// A frame that wraps a backend buffer, as uvc_sensor publishes it when zero-copy
+class zero_copy_stream
+{
+    frame_source _source;
+    std::shared_ptr< video_stream_profile > _profile;
+
+public:
+    std::vector< byte > buffer = std::vector< byte >( 640 * 480 * 2, 7 );
+    std::atomic< int > returned;  // Buffers handed back to the "driver"
+
+    zero_copy_stream()
+        : _source( 0 )
+        , _profile( std::make_shared< video_stream_profile >( platform::stream_profile{ 640, 480, 30, 0 } ) )
+        , returned( 0 )
+    {
+        // Normally set up by the context
+        environment::get_instance().set_time_service( std::make_shared< platform::os_time_service >() );
+        _source.init( nullptr );
+        _profile->set_stream_type( RS2_STREAM_DEPTH );
+    }
+
+    frame_holder publish( zero_copy_frames & frames )
+    {
+        std::function< void() > continuation = [this]() { ++returned; };
+        if( ! frames.hold( continuation ) )
+            return {};
+        frame_holder f( _source.alloc_frame( RS2_EXTENSION_VIDEO_FRAME, 0, frame_additional_data(), false ) );
+        REQUIRE( f );
+        f->set_stream( _profile );
+        f->attach_continuation( frame_continuation( continuation, buffer.data() ) );
+        return f;
+    }
+};
+
+
+TEST_CASE( "zero-copy frames held across close", "[sensor]" )
+{
+    zero_copy_stream stream;
+    auto frames = std::make_shared< zero_copy_frames >( 2 );
+
+    SECTION( "a driver buffer is always left" )
+    {
+        auto a = stream.publish( *frames );
+        auto b = stream.publish( *frames );
+        CHECK( a );
+        CHECK( b );
+        CHECK_FALSE( stream.publish( *frames ) );
+        a = {};
+        CHECK( stream.returned == 1 );
+        CHECK( stream.publish( *frames ) );
+    }
+
+    SECTION( "close waits for the frames to be released" )
+    {
+        auto f = stream.publish( *frames );
+        REQUIRE( f );
+        CHECK( f->get_frame_data() == stream.buffer.data() );
+        CHECK( frames->wait_released( std::chrono::milliseconds( 10 ) ) == 1 );
+        CHECK( stream.returned == 0 );
+
+        // As the user would, from another thread, while the sensor closes
+        std::thread user( [&]() {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+            CHECK( f->get_frame_data()[0] == 7 );
+            f = {};
+        } );
+        CHECK( frames->wait_released( std::chrono::seconds( 5 ) ) == 0 );
+        CHECK( stream.returned == 1 );
+        user.join();
+    }
+
+    SECTION( "frames outlive the sensor" )
+    {
+        auto f = stream.publish( *frames );
+        REQUIRE( f );
+        frames.reset();
+        f = {};
+        CHECK( stream.returned == 1 );
+    }
+}
@@ -0,0 +1,175 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include "../catch.h"
+
+#include <src/proc/cross-device-syncer.h>
+#include <src/source.h>
+#include <src/stream.h>
+#include <src/environment.h>
+
+#include <algorithm>
+
+using namespace librealsense;
+
+
+// Two devices with two streams each, hardware-synchronized at 30 fps: the second device's frame
+// counters started 1000 frames later, its frames reach the host 40ms after the first's, and for a
+// while its global-time timestamps drift 25ms away -- past the tolerance.
+struct arrival
+{
+    double at;
+    int stream;
+    double timestamp;
+    unsigned long long counter;
+};
+
+std::vector< arrival > make_arrivals( int n_captures )
+{
+    std::vector< arrival > arrivals;
+    for( int k = 0; k < n_captures; ++k )
+    {
+        double const ts = 1000. + k * 1000. / 30 + ( k % 3 ) * 0.5;
+        for( int s = 0; s < 4; ++s )
+        {
+            bool const second = s >= 2;
+            double drift = ( second && k >= 40 && k < 60 ) ? 25. : 0.;
+            arrivals.push_back( { ts + ( second ? 40. : 0. ) + s * 0.1,
+                                  s,
+                                  ts + drift + ( second ? 1. : 0. ),
+                                  (unsigned long long)( second ? k + 1000 : k ) } );
+        }
+    }
+    std::stable_sort( arrivals.begin(), arrivals.end(), []( arrival const & a, arrival const & b ) { return a.at < b.at; } );
+    return arrivals;
+}
+
+// Feeds frames of four streams to a syncer, and keeps the framesets that come out as the stream
+// and frame counter of each frame, with the timestamp of the capture
+class syncer_runner
+{
+    frame_source _source;
+    std::vector< std::shared_ptr< stream_profile_interface > > _profiles;
+    cross_device_syncer _syncer;
+
+public:
+    std::vector< std::vector< std::pair< int, unsigned long long > > > framesets;
+    std::vector< double > timestamps;
+
+    syncer_runner()
+        : _source( 0 )
+    {
+        // Normally set up by the context
+        environment::get_instance().set_time_service( std::make_shared< platform::os_time_service >() );
+
+        _source.init( nullptr );
+        for( int s = 0; s < 4; ++s )
+        {
+            auto profile = std::make_shared< video_stream_profile >( platform::stream_profile{ 640, 480, 30, 0 } );
+            profile->set_unique_id( s + 1 );
+            profile->set_stream_type( s % 2 ? RS2_STREAM_COLOR : RS2_STREAM_DEPTH );
+            profile->set_framerate( 30 );
+            _profiles.push_back( profile );
+        }
+
+        auto on_frame = [this]( frame_interface * f ) {
+            frame_holder holder( f );
+            auto composite = dynamic_cast< composite_frame * >( f );
+            REQUIRE( composite );
+            std::vector< std::pair< int, unsigned long long > > fs;
+            for( size_t i = 0; i < composite->get_embedded_frames_count(); ++i )
+            {
+                auto sub = composite->get_frame( int( i ) );
+                fs.emplace_back( sub->get_stream()->get_unique_id(), sub->get_frame_number() );
+            }
+            framesets.push_back( fs );
+            timestamps.push_back( composite->get_frame( 0 )->get_frame_timestamp() );
+        };
+        _syncer.set_output_callback( std::make_shared< internal_frame_callback< decltype( on_frame ) > >( on_frame ) );
+    }
+
+    void send( int stream, double timestamp, unsigned long long counter )
+    {
+        frame_additional_data data;
+        data.timestamp = timestamp;
+        data.timestamp_domain = RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME;
+        data.frame_number = counter;
+        auto f = _source.alloc_frame( RS2_EXTENSION_VIDEO_FRAME, 0, data, true );
+        f->set_stream( _profiles[stream] );
+        _syncer.invoke( frame_holder( f ) );
+    }
+};
+
+TEST_CASE( "cross_device_syncer matches frames of the same capture", "[syncer]" )
+{
+    syncer_runner runner;
+    auto & framesets = runner.framesets;
+
+    int const N = 100;
+    for( auto & a : make_arrivals( N ) )
+        runner.send( a.stream, a.timestamp, a.counter );
+
+    // Until it saw a frame of every stream, the syncer cannot know what it is waiting for: the
+    // first captures may be incomplete
+    size_t first = 0;
+    while( first < framesets.size() && framesets[first].size() < 4 )
+        ++first;
+    REQUIRE( first < framesets.size() );
+    auto const k0 = framesets[first].front().second;
+    CHECK( k0 <= 2 );
+
+    // The last captures may still be waiting for frames
+    REQUIRE( framesets.size() - first >= N - k0 - 2 );
+    for( size_t i = first; i < framesets.size(); ++i )
+    {
+        auto const k = k0 + ( i - first );
+        CAPTURE( k );
+        auto & fs = framesets[i];
+        REQUIRE( fs.size() == 4 );
+        for( auto & f : fs )
+            CHECK( f.second == ( f.first > 2 ? k + 1000 : k ) );
+    }
+}
+
+TEST_CASE( "cross_device_syncer drops frames that come after their capture", "[syncer]" )
+{
+    syncer_runner runner;
+    auto & framesets = runner.framesets;
+    auto timestamp = []( int k ) { return 1000. + k * 1000. / 30; };
+
+    // Two streams of one device, in step
+    for( int k = 0; k < 5; ++k )
+    {
+        runner.send( 0, timestamp( k ), k );
+        runner.send( 1, timestamp( k ), k );
+    }
+
+    // The second stream stalls, until captures 5 and 6 are emitted without it
+    for( int k = 5; k < 15; ++k )
+        runner.send( 0, timestamp( k ), k );
+    auto emitted = framesets.size();
+    REQUIRE( framesets.back() == std::vector< std::pair< int, unsigned long long > >{ { 1, 6 } } );
+
+    // Its frames of these captures are dropped; the next ones join theirs
+    runner.send( 1, timestamp( 5 ), 5 );
+    runner.send( 1, timestamp( 6 ) + 10., 6 );
+    CHECK( framesets.size() == emitted );
+    for( int k = 7; k < 15; ++k )
+        runner.send( 1, timestamp( k ), k );
+    for( int k = 15; k < 20; ++k )
+    {
+        runner.send( 0, timestamp( k ), k );
+        runner.send( 1, timestamp( k ), k );
+    }
+
+    REQUIRE( framesets.size() >= emitted + 12 );
+    CHECK( std::is_sorted( runner.timestamps.begin(), runner.timestamps.end() ) );
+    for( size_t i = emitted; i < framesets.size(); ++i )
+    {
+        auto const k = 7 + ( i - emitted );
+        CAPTURE( k );
+        CHECK( framesets[i] == std::vector< std::pair< int, unsigned long long > >{ { 1, k }, { 2, k } } );
+    }
+}
@@ -0,0 +1,167 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include "../catch.h"
+
+#include <src/sync.h>
+#include <src/source.h>
+#include <src/stream.h>
+#include <src/proc/synthetic-stream.h>
+#include <src/environment.h>
+
+#include <chrono>
+#include <iomanip>
+
+using namespace librealsense;
+
+
+// One frame of a recorded session: which stream it came from and its (hardware) timestamp
+struct recorded_frame
+{
+    int stream;
+    double timestamp;
+};
+
+// Frames of n streams as they would reach the syncer: every third stream runs at 60 fps, each has
+// its own phase and transport latency, and stream 1 drops one frame in 50.
+std::vector< recorded_frame > make_recording( int n_streams, double duration_ms )
+{
+    std::vector< std::pair< double, recorded_frame > > arrivals;
+    for( int s = 0; s < n_streams; ++s )
+    {
+        double const fps = ( s % 3 == 2 ) ? 60 : 30;
+        double const phase = ( s * 7 ) % 5 * 0.4;
+        double const latency = ( s % 4 ) * 3.;
+        int k = 0;
+        for( double ts = phase; ts < duration_ms; ts += 1000. / fps, ++k )
+        {
+            if( s == 1 && k % 50 == 49 )
+                continue;
+            arrivals.push_back( { ts + latency, { s, ts } } );
+        }
+    }
+    std::stable_sort( arrivals.begin(), arrivals.end(),
+                      []( std::pair< double, recorded_frame > const & a,
+                          std::pair< double, recorded_frame > const & b ) { return a.first < b.first; } );
+
+    std::vector< recorded_frame > recording;
+    for( auto & a : arrivals )
+        recording.push_back( a.second );
+    return recording;
+}
+
+typedef std::vector< std::pair< int, double > > frameset;
+
+// Replays a recording through a matcher, collecting the framesets it releases
+class replayer
+{
+    frame_source _source;
+    synthetic_source _synthetic;
+    single_consumer_frame_queue< frame_holder > _matches;
+    std::vector< std::shared_ptr< stream_profile_interface > > _profiles;
+    // Composite matchers order their streams by matcher address, so the same ones are used for
+    // every replay
+    std::vector< std::shared_ptr< matcher > > _streams;
+    std::vector< frameset > _framesets;
+
+public:
+    explicit replayer( int n_streams )
+        : _source( 0 )
+        , _synthetic( _source )
+    {
+        // Normally set up by the context
+        environment::get_instance().set_time_service( std::make_shared< platform::os_time_service >() );
+
+        _source.init( nullptr );
+        for( int s = 0; s < n_streams; ++s )
+        {
+            auto profile = std::make_shared< video_stream_profile >( platform::stream_profile{ 640, 480, 30, 0 } );
+            profile->set_unique_id( s + 1 );
+            profile->set_stream_type( RS2_STREAM_INFRARED );
+            profile->set_stream_index( s );
+            profile->set_framerate( ( s % 3 == 2 ) ? 60 : 30 );
+            _profiles.push_back( profile );
+            _streams.push_back( std::make_shared< identity_matcher >( s + 1, RS2_STREAM_INFRARED ) );
+        }
+    }
+
+    template< class M >
+    std::vector< frameset > replay( std::vector< recorded_frame > const & recording, double & ns_per_frame )
+    {
+        auto m = std::make_shared< M >( _streams );
+
+        _framesets.clear();
+        m->set_callback( [this]( frame_holder f, syncronization_environment const & ) {
+            auto composite = dynamic_cast< composite_frame * >( f.frame );
+            frameset fs;
+            for( size_t i = 0; i < composite->get_embedded_frames_count(); ++i )
+            {
+                auto sub = composite->get_frame( int( i ) );
+                fs.emplace_back( sub->get_stream()->get_unique_id(), sub->get_frame_timestamp() );
+            }
+            _framesets.push_back( fs );
+        } );
+
+        // Build the frames ahead of time so that only the matcher is timed
+        std::vector< frame_holder > frames;
+        frames.reserve( recording.size() );
+        for( auto & r : recording )
+        {
+            frame_additional_data data;
+            data.timestamp = r.timestamp;
+            data.timestamp_domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
+            auto f = _source.alloc_frame( RS2_EXTENSION_VIDEO_FRAME, 0, data, true );
+            f->set_stream( _profiles[r.stream] );
+            frames.push_back( frame_holder( f ) );
+        }
+
+        syncronization_environment env( &_synthetic, _matches, false );
+        auto start = std::chrono::high_resolution_clock::now();
+        for( auto & f : frames )
+            m->dispatch( std::move( f ), env );
+        auto elapsed = std::chrono::high_resolution_clock::now() - start;
+        ns_per_frame = double( std::chrono::duration_cast< std::chrono::nanoseconds >( elapsed ).count() )
+                     / recording.size();
+
+        m->stop();
+        return _framesets;
+    }
+};
+
+
+TEST_CASE( "timestamp_indexed_matcher releases the same framesets", "[syncer]" )
+{
+    for( int n_streams : { 2, 4, 6, 8, 12, 16 } )
+    {
+        CAPTURE( n_streams );
+        auto recording = make_recording( n_streams, 20000. );
+
+        replayer r( n_streams );
+        double old_ns, new_ns;
+        auto expected = r.replay< timestamp_composite_matcher >( recording, old_ns );
+        auto actual = r.replay< timestamp_indexed_matcher >( recording, new_ns );
+
+        REQUIRE( ! expected.empty() );
+        CHECK( actual == expected );
+    }
+}
+
+// Run it with "[!benchmark]"; compares the cost of the two matchers as streams are added
+TEST_CASE( "timestamp matcher throughput", "[!benchmark]" )
+{
+    std::cout << "streams   timestamp_composite_matcher   timestamp_indexed_matcher   (ns/frame)" << std::endl;
+    for( int n_streams : { 2, 4, 6, 8, 12, 16 } )
+    {
+        auto recording = make_recording( n_streams, 20000. );
+
+        replayer r( n_streams );
+        double old_ns, new_ns;
+        r.replay< timestamp_composite_matcher >( recording, old_ns );
+        r.replay< timestamp_indexed_matcher >( recording, new_ns );
+
+        std::cout << std::setw( 7 ) << n_streams << std::setw( 30 ) << int( old_ns ) << std::setw( 28 )
+                  << int( new_ns ) << std::endl;
+    }
+}
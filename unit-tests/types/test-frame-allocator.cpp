@@ -0,0 +1,156 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include "../catch.h"
+
+#include <librealsense2/rs.hpp>
+#include <src/source.h>
+#include <src/environment.h>
+
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+using namespace librealsense;
+
+
+// Hands out heap buffers, keeping track of those that are still out
+struct arena
+{
+    std::mutex mutex;
+    std::map< void *, size_t > live;
+    int allocations = 0;
+    int deallocations = 0;
+    bool wrong_size = false;
+
+    void * allocate( size_t size )
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        auto buffer = std::malloc( size );
+        live[buffer] = size;
+        ++allocations;
+        return buffer;
+    }
+
+    void deallocate( void * buffer, size_t size )
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        auto it = live.find( buffer );
+        if( it == live.end() || it->second != size )
+            wrong_size = true;
+        else
+            live.erase( it );
+        ++deallocations;
+        std::free( buffer );
+    }
+
+    bool owns( const void * buffer )
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        return live.count( const_cast< void * >( buffer ) ) != 0;
+    }
+};
+
+static void * arena_allocate( size_t size, void * user ) { return static_cast< arena * >( user )->allocate( size ); }
+static void arena_deallocate( void * buffer, size_t size, void * user ) { static_cast< arena * >( user )->deallocate( buffer, size ); }
+
+static frame_holder alloc_video_frame( frame_source & source, size_t size )
+{
+    frame_additional_data data;
+    return frame_holder( source.alloc_frame( RS2_EXTENSION_VIDEO_FRAME, size, data, true ) );
+}
+
+static const void * data_of( frame_holder const & f ) { return f->get_frame_data(); }
+
+
+TEST_CASE( "frame allocator", "[frame]" )
+{
+    // Normally set up by the context
+    environment::get_instance().set_time_service( std::make_shared< platform::os_time_service >() );
+    const size_t size = 640 * 480 * 2;
+    arena a;
+
+    SECTION( "frame buffers come from the allocator and go back to it" )
+    {
+        {
+            frame_source source( 0 );
+            source.init( nullptr );
+
+            rs2_set_frame_allocator( arena_allocate, arena_deallocate, &a, nullptr );
+            auto f = alloc_video_frame( source, size );
+            CHECK( a.allocations == 1 );
+            CHECK( a.owns( data_of( f ) ) );
+
+            // Released into the pool, then reused without another allocation
+            auto buffer = data_of( f );
+            f = frame_holder();
+            CHECK( a.deallocations == 0 );
+            f = alloc_video_frame( source, size );
+            CHECK( data_of( f ) == buffer );
+            CHECK( a.allocations == 1 );
+
+            // A buffer of the default heap once the allocator is reset, while the earlier one
+            // still goes back to the allocator that provided it
+            rs2_reset_frame_allocator( nullptr );
+            auto g = alloc_video_frame( source, size );
+            CHECK( a.allocations == 1 );
+            CHECK_FALSE( a.owns( data_of( g ) ) );
+        }
+        CHECK( a.deallocations == 1 );
+        CHECK( a.live.empty() );
+        CHECK_FALSE( a.wrong_size );
+    }
+
+    SECTION( "prewarmed buffers come from the allocator" )
+    {
+        {
+            frame_source source( 0 );
+            source.init( nullptr );
+
+            rs2_set_frame_allocator( arena_allocate, arena_deallocate, &a, nullptr );
+            source.prewarm( RS2_EXTENSION_VIDEO_FRAME, size, 3 );
+            rs2_reset_frame_allocator( nullptr );
+            CHECK( a.allocations == 3 );
+
+            auto f = alloc_video_frame( source, size );
+            CHECK( a.owns( data_of( f ) ) );
+            CHECK( a.allocations == 3 );
+        }
+        CHECK( a.deallocations == 3 );
+        CHECK( a.live.empty() );
+        CHECK_FALSE( a.wrong_size );
+    }
+
+    SECTION( "the C++ allocator is released once its buffers are" )
+    {
+        auto alive = std::make_shared< int >( 0 );
+        {
+            frame_source source( 0 );
+            source.init( nullptr );
+
+            rs2::set_frame_allocator( [&a, alive]( size_t size ) { return a.allocate( size ); },
+                                      [&a, alive]( void * buffer, size_t size ) { a.deallocate( buffer, size ); } );
+            auto f = alloc_video_frame( source, size );
+            CHECK( a.owns( data_of( f ) ) );
+
+            // The frame still holds on to the allocator
+            rs2::reset_frame_allocator();
+            CHECK( alive.use_count() > 1 );
+        }
+        CHECK( alive.use_count() == 1 );
+        CHECK( a.allocations == 1 );
+        CHECK( a.deallocations == 1 );
+        CHECK_FALSE( a.wrong_size );
+    }
+
+    SECTION( "null functions are rejected" )
+    {
+        rs2_error * e = nullptr;
+        rs2_set_frame_allocator( nullptr, arena_deallocate, &a, &e );
+        CHECK( e != nullptr );
+        rs2_free_error( e );
+        CHECK( environment::get_instance().get_frame_allocator() == nullptr );
+    }
+}
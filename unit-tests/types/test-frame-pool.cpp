@@ -0,0 +1,49 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include "../catch.h"
+
+#include <src/source.h>
+#include <src/option.h>
+#include <src/environment.h>
+
+#include <thread>
+
+using namespace librealsense;
+
+
+TEST_CASE( "frame pool retention option", "[frame]" )
+{
+    // Normally set up by the context
+    environment::get_instance().set_time_service( std::make_shared< platform::os_time_service >() );
+    frame_source source( 0 );
+    source.init( nullptr );
+
+    auto retention = source.get_buffers_retention_option();
+    auto hits = source.get_buffers_statistics_option( RS2_OPTION_FRAMES_POOL_HITS );
+    auto evictions = source.get_buffers_statistics_option( RS2_OPTION_FRAMES_POOL_EVICTIONS );
+    CHECK( retention->query() == 1000.f );
+    CHECK( retention->get_range().def == 1000.f );
+    CHECK_THROWS( retention->set( -1 ) );
+
+    auto reuse = [&]() {
+        frame_additional_data data;
+        frame_holder( source.alloc_frame( RS2_EXTENSION_VIDEO_FRAME, 1024, data, true ) );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+        frame_holder( source.alloc_frame( RS2_EXTENSION_VIDEO_FRAME, 1024, data, true ) );
+    };
+
+    // Kept for a second: the buffer is reused
+    reuse();
+    CHECK( hits->query() == 1.f );
+    CHECK( evictions->query() == 0.f );
+
+    // Expired by the time it is needed again
+    retention->set( 0 );
+    CHECK( source.get_buffers_retention() == 0 );
+    reuse();
+    CHECK( hits->query() == 1.f );
+    CHECK( evictions->query() > 0.f );
+}
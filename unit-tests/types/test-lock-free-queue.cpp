@@ -0,0 +1,108 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+//#cmake:add-file ../../src/concurrency.h
+#include <src/concurrency.h>
+
+#include <vector>
+
+
+TEST_CASE( "lock-free queue drops the oldest item when full", "[types]" )
+{
+    std::vector< int > dropped;
+    single_consumer_queue< int > q( 3, [&]( int const & i ) { dropped.push_back( i ); }, queue_type::lock_free );
+
+    for( int i = 0; i < 5; ++i )
+        q.enqueue( std::move( i ) );
+    CHECK( q.size() == 3 );
+    CHECK( dropped == std::vector< int >{ 0, 1 } );
+
+    int item;
+    for( int i = 2; i < 5; ++i )
+    {
+        REQUIRE( q.dequeue( &item, 0 ) );
+        CHECK( item == i );
+    }
+    CHECK_FALSE( q.try_dequeue( &item ) );
+    CHECK( q.empty() );
+}
+
+TEST_CASE( "lock-free queue stop and start", "[types]" )
+{
+    int dropped = 0;
+    single_consumer_queue< int > q( 3, [&]( int const & ) { ++dropped; }, queue_type::lock_free );
+
+    q.enqueue( 1 );
+    q.stop();
+    CHECK( q.empty() );
+    q.enqueue( 2 );
+    CHECK( q.empty() );
+    CHECK( dropped == 1 );
+
+    int item;
+    CHECK_FALSE( q.dequeue( &item, 10 ) );
+
+    q.start();
+    q.enqueue( 3 );
+    REQUIRE( q.dequeue( &item, 10 ) );
+    CHECK( item == 3 );
+}
+
+TEST_CASE( "lock-free queue wakes a parked consumer", "[types]" )
+{
+    single_consumer_queue< int > q( 2, nullptr, queue_type::lock_free, 100 );
+
+    std::thread producer( [&]() {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+        q.enqueue( 7 );
+    } );
+    int item = 0;
+    CHECK( q.dequeue( &item, 5000 ) );
+    CHECK( item == 7 );
+    producer.join();
+}
+
+TEST_CASE( "lock-free queue blocking producers lose nothing", "[types]" )
+{
+    const int PRODUCERS = 4;
+    const int ITEMS = 20000;
+
+    single_consumer_queue< int > q( 8, nullptr, queue_type::lock_free, 1000 );
+
+    std::vector< std::thread > producers;
+    for( int p = 0; p < PRODUCERS; ++p )
+    {
+        producers.emplace_back( [&, p]() {
+            for( int i = 0; i < ITEMS; ++i )
+                q.blocking_enqueue( p * ITEMS + i );
+        } );
+    }
+
+    // Items of each producer must arrive in the order they were sent
+    std::vector< int > last( PRODUCERS, -1 );
+    int received = 0, out_of_order = 0;
+    int item;
+    while( received < PRODUCERS * ITEMS && q.dequeue( &item, 5000 ) )
+    {
+        auto p = item / ITEMS;
+        if( item % ITEMS <= last[p] )
+            ++out_of_order;
+        last[p] = item % ITEMS;
+        ++received;
+    }
+    CHECK( received == PRODUCERS * ITEMS );
+    CHECK( out_of_order == 0 );
+
+    for( auto & th : producers )
+        th.join();
+}
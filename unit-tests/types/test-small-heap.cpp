@@ -0,0 +1,123 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+//#cmake:add-file ../../src/types.h
+#include <src/types.h>
+
+#include <thread>
+#include <set>
+
+using namespace librealsense;
+
+
+TEST_CASE( "small_heap allocates every slot once", "[types]" )
+{
+    small_heap< int, 16 > heap;
+    std::set< int * > allocated;
+    for( int i = 0; i < 16; ++i )
+    {
+        auto p = heap.allocate();
+        REQUIRE( p );
+        CHECK( allocated.insert( p ).second );
+    }
+    CHECK( heap.get_size() == 16 );
+    CHECK_FALSE( heap.allocate() );
+    CHECK( heap.get_size() == 16 );
+
+    for( auto p : allocated )
+        heap.deallocate( p );
+    CHECK( heap.is_empty() );
+
+    // Freed slots are handed out again
+    auto p = heap.allocate();
+    CHECK( allocated.count( p ) == 1 );
+    heap.deallocate( p );
+}
+
+TEST_CASE( "small_heap stop_allocation and wait_until_empty", "[types]" )
+{
+    small_heap< int, 4 > heap;
+    auto p = heap.allocate();
+    REQUIRE( p );
+
+    heap.stop_allocation();
+    CHECK_FALSE( heap.allocate() );
+    CHECK( heap.get_size() == 1 );
+
+    std::thread releaser( [&]() {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+        heap.deallocate( p );
+    } );
+    heap.wait_until_empty();
+    CHECK( heap.is_empty() );
+    releaser.join();
+}
+
+// Threads that allocate and release a slot over and over; returns the allocations that failed, or
+// found their slot in use
+template< class Heap >
+int contend( Heap & heap, int threads_count, int iterations )
+{
+    std::atomic< int > failures( 0 );
+    std::vector< std::thread > threads;
+    for( int t = 0; t < threads_count; ++t )
+    {
+        threads.emplace_back( [&]() {
+            for( int i = 0; i < iterations; ++i )
+            {
+                auto p = heap.allocate();
+                if( ! p )
+                {
+                    ++failures;
+                    continue;
+                }
+                // Every slot must be owned by a single thread at a time
+                if( *p != 0 )
+                    ++failures;
+                *p = 1;
+                *p = 0;
+                heap.deallocate( p );
+            }
+        } );
+    }
+    for( auto & th : threads )
+        th.join();
+    return failures;
+}
+
+TEST_CASE( "small_heap under contention", "[types]" )
+{
+    small_heap< int, 16 > heap;
+
+    // With fewer threads than slots, an allocation can never fail
+    CHECK( contend( heap, 8, 20000 ) == 0 );
+    CHECK( heap.is_empty() );
+}
+
+// Run it with "[!benchmark]"; the rate depends on the cores of this machine
+TEST_CASE( "small_heap allocations/s under contention", "[!benchmark]" )
+{
+    const int THREADS = 8;
+    const int ITERATIONS = 200000;
+
+    small_heap< int, 16 > heap;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    int failures = contend( heap, THREADS, ITERATIONS );
+    auto elapsed = std::chrono::duration< double >( std::chrono::high_resolution_clock::now() - start ).count();
+
+    CHECK( failures == 0 );
+    CHECK( heap.is_empty() );
+
+    std::cout << THREADS << " threads: " << int( THREADS * ITERATIONS / elapsed ) << " allocations/s" << std::endl;
+}
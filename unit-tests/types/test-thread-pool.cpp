@@ -0,0 +1,244 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2021 Intel Corporation. All Rights Reserved.
+
+//#cmake: static!
+
+#include <easylogging++.h>
+#ifdef BUILD_SHARED_LIBS
+// With static linkage, ELPP is initialized by librealsense, so doing it here will
+// create errors. When we're using the shared .so/.dll, the two are separate and we have
+// to initialize ours if we want to use the APIs!
+INITIALIZE_EASYLOGGINGPP
+#endif
+
+#include "../catch.h"
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+#include <src/thread-pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+#include <stdexcept>
+
+using namespace librealsense;
+
+
+// Runs the bands, and checks that each of them ran exactly once
+void check_bands( thread_pool & pool, int bands )
+{
+    std::vector< std::atomic< int > > runs( bands );
+    for( auto & r : runs )
+        r = 0;
+    pool.parallel_for( bands, [&]( int b ) { ++runs[b]; } );
+    for( int b = 0; b < bands; ++b )
+        REQUIRE( runs[b] == 1 );
+}
+
+TEST_CASE( "thread pool runs every band once", "[types]" )
+{
+    for( int threads : { 1, 2, 4 } )
+    {
+        CAPTURE( threads );
+        thread_pool pool( threads, false );
+        CHECK( pool.get_threads() == threads );
+        for( int bands : { 0, 1, 2, 7, 1000 } )
+        {
+            CAPTURE( bands );
+            check_bands( pool, bands );
+        }
+    }
+}
+
+TEST_CASE( "thread pool shares the bands between threads", "[types]" )
+{
+    thread_pool pool( 4, false );
+    std::mutex mutex;
+    std::set< std::thread::id > ids;
+    pool.parallel_for( 40, [&]( int ) {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        std::lock_guard< std::mutex > lock( mutex );
+        ids.insert( std::this_thread::get_id() );
+    } );
+    CHECK( ids.size() > 1 );
+    CHECK( ids.size() <= 4 );
+    CHECK( ids.count( std::this_thread::get_id() ) );
+}
+
+TEST_CASE( "thread pool with concurrent callers", "[types]" )
+{
+    thread_pool pool( 3, true );
+    CHECK( pool.is_pinned() );
+
+    std::vector< std::thread > callers;
+    for( int c = 0; c < 4; ++c )
+        callers.emplace_back( [&pool, c]() {
+            for( int i = 0; i < 200; ++i )
+                check_bands( pool, 1 + ( i * 7 + c ) % 64 );
+        } );
+    for( auto & c : callers )
+        c.join();
+}
+
+TEST_CASE( "thread pool runs nested bands inline", "[types]" )
+{
+    thread_pool pool( 4, false );
+    std::atomic< int > total( 0 );
+    pool.parallel_for( 8, [&]( int ) {
+        pool.parallel_for( 8, [&]( int ) { ++total; } );
+    } );
+    CHECK( total == 64 );
+}
+
+TEST_CASE( "thread pool rethrows the errors of its bands", "[types]" )
+{
+    thread_pool pool( 4, false );
+    std::atomic< int > runs( 0 );
+    REQUIRE_THROWS_AS( pool.parallel_for( 100, [&]( int b ) {
+        ++runs;
+        if( b == 42 )
+            throw std::runtime_error( "band failed" );
+    } ),
+                       std::runtime_error );
+    CHECK( runs == 100 );
+
+    // Still usable
+    check_bands( pool, 100 );
+}
+
+TEST_CASE( "processing threads are set through the context", "[types]" )
+{
+    rs2::context ctx;
+    ctx.set_processing_threads( 3 );
+    CHECK( ctx.get_processing_threads() == 3 );
+
+    ctx.set_processing_threads( 0 );
+    CHECK( ctx.get_processing_threads() == std::max( 1, int( std::thread::hardware_concurrency() ) ) );
+
+    CHECK_THROWS( ctx.set_processing_threads( -1 ) );
+
+    ctx.set_processing_threads( 2, true );
+    CHECK( ctx.get_processing_threads() == 2 );
+}
+
+// Depth frames of a software sensor
+class depth_source
+{
+    rs2::software_device _dev;
+    rs2::software_sensor _sensor;
+    rs2::stream_profile _profile;
+    rs2::frame_queue _queue;
+    int _width, _height;
+    int _frame_number = 0;
+
+public:
+    depth_source( int width, int height )
+        : _sensor( _dev.add_sensor( "Depth" ) )
+        , _queue( 10, true )
+        , _width( width )
+        , _height( height )
+    {
+        rs2_intrinsics intrinsics = { width, height, width / 2.f, height / 2.f, 640.f, 640.f, RS2_DISTORTION_BROWN_CONRADY, { 0, 0, 0, 0, 0 } };
+        _profile = _sensor.add_video_stream( { RS2_STREAM_DEPTH, 0, 0, width, height, 30, 2, RS2_FORMAT_Z16, intrinsics } );
+        _sensor.add_read_only_option( RS2_OPTION_DEPTH_UNITS, 0.001f );
+        _sensor.open( _profile );
+        _sensor.start( _queue );
+    }
+
+    rs2::frame get( std::vector< uint16_t > & pixels )
+    {
+        ++_frame_number;
+        _sensor.on_video_frame( { pixels.data(), []( void * ) {}, _width * 2, 2, rs2_time_t( _frame_number ),
+                                  RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, _frame_number, _profile } );
+        return _queue.wait_for_frame();
+    }
+};
+
+// A slanted plane with noise and holes
+std::vector< uint16_t > make_depth( int width, int height )
+{
+    std::mt19937 gen( 7 );
+    std::normal_distribution< float > noise( 0.f, 15.f );
+    std::uniform_int_distribution< int > percent( 0, 99 );
+
+    std::vector< uint16_t > depth( width * height );
+    for( int y = 0; y < height; ++y )
+        for( int x = 0; x < width; ++x )
+            depth[y * width + x] = percent( gen ) < 10 ? 0 : uint16_t( 700.f + 2.f * x + y + noise( gen ) );
+    return depth;
+}
+
+std::vector< uint16_t > filter( std::vector< rs2::filter * > const & blocks, rs2::frame f )
+{
+    for( auto block : blocks )
+        f = block->process( f );
+    auto vf = f.as< rs2::video_frame >();
+    auto data = reinterpret_cast< const uint16_t * >( vf.get_data() );
+    return std::vector< uint16_t >( data, data + vf.get_width() * vf.get_height() );
+}
+
+TEST_CASE( "filters give the same output on any number of threads", "[types]" )
+{
+    int const width = 848, height = 480;
+    rs2::context ctx;
+    depth_source source( width, height );
+    auto depth = make_depth( width, height );
+
+    std::vector< uint16_t > expected;
+    for( int threads : { 1, 2, 5 } )
+    {
+        CAPTURE( threads );
+        ctx.set_processing_threads( threads );
+
+        rs2::decimation_filter decimation;
+        rs2::spatial_filter spatial;
+        rs2::temporal_filter temporal;
+        rs2::hole_filling_filter hole_filling;
+        std::vector< uint16_t > output;
+        for( int i = 0; i < 3; ++i )
+            output = filter( { &decimation, &spatial, &temporal, &hole_filling }, source.get( depth ) );
+
+        if( expected.empty() )
+            expected = output;
+        else
+            REQUIRE( output == expected );
+    }
+    ctx.set_processing_threads( 0 );
+}
+
+// Run it with "[!benchmark]"; the scaling depends on the cores of this machine
+TEST_CASE( "filters ms/frame by threads", "[!benchmark]" )
+{
+    int const width = 1280, height = 720, frames = 20;
+    rs2::context ctx;
+    depth_source source( width, height );
+    auto depth = make_depth( width, height );
+
+    std::vector< int > thread_counts = { 1, 2, 4 };
+    int const cores = int( std::thread::hardware_concurrency() );
+    if( cores > 4 )
+        thread_counts.push_back( cores );
+
+    for( int threads : thread_counts )
+    {
+        ctx.set_processing_threads( threads );
+        rs2::spatial_filter spatial;
+        rs2::temporal_filter temporal;
+        filter( { &spatial, &temporal }, source.get( depth ) );
+
+        double total = 0;
+        for( int i = 0; i < frames; ++i )
+        {
+            auto f = source.get( depth );
+            auto start = std::chrono::high_resolution_clock::now();
+            filter( { &spatial, &temporal }, f );
+            total += std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - start ).count();
+        }
+        std::cout << width << "x" << height << " spatial + temporal on " << threads << " threads: "
+                  << total / frames << " ms/frame" << std::endl;
+    }
+    ctx.set_processing_threads( 0 );
+}
@@ -75,7 +75,7 @@ if not os.path.isdir( dir ) or not os.path.isdir( builddir ):
 root = repo.root.replace( '\\' , '/' )
 src = root + '/src'
 
-def generate_cmake( builddir, testdir, testname, filelist, custom_main ):
+def generate_cmake( builddir, testdir, testname, filelist, custom_main, include_dirs ):
     makefile = builddir + '/' + testdir + '/CMakeLists.txt'
     log.d( '   creating:', makefile )
     handle = open( makefile, 'w' )
@@ -103,6 +103,8 @@ set_target_properties( ''' + testname + ''' PROPERTIES FOLDER "Unit-Tests/''' +
 target_include_directories(''' + testname + ''' PRIVATE ''' + root + ''')
 
 ''' )
+    for include_dir in include_dirs:
+        handle.write( 'target_include_directories( ' + testname + ' PRIVATE ' + include_dir + ' )\n' )
     handle.close()
 
 
@@ -209,6 +211,7 @@ def process_cpp( dir, builddir ):
             shared = False
             static = False
             custom_main = False
+            include_dirs = []
             for cmake_directive in file.grep( '^//#cmake:\s*', dir + '/' + f ):
                 m = cmake_directive['match']
                 index = cmake_directive['index']
@@ -249,8 +252,18 @@ def process_cpp( dir, builddir ):
                         shared = True
                 elif cmd == 'custom-main':
                     custom_main = True
+                elif cmd == 'include-dir':
+                    # Relative to $dir, like add-file
+                    for additional_dir in rest:
+                        if not os.path.isabs( additional_dir ):
+                            additional_dir = dir + '/' + testparent + '/' + additional_dir
+                        additional_dir = os.path.normpath( additional_dir ).replace( '\\', '/' )
+                        if not os.path.isdir( additional_dir ):
+                            log.e( f + '+' + str(index) + ': directory not found "' + additional_dir + '"' )
+                        log.d( 'include dir:', additional_dir )
+                        include_dirs.append( additional_dir )
                 else:
-                    log.e( f + '+' + str(index) + ': unknown cmd \'' + cmd + '\' (should be \'add-file\', \'static!\', or \'shared!\')' )
+                    log.e( f + '+' + str(index) + ': unknown cmd \'' + cmd + '\' (should be \'add-file\', \'include-dir\', \'static!\', or \'shared!\')' )
             for include in includes:
                 filelist.append( include )
 
@@ -264,7 +277,7 @@ def process_cpp( dir, builddir ):
 
             # Each CMakeLists.txt sits in its own directory
             os.makedirs( builddir + '/' + testdir, exist_ok=True )  # "build/log/internal/test-all"
-            generate_cmake( builddir, testdir, testname, filelist, custom_main )
+            generate_cmake( builddir, testdir, testname, filelist, custom_main, include_dirs )
             if static:
                 statics.append( testdir )
             elif shared:
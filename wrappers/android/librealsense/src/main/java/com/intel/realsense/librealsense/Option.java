@@ -90,7 +90,11 @@ public enum Option {
     AUTO_EXPOSURE_LIMIT(85),
     AUTO_GAIN_LIMIT(86),
     AUTO_RX_SENSITIVITY(87),
-    OPTION_TRANSMITTER_FREQUENCY(88);
+    OPTION_TRANSMITTER_FREQUENCY(88),
+    FRAMES_POOL_HITS(89),
+    FRAMES_POOL_MISSES(90),
+    FRAMES_POOL_EVICTIONS(91),
+    FRAMES_POOL_RETENTION(92);
 
     private final int mValue;
 
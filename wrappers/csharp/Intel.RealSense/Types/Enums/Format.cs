@@ -96,6 +96,9 @@ namespace Intel.RealSense
         Z16H = 28,
 
         /// <summary>16-bit per-pixel frame grabber format.</summary>
-        FG = 29
+        FG = 29,
+
+        /// <summary>Motion samples read together from the sensor, as an array of rs2_motion_sample.</summary>
+        MotionBatch = 30
     }
 }
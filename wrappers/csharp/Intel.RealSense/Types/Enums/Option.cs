@@ -279,6 +279,18 @@ namespace Intel.RealSense
         auto_rx_sensitivity = 87,
 
         /// <summary>Change transmitter frequency, increasing effective range over sharpness</summary>
-        transmitter_frequency = 88
+        transmitter_frequency = 88,
+
+        /// <summary>Debug: number of frames whose buffer was reused from the frame buffers pool</summary>
+        frames_pool_hits = 89,
+
+        /// <summary>Debug: number of frames that required a new frame buffer allocation</summary>
+        frames_pool_misses = 90,
+
+        /// <summary>Debug: number of frame buffers dropped from the pool, either expired or overflowing</summary>
+        frames_pool_evictions = 91,
+
+        /// <summary>Time in milliseconds an unused frame buffer is kept in the frame buffers pool for reuse</summary>
+        frames_pool_retention = 92
     }
 }
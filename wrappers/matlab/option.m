@@ -90,6 +90,10 @@ classdef option < int64
         auto_gain_limit                 (86)
         auto_rx_sensitivity             (87)
         transmitter_frequency           (88)
-        count                           (89)
+        frames_pool_hits                (89)
+        frames_pool_misses              (90)
+        frames_pool_evictions           (91)
+        frames_pool_retention           (92)
+        count                           (93)
     end
 end
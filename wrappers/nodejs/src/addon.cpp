@@ -4642,6 +4642,7 @@ void InitModule(v8::Local<v8::Object> exports) {
   _FORCE_SET_ENUM(RS2_FORMAT_W10);
   _FORCE_SET_ENUM(RS2_FORMAT_Z16H);
   _FORCE_SET_ENUM(RS2_FORMAT_FG);
+  _FORCE_SET_ENUM(RS2_FORMAT_MOTION_BATCH);
   _FORCE_SET_ENUM(RS2_FORMAT_COUNT);
 
   // rs2_frame_metadata_value
@@ -4783,6 +4784,10 @@ void InitModule(v8::Local<v8::Object> exports) {
   _FORCE_SET_ENUM(RS2_OPTION_AUTO_GAIN_LIMIT);
   _FORCE_SET_ENUM(RS2_OPTION_AUTO_RX_SENSITIVITY);
   _FORCE_SET_ENUM(RS2_OPTION_TRANSMITTER_FREQUENCY);
+  _FORCE_SET_ENUM(RS2_OPTION_FRAMES_POOL_HITS);
+  _FORCE_SET_ENUM(RS2_OPTION_FRAMES_POOL_MISSES);
+  _FORCE_SET_ENUM(RS2_OPTION_FRAMES_POOL_EVICTIONS);
+  _FORCE_SET_ENUM(RS2_OPTION_FRAMES_POOL_RETENTION);
   _FORCE_SET_ENUM(RS2_OPTION_COUNT);
 
   // rs2_camera_info
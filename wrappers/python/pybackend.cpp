@@ -187,6 +187,10 @@ PYBIND11_MODULE(NAME, m) {
         .value("auto_gain_limit", RS2_OPTION_AUTO_GAIN_LIMIT)
         .value("auto_rx_sensitivity", RS2_OPTION_AUTO_RX_SENSITIVITY)
         .value("transmitter_frequency", RS2_OPTION_TRANSMITTER_FREQUENCY)
+        .value("frames_pool_hits", RS2_OPTION_FRAMES_POOL_HITS)
+        .value("frames_pool_misses", RS2_OPTION_FRAMES_POOL_MISSES)
+        .value("frames_pool_evictions", RS2_OPTION_FRAMES_POOL_EVICTIONS)
+        .value("frames_pool_retention", RS2_OPTION_FRAMES_POOL_RETENTION)
         .value("count", RS2_OPTION_COUNT);
 
     py::enum_<platform::power_state> power_state(m, "power_state");
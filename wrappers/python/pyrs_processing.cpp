@@ -133,6 +133,7 @@ void init_processing(py::module &m) {
              "6 - Warm\n"
              "7 - Quantized\n"
              "8 - Pattern", "color_scheme"_a)
+        .def(py::init<rs2_format>(), "Colorize into format rgb8, bgr8, rgba8 or bgra8", "output_format"_a)
         .def("colorize", &rs2::colorizer::colorize, "Start to generate color image base on depth frame", "depth"_a)
         /*.def("__call__", &rs2::colorizer::operator())*/;
 
@@ -143,6 +143,10 @@ enum class ERealSenseOptionType : uint8
     AUTO_GAIN_LIMIT                            , /**< Set and get auto gain limits ranging from 16 to 248. Default is 0 which means full gain. If the requested gain limit is less than 16, it will be set to 16. If the requested gain limit is greater than 248, it will be set to 248. Setting will not take effect until next streaming session. */
     AUTO_RX_SENSITIVITY                        , /**< Set and get auto receiver sensitivity.*/
     TRANSMITTER_FREQUENCY                      , /**< Change transmitter frequency, increasing effective range over sharpness. */
+    FRAMES_POOL_HITS                           , /**< Debug: number of frames whose buffer was reused from the frame buffers pool */
+    FRAMES_POOL_MISSES                         , /**< Debug: number of frames that required a new frame buffer allocation */
+    FRAMES_POOL_EVICTIONS                      , /**< Debug: number of frame buffers dropped from the pool, either expired or overflowing */
+    FRAMES_POOL_RETENTION                      , /**< Time in milliseconds an unused frame buffer is kept in the frame buffers pool for reuse */
 };
 
 UENUM(Blueprintable)